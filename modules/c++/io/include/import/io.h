@@ -74,8 +74,7 @@
 #include <io/CountingStreams.h>
 #include <io/RotatingFileOutputStream.h>
 #include <io/StreamSplitter.h>
-
-//#include "io/MMapInputStream.h"
-//using namespace io;
+#include <io/MMapInputStream.h>
+#include <io/AsyncFileReader.h>
 
 #endif  // CODA_OSS_import_io_h_INCLUDED_
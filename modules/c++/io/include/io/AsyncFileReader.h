@@ -0,0 +1,225 @@
+/* =========================================================================
+ * This file is part of io-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * io-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_io_AsyncFileReader_h_INCLUDED_
+#define CODA_OSS_io_AsyncFileReader_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/Exports.h"
+#include "sys/Conf.h"
+
+namespace io
+{
+namespace details
+{
+class AsyncReadEngine;
+}
+
+/*!
+ *  \class AsyncFileReader
+ *  \brief Reads from a file asynchronously, in batches of independent
+ *         (offset, length, buffer) requests.
+ *
+ *  Requests are submitted without blocking (unless getQueueDepth() are
+ *  already in flight) and their completions are collected with wait(), in
+ *  whatever order they finish.  On Linux the reads go through io_uring when
+ *  the kernel allows it; otherwise (or if THREAD_POOL is asked for) a small
+ *  pool of I/O threads does blocking pread()s.
+ *
+ *  Use ReadAheadQueue to consume a long list of requests in order while
+ *  keeping a fixed number of them in flight.
+ *
+ *  This isn't thread-safe; submit and wait from one thread.
+ */
+class CODA_OSS_API AsyncFileReader final
+{
+public:
+    enum Backend
+    {
+        //! io_uring if available, otherwise THREAD_POOL
+        AUTO = 0,
+        IO_URING,
+        THREAD_POOL
+    };
+
+    static constexpr size_t DEFAULT_QUEUE_DEPTH = 32;
+    static constexpr size_t DEFAULT_NUM_THREADS = 4;
+
+    struct Request final
+    {
+        sys::Off_T offset = 0;
+        size_t length = 0;
+        void* buffer = nullptr;
+        //! Returned in the Completion; not otherwise used
+        size_t tag = 0;
+    };
+
+    struct Completion final
+    {
+        size_t tag = 0;
+        //! Bytes read; less than requested only at end of file
+        size_t bytesRead = 0;
+        //! errno of the failure, or 0 on success
+        int error = 0;
+    };
+
+    /*!
+     *  Open pathname for reading.
+     *
+     *  \param backend Which backend to use.  Asking for IO_URING when it
+     *         isn't available throws.
+     *  \param queueDepth Maximum number of requests in flight
+     *  \param numThreads Number of I/O threads for the THREAD_POOL backend
+     *
+     *  \throw sys::SystemException if the file can't be opened
+     *  \throw except::NotImplementedException if IO_URING isn't available
+     */
+    AsyncFileReader(const std::string& pathname,
+                    Backend backend = AUTO,
+                    size_t queueDepth = DEFAULT_QUEUE_DEPTH,
+                    size_t numThreads = DEFAULT_NUM_THREADS);
+
+    //! Waits for all requests in flight
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    //! \return The backend in use (never AUTO)
+    Backend getBackend() const noexcept
+    {
+        return mBackend;
+    }
+
+    size_t getQueueDepth() const noexcept
+    {
+        return mQueueDepth;
+    }
+
+    //! \return The number of requests submitted but not yet returned by wait()
+    size_t getNumPending() const noexcept
+    {
+        return mNumInFlight + mReady.size();
+    }
+
+    /*!
+     *  Queue a read.  The buffer must stay valid until its completion is
+     *  returned.  If getQueueDepth() reads are already in flight, this
+     *  blocks until one finishes (its completion is kept for wait()).
+     */
+    void submit(const Request& request);
+
+    //! Queue a batch of reads.
+    void submit(const std::vector<Request>& requests);
+
+    /*!
+     *  Wait for at least minCompletions (capped at getNumPending()) reads to
+     *  finish, appending their completions to completions.
+     *
+     *  \return The number of completions appended
+     */
+    size_t wait(std::vector<Completion>& completions,
+                size_t minCompletions = 1);
+
+    //! \return true if io_uring can be used in this process
+    static bool isIoUringAvailable();
+
+private:
+    void queue(const Request& request);
+
+    std::unique_ptr<details::AsyncReadEngine> mEngine;
+    Backend mBackend = AUTO;
+    size_t mQueueDepth = DEFAULT_QUEUE_DEPTH;
+    size_t mNumInFlight = 0;
+
+    // Completions reaped to make room in submit(), not yet returned by wait()
+    std::vector<Completion> mReady;
+};
+
+/*!
+ *  \class ReadAheadQueue
+ *  \brief Reads a list of requests in order, keeping a window of them in
+ *         flight ahead of the consumer.
+ *
+ *  \code
+    io::ReadAheadQueue queue(reader, requests, 8);
+    while (!queue.isDone())
+    {
+        const auto completion = queue.next();  // requests[i], in order
+        process(requests[completion.tag]);
+    }
+    \endcode
+ *
+ *  Completions' tags are indices into requests.  The reader must not be
+ *  used for anything else while the queue is active.
+ */
+class CODA_OSS_API ReadAheadQueue final
+{
+public:
+    /*!
+     *  \param readAhead The number of requests to keep in flight; 0 means
+     *         reader.getQueueDepth()
+     */
+    ReadAheadQueue(AsyncFileReader& reader,
+                   const std::vector<AsyncFileReader::Request>& requests,
+                   size_t readAhead = 0);
+
+    //! Waits for anything still in flight
+    ~ReadAheadQueue();
+
+    ReadAheadQueue(const ReadAheadQueue&) = delete;
+    ReadAheadQueue& operator=(const ReadAheadQueue&) = delete;
+
+    //! \return true once next() has returned every request
+    bool isDone() const noexcept
+    {
+        return mNextToReturn == mRequests.size();
+    }
+
+    /*!
+     *  Wait for the next request in order, topping up the window.
+     *
+     *  \throw except::IOException if the read failed
+     */
+    AsyncFileReader::Completion next();
+
+private:
+    void fill();
+
+    AsyncFileReader& mReader;
+    std::vector<AsyncFileReader::Request> mRequests;
+    size_t mReadAhead;
+    size_t mNextToSubmit = 0;
+    size_t mNextToReturn = 0;
+    std::map<size_t, AsyncFileReader::Completion> mFinished;
+    std::vector<AsyncFileReader::Completion> mCompletions;
+};
+}
+
+#endif  // CODA_OSS_io_AsyncFileReader_h_INCLUDED_
@@ -28,6 +28,7 @@
 #include <ios>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 #include "except/Exception.h"
 #include "io/InputStream.h"
@@ -124,6 +125,36 @@ public:
     //!  Close the file
     void close();
 
+    /*!
+     *  Read len bytes and byte swap them in place as elements of elemSize
+     *  bytes.  Provided for compatibility with FileInputStreamOS; this is
+     *  simply read() followed by sys::byteSwap().
+     *
+     *  \param buffer Buffer to read into
+     *  \param len The number of bytes to read
+     *  \param elemSize The size of each element, in bytes
+     *  \param verifyFullRead If true, throw if fewer than len bytes are read
+     *  \throw except::IOException
+     *  \return The number of bytes read
+     */
+    sys::SSize_T readAndByteSwap(void* buffer,
+                                 size_t len,
+                                 size_t elemSize,
+                                 bool verifyFullRead = false);
+
+    /*!
+     *  Read exactly len bytes starting at offset, for compatibility with
+     *  FileInputStreamOS.  This is a seek and a read under a lock, with the
+     *  stream position restored afterwards, so it's safe to call from
+     *  several threads at once but the reads don't overlap.
+     *
+     *  \param offset Offset from the beginning of the file
+     *  \param buffer Buffer to read into
+     *  \param len The number of bytes to read
+     *  \throw except::IOException if len bytes can't be read
+     */
+    void readAt(sys::Off_T offset, void* buffer, size_t len);
+
     /*!
      *  Access the stream directly
      *  \return The stream in native C++
@@ -147,6 +178,7 @@ protected:
 
 
     std::ifstream mFStream;
+    std::mutex mReadAtMutex;
 };
 
 
@@ -60,9 +60,9 @@ struct CODA_OSS_API FileInputStreamOS : public SeekableInputStream
 {
 protected:
     sys::File mFile;
-    size_t mMaxReadThreads;
-    size_t mParallelChunkSize;
-    size_t mMinChunksForThreading;
+    size_t mMaxReadThreads = defaultNumThreads;
+    size_t mParallelChunkSize = defaultChunkSize;
+    size_t mMinChunksForThreading = defaultMinChunksForThreading;
 
 public:
 
@@ -239,6 +239,41 @@ public:
         return mMinChunksForThreading;
     }
 
+    /*!
+     *  Read len bytes and byte swap them in place as elements of elemSize
+     *  bytes.  This is equivalent to read() followed by sys::byteSwap(), but
+     *  the data is swapped a cache-sized piece at a time as it arrives, by
+     *  the same thread that read it (including the parallel read threads),
+     *  rather than in a second pass over the whole buffer.
+     *
+     *  \param buffer Buffer to read into
+     *  \param len The number of bytes to read; must be a multiple of
+     *         elemSize
+     *  \param elemSize The size of each element, in bytes
+     *  \param verifyFullRead If true, throw if fewer than len bytes are read
+     *  \throw except::IOException
+     *  \return The number of bytes read
+     */
+    sys::SSize_T readAndByteSwap(void* buffer,
+                                 size_t len,
+                                 size_t elemSize,
+                                 bool verifyFullRead = false);
+
+    /*!
+     *  Read exactly len bytes starting at offset.  This doesn't go through
+     *  the stream position, so it's safe to call from several threads at
+     *  once (e.g. to read independent pieces of the file in parallel).
+     *
+     *  \param offset Offset from the beginning of the file
+     *  \param buffer Buffer to read into
+     *  \param len The number of bytes to read
+     *  \throw sys::SystemException if len bytes can't be read
+     */
+    void readAt(sys::Off_T offset, void* buffer, size_t len)
+    {
+        mFile.readAtInto(offset, buffer, len);
+    }
+
 protected:
     /*!
      * Read up to len bytes of data from input stream into an array
@@ -250,6 +285,9 @@ protected:
      *
      */
     virtual sys::SSize_T readImpl(void* buffer, size_t len) override;
+
+private:
+    sys::SSize_T readImpl(void* buffer, size_t len, size_t elemSize);
 };
 }
 
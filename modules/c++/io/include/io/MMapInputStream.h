@@ -1,7 +1,7 @@
 /* =========================================================================
- * This file is part of io-c++ 
+ * This file is part of io-c++
  * =========================================================================
- * 
+ *
  * (C) Copyright 2004 - 2014, MDA Information Systems LLC
  *
  * io-c++ is free software; you can redistribute it and/or modify
@@ -14,8 +14,8 @@
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU Lesser General Public License for more details.
  *
- * You should have received a copy of the GNU Lesser General Public 
- * License along with this program; If not, 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
  * see <http://www.gnu.org/licenses/>.
  *
  */
@@ -23,67 +23,176 @@
 #ifndef __IO_MMAP_INPUT_STREAM_H__
 #define __IO_MMAP_INPUT_STREAM_H__
 
-#include <cstdio>
-#include "sys/OS.h"
+#include <string>
+
+#include "config/Exports.h"
+#include "coda_oss/span.h"
+#include "sys/Conf.h"
+#include "sys/File.h"
+#include "sys/filesystem.h"
 #include "io/SeekableStreams.h"
 
+/*!
+ *  \file MMapInputStream.h
+ *  \brief A read-only InputStream over a memory-mapped file
+ */
 
 namespace io
 {
-
-class MMapInputStream : public SeekableInputStream
+/*!
+ *  \class MMapInputStream
+ *  \brief An InputStream that maps the whole file into memory
+ *
+ *  read() copies out of the mapping like any other stream, but view()
+ *  hands back a pointer into the mapping itself, so large files can be
+ *  processed in place without any copy.  Views are valid until close().
+ *
+ *  \code
+    io::MMapInputStream mmap(path, io::MMapInputStream::POPULATE);
+    mmap.advise(io::MMapInputStream::SEQUENTIAL);
+    const auto pixels = mmap.view(headerLength, numBytes);
+    \endcode
+ */
+class CODA_OSS_API MMapInputStream : public SeekableInputStream
 {
 public:
-    MMapInputStream() : mFile(nullptr), mLength(0), mData(nullptr), mMark(0)
-    {}
-    MMapInputStream(const std::string& inputFile,
-                    char* flags = "r+b") :
-            mFile(nullptr), mLength(0), mData(nullptr), mMark(0)
+    //! Flags for open(); these are hints and are ignored where unsupported
+    enum
     {
-        open(inputFile, flags);
-
+        //! Ask for transparent huge pages to back the mapping
+        HUGE_PAGES = 1,
+        //! Fault the whole file in up front (MAP_POPULATE)
+        POPULATE = 2
+    };
+
+    //! Expected access pattern, see advise()
+    enum Advice
+    {
+        NORMAL = 0,
+        SEQUENTIAL,
+        RANDOM,
+        WILL_NEED
+    };
+
+    MMapInputStream() = default;
+
+    /*!
+     *  Open and map inputFile
+     *  \param inputFile The file name
+     *  \param mapFlags Bitwise OR of HUGE_PAGES and POPULATE
+     */
+    MMapInputStream(const std::string& inputFile, int mapFlags = 0)
+    {
+        open(inputFile, mapFlags);
     }
+    MMapInputStream(const char* inputFile, int mapFlags = 0) :
+        MMapInputStream(std::string(inputFile), mapFlags) { }
+    explicit MMapInputStream(const coda_oss::filesystem::path& inputFile,
+                             int mapFlags = 0) :
+        MMapInputStream(inputFile.string(), mapFlags) { }
+
+    MMapInputStream(const MMapInputStream&) = delete;
+    MMapInputStream& operator=(const MMapInputStream&) = delete;
 
     virtual ~MMapInputStream()
     {
-        if (mFile)
-        {
-            close();
-        }
+        close();
     }
 
-    virtual void open(const std::string& fname, char* flags);
+    /*!
+     *  Open and map inputFile.  Any previously open file is closed first.
+     *  \param inputFile The file name
+     *  \param mapFlags Bitwise OR of HUGE_PAGES and POPULATE
+     *  \throw sys::SystemException if the file can't be opened or mapped
+     */
+    void open(const std::string& inputFile, int mapFlags = 0);
 
-    virtual void close();
+    //! Unmap and close the file.  Invalidates all views.
+    void close();
 
-    sys::Handle_T getHandle();
+    //! \return True if a file is open
+    bool isOpen() const noexcept
+    {
+        return mFile.isOpen();
+    }
+
+    //! \return The size of the file, in bytes
+    sys::Off_T getLength() const noexcept
+    {
+        return static_cast<sys::Off_T>(mLength);
+    }
 
-    virtual off_t available()
+    virtual sys::Off_T available() override
     {
-        return (mLength - mMark);
+        return getLength() - mMark;
     }
 
-    virtual off_t seek(off_t off);
+    /*!
+     *  Go to the offset at the location specified.  Seeking past the end
+     *  of the file is an error.
+     *  \return The new position
+     */
+    virtual sys::Off_T seek(sys::Off_T off, Whence whence) override;
 
-    virtual off_t tell()
+    virtual sys::Off_T tell() override
     {
         return mMark;
     }
 
-protected:
-    virtual sys::SSize_T readImpl(void* buffer, size_t len);
-
-    virtual void _map();
-    virtual void _unmap();
-    sys::OS mOs;
+    /*!
+     *  Borrow len bytes of the mapping starting at offset.  This doesn't
+     *  copy, and doesn't move the stream position.
+     *
+     *  \throw except::IndexOutOfRangeException if the range is not within
+     *         the file
+     */
+    coda_oss::span<const sys::byte> view(sys::Off_T offset, size_t len) const;
+
+    //! \return The whole mapping
+    coda_oss::span<const sys::byte> view() const noexcept
+    {
+        return coda_oss::span<const sys::byte>(mData, mLength);
+    }
 
-    FILE* mFile;
-    size_t mLength;
-    sys::byte* mData;
-    size_t mMark;
+    /*!
+     *  Tell the OS how a range of the file is going to be accessed
+     *  (madvise()).  The range is widened to whole pages.  This is only a
+     *  hint; failure is ignored.
+     *
+     *  \param advice The access pattern
+     *  \param offset Start of the range
+     *  \param len Length of the range; 0 means through the end of the file
+     */
+    void advise(Advice advice, sys::Off_T offset = 0, size_t len = 0);
+
+    /*!
+     *  Read len bytes and byte swap them as elements of elemSize bytes.
+     *  The data is swapped straight out of the mapping into buffer, so this
+     *  is a single pass.  See FileInputStreamOS::readAndByteSwap().
+     *
+     *  \throw except::IOException
+     *  \return The number of bytes read
+     */
+    sys::SSize_T readAndByteSwap(void* buffer,
+                                 size_t len,
+                                 size_t elemSize,
+                                 bool verifyFullRead = false);
 
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len) override;
+
+private:
+    void map(int mapFlags);
+    void unmap() noexcept;
+
+    sys::File mFile;
+    size_t mLength = 0;
+    const sys::byte* mData = nullptr;
+    sys::Off_T mMark = 0;
+#if defined(_WIN32)
+    HANDLE mMapping = nullptr;
+#endif
 };
-
 }
 
 #endif
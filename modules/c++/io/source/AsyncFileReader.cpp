@@ -0,0 +1,635 @@
+/* =========================================================================
+ * This file is part of io-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * io-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "io/AsyncFileReader.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "except/Exception.h"
+#include "sys/File.h"
+
+// io_uring is used through the raw system calls so there's no dependency
+// on liburing
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define CODA_OSS_io_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+namespace io
+{
+namespace details
+{
+class AsyncReadEngine
+{
+public:
+    explicit AsyncReadEngine(const std::string& pathname) :
+        mFile(pathname, sys::File::READ_ONLY, sys::File::EXISTING),
+        mFileLength(mFile.length())
+    {
+    }
+
+    virtual ~AsyncReadEngine() = default;
+
+    AsyncReadEngine(const AsyncReadEngine&) = delete;
+    AsyncReadEngine& operator=(const AsyncReadEngine&) = delete;
+
+    // The caller guarantees that fewer than queueDepth reads are in flight
+    virtual void queue(const AsyncFileReader::Request& request) = 0;
+
+    // Start everything queued since the last call
+    virtual void flush() = 0;
+
+    // Block until at least minCompletions reads finish; appends them all
+    virtual size_t reap(std::vector<AsyncFileReader::Completion>& completions,
+                        size_t minCompletions) = 0;
+
+protected:
+    sys::File mFile;
+    const sys::Off_T mFileLength;
+};
+
+namespace
+{
+class ThreadPoolEngine final : public AsyncReadEngine
+{
+public:
+    ThreadPoolEngine(const std::string& pathname, size_t numThreads) :
+        AsyncReadEngine(pathname)
+    {
+        numThreads = std::max<size_t>(numThreads, 1);
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            mThreads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~ThreadPoolEngine()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWorkReady.notify_all();
+        for (auto& thread : mThreads)
+        {
+            thread.join();
+        }
+    }
+
+    void queue(const AsyncFileReader::Request& request) override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueue.push_back(request);
+        }
+        mWorkReady.notify_one();
+    }
+
+    void flush() override
+    {
+    }
+
+    size_t reap(std::vector<AsyncFileReader::Completion>& completions,
+                size_t minCompletions) override
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDoneReady.wait(lock,
+                        [&]() { return mDone.size() >= minCompletions; });
+        const size_t numDone = mDone.size();
+        completions.insert(completions.end(), mDone.begin(), mDone.end());
+        mDone.clear();
+        return numDone;
+    }
+
+private:
+    void workerLoop()
+    {
+        while (true)
+        {
+            AsyncFileReader::Request request;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWorkReady.wait(lock,
+                                [&]() { return mStop || !mQueue.empty(); });
+                if (mQueue.empty())
+                {
+                    return;
+                }
+                request = mQueue.front();
+                mQueue.pop_front();
+            }
+
+            AsyncFileReader::Completion completion;
+            completion.tag = request.tag;
+
+            // Short reads only happen at the end of the file, which we know
+            // the position of; this keeps readAtInto() from throwing there
+            size_t length = 0;
+            if (request.offset < mFileLength)
+            {
+                length = static_cast<size_t>(std::min<sys::Off_T>(
+                        request.length, mFileLength - request.offset));
+            }
+            try
+            {
+                mFile.readAtInto(request.offset, request.buffer, length);
+                completion.bytesRead = length;
+            }
+            catch (...)
+            {
+                completion.error = EIO;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mDone.push_back(completion);
+            }
+            mDoneReady.notify_one();
+        }
+    }
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWorkReady;
+    std::condition_variable mDoneReady;
+    std::deque<AsyncFileReader::Request> mQueue;
+    std::vector<AsyncFileReader::Completion> mDone;
+    bool mStop = false;
+};
+
+#if defined(CODA_OSS_io_HAVE_IO_URING)
+int ioUringSetup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                 unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit,
+                                      minComplete, flags, nullptr, 0));
+}
+
+class IoUringEngine final : public AsyncReadEngine
+{
+public:
+    IoUringEngine(const std::string& pathname, size_t queueDepth) :
+        AsyncReadEngine(pathname),
+        mSlots(std::max<size_t>(queueDepth, 1))
+    {
+        io_uring_params params;
+        ::memset(&params, 0, sizeof(params));
+        mRingFd = ioUringSetup(static_cast<unsigned>(mSlots.size()), &params);
+        if (mRingFd < 0)
+        {
+            throw except::NotImplementedException(
+                    Ctxt("io_uring is not available"));
+        }
+
+        mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        mCqRingSize = params.cq_off.cqes +
+                params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = false;
+#if defined(IORING_FEAT_SINGLE_MMAP)
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            singleMmap = true;
+            mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+        }
+#endif
+
+        mSqRing = mapRing(mSqRingSize, IORING_OFF_SQ_RING);
+        mCqRing = singleMmap ? mSqRing : mapRing(mCqRingSize, IORING_OFF_CQ_RING);
+        mSqes = static_cast<io_uring_sqe*>(
+                mapRing(params.sq_entries * sizeof(io_uring_sqe),
+                        IORING_OFF_SQES));
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        if (!mSqRing || !mCqRing || !mSqes)
+        {
+            cleanUp();
+            throw except::NotImplementedException(
+                    Ctxt("Failed to map io_uring queues"));
+        }
+
+        sys::ubyte* const sq = static_cast<sys::ubyte*>(mSqRing);
+        mSqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        mSqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        sys::ubyte* const cq = static_cast<sys::ubyte*>(mCqRing);
+        mCqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        mCqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        mFreeSlots.reserve(mSlots.size());
+        for (size_t ii = mSlots.size(); ii > 0; --ii)
+        {
+            mFreeSlots.push_back(ii - 1);
+        }
+    }
+
+    ~IoUringEngine()
+    {
+        cleanUp();
+    }
+
+    void queue(const AsyncFileReader::Request& request) override
+    {
+        const size_t slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+        mSlots[slot].request = request;
+        mSlots[slot].bytesRead = 0;
+        prepare(slot);
+    }
+
+    void flush() override
+    {
+        while (mToSubmit > 0)
+        {
+            const int submitted = ioUringEnter(mRingFd, mToSubmit, 0, 0);
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                {
+                    continue;
+                }
+                throw except::IOException(Ctxt(
+                        std::string("io_uring_enter failed: ") +
+                        ::strerror(errno)));
+            }
+            mToSubmit -= static_cast<unsigned>(submitted);
+        }
+    }
+
+    size_t reap(std::vector<AsyncFileReader::Completion>& completions,
+                size_t minCompletions) override
+    {
+        size_t numDone = 0;
+        while (true)
+        {
+            unsigned head = *mCqHead;
+            const unsigned tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = mCqes[head & mCqMask];
+                numDone += complete(static_cast<size_t>(cqe.user_data),
+                                    cqe.res, completions);
+            }
+            __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+
+            // Partial reads may have queued their remainders
+            flush();
+            if (numDone >= minCompletions)
+            {
+                return numDone;
+            }
+
+            const int result = ioUringEnter(mRingFd, 0, 1,
+                                            IORING_ENTER_GETEVENTS);
+            if (result < 0 && errno != EINTR && errno != EAGAIN)
+            {
+                throw except::IOException(Ctxt(
+                        std::string("io_uring_enter failed: ") +
+                        ::strerror(errno)));
+            }
+        }
+    }
+
+private:
+    struct Slot final
+    {
+        AsyncFileReader::Request request;
+        size_t bytesRead = 0;
+        iovec iov;
+    };
+
+    void* mapRing(size_t size, off_t offset)
+    {
+        void* const ring = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, mRingFd, offset);
+        return ring == MAP_FAILED ? nullptr : ring;
+    }
+
+    void cleanUp() noexcept
+    {
+        if (mSqes)
+        {
+            ::munmap(mSqes, mSqesSize);
+        }
+        if (mCqRing && mCqRing != mSqRing)
+        {
+            ::munmap(mCqRing, mCqRingSize);
+        }
+        if (mSqRing)
+        {
+            ::munmap(mSqRing, mSqRingSize);
+        }
+        if (mRingFd >= 0)
+        {
+            ::close(mRingFd);
+        }
+        mSqes = nullptr;
+        mSqRing = mCqRing = nullptr;
+        mRingFd = -1;
+    }
+
+    // Add an SQE reading whatever's left of slot's request
+    void prepare(size_t slot)
+    {
+        Slot& s = mSlots[slot];
+        s.iov.iov_base = static_cast<sys::byte*>(s.request.buffer) + s.bytesRead;
+        s.iov.iov_len = s.request.length - s.bytesRead;
+
+        const unsigned tail = *mSqTail;
+        const unsigned index = tail & mSqMask;
+        io_uring_sqe& sqe = mSqes[index];
+        ::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = mFile.getHandle();
+        sqe.off = static_cast<__u64>(s.request.offset + s.bytesRead);
+        sqe.addr = reinterpret_cast<__u64>(&s.iov);
+        sqe.len = 1;
+        sqe.user_data = slot;
+        mSqArray[index] = index;
+        __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+        ++mToSubmit;
+    }
+
+    // Handle one CQE; returns the number of completions appended (0 or 1)
+    size_t complete(size_t slot,
+                    int result,
+                    std::vector<AsyncFileReader::Completion>& completions)
+    {
+        Slot& s = mSlots[slot];
+        if (result == -EINTR || result == -EAGAIN)
+        {
+            prepare(slot);
+            return 0;
+        }
+        if (result > 0)
+        {
+            s.bytesRead += static_cast<size_t>(result);
+            if (s.bytesRead < s.request.length)
+            {
+                prepare(slot);
+                return 0;
+            }
+        }
+
+        AsyncFileReader::Completion completion;
+        completion.tag = s.request.tag;
+        completion.bytesRead = s.bytesRead;
+        completion.error = result < 0 ? -result : 0;
+        completions.push_back(completion);
+        mFreeSlots.push_back(slot);
+        return 1;
+    }
+
+    std::vector<Slot> mSlots;
+    std::vector<size_t> mFreeSlots;
+    int mRingFd = -1;
+    unsigned mToSubmit = 0;
+
+    void* mSqRing = nullptr;
+    void* mCqRing = nullptr;
+    io_uring_sqe* mSqes = nullptr;
+    size_t mSqRingSize = 0;
+    size_t mCqRingSize = 0;
+    size_t mSqesSize = 0;
+
+    unsigned* mSqTail = nullptr;
+    unsigned mSqMask = 0;
+    unsigned* mSqArray = nullptr;
+    unsigned* mCqHead = nullptr;
+    unsigned* mCqTail = nullptr;
+    unsigned mCqMask = 0;
+    io_uring_cqe* mCqes = nullptr;
+};
+#endif
+}
+}
+
+AsyncFileReader::AsyncFileReader(const std::string& pathname,
+                                 Backend backend,
+                                 size_t queueDepth,
+                                 size_t numThreads) :
+    mBackend(backend),
+    mQueueDepth(std::max<size_t>(queueDepth, 1))
+{
+    if (mBackend == AUTO)
+    {
+        mBackend = isIoUringAvailable() ? IO_URING : THREAD_POOL;
+    }
+
+    if (mBackend == IO_URING)
+    {
+#if defined(CODA_OSS_io_HAVE_IO_URING)
+        mEngine.reset(new details::IoUringEngine(pathname, mQueueDepth));
+#else
+        throw except::NotImplementedException(
+                Ctxt("io_uring is not available on this platform"));
+#endif
+    }
+    else
+    {
+        mEngine.reset(new details::ThreadPoolEngine(pathname, numThreads));
+    }
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    // The buffers belong to the caller; don't leave the kernel or the I/O
+    // threads writing into them
+    try
+    {
+        std::vector<Completion> completions;
+        while (mNumInFlight > 0)
+        {
+            mNumInFlight -= mEngine->reap(completions, mNumInFlight);
+        }
+    }
+    catch (...)
+    {
+    }
+}
+
+void AsyncFileReader::queue(const Request& request)
+{
+    if (mNumInFlight == mQueueDepth)
+    {
+        mEngine->flush();
+        mNumInFlight -= mEngine->reap(mReady, 1);
+    }
+    mEngine->queue(request);
+    ++mNumInFlight;
+}
+
+void AsyncFileReader::submit(const Request& request)
+{
+    queue(request);
+    mEngine->flush();
+}
+
+void AsyncFileReader::submit(const std::vector<Request>& requests)
+{
+    for (const auto& request : requests)
+    {
+        queue(request);
+    }
+    mEngine->flush();
+}
+
+size_t AsyncFileReader::wait(std::vector<Completion>& completions,
+                             size_t minCompletions)
+{
+    minCompletions = std::min(minCompletions, getNumPending());
+
+    size_t numAppended = mReady.size();
+    completions.insert(completions.end(), mReady.begin(), mReady.end());
+    mReady.clear();
+
+    if (numAppended < minCompletions)
+    {
+        const size_t numReaped =
+                mEngine->reap(completions, minCompletions - numAppended);
+        mNumInFlight -= numReaped;
+        numAppended += numReaped;
+    }
+    return numAppended;
+}
+
+bool AsyncFileReader::isIoUringAvailable()
+{
+#if defined(CODA_OSS_io_HAVE_IO_URING)
+    // Kernels can be too old, and containers often block the syscalls
+    static const bool available = []() {
+        io_uring_params params;
+        ::memset(&params, 0, sizeof(params));
+        const int fd = details::ioUringSetup(1, &params);
+        if (fd < 0)
+        {
+            return false;
+        }
+        ::close(fd);
+        return true;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+ReadAheadQueue::ReadAheadQueue(
+        AsyncFileReader& reader,
+        const std::vector<AsyncFileReader::Request>& requests,
+        size_t readAhead) :
+    mReader(reader),
+    mRequests(requests),
+    mReadAhead(readAhead == 0 ? reader.getQueueDepth() : readAhead)
+{
+    for (size_t ii = 0; ii < mRequests.size(); ++ii)
+    {
+        mRequests[ii].tag = ii;
+    }
+    fill();
+}
+
+ReadAheadQueue::~ReadAheadQueue()
+{
+    try
+    {
+        std::vector<AsyncFileReader::Completion> completions;
+        while (mReader.getNumPending() > 0)
+        {
+            mReader.wait(completions, mReader.getNumPending());
+        }
+    }
+    catch (...)
+    {
+    }
+}
+
+void ReadAheadQueue::fill()
+{
+    const size_t end = std::min(mRequests.size(), mNextToReturn + mReadAhead);
+    if (mNextToSubmit >= end)
+    {
+        return;
+    }
+    const std::vector<AsyncFileReader::Request> batch(
+            mRequests.begin() + mNextToSubmit, mRequests.begin() + end);
+    mReader.submit(batch);
+    mNextToSubmit = end;
+}
+
+AsyncFileReader::Completion ReadAheadQueue::next()
+{
+    if (isDone())
+    {
+        throw except::Exception(Ctxt("No more requests to read"));
+    }
+
+    auto iter = mFinished.find(mNextToReturn);
+    while (iter == mFinished.end())
+    {
+        mCompletions.clear();
+        mReader.wait(mCompletions);
+        for (const auto& completion : mCompletions)
+        {
+            mFinished[completion.tag] = completion;
+        }
+        iter = mFinished.find(mNextToReturn);
+    }
+
+    const AsyncFileReader::Completion completion = iter->second;
+    mFinished.erase(iter);
+    ++mNextToReturn;
+    fill();
+
+    if (completion.error != 0)
+    {
+        const AsyncFileReader::Request& request = mRequests[completion.tag];
+        std::ostringstream ostr;
+        ostr << "Failed to read " << request.length << " bytes at offset "
+             << request.offset << ": " << ::strerror(completion.error);
+        throw except::IOException(Ctxt(ostr));
+    }
+    return completion;
+}
+}
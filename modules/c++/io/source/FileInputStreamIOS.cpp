@@ -24,6 +24,8 @@
 
 #if defined(USE_IO_STREAMS)
 
+#include "sys/ByteSwap.h"
+
 io::FileInputStreamIOS::FileInputStreamIOS(const char* inputFile,
                                      std::ios::openmode mode)
 {
@@ -123,4 +125,42 @@ sys::SSize_T io::FileInputStreamIOS::readImpl(void* buffer, size_t len)
     return 0;
 }
 
+sys::SSize_T io::FileInputStreamIOS::readAndByteSwap(void* buffer,
+                                                    size_t len,
+                                                    size_t elemSize,
+                                                    bool verifyFullRead)
+{
+    const sys::SSize_T numBytes = read(buffer, len, verifyFullRead);
+    if (numBytes > 0 && elemSize > 1)
+    {
+        sys::byteSwap(buffer, elemSize, numBytes / elemSize);
+    }
+    return numBytes;
+}
+
+void io::FileInputStreamIOS::readAt(sys::Off_T offset, void* buffer, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mReadAtMutex);
+    mFStream.clear();
+    const sys::Off_T position = tell();
+    seek(offset, START);
+    try
+    {
+        read(buffer, len, true);
+    }
+    catch (...)
+    {
+        mFStream.clear();
+        seek(position, START);
+        throw;
+    }
+    mFStream.clear();
+    seek(position, START);
+}
+
 #endif
@@ -22,21 +22,56 @@
 
 #include "io/FileInputStreamOS.h"
 
+#include <algorithm>
+#include <sstream>
+
+#include "sys/ByteSwap.h"
 #include "mt/ThreadGroup.h"
 #include "mt/ThreadPlanner.h"
+#include "mt/WorkStealingExecutor.h"
 
 #if !defined(USE_IO_STREAMS)
 
 namespace
 {
+// When byte swapping, reads are broken into pieces of (about) this many bytes
+// so that each piece is still in cache when it is swapped.
+constexpr size_t swapBlockSize = 256 * 1024;
+
+void readAtInto(sys::File& file,
+                size_t offset,
+                size_t len,
+                void* buffer,
+                size_t elemSize)
+{
+    if (elemSize <= 1)
+    {
+        file.readAtInto(offset, buffer, len);
+        return;
+    }
+
+    // Callers guarantee len is a multiple of elemSize
+    const size_t blockSize =
+            std::max(swapBlockSize / elemSize, static_cast<size_t>(1)) * elemSize;
+    sys::byte* const bufferPtr = static_cast<sys::byte*>(buffer);
+    for (size_t done = 0; done < len; done += blockSize)
+    {
+        const size_t thisLen = std::min(blockSize, len - done);
+        file.readAtInto(offset + done, bufferPtr + done, thisLen);
+        sys::byteSwap(bufferPtr + done, elemSize, thisLen / elemSize);
+    }
+}
+
 class ChunkReadRunnable : public sys::Runnable
 {
 public:
     ChunkReadRunnable(sys::File& file,
                       size_t offset,
                       size_t len,
-                      void* buffer) :
-        mFile(file), mOffset(offset), mLen(len), mBuffer(buffer)
+                      void* buffer,
+                      size_t elemSize) :
+        mFile(file), mOffset(offset), mLen(len), mBuffer(buffer),
+        mElemSize(elemSize)
     {
     }
 
@@ -45,7 +80,7 @@ public:
         // No need to clear buffer because the readInto call will write every
         // byte
         //::memset(mBuffer, 0, mLen);
-        mFile.readAtInto(mOffset, mBuffer, mLen);
+        readAtInto(mFile, mOffset, mLen, mBuffer, mElemSize);
     }
 
 private:
@@ -53,6 +88,7 @@ private:
     size_t mOffset;
     size_t mLen;
     void* mBuffer;
+    size_t mElemSize;
 };
 }
 
@@ -75,7 +111,39 @@ sys::Off_T io::FileInputStreamOS::available()
 }
 
 
+sys::SSize_T io::FileInputStreamOS::readAndByteSwap(void* buffer,
+                                                   size_t len,
+                                                   size_t elemSize,
+                                                   bool verifyFullRead)
+{
+    if (elemSize > 1 && len % elemSize != 0)
+    {
+        std::ostringstream ostr;
+        ostr << "Read length " << len
+             << " is not a multiple of the element size " << elemSize;
+        throw except::InvalidArgumentException(Ctxt(ostr));
+    }
+
+    const sys::SSize_T numBytes = readImpl(buffer, len, elemSize);
+    if (verifyFullRead && numBytes != static_cast<sys::SSize_T>(len))
+    {
+        std::ostringstream ostr;
+        ostr << "Tried to read " << len << " bytes but only read "
+             << (numBytes == io::InputStream::IS_EOF ? 0 : numBytes)
+             << " bytes";
+        throw except::IOException(Ctxt(ostr));
+    }
+    return numBytes;
+}
+
 sys::SSize_T io::FileInputStreamOS::readImpl(void* buffer, size_t len)
+{
+    return readImpl(buffer, len, 1);
+}
+
+sys::SSize_T io::FileInputStreamOS::readImpl(void* buffer,
+                                             size_t len,
+                                             size_t elemSize)
 {
     sys::Off_T avail = available();
     sys::byte* bufferPtr = static_cast<sys::byte*>(buffer);
@@ -93,38 +161,68 @@ sys::SSize_T io::FileInputStreamOS::readImpl(void* buffer, size_t len)
         len = static_cast<sys::Size_T>(avail);
     }
 
+    // Only whole elements get swapped; a trailing partial element (from a
+    // short read) is left as-is.
+    const size_t swapLen = elemSize > 1 ? len - len % elemSize : 0;
+    if (elemSize > 1 && swapLen == 0)
+    {
+        elemSize = 1;
+    }
+
     if (mMaxReadThreads <= 1 ||
         len <= mParallelChunkSize * mMinChunksForThreading)
     {
-        // No need to clear buffer because the readInto call will write every
-        // byte
-        //::memset(buffer, 0, len);
-        mFile.readInto(buffer, len);
+        if (elemSize <= 1)
+        {
+            // No need to clear buffer because the readInto call will write
+            // every byte
+            //::memset(buffer, 0, len);
+            mFile.readInto(buffer, len);
+        }
+        else
+        {
+            const size_t baseLocation = tell();
+            readAtInto(mFile, baseLocation, swapLen, buffer, elemSize);
+            seek(baseLocation + swapLen, START);
+            mFile.readInto(bufferPtr + swapLen, len - swapLen);
+        }
         return static_cast<sys::SSize_T>(len);
     }
 
     size_t baseLocation = tell();
 
-    size_t chunks = len / mParallelChunkSize;
+    // Every chunk has to hold whole elements for the threads to swap them
+    const size_t chunkSize = elemSize > 1 ?
+            std::max(mParallelChunkSize / elemSize, static_cast<size_t>(1)) * elemSize :
+            mParallelChunkSize;
+    size_t chunks = (elemSize > 1 ? swapLen : len) / chunkSize;
     const mt::ThreadPlanner planner(chunks, mMaxReadThreads);
-    mt::ThreadGroup threadGroup;
+    mt::ThreadGroup threadGroup(mt::WorkStealingExecutor::getInstance());
 
     size_t threadNum(0);
     size_t threadOffset;
     size_t threadNumChunks;
     while (planner.getThreadInfo(threadNum++, threadOffset, threadNumChunks))
     {
-        size_t bufferOffset = threadOffset * mParallelChunkSize;
+        size_t bufferOffset = threadOffset * chunkSize;
         threadGroup.createThread(
                 new ChunkReadRunnable(mFile,
                                       baseLocation + bufferOffset,
-                                      threadNumChunks * mParallelChunkSize,
-                                      bufferPtr + bufferOffset));
+                                      threadNumChunks * chunkSize,
+                                      bufferPtr + bufferOffset,
+                                      elemSize));
     }
 
     threadGroup.joinAll();
 
-    size_t threadedRead = chunks * mParallelChunkSize;
+    size_t threadedRead = chunks * chunkSize;
+    if (elemSize > 1)
+    {
+        // Whatever whole elements are left over after the chunks
+        readAtInto(mFile, baseLocation + threadedRead, swapLen - threadedRead,
+                   bufferPtr + threadedRead, elemSize);
+        threadedRead = swapLen;
+    }
     seek(baseLocation + threadedRead, START);
     mFile.readInto(bufferPtr + threadedRead, len - threadedRead);
     return static_cast<sys::SSize_T>(len);
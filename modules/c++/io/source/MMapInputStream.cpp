@@ -1,7 +1,7 @@
 /* =========================================================================
- * This file is part of io-c++ 
+ * This file is part of io-c++
  * =========================================================================
- * 
+ *
  * (C) Copyright 2004 - 2014, MDA Information Systems LLC
  *
  * io-c++ is free software; you can redistribute it and/or modify
@@ -14,73 +14,304 @@
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU Lesser General Public License for more details.
  *
- * You should have received a copy of the GNU Lesser General Public 
- * License along with this program; If not, 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
  * see <http://www.gnu.org/licenses/>.
  *
  */
 
 #include "io/MMapInputStream.h"
 
-void io::MMapInputStream::open(const std::string& fname, char* flags)
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include "except/Exception.h"
+#include "sys/ByteSwap.h"
+#include "sys/SystemException.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+void io::MMapInputStream::open(const std::string& inputFile, int mapFlags)
 {
-    mLength = mOs.getSize(fname);
-    //    std::cout << mLength << std::endl;
-    mFile = fopen(fname.c_str(), "r");
-    if (!mFile)
-        throw sys::SystemException(str::Format("Failure while opening file: %s", fname));
+    close();
 
-    _map();
+    mFile.create(inputFile, sys::File::READ_ONLY, sys::File::EXISTING);
 
+    const sys::Off_T length = mFile.length();
+    if (static_cast<sys::Size_T>(length) >
+        std::numeric_limits<size_t>::max())
+    {
+        mFile.close();
+        throw sys::SystemException(Ctxt(
+                "File is too large to map into memory: " + inputFile));
+    }
+    mLength = static_cast<size_t>(length);
+
+    try
+    {
+        map(mapFlags);
+    }
+    catch (...)
+    {
+        mFile.close();
+        mLength = 0;
+        throw;
+    }
 }
 
 void io::MMapInputStream::close()
 {
-    _unmap();
-    fclose(mFile);
-    mFile = nullptr;
+    unmap();
+    if (mFile.isOpen())
+    {
+        mFile.close();
+    }
+    mLength = 0;
+    mMark = 0;
 }
 
-void io::MMapInputStream::_map()
+sys::Off_T io::MMapInputStream::seek(sys::Off_T off, Whence whence)
 {
-    sys::Handle_T handle = getHandle();
-    mData = (sys::byte*)mOs.mapFile(handle, mLength, PROT_READ, MAP_SHARED, 0);
+    sys::Off_T where = off;
+    switch (whence)
+    {
+    case END:
+        where += getLength();
+        break;
+
+    case CURRENT:
+        where += mMark;
+        break;
+
+    case START:
+    default:
+        break;
+    }
+
+    if (where < 0 || where > getLength())
+    {
+        std::ostringstream ostr;
+        ostr << "Tried to seek to " << where << " in a file of "
+             << getLength() << " bytes";
+        throw except::IOException(Ctxt(ostr));
+    }
+    mMark = where;
+    return mMark;
 }
-void io::MMapInputStream::_unmap()
+
+coda_oss::span<const sys::byte> io::MMapInputStream::view(sys::Off_T offset,
+                                                          size_t len) const
 {
-    //     std::cout << "Unmapping file... ";
-    mOs.unmapFile(mData, mLength);
-    mData = nullptr;
-    //    std::cout << "done!" << std::endl;
+    if (offset < 0 || offset > getLength() ||
+        len > static_cast<size_t>(getLength() - offset))
+    {
+        std::ostringstream ostr;
+        ostr << "Tried to view " << len << " bytes at offset " << offset
+             << " in a file of " << getLength() << " bytes";
+        throw except::IndexOutOfRangeException(Ctxt(ostr));
+    }
+    return coda_oss::span<const sys::byte>(mData + offset, len);
 }
 
-sys::Handle_T io::MMapInputStream::getHandle()
+sys::SSize_T io::MMapInputStream::readImpl(void* buffer, size_t len)
 {
-    if (!mFile) throw except::NullPointerReference(Ctxt("Uninitialized memory mapped file stream!"));
-    return ::fileno(mFile);
+    const sys::Off_T avail = available();
+    if (avail <= 0)
+    {
+        // Match FileInputStreamOS
+        ::memset(buffer, 0, len);
+        return io::InputStream::IS_EOF;
+    }
+    if (len > static_cast<sys::Size_T>(avail))
+    {
+        ::memset(static_cast<sys::byte*>(buffer) + avail, 0, len - avail);
+        len = static_cast<size_t>(avail);
+    }
+
+    ::memcpy(buffer, mData + mMark, len);
+    mMark += len;
+    return static_cast<sys::SSize_T>(len);
 }
 
+sys::SSize_T io::MMapInputStream::readAndByteSwap(void* buffer,
+                                                  size_t len,
+                                                  size_t elemSize,
+                                                  bool verifyFullRead)
+{
+    if (elemSize > 1 && len % elemSize != 0)
+    {
+        std::ostringstream ostr;
+        ostr << "Read length " << len
+             << " is not a multiple of the element size " << elemSize;
+        throw except::InvalidArgumentException(Ctxt(ostr));
+    }
 
+    const sys::Off_T avail = available();
+    size_t numBytes = len;
+    if (len > static_cast<sys::Size_T>(std::max<sys::Off_T>(avail, 0)))
+    {
+        numBytes = static_cast<size_t>(std::max<sys::Off_T>(avail, 0));
+        if (verifyFullRead)
+        {
+            std::ostringstream ostr;
+            ostr << "Tried to read " << len << " bytes but only read "
+                 << numBytes << " bytes";
+            throw except::IOException(Ctxt(ostr));
+        }
+        ::memset(static_cast<sys::byte*>(buffer) + numBytes, 0,
+                 len - numBytes);
+    }
+    if (numBytes == 0)
+    {
+        return io::InputStream::IS_EOF;
+    }
 
-long io::MMapInputStream::seek(long off)
+    // Only whole elements get swapped; a trailing partial element (from a
+    // short read) is copied as-is.
+    const sys::byte* const src = mData + mMark;
+    sys::byte* const dest = static_cast<sys::byte*>(buffer);
+    const size_t swapLen =
+            elemSize > 1 ? numBytes - numBytes % elemSize : 0;
+    if (swapLen > 0)
+    {
+        sys::byteSwap(src, elemSize, swapLen / elemSize, dest);
+    }
+    ::memcpy(dest + swapLen, src + swapLen, numBytes - swapLen);
+
+    mMark += numBytes;
+    return static_cast<sys::SSize_T>(numBytes);
+}
+
+#if defined(_WIN32)
+
+void io::MMapInputStream::map(int)
 {
-    long where = mMark;
-    mMark = off;
-    return mMark - where;
+    // Windows can't map an empty file; there's nothing to view anyway
+    if (mLength == 0)
+    {
+        return;
+    }
+
+    mMapping = CreateFileMapping(mFile.getHandle(), nullptr, PAGE_READONLY,
+                                 0, 0, nullptr);
+    if (mMapping == nullptr)
+    {
+        throw sys::SystemException(Ctxt("Failed to create file mapping"));
+    }
+
+    mData = static_cast<const sys::byte*>(
+            MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData == nullptr)
+    {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+        throw sys::SystemException(Ctxt("Failed to map view of file"));
+    }
 }
 
+void io::MMapInputStream::unmap() noexcept
+{
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+        mData = nullptr;
+    }
+    if (mMapping)
+    {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+    }
+}
 
-sys::SSize_T io::MMapInputStream::readImpl(void* buffer, size_t len)
+void io::MMapInputStream::advise(Advice, sys::Off_T, size_t)
+{
+    // No madvise() equivalent worth using; the hints are just that
+}
+
+#else
+
+void io::MMapInputStream::map(int mapFlags)
+{
+    // mmap() rejects a zero length; there's nothing to view anyway
+    if (mLength == 0)
+    {
+        return;
+    }
+
+    int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (mapFlags & POPULATE)
+    {
+        flags |= MAP_POPULATE;
+    }
+#endif
+
+    void* const data =
+            ::mmap(nullptr, mLength, PROT_READ, flags, mFile.getHandle(), 0);
+    if (data == MAP_FAILED)
+    {
+        throw sys::SystemException(Ctxt("Failed to map file into memory"));
+    }
+    mData = static_cast<const sys::byte*>(data);
+
+#if defined(MADV_HUGEPAGE)
+    // Only takes effect on file mappings if the kernel supports
+    // read-only THP for files; it's harmless otherwise
+    if (mapFlags & HUGE_PAGES)
+    {
+        ::madvise(data, mLength, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+void io::MMapInputStream::unmap() noexcept
 {
-    int size = available();
-    //    std::cout << "Available: " << size << std::endl;
-    //     std::cout << "Len: " << len << std::endl;
-
-    if (len < size)
-        size = len;
-    memcpy(buffer, &mData[mMark], size);
-    mMark += size;
-    //    std::cout << "Used: " << size << std::endl;
-    return size;
+    if (mData)
+    {
+        ::munmap(const_cast<sys::byte*>(mData), mLength);
+        mData = nullptr;
+    }
+}
+
+void io::MMapInputStream::advise(Advice advice, sys::Off_T offset, size_t len)
+{
+    if (mData == nullptr || offset < 0 || offset >= getLength())
+    {
+        return;
+    }
+    if (len == 0 || len > static_cast<size_t>(getLength() - offset))
+    {
+        len = static_cast<size_t>(getLength() - offset);
+    }
+
+    // madvise() wants a page-aligned address
+    static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin = static_cast<size_t>(offset) / pageSize * pageSize;
+    len += static_cast<size_t>(offset) - begin;
+
+    int osAdvice = MADV_NORMAL;
+    switch (advice)
+    {
+    case SEQUENTIAL:
+        osAdvice = MADV_SEQUENTIAL;
+        break;
+    case RANDOM:
+        osAdvice = MADV_RANDOM;
+        break;
+    case WILL_NEED:
+        osAdvice = MADV_WILLNEED;
+        break;
+    case NORMAL:
+    default:
+        break;
+    }
+    ::madvise(const_cast<sys::byte*>(mData) + begin, len, osAdvice);
 }
 
+#endif
@@ -0,0 +1,188 @@
+/* =========================================================================
+ * This file is part of io-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * io-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TestCase.h>
+#include <io/AsyncFileReader.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+std::string thisExecutable;
+
+static std::vector<char> readReference()
+{
+    std::ifstream from(thisExecutable, std::ios::binary);
+    from.seekg(0, std::ios::end);
+    const size_t trueLen = from.tellg();
+    from.seekg(0);
+    std::vector<char> reference(trueLen);
+    from.read(&reference[0], trueLen);
+    return reference;
+}
+
+static std::vector<io::AsyncFileReader::Backend> getBackends()
+{
+    std::vector<io::AsyncFileReader::Backend> backends{
+            io::AsyncFileReader::THREAD_POOL};
+    if (io::AsyncFileReader::isIoUringAvailable())
+    {
+        backends.push_back(io::AsyncFileReader::IO_URING);
+    }
+    return backends;
+}
+
+TEST_CASE(testBatchRead)
+{
+    const std::vector<char> reference = readReference();
+    const size_t numRequests = 100;
+    const size_t requestSize = reference.size() / numRequests;
+
+    for (const auto backend : getBackends())
+    {
+        // Smaller queue than batch, so submit() has to wait for room
+        io::AsyncFileReader reader(thisExecutable, backend, 8, 3);
+        TEST_ASSERT_EQ(reader.getBackend(), backend);
+
+        // Backwards, so the requests aren't sequential
+        std::vector<char> buffer(reference.size());
+        std::vector<io::AsyncFileReader::Request> requests(numRequests);
+        for (size_t ii = 0; ii < numRequests; ++ii)
+        {
+            const size_t block = numRequests - 1 - ii;
+            requests[ii].offset = block * requestSize;
+            requests[ii].length = requestSize;
+            requests[ii].buffer = &buffer[block * requestSize];
+            requests[ii].tag = block;
+        }
+        reader.submit(requests);
+        TEST_ASSERT_EQ(reader.getNumPending(), numRequests);
+
+        std::vector<io::AsyncFileReader::Completion> completions;
+        while (reader.getNumPending() > 0)
+        {
+            reader.wait(completions);
+        }
+        TEST_ASSERT_EQ(completions.size(), numRequests);
+
+        std::vector<bool> seen(numRequests, false);
+        for (const auto& completion : completions)
+        {
+            TEST_ASSERT_EQ(completion.error, 0);
+            TEST_ASSERT_EQ(completion.bytesRead, requestSize);
+            seen[completion.tag] = true;
+        }
+        TEST_ASSERT_TRUE(std::find(seen.begin(), seen.end(), false) ==
+                         seen.end());
+
+        const size_t numRead = numRequests * requestSize;
+        TEST_ASSERT_TRUE(std::equal(buffer.begin(), buffer.begin() + numRead,
+                                    reference.begin()));
+    }
+}
+
+TEST_CASE(testEndOfFile)
+{
+    const std::vector<char> reference = readReference();
+    for (const auto backend : getBackends())
+    {
+        io::AsyncFileReader reader(thisExecutable, backend);
+
+        std::vector<char> buffer(100);
+        io::AsyncFileReader::Request request;
+        request.offset = reference.size() - 10;
+        request.length = buffer.size();
+        request.buffer = &buffer[0];
+        reader.submit(request);
+
+        request.offset = reference.size() + 10;
+        request.tag = 1;
+        reader.submit(request);
+
+        std::vector<io::AsyncFileReader::Completion> completions;
+        const size_t numWaited = reader.wait(completions, 2);
+        TEST_ASSERT_EQ(numWaited, static_cast<size_t>(2));
+        for (const auto& completion : completions)
+        {
+            TEST_ASSERT_EQ(completion.error, 0);
+            TEST_ASSERT_EQ(completion.bytesRead,
+                           completion.tag == 0 ? static_cast<size_t>(10)
+                                               : static_cast<size_t>(0));
+        }
+    }
+}
+
+TEST_CASE(testReadAhead)
+{
+    const std::vector<char> reference = readReference();
+    const size_t requestSize = 4096;
+    const size_t numRequests = reference.size() / requestSize;
+
+    for (const auto backend : getBackends())
+    {
+        io::AsyncFileReader reader(thisExecutable, backend, 4);
+
+        // Every other block, strided like reading a column of tiles
+        std::vector<std::vector<char> > buffers;
+        std::vector<io::AsyncFileReader::Request> requests;
+        for (size_t ii = 0; ii < numRequests; ii += 2)
+        {
+            buffers.emplace_back(requestSize);
+            io::AsyncFileReader::Request request;
+            request.offset = ii * requestSize;
+            request.length = requestSize;
+            request.buffer = &buffers.back()[0];
+            requests.push_back(request);
+        }
+
+        for (const size_t readAhead : {1, 3, 16})
+        {
+            io::ReadAheadQueue queue(reader, requests, readAhead);
+            size_t expectedTag = 0;
+            while (!queue.isDone())
+            {
+                const auto completion = queue.next();
+                TEST_ASSERT_EQ(completion.tag, expectedTag);
+                TEST_ASSERT_EQ(completion.bytesRead, requestSize);
+
+                const auto& request = requests[completion.tag];
+                const auto buffer =
+                        static_cast<const char*>(request.buffer);
+                TEST_ASSERT_TRUE(std::equal(buffer, buffer + requestSize,
+                        reference.begin() + request.offset));
+                ++expectedTag;
+            }
+            TEST_ASSERT_EQ(expectedTag, requests.size());
+            TEST_EXCEPTION(queue.next());
+        }
+    }
+}
+
+int main(int, char* argv[])
+{
+    thisExecutable = std::string(argv[0]);
+    TEST_CHECK(testBatchRead);
+    TEST_CHECK(testEndOfFile);
+    TEST_CHECK(testReadAhead);
+    return 0;
+}
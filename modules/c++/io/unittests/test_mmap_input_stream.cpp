@@ -0,0 +1,149 @@
+/* =========================================================================
+ * This file is part of io-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * io-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <TestCase.h>
+#include <io/MMapInputStream.h>
+#include <sys/ByteSwap.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+std::string thisExecutable;
+
+static std::vector<char> readReference()
+{
+    std::ifstream from(thisExecutable, std::ios::binary);
+    from.seekg(0, std::ios::end);
+    const size_t trueLen = from.tellg();
+    from.seekg(0);
+    std::vector<char> reference(trueLen);
+    from.read(&reference[0], trueLen);
+    return reference;
+}
+
+TEST_CASE(testMMapRead)
+{
+    const std::vector<char> reference = readReference();
+    const auto trueLen = static_cast<sys::Off_T>(reference.size());
+
+    io::MMapInputStream mmap(thisExecutable,
+                             io::MMapInputStream::POPULATE |
+                             io::MMapInputStream::HUGE_PAGES);
+    TEST_ASSERT_TRUE(mmap.isOpen());
+    TEST_ASSERT_EQ(mmap.getLength(), trueLen);
+    TEST_ASSERT_EQ(mmap.available(), trueLen);
+    mmap.advise(io::MMapInputStream::SEQUENTIAL);
+
+    std::vector<char> wholeRead(reference.size());
+    const auto wasRead = mmap.read(&wholeRead[0], wholeRead.size());
+    TEST_ASSERT_EQ(wasRead, static_cast<sys::SSize_T>(trueLen));
+    TEST_ASSERT_TRUE(reference == wholeRead);
+    TEST_ASSERT_EQ(mmap.available(), 0);
+
+    char next = 0;
+    const auto eofRead = mmap.read(&next, 1);
+    TEST_ASSERT_EQ(eofRead, io::InputStream::IS_EOF);
+
+    const auto fromEnd = mmap.seek(-10, io::Seekable::END);
+    TEST_ASSERT_EQ(fromEnd, trueLen - 10);
+    const auto fromCurrent = mmap.seek(4, io::Seekable::CURRENT);
+    TEST_ASSERT_EQ(fromCurrent, trueLen - 6);
+    mmap.read(&next, 1);
+    TEST_ASSERT_EQ(next, reference[reference.size() - 6]);
+    TEST_EXCEPTION(mmap.seek(trueLen + 1, io::Seekable::START));
+    TEST_EXCEPTION(mmap.seek(-1, io::Seekable::START));
+
+    mmap.close();
+    TEST_ASSERT_FALSE(mmap.isOpen());
+    TEST_ASSERT_EQ(mmap.getLength(), 0);
+}
+
+TEST_CASE(testMMapView)
+{
+    const std::vector<char> reference = readReference();
+
+    io::MMapInputStream mmap(thisExecutable);
+    mmap.advise(io::MMapInputStream::RANDOM, 100, 1000);
+    mmap.advise(io::MMapInputStream::WILL_NEED);
+
+    // view() borrows from the mapping and doesn't move the position
+    const auto view = mmap.view(100, 1000);
+    TEST_ASSERT_EQ(view.size(), static_cast<size_t>(1000));
+    TEST_ASSERT_TRUE(std::equal(view.begin(), view.end(),
+                                reference.begin() + 100));
+    TEST_ASSERT_EQ(mmap.view(100, 1).data(), view.data());
+    TEST_ASSERT_EQ(mmap.tell(), 0);
+
+    TEST_ASSERT_EQ(mmap.view().size(), reference.size());
+    TEST_ASSERT_EQ(mmap.view(mmap.getLength(), 0).size(),
+                   static_cast<size_t>(0));
+    TEST_EXCEPTION(mmap.view(mmap.getLength() - 1, 2));
+    TEST_EXCEPTION(mmap.view(-1, 1));
+}
+
+TEST_CASE(testMMapReadAndByteSwap)
+{
+    const std::vector<char> reference = readReference();
+    const size_t trueLen = reference.size();
+
+    io::MMapInputStream mmap(thisExecutable);
+    for (const size_t elemSize : {2, 4, 8})
+    {
+        const size_t len = (trueLen / 2) / elemSize * elemSize;
+        std::vector<char> expected(reference.begin(), reference.begin() + len);
+        sys::byteSwap(&expected[0], elemSize, len / elemSize);
+
+        mmap.seek(0, io::Seekable::START);
+        std::vector<char> swapped(len);
+        const auto wasRead = mmap.readAndByteSwap(&swapped[0], len, elemSize);
+        TEST_ASSERT_EQ(static_cast<size_t>(wasRead), len);
+        TEST_ASSERT_TRUE(expected == swapped);
+        TEST_ASSERT_EQ(static_cast<size_t>(mmap.tell()), len);
+    }
+
+    std::vector<char> buffer(7);
+    TEST_EXCEPTION(mmap.readAndByteSwap(&buffer[0], buffer.size(), 2));
+
+    // Asking for more than is there still swaps what was read
+    mmap.seek(trueLen - 8, io::Seekable::START);
+    std::vector<char> tail(16);
+    const auto tailRead = mmap.readAndByteSwap(&tail[0], tail.size(), 4);
+    TEST_ASSERT_EQ(tailRead, 8);
+    std::vector<char> expectedTail(reference.end() - 8, reference.end());
+    sys::byteSwap(&expectedTail[0], 4, 2);
+    TEST_ASSERT_TRUE(std::equal(expectedTail.begin(), expectedTail.end(),
+                                tail.begin()));
+
+    mmap.seek(trueLen - 8, io::Seekable::START);
+    TEST_THROWS(mmap.readAndByteSwap(&tail[0], tail.size(), 4, true));
+}
+
+int main(int, char* argv[])
+{
+    thisExecutable = std::string(argv[0]);
+    TEST_CHECK(testMMapRead);
+    TEST_CHECK(testMMapView);
+    TEST_CHECK(testMMapReadAndByteSwap);
+    return 0;
+}
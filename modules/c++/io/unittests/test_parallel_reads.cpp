@@ -22,6 +22,7 @@
 
 #include <TestCase.h>
 #include <io/FileInputStreamOS.h>
+#include <sys/ByteSwap.h>
 
 #include <fstream>
 #include <iostream>
@@ -77,9 +78,63 @@ TEST_CASE(testParallelReads)
     TEST_ASSERT_TRUE(referenceRead == multiThreadRead);
 }
 
+TEST_CASE(testReadAndByteSwap)
+{
+    std::ifstream from(thisExecutable, std::ios::binary);
+    from.seekg(0, std::ios::end);
+    const size_t trueLen = from.tellg();
+    from.seekg(0);
+    std::vector<char> reference(trueLen);
+    from.read(&reference[0], trueLen);
+    from.close();
+
+    io::FileInputStreamOS fis(thisExecutable);
+    for (const size_t elemSize : {2, 4, 8})
+    {
+        // Whole elements only; leave some bytes after to check the position
+        const size_t len = (trueLen / 2) / elemSize * elemSize;
+        std::vector<char> expected(reference.begin(), reference.begin() + len);
+        sys::byteSwap(&expected[0], elemSize, len / elemSize);
+
+        for (const size_t numThreads : {1, 16})
+        {
+            fis.setMaxReadThreads(numThreads);
+            fis.setMinimumChunkCount(4);
+            // Deliberately not a multiple of the element size
+            fis.setParallelChunkSize(1027);
+
+            fis.seek(0, io::Seekable::START);
+            std::vector<char> swapped(len);
+            const auto wasRead = fis.readAndByteSwap(&swapped[0], len, elemSize);
+            TEST_ASSERT_EQ(static_cast<size_t>(wasRead), len);
+            TEST_ASSERT_TRUE(expected == swapped);
+            TEST_ASSERT_EQ(static_cast<size_t>(fis.tell()), len);
+
+            char next = 0;
+            fis.read(&next, 1);
+            TEST_ASSERT_EQ(next, reference[len]);
+        }
+    }
+
+    fis.seek(0, io::Seekable::START);
+    std::vector<char> buffer(7);
+    TEST_EXCEPTION(fis.readAndByteSwap(&buffer[0], buffer.size(), 2));
+
+    // Asking for more than is there still swaps what was read
+    fis.seek(trueLen - 8, io::Seekable::START);
+    std::vector<char> tail(16);
+    const auto tailRead = fis.readAndByteSwap(&tail[0], tail.size(), 4);
+    TEST_ASSERT_EQ(tailRead, 8);
+    TEST_THROWS(fis.readAndByteSwap(&tail[0], tail.size(), 4, true));
+    std::vector<char> expectedTail(reference.end() - 8, reference.end());
+    sys::byteSwap(&expectedTail[0], 4, 2);
+    TEST_ASSERT_TRUE(std::equal(expectedTail.begin(), expectedTail.end(), tail.begin()));
+}
+
 int main(int, char* argv[])
 {
     thisExecutable = std::string(argv[0]);
     TEST_CHECK(testParallelReads);
+    TEST_CHECK(testReadAndByteSwap);
     return 0;
 }
@@ -23,6 +23,7 @@
 #ifndef __IMPORT_LOGGING_H__
 #define __IMPORT_LOGGING_H__
 
+#include "logging/AsyncHandler.h"
 #include "logging/DefaultLogger.h"
 #include "logging/Enums.h"
 #include "logging/FileHandler.h"
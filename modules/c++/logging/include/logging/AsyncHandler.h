@@ -0,0 +1,152 @@
+/* =========================================================================
+ * This file is part of logging-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * logging-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////////////////////////////////////////////
+//  AsyncHandler.h
+///////////////////////////////////////////////////////////
+
+#pragma once
+#ifndef CODA_OSS_logging_AsyncHandler_h_INCLUDED_
+#define CODA_OSS_logging_AsyncHandler_h_INCLUDED_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "config/Exports.h"
+#include "logging/LogRecord.h"
+#include "logging/Handler.h"
+#include "mt/BoundedRequestQueue.h"
+
+namespace logging
+{
+
+/*!
+ * \class AsyncHandler
+ * \brief Hands LogRecords to another Handler on a background thread
+ *
+ * handle() copies the record onto a lock-free queue and returns; the
+ * background thread takes records off the queue and passes them to the
+ * wrapped Handler, which does the formatting and the (slow) writing.  The
+ * thread logging never waits on I/O, nor on the wrapped Handler's lock.
+ *
+ * When the queue is full, the Overflow policy decides whether the caller
+ * waits for room or the record is dropped.
+ *
+ * Everything queued is written before close() or the destructor returns.
+ * Records at or above the flush level (LOG_CRITICAL by default) aren't
+ * queued and forgotten: handle() waits until they've been written, so the
+ * last thing logged before a crash isn't lost.
+ */
+struct CODA_OSS_API AsyncHandler : public Handler
+{
+    enum class Overflow
+    {
+        Block,  //!< wait for room on the queue
+        Drop,  //!< silently discard the record
+        DropAndCount  //!< discard the record, count it, and log how many were dropped
+    };
+
+    static constexpr size_t defaultCapacity = 8192;
+
+    /*!
+     * \param handler   The Handler that writes the records
+     * \param capacity  The number of records the queue will hold (rounded up
+     *                  to a power of two)
+     * \param overflow  What to do with a record when the queue is full
+     */
+    AsyncHandler(std::unique_ptr<Handler>&& handler,
+                 size_t capacity = defaultCapacity,
+                 Overflow overflow = Overflow::Block);
+    virtual ~AsyncHandler();
+
+    AsyncHandler(const AsyncHandler&) = delete;
+    AsyncHandler& operator=(const AsyncHandler&) = delete;
+    AsyncHandler(AsyncHandler&&) = delete;
+    AsyncHandler& operator=(AsyncHandler&&) = delete;
+
+    //! Queues (a copy of) the record, if it passes the filters and the
+    //! handler isn't closed
+    bool handle(const LogRecord* record) override;
+    using Handler::handle;
+
+    //! Sets the formatter of the wrapped Handler, once the queue is written
+    void setFormatter(Formatter* formatter) override;
+    void setFormatter(std::unique_ptr<Formatter>&&) override;
+
+    //! Records at or above this level are written before handle() returns
+    void setFlushLevel(LogLevel level)
+    {
+        mFlushLevel = level;
+    }
+
+    //! Waits until every record queued so far has been written
+    void flush();
+
+    //! Writes everything queued, stops the thread and closes the wrapped Handler
+    void close() override;
+
+    //! The number of records dropped (only counted with Overflow::DropAndCount)
+    uint64_t getNumDropped() const
+    {
+        return mNumDropped.load(std::memory_order_relaxed);
+    }
+
+protected:
+    //! Nothing is written but records, and that's done by the wrapped Handler
+    void write(const std::string&) override;
+
+    void emitRecord(const LogRecord* record) override;
+
+private:
+    void run();
+    void writeRecord(const LogRecord&);
+    void stop();
+    void reportDropped();
+
+    std::unique_ptr<Handler> mHandler;
+    const Overflow mOverflow;
+    LogLevel mFlushLevel = LogLevel::LOG_CRITICAL;
+
+    // nullptr tells the thread to stop
+    mt::BoundedRequestQueue<LogRecord*> mQueue;
+    std::atomic<uint64_t> mNumQueued{0};
+    std::atomic<uint64_t> mNumWritten{0};
+    std::atomic<uint64_t> mNumDropped{0};
+    uint64_t mNumReported = 0;  // only touched by the thread
+    std::atomic<bool> mClosed{false};
+    std::atomic<size_t> mNumProducers{0};  // in handle(), past the mClosed check
+    std::atomic<bool> mStopped{false};  // the thread has gone
+
+    std::mutex mFlushMutex;
+    std::condition_variable mFlushed;
+    std::atomic<size_t> mNumFlushing{0};
+
+    std::thread mThread;
+};
+
+}
+#endif  // CODA_OSS_logging_AsyncHandler_h_INCLUDED_
@@ -27,7 +27,11 @@
 #ifndef __LOGGING_LOG_RECORD_H__
 #define __LOGGING_LOG_RECORD_H__
 
+#include <stdint.h>
+
+#include <functional>
 #include <string>
+#include <utility>
 #include "logging/Enums.h"
 
 namespace logging
@@ -40,37 +44,52 @@ namespace logging
  * LogRecord instances are created every time something is logged. They
  * contain all the information pertinent to the event being logged. The
  * record also includes the timestamp when the record was created.
+ *
+ * The time is kept as seconds since the epoch and made into a string only
+ * if getTimeStamp() is called; likewise, a record can be given a function
+ * that builds its message when getMessage() is first called.  Neither
+ * is safe to call from two threads at once for the same record.
  */
 class LogRecord
 {
 
 public:
+    //! Builds the message of a record, when (and if) it's needed
+    using MessageFunc = std::function<std::string()>;
+
     LogRecord(std::string name, std::string msg, LogLevel level = LogLevel::LOG_NOTSET);
     LogRecord(std::string name, std::string msg, LogLevel level,
               std::string file, std::string function, int lineNum, std::string timestamp) :
-            mName(name), mMsg(msg), mLevel(level), mFile(file), mFunction(function),
-            mLineNum(lineNum), mTimestamp(timestamp){}
+            mName(std::move(name)), mMsg(std::move(msg)), mLevel(level), mFile(std::move(file)),
+            mFunction(std::move(function)), mLineNum(lineNum), mTimestamp(std::move(timestamp)){}
+    LogRecord(std::string name, MessageFunc makeMessage, LogLevel level,
+              std::string file, std::string function, int lineNum);
     virtual ~LogRecord() = default;
 
     LogLevel getLevel() const { return mLevel; }
     std::string getLevelName() const;
 
-    std::string getMessage() const { return mMsg; }
-    std::string getName() const { return mName; }
-    std::string getTimeStamp() const { return mTimestamp; }
-    std::string getFile() const { return mFile; }
-    std::string getFunction() const { return mFunction; }
+    const std::string& getMessage() const;
+    const std::string& getName() const { return mName; }
+    const std::string& getTimeStamp() const;
+    const std::string& getFile() const { return mFile; }
+    const std::string& getFunction() const { return mFunction; }
     int getLineNum() const { return mLineNum; }
 
+    //! Seconds since the epoch; 0 if the record was given a timestamp string
+    int64_t getTime() const { return mTime; }
+
 
 private:
     std::string mName;
-    std::string mMsg;
+    mutable std::string mMsg;
+    mutable MessageFunc mMakeMessage;
     LogLevel mLevel;
     std::string mFile;
     std::string mFunction;
-    int mLineNum;
-    std::string mTimestamp;
+    int mLineNum = -1;
+    int64_t mTime = 0;
+    mutable std::string mTimestamp;
 };
 
 }
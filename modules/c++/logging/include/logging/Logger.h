@@ -28,19 +28,51 @@
 #ifndef CODA_OSS_logging_Logger_h_INCLUDED_
 #define CODA_OSS_logging_Logger_h_INCLUDED_
 
+#include <initializer_list>
 #include <string>
 #include <vector>
 #include <memory>
 #include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "config/Exports.h"
 #include "logging/Filterer.h"
 #include "logging/LogRecord.h"
 #include "logging/Handler.h"
 #include <import/except.h>
+#include "sys/Conf.h"
 
 namespace logging
 {
+namespace details
+{
+// Arguments are copied so the message can be built later, maybe on another
+// thread (see AsyncHandler); that's no good for a pointer to a C string.
+template<typename T> struct Captured { using type = T; };
+template<> struct Captured<char*> { using type = std::string; };
+template<> struct Captured<const char*> { using type = std::string; };
+template<typename T>
+using Captured_t = typename Captured<typename std::decay<T>::type>::type;
+
+template<typename TTuple, size_t... Is>
+inline void write(std::ostream& os, const TTuple& args, std::index_sequence<Is...>)
+{
+    (void)std::initializer_list<int>{ ((os << std::get<Is>(args)), 0)... };
+}
+
+template<typename... TArgs>
+inline LogRecord::MessageFunc makeMessageFunc(TArgs&&... args)
+{
+    std::tuple<Captured_t<TArgs>...> captured(std::forward<TArgs>(args)...);
+    return [captured]() {
+        std::ostringstream os;
+        write(os, captured, std::index_sequence_for<TArgs...>{});
+        return os.str();
+    };
+}
+}
 
 /*!
  * \class Logger
@@ -64,6 +96,34 @@ struct CODA_OSS_API Logger : public Filterer
     //! Logs a message at the specified LogLevel
     void log(LogLevel level, const std::string& msg);
 
+    /*!
+     * Logs the arguments, streamed one after the other as with a
+     * std::ostringstream, at the specified LogLevel.  Nothing is done
+     * unless isEnabledFor(level); the arguments are copied and the message
+     * is built only when a Formatter asks for it.
+     *
+     * Use the CODA_OSS_LOG macros so the arguments aren't even evaluated
+     * for a disabled level.
+     *
+     * The arguments are streamed when the message is built, which may be on
+     * an AsyncHandler's thread.  Streaming them may log; Handlers build the
+     * message before taking their lock.
+     */
+    template<typename... TArgs>
+    void logDeferred(LogLevel level, const char* file, const char* function, int lineNum,
+                     TArgs&&... args)
+    {
+        if (isEnabledFor(level))
+        {
+            const LogRecord rec(mName, details::makeMessageFunc(std::forward<TArgs>(args)...),
+                                level, file, function, lineNum);
+            handle(rec);
+        }
+    }
+
+    //! Whether any Handler would emit a record at the specified LogLevel
+    bool isEnabledFor(LogLevel level) const;
+
     //! Logs an Exception Context at the specified LogLevel
     void log(LogLevel level, const except::Context& ctxt);
 
@@ -168,4 +228,25 @@ protected:
 };
 typedef std::shared_ptr<Logger> LoggerPtr;
 }
+
+/*!
+ * Logs the remaining arguments with logging::Logger::logDeferred(); they're
+ * evaluated only if the logger is enabled for the level.  For example,
+ *   CODA_OSS_LOG_DEBUG(logger, "read ", count, " bytes from ", pathname);
+ */
+#define CODA_OSS_LOG(LOGGER, LEVEL, ...) \
+    do { \
+        logging::Logger& coda_oss_log_logger_ = (LOGGER); \
+        const logging::LogLevel coda_oss_log_level_ = (LEVEL); \
+        if (coda_oss_log_logger_.isEnabledFor(coda_oss_log_level_)) \
+        { \
+            coda_oss_log_logger_.logDeferred(coda_oss_log_level_, __FILE__, SYS_FUNC, __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+#define CODA_OSS_LOG_DEBUG(LOGGER, ...) CODA_OSS_LOG(LOGGER, logging::LogLevel::LOG_DEBUG, __VA_ARGS__)
+#define CODA_OSS_LOG_INFO(LOGGER, ...) CODA_OSS_LOG(LOGGER, logging::LogLevel::LOG_INFO, __VA_ARGS__)
+#define CODA_OSS_LOG_WARN(LOGGER, ...) CODA_OSS_LOG(LOGGER, logging::LogLevel::LOG_WARNING, __VA_ARGS__)
+#define CODA_OSS_LOG_ERROR(LOGGER, ...) CODA_OSS_LOG(LOGGER, logging::LogLevel::LOG_ERROR, __VA_ARGS__)
+#define CODA_OSS_LOG_CRITICAL(LOGGER, ...) CODA_OSS_LOG(LOGGER, logging::LogLevel::LOG_CRITICAL, __VA_ARGS__)
+
 #endif  // CODA_OSS_logging_Logger_h_INCLUDED_
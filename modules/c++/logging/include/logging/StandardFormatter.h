@@ -28,6 +28,7 @@
 #define __LOGGING_STANDARD_FORMATTER_H__
 
 #include <string>
+#include <vector>
 #include <str/Manip.h>
 #include "config/Exports.h"
 #include "logging/Formatter.h"
@@ -52,13 +53,16 @@ namespace logging
  *
  *  The default format looks like this:
  *  [%c] %p %d ==> %m
+ *
+ *  The format string is parsed once, when the formatter is created; each
+ *  record is then written by appending literals and fields to a buffer.
  */
 class CODA_OSS_API StandardFormatter : public Formatter
 {
 public:
     static const char DEFAULT_FORMAT[];
 
-    StandardFormatter() : Formatter(DEFAULT_FORMAT) {}
+    StandardFormatter() : StandardFormatter(DEFAULT_FORMAT) {}
     StandardFormatter(const std::string& fmt, 
                       const std::string& prologue = "",
                       const std::string& epilogue = "");
@@ -69,6 +73,30 @@ public:
 
     virtual void format(const LogRecord* record, io::OutputStream& os) const override;
 
+private:
+    void parse(const std::string& fmt);
+    void format(const LogRecord& record, std::string& buffer) const;
+
+    // A piece of the format string: either literal text or a field of the record
+    struct Token final
+    {
+        enum class Field
+        {
+            Literal,
+            ThreadID,
+            Name,
+            Level,
+            TimeStamp,
+            File,
+            LineNum,
+            Function,
+            Message
+        };
+
+        Field field = Field::Literal;
+        std::string literal;
+    };
+    std::vector<Token> mTokens;
 };
 
 }
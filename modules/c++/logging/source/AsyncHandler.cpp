@@ -0,0 +1,251 @@
+/* =========================================================================
+ * This file is part of logging-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * logging-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+///////////////////////////////////////////////////////////
+//  AsyncHandler.cpp
+///////////////////////////////////////////////////////////
+
+#include "logging/AsyncHandler.h"
+
+#include <sstream>
+
+namespace logging
+{
+AsyncHandler::AsyncHandler(std::unique_ptr<Handler>&& handler,
+                           size_t capacity,
+                           Overflow overflow) :
+    mHandler(std::move(handler)),
+    mOverflow(overflow),
+    mQueue(capacity)
+{
+    if (mHandler.get() == nullptr)
+    {
+        throw except::NullPointerReference(Ctxt("No Handler to write records"));
+    }
+    mThread = std::thread([this]() { run(); });
+}
+
+AsyncHandler::~AsyncHandler()
+{
+    try
+    {
+        stop();
+    }
+    catch (...)
+    {
+    }
+}
+
+bool AsyncHandler::handle(const LogRecord* record)
+{
+    if (!filter(record))
+    {
+        return false;
+    }
+
+    // stop() waits for everyone who gets past mClosed, so nothing is
+    // queued once the thread has gone
+    mNumProducers.fetch_add(1);
+    bool handled = false;
+    try
+    {
+        if (!mClosed.load())
+        {
+            emitRecord(record);
+            handled = true;
+        }
+    }
+    catch (...)
+    {
+        mNumProducers.fetch_sub(1);
+        throw;
+    }
+    mNumProducers.fetch_sub(1);
+    return handled;
+}
+
+void AsyncHandler::emitRecord(const LogRecord* record)
+{
+    // Logged by the thread itself, e.g. while building a deferred message;
+    // waiting for room on the queue would wait forever
+    if (std::this_thread::get_id() == mThread.get_id())
+    {
+        writeRecord(*record);
+        return;
+    }
+
+    auto copy = std::make_unique<LogRecord>(*record);
+    if (mOverflow == Overflow::Block)
+    {
+        mQueue.enqueue(copy.get());
+    }
+    else if (!mQueue.tryEnqueue(copy.get()))
+    {
+        if (mOverflow == Overflow::DropAndCount)
+        {
+            mNumDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    copy.release();  // the thread owns it now
+    mNumQueued.fetch_add(1, std::memory_order_release);
+
+    if (record->getLevel() >= mFlushLevel)
+    {
+        flush();
+    }
+}
+
+void AsyncHandler::write(const std::string&)
+{
+}
+
+void AsyncHandler::flush()
+{
+    // e.g., the wrapped Handler logging to this one; it would wait forever
+    if (std::this_thread::get_id() == mThread.get_id())
+    {
+        return;
+    }
+
+    const auto numQueued = mNumQueued.load(std::memory_order_acquire);
+    const auto written = [&]() {
+        return (mNumWritten.load() >= numQueued) || mStopped.load();
+    };
+    if (written())
+    {
+        return;
+    }
+
+    mNumFlushing.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(mFlushMutex);
+        mFlushed.wait(lock, written);
+    }
+    mNumFlushing.fetch_sub(1);
+}
+
+void AsyncHandler::run()
+{
+    while (true)
+    {
+        LogRecord* pRecord = nullptr;
+        mQueue.dequeue(pRecord);
+        if (pRecord == nullptr)
+        {
+            break;
+        }
+        const std::unique_ptr<LogRecord> record(pRecord);
+        reportDropped();
+        writeRecord(*record);
+
+        // Either flush() sees this, or this sees it flushing
+        mNumWritten.fetch_add(1);
+        if (mNumFlushing.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mFlushMutex);
+            mFlushed.notify_all();
+        }
+    }
+    reportDropped();
+}
+
+void AsyncHandler::writeRecord(const LogRecord& record)
+{
+    try
+    {
+        // As Logger::handle() would do
+        if (mHandler->getLevel() <= record.getLevel())
+        {
+            mHandler->handle(&record);
+        }
+    }
+    catch (...)
+    {
+        // There's nobody to tell; keep writing the rest
+    }
+}
+
+void AsyncHandler::reportDropped()
+{
+    const auto numDropped = mNumDropped.load(std::memory_order_relaxed);
+    if (numDropped != mNumReported)
+    {
+        std::ostringstream oss;
+        oss << (numDropped - mNumReported) << " log record(s) dropped; the queue was full";
+        mNumReported = numDropped;
+
+        writeRecord(LogRecord("logging::AsyncHandler", oss.str(), LogLevel::LOG_WARNING));
+    }
+}
+
+void AsyncHandler::setFormatter(Formatter* formatter)
+{
+    // The thread might be using the current one
+    flush();
+    mHandler->setFormatter(formatter);
+}
+void AsyncHandler::setFormatter(std::unique_ptr<Formatter>&& formatter)
+{
+    flush();
+    mHandler->setFormatter(std::move(formatter));
+}
+
+void AsyncHandler::stop()
+{
+    if (!mClosed.exchange(true))
+    {
+        // Let anyone already queueing finish; the thread is still taking
+        // records, so a blocked enqueue gets its room
+        while (mNumProducers.load() > 0)
+        {
+            std::this_thread::yield();
+        }
+
+        mQueue.enqueue(nullptr);  // after everything already queued
+        mThread.join();
+
+        // Nothing should be left, but don't lose it if it is
+        LogRecord* pRecord = nullptr;
+        while (mQueue.tryDequeue(pRecord))
+        {
+            const std::unique_ptr<LogRecord> record(pRecord);
+            if (record != nullptr)
+            {
+                writeRecord(*record);
+                mNumWritten.fetch_add(1);
+            }
+        }
+
+        // Nothing more will be written; don't leave flush() waiting
+        std::lock_guard<std::mutex> lock(mFlushMutex);
+        mStopped = true;
+        mFlushed.notify_all();
+    }
+}
+
+void AsyncHandler::close()
+{
+    stop();
+    mHandler->close();
+}
+}
@@ -29,7 +29,7 @@
 
 bool logging::Filter::filter(const logging::LogRecord* record) const
 {
-    std::string recName = record->getName();
+    const auto& recName = record->getName();
     if (mName.empty() || recName == mName)
         return true;
     else if (recName.find(mName, 0) != 0)
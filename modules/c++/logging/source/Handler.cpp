@@ -56,10 +56,14 @@ bool Handler::handle(const LogRecord* record)
     bool rv = false;
     if (filter(record))
     {
-        //acquire lock
-        mt::CriticalSection<sys::Mutex> lock(&mHandlerLock);
         try
         {
+            // Build a deferred message before taking the lock; building it
+            // may log, possibly to this Handler
+            record->getMessage();
+
+            //acquire lock
+            mt::CriticalSection<sys::Mutex> lock(&mHandlerLock);
             emitRecord(record);
             rv = true;
         }
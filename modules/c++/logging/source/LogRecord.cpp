@@ -25,13 +25,50 @@
 ///////////////////////////////////////////////////////////
 
 #include "logging/LogRecord.h"
-#include "sys/TimeStamp.h"
+#include "sys/DateTime.h"
+#include "sys/LocalDateTime.h"
 
 logging::LogRecord::LogRecord(std::string name, std::string msg, logging::LogLevel level)
-        : mName(name), mMsg(msg), mLevel(level), mFile(""), mFunction(""), mLineNum(-1)
+        : mName(std::move(name)), mMsg(std::move(msg)), mLevel(level), mFile(""), mFunction(""), mLineNum(-1),
+          mTime(sys::DateTime::getEpochSeconds())
 {
-    mTimestamp = sys::TimeStamp(true).local();
 }
 
+logging::LogRecord::LogRecord(std::string name, MessageFunc makeMessage, LogLevel level,
+                              std::string file, std::string function, int lineNum)
+        : mName(std::move(name)), mMakeMessage(std::move(makeMessage)), mLevel(level),
+          mFile(std::move(file)), mFunction(std::move(function)), mLineNum(lineNum),
+          mTime(sys::DateTime::getEpochSeconds())
+{
+}
+
+const std::string& logging::LogRecord::getMessage() const
+{
+    if (mMakeMessage)
+    {
+        mMsg = mMakeMessage();
+        mMakeMessage = nullptr;
+    }
+    return mMsg;
+}
+
+const std::string& logging::LogRecord::getTimeStamp() const
+{
+    if (mTimestamp.empty() && (mTime != 0))
+    {
+        // Records come many to a second; only format a new second
+        thread_local int64_t lastTime = 0;
+        thread_local std::string lastTimestamp;
+        if (mTime != lastTime)
+        {
+            // as sys::TimeStamp(true).local()
+            const sys::LocalDateTime dt(static_cast<double>(mTime) * 1000.0);
+            lastTimestamp = dt.format("%m/%d/%Y, %H:%M:%S");
+            lastTime = mTime;
+        }
+        mTimestamp = lastTimestamp;
+    }
+    return mTimestamp;
+}
 
 std::string logging::LogRecord::getLevelName() const { return mLevel.toString(); }
@@ -34,12 +34,20 @@ logging::Logger::~Logger()
 
 void logging::Logger::log(logging::LogLevel level, const std::string& msg)
 {
+    if (!isEnabledFor(level))
+    {
+        return;
+    }
     const logging::LogRecord rec(mName, msg, level);
     handle(rec);
 }
 
 void logging::Logger::log(LogLevel level, const except::Context& ctxt)
 {
+    if (!isEnabledFor(level))
+    {
+        return;
+    }
    const logging::LogRecord rec(mName, ctxt.getMessage(),
                                                      level, ctxt.getFile(),
                                                      ctxt.getFunction(),
@@ -100,27 +108,42 @@ void logging::Logger::critical(const std::string& msg)
 
 void logging::Logger::debug(const std::ostringstream& msg)
 {
-    log(LogLevel::LOG_DEBUG, msg.str());
+    if (isEnabledFor(LogLevel::LOG_DEBUG))
+    {
+        log(LogLevel::LOG_DEBUG, msg.str());
+    }
 }
 
 void logging::Logger::info(const std::ostringstream& msg)
 {
-    log(LogLevel::LOG_INFO, msg.str());
+    if (isEnabledFor(LogLevel::LOG_INFO))
+    {
+        log(LogLevel::LOG_INFO, msg.str());
+    }
 }
 
 void logging::Logger::warn(const std::ostringstream& msg)
 {
-    log(LogLevel::LOG_WARNING, msg.str());
+    if (isEnabledFor(LogLevel::LOG_WARNING))
+    {
+        log(LogLevel::LOG_WARNING, msg.str());
+    }
 }
 
 void logging::Logger::error(const std::ostringstream& msg)
 {
-    log(LogLevel::LOG_ERROR, msg.str());
+    if (isEnabledFor(LogLevel::LOG_ERROR))
+    {
+        log(LogLevel::LOG_ERROR, msg.str());
+    }
 }
 
 void logging::Logger::critical(const std::ostringstream& msg)
 {
-    log(LogLevel::LOG_CRITICAL, msg.str());
+    if (isEnabledFor(LogLevel::LOG_CRITICAL))
+    {
+        log(LogLevel::LOG_CRITICAL, msg.str());
+    }
 }
 
 void logging::Logger::debug(const except::Context& ctxt)
@@ -173,6 +196,18 @@ void logging::Logger::critical(const except::Throwable& t)
     log(LogLevel::LOG_CRITICAL, t);
 }
 
+bool logging::Logger::isEnabledFor(LogLevel level) const
+{
+    for (const auto& p : mHandlers)
+    {
+        if (p.first->getLevel() <= level)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void logging::Logger::handle(const logging::LogRecord* record)
 {
     if (filter(record))
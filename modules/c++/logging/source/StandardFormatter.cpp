@@ -24,8 +24,7 @@
 //  StandardFormatter.cpp
 ///////////////////////////////////////////////////////////
 
-#include <sstream>
-#include <iostream>
+#include <utility>
 #include <import/sys.h>
 #include <import/str.h>
 #include "logging/StandardFormatter.h"
@@ -39,33 +38,118 @@ StandardFormatter::StandardFormatter(const std::string& fmt,
                                      const std::string& epilogue) :
     Formatter((fmt.empty()) ? DEFAULT_FORMAT : fmt, prologue, epilogue)
 {
+    parse(mFmt);
 }
 
-void StandardFormatter::format(const LogRecord* record, io::OutputStream& os) const
+void StandardFormatter::parse(const std::string& fmt)
 {
-    std::string name = (record->getName().empty()) ? ("DEFAULT") : record->getName();
+    using Field = Token::Field;
+    const std::pair<const char*, Field> fields[] = {
+        { THREAD_ID, Field::ThreadID },
+        { LOG_NAME,  Field::Name },
+        { LOG_LEVEL, Field::Level },
+        { TIMESTAMP, Field::TimeStamp },
+        { FILE_NAME, Field::File },
+        { LINE_NUM,  Field::LineNum },
+        { FUNCTION,  Field::Function },
+        { MESSAGE,   Field::Message } };
 
-    // populate log
-    long threadId = sys::getThreadID();
-    std::string format = mFmt;
-    str::replace(format, THREAD_ID, std::to_string(threadId));
-    str::replace(format, LOG_NAME,  name);
-    str::replace(format, LOG_LEVEL, record->getLevelName());
-    str::replace(format, TIMESTAMP, record->getTimeStamp());
-    if (record->getLineNum() >= 0)
+    Token literal;
+    for (size_t ii = 0; ii < fmt.length(); ++ii)
     {
-        str::replace(format, FILE_NAME, record->getFile());
-        str::replace(format, LINE_NUM, std::to_string(record->getLineNum()));
+        Field field = Field::Literal;
+        for (const auto& f : fields)
+        {
+            if (fmt.compare(ii, 2, f.first) == 0)
+            {
+                field = f.second;
+                break;
+            }
+        }
+
+        if (field == Field::Literal)
+        {
+            literal.literal += fmt[ii];
+            continue;
+        }
+
+        if (!literal.literal.empty())
+        {
+            mTokens.push_back(std::move(literal));
+            literal = Token();
+        }
+        Token token;
+        token.field = field;
+        mTokens.push_back(std::move(token));
+        ++ii; // the rest of "%c"
     }
-    else
+    if (!literal.literal.empty())
     {
-        str::replace(format, FILE_NAME, "");
-        str::replace(format, LINE_NUM,  "");
+        mTokens.push_back(std::move(literal));
     }
-    str::replace(format, FUNCTION, record->getFunction());
-    str::replace(format, MESSAGE,  record->getMessage());
+}
 
-    // write to stream
-    os.write(format + "\n");
+void StandardFormatter::format(const LogRecord& record, std::string& buffer) const
+{
+    static const std::string defaultName = "DEFAULT";
+
+    using Field = Token::Field;
+    for (const auto& token : mTokens)
+    {
+        switch (token.field)
+        {
+        case Field::Literal:
+            buffer += token.literal;
+            break;
+        case Field::ThreadID:
+        {
+            thread_local const std::string threadId = std::to_string(sys::getThreadID());
+            buffer += threadId;
+            break;
+        }
+        case Field::Name:
+            buffer += record.getName().empty() ? defaultName : record.getName();
+            break;
+        case Field::Level:
+            buffer += record.getLevelName();
+            break;
+        case Field::TimeStamp:
+            buffer += record.getTimeStamp();
+            break;
+        case Field::File:
+            if (record.getLineNum() >= 0)
+            {
+                buffer += record.getFile();
+            }
+            break;
+        case Field::LineNum:
+            if (record.getLineNum() >= 0)
+            {
+                buffer += std::to_string(record.getLineNum());
+            }
+            break;
+        case Field::Function:
+            buffer += record.getFunction();
+            break;
+        case Field::Message:
+            buffer += record.getMessage();
+            break;
+        }
+    }
+    buffer += '\n';
 }
 
+void StandardFormatter::format(const LogRecord* record, io::OutputStream& os) const
+{
+    // Build a deferred message first; building it may log on this thread,
+    // which would reuse the buffer
+    record->getMessage();
+
+    // Reused by every record logged on this thread, so it rarely allocates
+    thread_local std::string buffer;
+    buffer.clear();
+    format(*record, buffer);
+
+    // write to stream
+    os.write(buffer);
+}
@@ -0,0 +1,198 @@
+/* =========================================================================
+ * This file is part of logging-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * logging-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestCase.h"
+
+#include <logging/AsyncHandler.h>
+#include <logging/Logger.h>
+#include <logging/MemoryHandler.h>
+
+// A MemoryHandler that can be held up, as if by a slow disk
+struct SlowHandler final : public logging::MemoryHandler
+{
+    std::atomic<bool> mWait{false};
+    std::atomic<bool> mHeld{false};  // waiting on mWait
+    std::atomic<size_t> mNumEmitted{0};
+
+protected:
+    void emitRecord(const logging::LogRecord* record) override
+    {
+        mHeld = mWait.load();
+        while (mWait)
+        {
+            std::this_thread::yield();
+        }
+        MemoryHandler::emitRecord(record);
+        ++mNumEmitted;
+    }
+};
+
+static std::unique_ptr<SlowHandler> makeHandler(SlowHandler*& pHandler)
+{
+    auto retval = std::make_unique<SlowHandler>();
+    retval->setFormatter(std::make_unique<logging::StandardFormatter>("%m"));
+    pHandler = retval.get();
+    return retval;
+}
+
+TEST_CASE(testAsyncHandler)
+{
+    SlowHandler* pHandler = nullptr;
+    logging::AsyncHandler handler(makeHandler(pHandler));
+    logging::Logger log("test");
+    log.addHandler(&handler);
+
+    constexpr size_t numThreads = 4;
+    constexpr size_t numRecords = 1000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < numRecords; ++i)
+            {
+                log.info(std::to_string(i));
+            }
+        });
+    }
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    handler.flush();
+    const auto& logs = pHandler->getLogs(logging::LogLevel::LOG_INFO);
+    TEST_ASSERT_EQ(logs.size(), numThreads * numRecords);
+    TEST_ASSERT_EQ(logs.front(), "0\n");
+    TEST_ASSERT_EQ(handler.getNumDropped(), static_cast<uint64_t>(0));
+}
+
+TEST_CASE(testAsyncHandlerClose)
+{
+    SlowHandler* pHandler = nullptr;
+    auto handler = std::make_unique<logging::AsyncHandler>(makeHandler(pHandler));
+    pHandler->mWait = true;
+    handler->handle(logging::LogRecord("test", "queued", logging::LogLevel::LOG_INFO));
+    TEST_ASSERT_EQ(pHandler->mNumEmitted.load(), static_cast<size_t>(0));
+
+    // Everything queued is written before the thread stops
+    pHandler->mWait = false;
+    handler->close();
+    TEST_ASSERT_EQ(pHandler->mNumEmitted.load(), static_cast<size_t>(1));
+    TEST_ASSERT_FALSE(handler->handle(logging::LogRecord("test", "closed", logging::LogLevel::LOG_INFO)));
+}
+
+TEST_CASE(testAsyncHandlerCloseWhileLogging)
+{
+    // Every record handle() takes is written, and nobody is left waiting
+    for (size_t run = 0; run < 20; ++run)
+    {
+        SlowHandler* pHandler = nullptr;
+        logging::AsyncHandler handler(makeHandler(pHandler), 4 /*capacity*/);
+        handler.setFlushLevel(logging::LogLevel::LOG_ERROR);
+
+        std::atomic<size_t> numHandled{0};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&]() {
+                for (size_t i = 0; i < 200; ++i)
+                {
+                    const auto level = i % 4 == 0 ? logging::LogLevel::LOG_ERROR : logging::LogLevel::LOG_INFO;
+                    if (handler.handle(logging::LogRecord("test", std::to_string(i), level)))
+                    {
+                        ++numHandled;
+                    }
+                }
+            });
+        }
+        std::this_thread::yield();
+        handler.close();
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+
+        handler.flush();
+        const auto numEmitted = pHandler->mNumEmitted.load();
+        TEST_ASSERT_EQ(numEmitted, numHandled.load());
+    }
+}
+
+TEST_CASE(testAsyncHandlerDrop)
+{
+    SlowHandler* pHandler = nullptr;
+    logging::AsyncHandler handler(makeHandler(pHandler), 2 /*capacity*/,
+                                  logging::AsyncHandler::Overflow::DropAndCount);
+    pHandler->mWait = true;
+
+    // Hold the thread on the first record, so it can't report any drops
+    // until they've all been made
+    handler.handle(logging::LogRecord("test", "0", logging::LogLevel::LOG_INFO));
+    while (!pHandler->mHeld)
+    {
+        std::this_thread::yield();
+    }
+
+    constexpr size_t numRecords = 100;
+    for (size_t i = 1; i < numRecords; ++i)
+    {
+        handler.handle(logging::LogRecord("test", std::to_string(i), logging::LogLevel::LOG_INFO));
+    }
+    pHandler->mWait = false;
+    handler.flush();
+
+    // The thread holds one record and the queue two more; the rest are dropped
+    const auto numDropped = handler.getNumDropped();
+    TEST_ASSERT_TRUE(numDropped > 0);
+    const auto& infos = pHandler->getLogs(logging::LogLevel::LOG_INFO);
+    TEST_ASSERT_EQ(infos.size() + numDropped, numRecords);
+
+    handler.close();
+    const auto& warnings = pHandler->getLogs(logging::LogLevel::LOG_WARNING);
+    TEST_ASSERT_EQ(warnings.size(), static_cast<size_t>(1));
+    TEST_ASSERT(warnings[0].find(std::to_string(numDropped) + " log record(s) dropped") != std::string::npos);
+}
+
+TEST_CASE(testAsyncHandlerFlushLevel)
+{
+    SlowHandler* pHandler = nullptr;
+    logging::AsyncHandler handler(makeHandler(pHandler));
+    handler.setFlushLevel(logging::LogLevel::LOG_ERROR);
+
+    handler.handle(logging::LogRecord("test", "info", logging::LogLevel::LOG_INFO));
+    handler.handle(logging::LogRecord("test", "error", logging::LogLevel::LOG_ERROR));
+    TEST_ASSERT_EQ(pHandler->mNumEmitted.load(), static_cast<size_t>(2));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testAsyncHandler);
+    TEST_CHECK(testAsyncHandlerClose);
+    TEST_CHECK(testAsyncHandlerCloseWhileLogging);
+    TEST_CHECK(testAsyncHandlerDrop);
+    TEST_CHECK(testAsyncHandlerFlushLevel);
+    )
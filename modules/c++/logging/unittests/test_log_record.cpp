@@ -0,0 +1,193 @@
+/* =========================================================================
+ * This file is part of logging-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * logging-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <string>
+
+#include "TestCase.h"
+
+#include <logging/AsyncHandler.h>
+#include <logging/Logger.h>
+#include <logging/MemoryHandler.h>
+#include <sys/TimeStamp.h>
+
+// Counts how often it's streamed, i.e., how often a message is built
+struct Counted final
+{
+    int* pCount;
+};
+static std::ostream& operator<<(std::ostream& os, const Counted& counted)
+{
+    ++(*counted.pCount);
+    return os << "counted";
+}
+
+static std::unique_ptr<logging::MemoryHandler> makeHandler(logging::LogLevel level)
+{
+    auto retval = std::make_unique<logging::MemoryHandler>(level);
+    retval->setFormatter(std::make_unique<logging::StandardFormatter>("%m"));
+    return retval;
+}
+
+TEST_CASE(testIsEnabledFor)
+{
+    logging::Logger log("test");
+    TEST_ASSERT_FALSE(log.isEnabledFor(logging::LogLevel::LOG_CRITICAL));
+
+    logging::MemoryHandler* pHandler = nullptr;
+    {
+        auto handler = makeHandler(logging::LogLevel::LOG_WARNING);
+        pHandler = handler.get();
+        log.addHandler(std::move(handler));
+    }
+    TEST_ASSERT_FALSE(log.isEnabledFor(logging::LogLevel::LOG_INFO));
+    TEST_ASSERT_TRUE(log.isEnabledFor(logging::LogLevel::LOG_WARNING));
+    TEST_ASSERT_TRUE(log.isEnabledFor(logging::LogLevel::LOG_ERROR));
+
+    // The arguments aren't even evaluated for a disabled level
+    int numEvaluated = 0;
+    const auto evaluate = [&]() { return ++numEvaluated; };
+    CODA_OSS_LOG_INFO(log, "info ", evaluate());
+    TEST_ASSERT_EQ(numEvaluated, 0);
+    CODA_OSS_LOG_WARN(log, "warning ", evaluate());
+    TEST_ASSERT_EQ(numEvaluated, 1);
+
+    TEST_ASSERT_TRUE(pHandler->getLogs(logging::LogLevel::LOG_INFO).empty());
+    const auto& warnings = pHandler->getLogs(logging::LogLevel::LOG_WARNING);
+    TEST_ASSERT_EQ(warnings.size(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(warnings[0], "warning 1\n");
+}
+
+TEST_CASE(testDeferredMessage)
+{
+    int numBuilt = 0;
+    const logging::LogRecord record("test", logging::details::makeMessageFunc("a ", 1, ' ', Counted{&numBuilt}),
+                                    logging::LogLevel::LOG_INFO, "file.cpp", "function", 42);
+    TEST_ASSERT_EQ(numBuilt, 0);
+    TEST_ASSERT_EQ(record.getMessage(), "a 1 counted");
+    TEST_ASSERT_EQ(record.getMessage(), "a 1 counted");
+    TEST_ASSERT_EQ(numBuilt, 1);
+
+    // Filtered out after the level check; no message is built
+    logging::Logger log("test");
+    log.addHandler(makeHandler(logging::LogLevel::LOG_DEBUG));
+    logging::Filter filter("other");
+    log.addFilter(&filter);
+    CODA_OSS_LOG_ERROR(log, Counted{&numBuilt});
+    TEST_ASSERT_EQ(numBuilt, 1);
+    log.removeFilter(&filter);
+    CODA_OSS_LOG_ERROR(log, Counted{&numBuilt});
+    TEST_ASSERT_EQ(numBuilt, 2);
+}
+
+TEST_CASE(testDeferredAsync)
+{
+    auto handler = makeHandler(logging::LogLevel::LOG_DEBUG);
+    auto pHandler = handler.get();
+    logging::AsyncHandler async(std::move(handler));
+    logging::Logger log("test");
+    log.addHandler(&async);
+
+    // The message is built on the AsyncHandler's thread, long after the
+    // buffer has changed; it has to have been copied.
+    char buffer[] = "first";
+    CODA_OSS_LOG_DEBUG(log, buffer, " record");
+    buffer[0] = 'F';
+    async.flush();
+
+    const auto& logs = pHandler->getLogs(logging::LogLevel::LOG_DEBUG);
+    TEST_ASSERT_EQ(logs.size(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(logs[0], "first record\n");
+}
+
+// Logs to its logger when it's streamed
+struct Reentrant final
+{
+    logging::Logger* pLogger;
+};
+static std::ostream& operator<<(std::ostream& os, const Reentrant& reentrant)
+{
+    CODA_OSS_LOG_INFO(*reentrant.pLogger, "inner ", 1);
+    return os << "outer";
+}
+
+TEST_CASE(testDeferredReentrant)
+{
+    // Building the message logs to the same Handler; that can't wait on
+    // the Handler's lock nor clobber the formatter's buffer
+    {
+        auto handler = makeHandler(logging::LogLevel::LOG_DEBUG);
+        auto pHandler = handler.get();
+        logging::Logger log("test");
+        log.addHandler(std::move(handler));
+        CODA_OSS_LOG_INFO(log, Reentrant{&log}, ' ', 2);
+
+        const auto& logs = pHandler->getLogs(logging::LogLevel::LOG_INFO);
+        TEST_ASSERT_EQ(logs.size(), static_cast<size_t>(2));
+        TEST_ASSERT_EQ(logs[0], "inner 1\n");
+        TEST_ASSERT_EQ(logs[1], "outer 2\n");
+    }
+
+    // Likewise on an AsyncHandler's thread, even with a full queue
+    {
+        auto handler = makeHandler(logging::LogLevel::LOG_DEBUG);
+        auto pHandler = handler.get();
+        logging::AsyncHandler async(std::move(handler), 1);
+        logging::Logger log("test");
+        log.addHandler(&async);
+        for (int ii = 0; ii < 10; ++ii)
+        {
+            CODA_OSS_LOG_INFO(log, Reentrant{&log}, ' ', 2);
+        }
+        async.flush();
+
+        const auto& logs = pHandler->getLogs(logging::LogLevel::LOG_INFO);
+        TEST_ASSERT_EQ(logs.size(), static_cast<size_t>(20));
+        TEST_ASSERT_EQ(logs[0], "inner 1\n");
+        TEST_ASSERT_EQ(logs[1], "outer 2\n");
+    }
+}
+
+TEST_CASE(testTimeStamp)
+{
+    const auto expected = sys::TimeStamp(true).local();
+    const logging::LogRecord record("test", "message", logging::LogLevel::LOG_INFO);
+    TEST_ASSERT_GREATER(record.getTime(), static_cast<int64_t>(0));
+
+    // Unless the second just changed, these are the same
+    const auto& actual = record.getTimeStamp();
+    TEST_ASSERT_EQ(actual.size(), expected.size());
+    TEST_ASSERT_EQ(actual.substr(0, 14), expected.substr(0, 14));  // "mm/dd/YYYY, HH"
+
+    // A timestamp given as a string is used as-is
+    const logging::LogRecord given("test", "message", logging::LogLevel::LOG_INFO, "", "", -1, "now");
+    TEST_ASSERT_EQ(given.getTimeStamp(), "now");
+    TEST_ASSERT_EQ(given.getTime(), static_cast<int64_t>(0));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testIsEnabledFor);
+    TEST_CHECK(testDeferredMessage);
+    TEST_CHECK(testDeferredAsync);
+    TEST_CHECK(testDeferredReentrant);
+    TEST_CHECK(testTimeStamp);
+    )
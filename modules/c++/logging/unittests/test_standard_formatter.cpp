@@ -0,0 +1,75 @@
+/* =========================================================================
+ * This file is part of logging-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * logging-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <string>
+
+#include "TestCase.h"
+
+#include <io/StringStream.h>
+#include <logging/LogRecord.h>
+#include <logging/StandardFormatter.h>
+
+static std::string format(const logging::Formatter& formatter, const logging::LogRecord& record)
+{
+    io::StringStream output;
+    formatter.format(&record, output);
+    return output.stream().str();
+}
+
+TEST_CASE(testDefaultFormat)
+{
+    const logging::LogRecord record("test", "message", logging::LogLevel::LOG_INFO,
+                                    "file.cpp", "function", 42, "2025-01-02 03:04:05");
+    const logging::StandardFormatter formatter;
+    const auto threadId = std::to_string(sys::getThreadID());
+    TEST_ASSERT_EQ(format(formatter, record),
+                   "[test] INFO [" + threadId + "] 2025-01-02 03:04:05 ==> message\n");
+
+    // An unnamed record is "DEFAULT"
+    const logging::LogRecord unnamed("", "message", logging::LogLevel::LOG_WARNING);
+    const auto actual = format(formatter, unnamed);
+    TEST_ASSERT_EQ(actual.find("[DEFAULT] WARNING ["), static_cast<size_t>(0));
+}
+
+TEST_CASE(testAllFields)
+{
+    const logging::LogRecord record("test", "100% done", logging::LogLevel::LOG_ERROR,
+                                    "file.cpp", "function", 42, "now");
+    const logging::StandardFormatter formatter("%p %F:%L %M() %d %% %x %m%m %");
+    TEST_ASSERT_EQ(format(formatter, record),
+                   "ERROR file.cpp:42 function() now %% %x 100% done100% done %\n");
+
+    // Without a line number, there's no file either
+    const logging::LogRecord noLine("test", "message", logging::LogLevel::LOG_ERROR,
+                                    "file.cpp", "function", -1, "now");
+    TEST_ASSERT_EQ(format(formatter, noLine), "ERROR : function() now %% %x messagemessage %\n");
+
+    // The format string is used as-is
+    const logging::StandardFormatter literal("no fields");
+    TEST_ASSERT_EQ(format(literal, record), "no fields\n");
+}
+
+TEST_MAIN(
+    TEST_CHECK(testDefaultFormat);
+    TEST_CHECK(testAllFields);
+    )
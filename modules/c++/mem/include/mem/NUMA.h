@@ -0,0 +1,90 @@
+/* =========================================================================
+ * This file is part of mem-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, Radiant Geospatial Solutions
+ *
+ * mem-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_mem_NUMA_h_INCLUDED_
+#define CODA_OSS_mem_NUMA_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+
+#include <config/Exports.h>
+
+namespace mem
+{
+/*!
+ * Where to put newly allocated memory on a NUMA system.  Threads pinned
+ * with mt::CPUOrdering::NUMANodeFirst and allocating their own buffers
+ * will then find them on their own node.
+ *
+ * Default: leave it to the OS; pages land on the node of whichever thread
+ *          first writes to them.
+ * FirstTouch: write to every page from the allocating thread right away,
+ *             so the pages land on its node.
+ * BindToCurrentNode: bind the pages to the allocating thread's node (they
+ *                    stay there no matter who touches them first).  Only
+ *                    whole pages are bound, so the memory has to be
+ *                    allocated for it (see getNUMAPageSize()).  Falls back
+ *                    to FirstTouch if the OS doesn't support it.
+ */
+enum class NUMAPlacement
+{
+    Default,
+    FirstTouch,
+    BindToCurrentNode
+};
+
+/*!
+ * \return The page size.  BindToCurrentNode needs memory that starts on a
+ *         page boundary and is a whole number of pages long.
+ */
+CODA_OSS_API size_t getNUMAPageSize();
+
+/*!
+ * Place memory that the calling thread just allocated on the calling
+ * thread's NUMA node.
+ *
+ * \param data Start of the memory
+ * \param numBytes Size of the memory in bytes
+ * \param placement How to place it.  FirstTouch zeros a byte in each page,
+ *        so only use it on memory that doesn't hold anything yet.
+ *        BindToCurrentNode falls back to FirstTouch unless the memory is
+ *        whole pages.
+ */
+CODA_OSS_API void placeOnCurrentNUMANode(void* data,
+                                         size_t numBytes,
+                                         NUMAPlacement placement);
+
+/*!
+ * Undo placeOnCurrentNUMANode() on memory that's about to be freed.  Only
+ * BindToCurrentNode leaves anything behind: the binding belongs to the
+ * pages, so it would otherwise apply to whatever reuses them.
+ *
+ * \param data Start of the memory
+ * \param numBytes Size of the memory in bytes
+ * \param placement The placement the memory was given
+ */
+CODA_OSS_API void releaseNUMAPlacement(void* data,
+                                       size_t numBytes,
+                                       NUMAPlacement placement);
+}
+
+#endif  // CODA_OSS_mem_NUMA_h_INCLUDED_
@@ -26,12 +26,19 @@
 #include <cstddef>
 
 #include <sys/Conf.h>
+#include <mem/NUMA.h>
 
 namespace mem
 {
     /*!
      *  \class ScopedAlignedArray
      *  \brief This class provides RAII for alignedAlloc() and alignedFree()
+     *
+     *  The optional NUMAPlacement controls which NUMA node the pages end up
+     *  on; see placeOnCurrentNUMANode().  With BindToCurrentNode, the array
+     *  is allocated as whole pages, so that binding it doesn't bind anything
+     *  else, and the binding is dropped again before it's freed.  If the
+     *  array is release()'d, the binding is left to the caller.
      */
     template <class T>
     struct ScopedAlignedArray
@@ -40,9 +47,11 @@ namespace mem
 
         explicit ScopedAlignedArray(
             size_t numElements = 0,
-            size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT) :
-            mArray(allocate(numElements, alignment))
+            size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT,
+            NUMAPlacement placement = NUMAPlacement::Default) :
+            mArray(nullptr)
         {
+            allocate(numElements, alignment, placement);
         }
 
         ~ScopedAlignedArray()
@@ -53,7 +62,7 @@ namespace mem
                 // in case...
                 try
                 {
-                    sys::alignedFree(mArray);
+                    deallocate();
                 }
                 catch (...)
                 {
@@ -62,15 +71,15 @@ namespace mem
         }
 
         void reset(size_t numElements = 0, 
-                   size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT)
+                   size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT,
+                   NUMAPlacement placement = NUMAPlacement::Default)
         {
             if (mArray)
             {
-                sys::alignedFree(mArray);
-                mArray = nullptr;
+                deallocate();
             }
 
-            mArray = allocate(numElements, alignment);
+            allocate(numElements, alignment, placement);
         }
 
         T& operator[](std::ptrdiff_t idx) const
@@ -87,6 +96,7 @@ namespace mem
         {
             T* const array = mArray;
             mArray = nullptr;
+            mBoundBytes = 0;
             return array;
         }
 
@@ -94,23 +104,47 @@ namespace mem
         ScopedAlignedArray& operator=(const ScopedAlignedArray&) = delete;
 
     private:
-        static
-        T* allocate(size_t numElements, size_t alignment)
+        void allocate(size_t numElements, size_t alignment,
+                      NUMAPlacement placement)
         {
             if (numElements > 0)
             {
-                const size_t numBytes(numElements * sizeof(T));
-                return static_cast<T *>(sys::alignedAlloc(numBytes, 
-                                                          alignment));
-            }
-            else
-            {
-                return nullptr;
+                size_t numBytes(numElements * sizeof(T));
+                if (placement == NUMAPlacement::BindToCurrentNode)
+                {
+                    // Only whole pages can be bound without also binding
+                    // the neighbors
+                    const size_t pageSize = getNUMAPageSize();
+                    if (alignment < pageSize)
+                    {
+                        alignment = pageSize;
+                    }
+                    numBytes = (numBytes + pageSize - 1) / pageSize * pageSize;
+                }
+                mArray = static_cast<T *>(sys::alignedAlloc(numBytes,
+                                                           alignment));
+                if (placement == NUMAPlacement::BindToCurrentNode)
+                {
+                    mBoundBytes = numBytes;
+                }
+                placeOnCurrentNUMANode(mArray, numBytes, placement);
             }
         }
 
+        void deallocate()
+        {
+            releaseNUMAPlacement(mArray, mBoundBytes,
+                                 NUMAPlacement::BindToCurrentNode);
+            sys::alignedFree(mArray);
+            mArray = nullptr;
+            mBoundBytes = 0;
+        }
+
     private:
         T* mArray;
+
+        // The size of the allocation if it was bound to a NUMA node
+        size_t mBoundBytes = 0;
     };
 }
 
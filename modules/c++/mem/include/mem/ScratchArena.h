@@ -0,0 +1,169 @@
+/* =========================================================================
+ * This file is part of mem-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2018, MDA Information Systems LLC
+ *
+ * mem-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_mem_ScratchArena_h_INCLUDED_
+#define CODA_OSS_mem_ScratchArena_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+
+#include <config/Exports.h>
+#include <mem/BufferView.h>
+#include <sys/Conf.h>
+
+namespace mem
+{
+/*!
+ *  \class ScratchArena
+ *  \brief Bump allocator over a fixed buffer with mark/reset.
+ *
+ *  Allocations are carved off the front of the buffer in order; nothing is
+ *  freed individually.  Instead, take a mark() and reset() back to it (or
+ *  use a Scope) to free everything allocated since, in one shot.  Scopes
+ *  nest, so a per-tile Scope can contain per-row Scopes and so on.
+ *
+ *  The buffer is typically a segment of a ScratchMemory:
+ *
+ *  \code
+ *  const auto arenaHandle = scratch.put<sys::ubyte>("arena", numBytes);
+ *  scratch.setup();
+ *  mem::ScratchArena arena(scratch.getBufferView(arenaHandle));
+ *  for (each tile)
+ *  {
+ *      const mem::ScratchArena::Scope tileScope(arena);
+ *      float* temp = arena.allocate<float>(tileSize);
+ *      ...
+ *  }
+ *  \endcode
+ *
+ *  Like ScratchMemory, this isn't thread-safe; give each thread its own.
+ */
+class CODA_OSS_API ScratchArena final
+{
+public:
+    /*!
+     *  \class Scope
+     *  \brief Takes a mark() on construction and resets to it on
+     *         destruction.
+     */
+    class Scope final
+    {
+    public:
+        explicit Scope(ScratchArena& arena) :
+            mArena(arena),
+            mMark(arena.mark())
+        {
+        }
+
+        ~Scope()
+        {
+            // Someone may already have reset past us; don't throw here
+            if (mMark <= mArena.mark())
+            {
+                mArena.reset(mMark);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& mArena;
+        const size_t mMark;
+    };
+
+    /*!
+     * \param buffer Storage to allocate from.  This must outlive the arena.
+     */
+    explicit ScratchArena(const BufferView<sys::ubyte>& buffer);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /*!
+     * \brief Allocate space for numElements elements of T.  The memory is
+     *        not initialized.
+     *
+     * \param numElements Number of elements
+     * \param alignment Number of bytes to align the pointer to. Defaults to
+     *                  sys::SSE_INSTRUCTION_ALIGNMENT.
+     *
+     * \return Pointer to the elements
+     *
+     * \throws except::Exception if there isn't enough space left
+     */
+    template <typename T>
+    T* allocate(size_t numElements,
+                size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT)
+    {
+        return reinterpret_cast<T*>(
+                allocateBytes(numElements * sizeof(T), alignment));
+    }
+
+    //! \return The current position, to pass to reset() later
+    size_t mark() const
+    {
+        return mOffset;
+    }
+
+    /*!
+     * \brief Free everything allocated since mark was taken.
+     *
+     * \throws except::Exception if mark is past the current position (i.e.
+     *         marks were reset out of order)
+     */
+    void reset(size_t mark);
+
+    //! Free everything
+    void reset()
+    {
+        mOffset = 0;
+    }
+
+    //! \return The number of bytes allocated (including alignment padding)
+    size_t getNumBytesUsed() const
+    {
+        return mOffset;
+    }
+
+    //! \return The most bytes that have ever been in use at once
+    size_t getHighWaterMark() const
+    {
+        return mHighWaterMark;
+    }
+
+    //! \return The size of the underlying buffer
+    size_t getCapacity() const
+    {
+        return mBuffer.size;
+    }
+
+private:
+    sys::ubyte* allocateBytes(size_t numBytes, size_t alignment);
+
+    const BufferView<sys::ubyte> mBuffer;
+    size_t mOffset = 0;
+    size_t mHighWaterMark = 0;
+};
+}
+
+#endif  // CODA_OSS_mem_ScratchArena_h_INCLUDED_
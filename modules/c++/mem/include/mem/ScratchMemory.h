@@ -32,6 +32,8 @@
 #include <vector>
 #include <except/Exception.h>
 #include <mem/BufferView.h>
+#include <mem/NUMA.h>
+#include <mem/ScopedAlignedArray.h>
 #include <sys/Conf.h>
 #include <config/Exports.h>
 
@@ -46,10 +48,56 @@ namespace mem
  *  the underlying memory and ensure the alignment requirements of each segment.
  *  The get method may be used afterwards to obtain pointers to the memory
  *  segments.
+ *
+ *  put also returns a Handle to the segment.  Looking a segment up by
+ *  Handle is a vector index rather than a map lookup, so prefer it in inner
+ *  loops.  For temporaries whose lifetimes nest (e.g. per tile), reserve a
+ *  single segment and carve it up with a ScratchArena.
  */
 class CODA_OSS_API ScratchMemory
 {
 public:
+    /*!
+     * \class Handle
+     * \brief Identifies a segment reserved with put<T>().
+     *
+     * Handles remain valid across setup() calls and release() of other
+     * segments, but not after the segment itself is released.  A
+     * default-constructed Handle doesn't refer to any segment.
+     */
+    template <typename T>
+    class Handle final
+    {
+    public:
+        Handle() = default;
+
+        //! \return The number of elements of T in each buffer
+        size_t getNumElements() const
+        {
+            return mNumElements;
+        }
+
+        //! \return The number of distinct buffers
+        size_t getNumBuffers() const
+        {
+            return mNumBuffers;
+        }
+
+    private:
+        friend class ScratchMemory;
+
+        Handle(size_t index, size_t numBuffers, size_t numElements) :
+            mIndex(index),
+            mNumBuffers(numBuffers),
+            mNumElements(numElements)
+        {
+        }
+
+        size_t mIndex = 0;
+        size_t mNumBuffers = 0;
+        size_t mNumElements = 0;
+    };
+
     ScratchMemory() = default;
 
     /*!
@@ -61,10 +109,12 @@ public:
      * \param alignment Number of bytes to align segment pointer. Defaults to
      *                  sys::SSE_INSTRUCTION_ALIGNMENT.
      *
+     * \return Handle to the segment, for use with get() and getBufferView()
+     *
      * \throws except::Exception if the given key has already been used
      */
     template <typename T>
-    void put(const std::string& key,
+    Handle<T> put(const std::string& key,
              size_t numElements,
              size_t numBuffers = 1,
              size_t alignment = sys::SSE_INSTRUCTION_ALIGNMENT);
@@ -104,6 +154,34 @@ public:
     template <typename T>
     const T* get(const std::string& key, size_t indexBuffer = 0) const;
 
+    /*!
+     * \brief Get pointer to buffer segment.  This doesn't look up the key
+     *        or allocate.
+     *
+     * \param handle Handle returned by put<T>()
+     * \param indexBuffer Index of distinct buffer. Defaults to 0.
+     *
+     * \return Pointer to buffer segment
+     *
+     * \throws except::Exception if the scratch memory has not been set up,
+     *         the handle is invalid, or index of buffer is out of bounds
+     */
+    template <typename T>
+    T* get(const Handle<T>& handle, size_t indexBuffer = 0)
+    {
+        checkHandle(handle.mIndex, handle.mNumBuffers, indexBuffer);
+        return reinterpret_cast<T*>(mHandleBuffers[handle.mIndex + indexBuffer]);
+    }
+
+    //! \copydoc get(const Handle<T>&, size_t)
+    template <typename T>
+    const T* get(const Handle<T>& handle, size_t indexBuffer = 0) const
+    {
+        checkHandle(handle.mIndex, handle.mNumBuffers, indexBuffer);
+        return reinterpret_cast<const T*>(
+                mHandleBuffers[handle.mIndex + indexBuffer]);
+    }
+
     /*!
      * \brief Get buffer view of buffer segment.
      *
@@ -133,6 +211,32 @@ public:
     BufferView<const T> getBufferView(const std::string& key,
                                       size_t indexBuffer = 0) const;
 
+    /*!
+     * \brief Get buffer view of buffer segment.
+     *
+     * \param handle Handle returned by put<T>()
+     * \param indexBuffer Index of distinct buffer. Defaults to 0.
+     *
+     * \return Buffer view of the segment, sized in elements of T
+     *
+     * \throws except::Exception if the scratch memory has not been set up,
+     *         the handle is invalid, or index of buffer is out of bounds
+     */
+    template <typename T>
+    BufferView<T> getBufferView(const Handle<T>& handle, size_t indexBuffer = 0)
+    {
+        return BufferView<T>(get(handle, indexBuffer), handle.mNumElements);
+    }
+
+    //! \copydoc getBufferView(const Handle<T>&, size_t)
+    template <typename T>
+    BufferView<const T> getBufferView(const Handle<T>& handle,
+                                      size_t indexBuffer = 0) const
+    {
+        return BufferView<const T>(get(handle, indexBuffer),
+                                   handle.mNumElements);
+    }
+
     /*!
      * \brief Ensure underlying memory is properly set up and position segment
      *        pointers.
@@ -140,13 +244,19 @@ public:
      * \param scratchBuffer Storage to use for scratch memory. If buffer of
      *        size 0 is passed, memory is allocated internally. Defaults to
      *        an empty buffer.
+     * \param placement Which NUMA node internally allocated scratch memory
+     *        should live on; see placeOnCurrentNUMANode().  Call setup()
+     *        from the thread that will use the memory.  An external
+     *        scratchBuffer is left where it is.  Defaults to
+     *        NUMAPlacement::Default.
      *
      * \throws except::Exception if the scratchBuffer passed in is too small
      *         to hold the requested scratch memory or has size > 0 with null
      *         data pointer
      */
     void setup(const BufferView<sys::ubyte>& scratchBuffer =
-            BufferView<sys::ubyte>());
+                       BufferView<sys::ubyte>(),
+               NUMAPlacement placement = NUMAPlacement::Default);
 
     /*!
      * \brief Get number of bytes needed to store scratch memory, including the
@@ -163,24 +273,50 @@ public:
 private:
     struct CODA_OSS_API Segment final
     {
-        Segment(size_t numBytes, size_t numBuffers, size_t alignment, size_t offset);
+        Segment(size_t numBytes, size_t numBuffers, size_t alignment,
+                size_t offset, size_t handleIndex);
 
         size_t numBytes;
         size_t numBuffers;
         size_t alignment;
         size_t offset;
+        size_t handleIndex;
         std::vector<sys::ubyte*> buffers;
     };
 
     const Segment& lookupSegment(const std::string& key,
                                  size_t indexBuffer) const;
 
+    void insertSegment(const std::string& key,
+                       size_t numBytes,
+                       size_t numBuffers,
+                       size_t alignment,
+                       size_t handleIndex);
+
+    void checkHandle(size_t index, size_t numBuffers, size_t indexBuffer) const
+    {
+        if (mBuffer.data == nullptr || indexBuffer >= numBuffers ||
+            index + indexBuffer >= mHandleBuffers.size())
+        {
+            throwInvalidHandle(indexBuffer, numBuffers);
+        }
+    }
+
+    void throwInvalidHandle(size_t indexBuffer, size_t numBuffers) const;
+
     std::map<std::string, Segment> mSegments;
     std::vector<sys::ubyte> mStorage;
+
+    // Internal storage for NUMAPlacement::BindToCurrentNode, which has to
+    // own its pages outright
+    ScopedAlignedArray<sys::ubyte> mBoundStorage;
     std::vector<std::string> mKeyOrder;
     std::set<std::string> mReleasedKeys;
     std::set<std::string> mConnectedKeys;
 
+    // Buffer pointers for all segments, indexed by Handle
+    std::vector<sys::ubyte*> mHandleBuffers;
+
     BufferView<sys::ubyte> mBuffer;
     size_t mNumBytesNeeded=0;
     size_t mOffset=0;
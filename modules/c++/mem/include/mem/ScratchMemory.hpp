@@ -23,42 +23,27 @@
 namespace mem
 {
 template <typename T>
-void ScratchMemory::put(const std::string& key,
-                        size_t numElements,
-                        size_t numBuffers,
-                        size_t alignment)
+ScratchMemory::Handle<T> ScratchMemory::put(const std::string& key,
+                                            size_t numElements,
+                                            size_t numBuffers,
+                                            size_t alignment)
 {
-    put<sys::ubyte>(key, numElements * sizeof(T), numBuffers, alignment);
+    const Handle<sys::ubyte> handle =
+            put<sys::ubyte>(key, numElements * sizeof(T), numBuffers, alignment);
+    return Handle<T>(handle.mIndex, numBuffers, numElements);
 }
 
 template <>
-inline void ScratchMemory::put<sys::ubyte>(const std::string& key,
-                                           size_t numElements,
-                                           size_t numBuffers,
-                                           size_t alignment)
+inline ScratchMemory::Handle<sys::ubyte> ScratchMemory::put<sys::ubyte>(
+        const std::string& key,
+        size_t numElements,
+        size_t numBuffers,
+        size_t alignment)
 {
-    // invalidate buffer (setup must be called before any subsequent get call)
-    mBuffer.data = nullptr;
-
-    size_t segmentOffset = mOffset;
-
-    alignment = std::max<size_t>(1, alignment);
-    mOffset += numBuffers * (numElements + alignment - 1);
-
-    mNumBytesNeeded = std::max<size_t>(mNumBytesNeeded, mOffset);
-
-    std::map<std::string, Segment>::iterator iterSeg = mSegments.find(key);
-    if (iterSeg != mSegments.end())
-    {
-        std::ostringstream oss;
-        oss << "Scratch memory space was already reserved for " << key;
-        throw except::Exception(Ctxt(oss));
-    }
-    mSegments.insert(
-            iterSeg,
-            std::make_pair(key, Segment(numElements, numBuffers, alignment, segmentOffset)));
-
-    mKeyOrder.push_back(key);
+    const size_t handleIndex = mHandleBuffers.size();
+    insertSegment(key, numElements, numBuffers, alignment, handleIndex);
+    mHandleBuffers.resize(handleIndex + numBuffers, nullptr);
+    return Handle<sys::ubyte>(handleIndex, numBuffers, numElements);
 }
 
 template <typename T>
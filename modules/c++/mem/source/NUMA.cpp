@@ -0,0 +1,91 @@
+/* =========================================================================
+ * This file is part of mem-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2020, Radiant Geospatial Solutions
+ *
+ * mem-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <mem/NUMA.h>
+
+#include <sys/Conf.h>
+#include <sys/OS.h>
+
+namespace
+{
+// Large enough for any page size we're likely to see; touching more often
+// than necessary is harmless.
+constexpr size_t touchStride = 4096;
+
+void touchPages(void* data, size_t numBytes)
+{
+    sys::ubyte* const bytes = static_cast<sys::ubyte*>(data);
+    for (size_t offset = 0; offset < numBytes; offset += touchStride)
+    {
+        bytes[offset] = 0;
+    }
+    bytes[numBytes - 1] = 0;
+}
+}
+
+namespace mem
+{
+size_t getNUMAPageSize()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void placeOnCurrentNUMANode(void* data,
+                            size_t numBytes,
+                            NUMAPlacement placement)
+{
+    if (data == nullptr || numBytes == 0 ||
+        placement == NUMAPlacement::Default)
+    {
+        return;
+    }
+
+    if (placement == NUMAPlacement::BindToCurrentNode)
+    {
+        const sys::OS os;
+        if (os.bindToNUMANode(data, numBytes, os.getCurrentNUMANode()))
+        {
+            return;
+        }
+    }
+    touchPages(data, numBytes);
+}
+
+void releaseNUMAPlacement(void* data,
+                          size_t numBytes,
+                          NUMAPlacement placement)
+{
+    if (data != nullptr && numBytes != 0 &&
+        placement == NUMAPlacement::BindToCurrentNode)
+    {
+        // If it couldn't be bound, this fails too, which is fine
+        const sys::OS os;
+        os.unbindFromNUMANode(data, numBytes);
+    }
+}
+}
@@ -0,0 +1,74 @@
+/* =========================================================================
+ * This file is part of mem-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2018, MDA Information Systems LLC
+ *
+ * mem-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <mem/ScratchArena.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <except/Exception.h>
+
+namespace mem
+{
+ScratchArena::ScratchArena(const BufferView<sys::ubyte>& buffer) :
+    mBuffer(buffer)
+{
+    if (mBuffer.size > 0 && mBuffer.data == nullptr)
+    {
+        throw except::Exception(Ctxt("Invalid buffer was provided"));
+    }
+}
+
+sys::ubyte* ScratchArena::allocateBytes(size_t numBytes, size_t alignment)
+{
+    alignment = std::max<size_t>(1, alignment);
+
+    const size_t address = reinterpret_cast<size_t>(mBuffer.data) + mOffset;
+    const size_t padding = (alignment - address % alignment) % alignment;
+    if (padding > mBuffer.size - mOffset ||
+        numBytes > mBuffer.size - mOffset - padding)
+    {
+        std::ostringstream oss;
+        oss << "Scratch arena has insufficient space for " << numBytes
+            << " bytes (" << mBuffer.size - mOffset << " of "
+            << mBuffer.size << " bytes free)";
+        throw except::Exception(Ctxt(oss));
+    }
+
+    sys::ubyte* const data = mBuffer.data + mOffset + padding;
+    mOffset += padding + numBytes;
+    mHighWaterMark = std::max(mHighWaterMark, mOffset);
+    return data;
+}
+
+void ScratchArena::reset(size_t mark)
+{
+    if (mark > mOffset)
+    {
+        std::ostringstream oss;
+        oss << "Tried to reset scratch arena to " << mark
+            << " which is past the current position " << mOffset;
+        throw except::Exception(Ctxt(oss));
+    }
+    mOffset = mark;
+}
+}
@@ -19,6 +19,8 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
+
 #include <mem/Align.h>
 
 #include <mem/ScratchMemory.h>
@@ -29,12 +31,45 @@ namespace mem
 ScratchMemory::Segment::Segment(size_t numBytes_,
                                 size_t numBuffers_,
                                 size_t alignment_,
-                                size_t offset_) :
+                                size_t offset_,
+                                size_t handleIndex_) :
     numBytes(numBytes_),
     numBuffers(numBuffers_),
     alignment(alignment_),
-    offset(offset_)
+    offset(offset_),
+    handleIndex(handleIndex_)
+{
+}
+
+void ScratchMemory::insertSegment(const std::string& key,
+                                  size_t numElements,
+                                  size_t numBuffers,
+                                  size_t alignment,
+                                  size_t handleIndex)
 {
+    // invalidate buffer (setup must be called before any subsequent get call)
+    mBuffer.data = nullptr;
+
+    size_t segmentOffset = mOffset;
+
+    alignment = std::max<size_t>(1, alignment);
+    mOffset += numBuffers * (numElements + alignment - 1);
+
+    mNumBytesNeeded = std::max<size_t>(mNumBytesNeeded, mOffset);
+
+    std::map<std::string, Segment>::iterator iterSeg = mSegments.find(key);
+    if (iterSeg != mSegments.end())
+    {
+        std::ostringstream oss;
+        oss << "Scratch memory space was already reserved for " << key;
+        throw except::Exception(Ctxt(oss));
+    }
+    mSegments.insert(
+            iterSeg,
+            std::make_pair(key, Segment(numElements, numBuffers, alignment,
+                                        segmentOffset, handleIndex)));
+
+    mKeyOrder.push_back(key);
 }
 
 void ScratchMemory::release(const std::string& key)
@@ -116,6 +151,7 @@ void ScratchMemory::release(const std::string& key)
             const size_t numElements = segmentToBeMoved.numBytes;
             const size_t numBuffers = segmentToBeMoved.numBuffers;
             const size_t alignment = segmentToBeMoved.alignment;
+            const size_t handleIndex = segmentToBeMoved.handleIndex;
 
             mSegments.erase(*nextKeyIter);
             std::string keyToInsert = *nextKeyIter;
@@ -154,7 +190,8 @@ void ScratchMemory::release(const std::string& key)
                 firstReleasedKey.clear();
             }
 
-            put<sys::ubyte>(keyToInsert, numElements, numBuffers, alignment);
+            insertSegment(keyToInsert, numElements, numBuffers, alignment,
+                          handleIndex);
 
         }
         std::map<std::string, Segment>::const_iterator iterSegNew =
@@ -164,11 +201,24 @@ void ScratchMemory::release(const std::string& key)
     }
 }
 
-void ScratchMemory::setup(const BufferView<sys::ubyte>& scratchBuffer)
+void ScratchMemory::setup(const BufferView<sys::ubyte>& scratchBuffer,
+                          NUMAPlacement placement)
 {
-    if (scratchBuffer.size == 0)
+    if (scratchBuffer.size == 0 && placement == NUMAPlacement::BindToCurrentNode)
     {
-        // allocate the storage internally
+        // allocate whole pages of storage internally and bind them, then
+        // zero them like the vector below would
+        std::vector<sys::ubyte>().swap(mStorage);
+        mBoundStorage.reset(mNumBytesNeeded, sys::SSE_INSTRUCTION_ALIGNMENT,
+                            placement);
+        std::fill_n(mBoundStorage.get(), mNumBytesNeeded, static_cast<sys::ubyte>(0));
+        mBuffer = mem::BufferView<sys::ubyte>(mBoundStorage.get(), mNumBytesNeeded);
+    }
+    else if (scratchBuffer.size == 0)
+    {
+        // allocate the storage internally; resizing zeros it, which is
+        // already a first touch from this thread
+        mBoundStorage.reset();
         mStorage.resize(mNumBytesNeeded);
         mBuffer = mem::BufferView<sys::ubyte>(mStorage.data(), mStorage.size());
     }
@@ -185,6 +235,7 @@ void ScratchMemory::setup(const BufferView<sys::ubyte>& scratchBuffer)
             throw except::Exception(Ctxt(
                     "Invalid external buffer was provided"));
         }
+        // it's the caller's memory, so it's also the caller's placement
         mBuffer = scratchBuffer;
     }
 
@@ -201,10 +252,31 @@ void ScratchMemory::setup(const BufferView<sys::ubyte>& scratchBuffer)
             align(&segment.buffers[i], segment.alignment);
             currentOffset = segment.buffers[i] + segment.numBytes -
                     mBuffer.data;
+            mHandleBuffers[segment.handleIndex + i] = segment.buffers[i];
         }
     }
 }
 
+void ScratchMemory::throwInvalidHandle(size_t indexBuffer,
+                                       size_t numBuffers) const
+{
+    std::ostringstream oss;
+    if (mBuffer.data == nullptr)
+    {
+        oss << "Tried to get scratch memory before running setup.";
+    }
+    else if (numBuffers == 0)
+    {
+        oss << "Tried to get scratch memory with an invalid handle.";
+    }
+    else
+    {
+        oss << "Trying to get buffer index " << indexBuffer
+            << " for a handle which has only " << numBuffers << " buffers";
+    }
+    throw except::Exception(Ctxt(oss));
+}
+
 const ScratchMemory::Segment& ScratchMemory::lookupSegment(
         const std::string& key,
         size_t indexBuffer) const
@@ -21,9 +21,12 @@
  */
 
 #include <mem/ScratchMemory.h>
+#include <mem/ScratchArena.h>
 
 #include <mem/BufferView.h>
+#include <mem/ScopedAlignedArray.h>
 #include <sys/Conf.h>
+#include <sys/OS.h>
 #include <cstdlib>
 #include <algorithm>
 #include <vector>
@@ -621,6 +624,140 @@ TEST_CASE(testScratchMemory)
     TEST_EXCEPTION(scratch.setup(invalidBuffer));
 }
 
+TEST_CASE(testNUMAPlacement)
+{
+    // We can't tell where the pages end up, but every placement should
+    // leave usable memory behind
+    const mem::NUMAPlacement placements[] = {
+            mem::NUMAPlacement::Default,
+            mem::NUMAPlacement::FirstTouch,
+            mem::NUMAPlacement::BindToCurrentNode};
+    for (const auto placement : placements)
+    {
+        mem::ScratchMemory scratch;
+        scratch.put<int>("ints", 100000);
+        scratch.put<double>("doubles", 3, 2);
+        scratch.setup(mem::BufferView<sys::ubyte>(), placement);
+
+        int* const ints = scratch.get<int>("ints");
+        std::fill_n(ints, 100000, 7);
+        TEST_ASSERT_EQ(ints[99999], 7);
+        scratch.get<double>("doubles", 1)[2] = 1.5;
+        TEST_ASSERT_EQ(scratch.get<double>("doubles", 1)[2], 1.5);
+
+        // External buffers are the caller's; they're left alone
+        std::vector<sys::ubyte> external(scratch.getNumBytes(), 0xAB);
+        scratch.setup(mem::BufferView<sys::ubyte>(external.data(),
+                                                  external.size()),
+                      placement);
+        TEST_ASSERT_EQ(scratch.get<int>("ints") -
+                               reinterpret_cast<int*>(external.data()) < 16,
+                       true);
+        TEST_ASSERT(std::all_of(external.begin(), external.end(),
+                                [](sys::ubyte b) { return b == 0xAB; }));
+
+        mem::ScopedAlignedArray<float> array(123457,
+                                             sys::SSE_INSTRUCTION_ALIGNMENT,
+                                             placement);
+        TEST_ASSERT_NOT_NULL(array.get());
+        std::fill_n(array.get(), 123457, 1.0f);
+        TEST_ASSERT_EQ(array[123456], 1.0f);
+
+        array.reset(10, sys::SSE_INSTRUCTION_ALIGNMENT, placement);
+        array[9] = 2.0f;
+        TEST_ASSERT_EQ(array[9], 2.0f);
+
+        // Bound arrays get pages of their own
+        if (placement == mem::NUMAPlacement::BindToCurrentNode)
+        {
+            TEST_ASSERT_EQ(reinterpret_cast<uintptr_t>(array.get()) %
+                                   mem::getNUMAPageSize(),
+                           static_cast<uintptr_t>(0));
+        }
+    }
+
+    // Memory that shares its pages with something else is never bound
+    const size_t pageSize = mem::getNUMAPageSize();
+    mem::ScopedAlignedArray<sys::ubyte> pages(3 * pageSize, pageSize);
+    const sys::OS os;
+    TEST_ASSERT_FALSE(os.bindToNUMANode(pages.get() + 1, pageSize, 0));
+    TEST_ASSERT_FALSE(os.bindToNUMANode(pages.get(), pageSize + 1, 0));
+    TEST_ASSERT_FALSE(os.unbindFromNUMANode(pages.get() + 1, pageSize));
+}
+
+TEST_CASE(testHandles)
+{
+    mem::ScratchMemory scratch;
+    const auto hBuf0 = scratch.put<sys::ubyte>("buf0", 11, 1, 13);
+    const auto hBuf1 = scratch.put<int>("buf1", 17, 1, 1);
+    const auto hBuf2 = scratch.put<double>("buf2", 29, 3, 8);
+    TEST_ASSERT_EQ(hBuf1.getNumElements(), static_cast<size_t>(17));
+    TEST_ASSERT_EQ(hBuf2.getNumBuffers(), static_cast<size_t>(3));
+
+    // not set up yet
+    TEST_EXCEPTION(scratch.get(hBuf0));
+
+    scratch.setup();
+    TEST_ASSERT_EQ(scratch.get(hBuf0), scratch.get<sys::ubyte>("buf0"));
+    TEST_ASSERT_EQ(scratch.get(hBuf1), scratch.get<int>("buf1"));
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        TEST_ASSERT_EQ(scratch.get(hBuf2, ii), scratch.get<double>("buf2", ii));
+    }
+    TEST_EXCEPTION(scratch.get(hBuf2, 3));
+    TEST_EXCEPTION(scratch.get(mem::ScratchMemory::Handle<int>()));
+
+    const mem::BufferView<double> view = scratch.getBufferView(hBuf2, 1);
+    TEST_ASSERT_EQ(view.data, scratch.get(hBuf2, 1));
+    TEST_ASSERT_EQ(view.size, static_cast<size_t>(29));
+
+    const mem::ScratchMemory& constScratch = scratch;
+    TEST_ASSERT_EQ(constScratch.get(hBuf1), scratch.get<int>("buf1"));
+
+    // handles survive other segments being released and moved around
+    scratch.release("buf0");
+    const auto hBuf3 = scratch.put<float>("buf3", 5);
+    scratch.setup();
+    TEST_ASSERT_EQ(scratch.get(hBuf1), scratch.get<int>("buf1"));
+    TEST_ASSERT_EQ(scratch.get(hBuf2, 2), scratch.get<double>("buf2", 2));
+    TEST_ASSERT_EQ(scratch.get(hBuf3), scratch.get<float>("buf3"));
+}
+
+TEST_CASE(testScratchArena)
+{
+    std::vector<sys::ubyte> storage(1024);
+    mem::ScratchArena arena(mem::BufferView<sys::ubyte>(storage.data(),
+                                                        storage.size()));
+    TEST_ASSERT_EQ(arena.getCapacity(), static_cast<size_t>(1024));
+
+    int* const ints = arena.allocate<int>(10, 16);
+    TEST_ASSERT_EQ(reinterpret_cast<size_t>(ints) % 16, static_cast<size_t>(0));
+    const size_t outerMark = arena.mark();
+    {
+        const mem::ScratchArena::Scope tileScope(arena);
+        double* const doubles = arena.allocate<double>(20);
+        TEST_ASSERT_TRUE(reinterpret_cast<sys::ubyte*>(doubles) >=
+                reinterpret_cast<sys::ubyte*>(ints + 10));
+        {
+            const mem::ScratchArena::Scope rowScope(arena);
+            arena.allocate<sys::ubyte>(100);
+        }
+        // the inner scope's memory gets reused
+        sys::ubyte* const bytes = arena.allocate<sys::ubyte>(100, 1);
+        TEST_ASSERT_EQ(bytes, reinterpret_cast<sys::ubyte*>(doubles + 20));
+    }
+    TEST_ASSERT_EQ(arena.mark(), outerMark);
+    TEST_ASSERT_TRUE(arena.getHighWaterMark() >= outerMark + 20 * sizeof(double) + 100);
+
+    // out of space, and resetting past the current position
+    TEST_EXCEPTION(arena.allocate<sys::ubyte>(1024));
+    TEST_EXCEPTION(arena.reset(arena.mark() + 1));
+
+    arena.reset();
+    TEST_ASSERT_EQ(arena.getNumBytesUsed(), static_cast<size_t>(0));
+    TEST_ASSERT_NOT_NULL(arena.allocate<sys::ubyte>(1024, 1));
+}
+
 TEST_MAIN(
     TEST_CHECK(testScratchMemory);
     TEST_CHECK(testReleaseSingleEndBuffer);
@@ -630,4 +767,7 @@ TEST_MAIN(
     TEST_CHECK(testReleaseConcurrentKeys);
     TEST_CHECK(testReleaseConnectedKeys);
     TEST_CHECK(testGenerateBuffersForRelease);
+    TEST_CHECK(testNUMAPlacement);
+    TEST_CHECK(testHandles);
+    TEST_CHECK(testScratchArena);
     )
@@ -31,6 +31,7 @@
 #endif // _MSC_VER
 
 #include "mt/RequestQueue.h"
+#include "mt/BoundedRequestQueue.h"
 #include "mt/ThreadPoolException.h"
 #include "mt/BasicThreadPool.h"
 #include "mt/GenericRequestHandler.h"
@@ -46,6 +47,7 @@
 #include "mt/Runnable1D.h"
 #include "mt/BalancedRunnable1D.h"
 #include "mt/WorkSharingBalancedRunnable1D.h"
+#include "mt/WorkStealingExecutor.h"
 
 #include "mt/CPUAffinityInitializer.h"
 #include "mt/CPUAffinityThreadInitializer.h"
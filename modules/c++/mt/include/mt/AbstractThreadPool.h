@@ -46,8 +46,13 @@ namespace mt
  *  in order to clarify the derived type of WorkerThread's
  *  performTask() behavior.  
  *
+ *  RequestQueue_T may be any queue with RequestQueue's interface, such
+ *  as BoundedRequestQueue.
+ *
  */
-template <typename Request_T> class AbstractThreadPool
+template <typename Request_T,
+          typename RequestQueue_T = mt::RequestQueue<Request_T> >
+class AbstractThreadPool
 {
 public:
 
@@ -92,7 +97,7 @@ public:
     *  function can be derived to produce a pointer to the base class, 
     *  pointing at the newly derived worker thread.
     */
-    virtual WorkerThread<Request_T>* newWorker() = 0;
+    virtual WorkerThread<Request_T, RequestQueue_T>* newWorker() = 0;
 
     /*!
     *  Wait on all the threads in a pool.  If the WorkerThread<T>'s run()
@@ -139,7 +144,7 @@ protected:
 
     size_t mNumThreads;
     std::vector<std::shared_ptr<sys::Thread>> mPool;
-    mt::RequestQueue<Request_T> mRequestQueue;
+    RequestQueue_T mRequestQueue;
 };
 }
 
@@ -22,6 +22,7 @@
 #ifndef __MT_BALANCED_RUNNABLE_1D_H__
 #define __MT_BALANCED_RUNNABLE_1D_H__
 
+#include <algorithm>
 #include <vector>
 #include <sstream>
 
@@ -38,10 +39,15 @@ namespace mt
  *  \class BalancedRunnable1D
  *  \tparam OpT The type of functor that will be used to process elements
  *
- *  Given a reference to an atomic counter, this runnable will
- *  atomically get and then increment an element, passing the fetched element
- *  to the provided functor for processing. Each runnable will operate over
- *  the full range of elements.
+ *  Given a ThreadPlanner shared by all the runnables, this runnable will
+ *  repeatedly claim the next chunk of elements with getNextChunk(),
+ *  passing each element in the chunk to the provided functor for
+ *  processing.  Each runnable will operate over the full range of
+ *  elements.
+ *
+ *  Given a reference to an atomic counter instead, it claims one element
+ *  at a time.  That takes an atomic operation per element, which can cost
+ *  more than the work when each element is cheap.
  *
  *  This runnable is useful in cases where work needs to be
  *  done across a range of elements, but when dividing these elements
@@ -69,16 +75,47 @@ public:
                        sys::AtomicCounter& atomicCounter,
                        const OpT& op) :
         mNumElements(numElements),
-        mCounter(atomicCounter),
+        mCounter(&atomicCounter),
+        mOp(op)
+    {
+    }
+
+    /*!
+     *  Constructor
+     *
+     *  \param[in,out] planner Planner all threads will use to claim
+     *  chunks of elements to process
+     *
+     *  \param op Functor to use
+     *
+     */
+    BalancedRunnable1D(ThreadPlanner& planner, const OpT& op) :
+        mNumElements(0),
+        mPlanner(&planner),
         mOp(op)
     {
     }
 
     virtual void run() override
     {
+        if (mPlanner)
+        {
+            size_t startElement = 0;
+            size_t numElementsThisChunk = 0;
+            while (mPlanner->getNextChunk(startElement, numElementsThisChunk))
+            {
+                const size_t endElement = startElement + numElementsThisChunk;
+                for (size_t element = startElement; element < endElement; ++element)
+                {
+                    mOp(element);
+                }
+            }
+            return;
+        }
+
         while (true)
         {
-            const size_t element = mCounter.getThenIncrement();
+            const size_t element = mCounter->getThenIncrement();
             if (element < mNumElements)
             {
                 mOp(element);
@@ -92,15 +129,16 @@ public:
 
 private:
     const size_t mNumElements;
-    sys::AtomicCounter& mCounter;
+    sys::AtomicCounter* mCounter = nullptr;
+    ThreadPlanner* mPlanner = nullptr;
     const OpT& mOp;
 };
 
 /*!
- *  This method creates an atomic counter that will be shared across threads
- *  and used to fetch elements within a global range. Each thread will
- *  process fetched elements using the provided functor until all elements
- *  have been processed.
+ *  This method creates a ThreadPlanner that will be shared across threads
+ *  and used to claim chunks of elements within a global range. Each thread
+ *  will process claimed elements using the provided functor until all
+ *  elements have been processed.
  *
  *  Rather than divide the range of elements across threads, each thread
  *  will remain active until every element within the global range has been
@@ -110,29 +148,35 @@ private:
  *  all threads will participate equally in grabbing any available work
  *  across the global range.
  *
+ *  Chunks follow a Schedule::GUIDED schedule: they start at the remaining
+ *  elements divided by the number of threads and shrink towards the end,
+ *  but are never smaller than grainSize (except for the last one).
+ *
  *  \tparam OpT The type of functor that will be used to process elements
  *
  *  \param numElements Number of elements of work
  *  \param numThreads Number of threads
  *  \param op Functor to use
+ *  \param grainSize The smallest number of elements to claim at a time
  */
 template <typename OpT>
 void runBalanced1D(size_t numElements,
                    size_t numThreads,
-                   const OpT& op)
+                   const OpT& op,
+                   size_t grainSize = 1)
 {
-    sys::AtomicCounter counter(0);
+    ThreadPlanner planner(numElements, std::max<size_t>(numThreads, 1),
+                          Schedule(Schedule::GUIDED, grainSize));
     if (numThreads <= 1)
     {
-        BalancedRunnable1D<OpT>(numElements, counter, op).run();
+        BalancedRunnable1D<OpT>(planner, op).run();
     }
     else
     {
         ThreadGroup threads;
         for (size_t ii = 0; ii < numThreads; ++ii)
         {
-            threads.createThread(new BalancedRunnable1D<OpT>(
-                     numElements, counter, op));
+            threads.createThread(new BalancedRunnable1D<OpT>(planner, op));
         }
         threads.joinAll();
     }
@@ -147,13 +191,14 @@ void runBalanced1D(size_t numElements,
  *  \param numElements Number of elements of work
  *  \param numThreads Number of threads
  *  \param ops Vector of functors to use
+ *  \param grainSize The smallest number of elements to claim at a time
  */
 template <typename OpT>
 void runBalanced1D(size_t numElements,
                    size_t numThreads,
-                   const std::vector<OpT>& ops)
+                   const std::vector<OpT>& ops,
+                   size_t grainSize = 1)
 {
-    sys::AtomicCounter counter(0);
     if (ops.size() != numThreads)
     {
         std::ostringstream ostr;
@@ -162,17 +207,18 @@ void runBalanced1D(size_t numElements,
         throw except::Exception(Ctxt(ostr));
     }
 
+    ThreadPlanner planner(numElements, std::max<size_t>(numThreads, 1),
+                          Schedule(Schedule::GUIDED, grainSize));
     if (numThreads <= 1)
     {
-        BalancedRunnable1D<OpT>(numElements, counter, ops[0]).run();
+        BalancedRunnable1D<OpT>(planner, ops[0]).run();
     }
     else
     {
         ThreadGroup threads;
         for (size_t ii = 0; ii < numThreads; ++ii)
         {
-            threads.createThread(new BalancedRunnable1D<OpT>(
-                    numElements, counter, ops[ii]));
+            threads.createThread(new BalancedRunnable1D<OpT>(planner, ops[ii]));
         }
 
         threads.joinAll();
@@ -189,14 +235,16 @@ void runBalanced1D(size_t numElements,
  *  \param numElements Number of elements of work
  *  \param numThreads Number of threads
  *  \param op Functor to use
+ *  \param grainSize The smallest number of elements to claim at a time
  */
 template <typename OpT>
 void runBalanced1DWithCopies(size_t numElements,
                              size_t numThreads,
-                             const OpT& op)
+                             const OpT& op,
+                             size_t grainSize = 1)
 {
     const std::vector<OpT> ops(numThreads, op);
-    runBalanced1D(numElements, numThreads, ops);
+    runBalanced1D(numElements, numThreads, ops, grainSize);
 }
 }
 
@@ -30,13 +30,24 @@
 #include "sys/Mutex.h"
 #include "sys/Thread.h"
 #include "mt/RequestQueue.h"
+#include "mt/BoundedRequestQueue.h"
 #include "mt/GenericRequestHandler.h"
 #include "mt/ThreadPoolException.h"
 #include "mem/SharedPtr.h"
 
 namespace mt
 {
-template<typename RequestHandler_T>
+/*!
+ *  \class BasicThreadPool
+ *  \brief Thread pool whose threads each run a RequestHandler_T, which
+ *  pulls sys::Runnable's off a shared request queue.
+ *
+ *  RequestQueue_T may be RunnableRequestQueue (the default) or any queue
+ *  with the same interface, such as BoundedRunnableRequestQueue.
+ *  RequestHandler_T is constructed from a pointer to the queue.
+ */
+template<typename RequestHandler_T,
+         typename RequestQueue_T = RunnableRequestQueue>
 struct BasicThreadPool
 {
     /*! Constructor.  Set up the thread pool.
@@ -150,7 +161,7 @@ protected:
     bool mStarted = false;
     size_t mNumThreads = 0;
     std::vector<std::shared_ptr<sys::Thread>> mPool;
-    mt::RunnableRequestQueue mHandlerQueue;
+    RequestQueue_T mHandlerQueue;
 
 private:
     void addThread()
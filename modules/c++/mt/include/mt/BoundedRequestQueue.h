@@ -0,0 +1,356 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_mt_BoundedRequestQueue_h_INCLUDED_
+#define CODA_OSS_mt_BoundedRequestQueue_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "sys/Runnable.h"
+
+namespace mt
+{
+/*!
+ *  \class BoundedRequestQueue
+ *  \brief Fixed-capacity, lock-free multi-producer/multi-consumer queue
+ *
+ *  This has the same interface as RequestQueue, so it can be used in its
+ *  place (e.g. as the RequestQueue_T of BasicThreadPool or
+ *  GenerationThreadPoolT), but enqueue() and dequeue() don't take a lock.
+ *  The queue is a ring of cells, each with a sequence number that tells
+ *  producers and consumers whether it is free or full for the current
+ *  lap around the ring (D. Vyukov's bounded MPMC queue).
+ *
+ *  Unlike RequestQueue, the capacity is fixed: enqueue() blocks while the
+ *  queue is full.  Don't fill a queue that nobody is draining yet (e.g.
+ *  before a thread pool is started) past its capacity.
+ *
+ *  Blocked callers spin for a while before sleeping on a condition
+ *  variable.  The number of spins adapts: it grows when spinning pays off
+ *  and shrinks when callers end up sleeping anyway.  The condition
+ *  variables are only signaled if someone is actually asleep.
+ */
+template <typename T>
+class BoundedRequestQueue final
+{
+public:
+    static constexpr size_t defaultCapacity = 1024;
+
+    /*!
+     *  Constructor
+     *  \param capacity The maximum number of items in the queue.  This is
+     *  rounded up to a power of two.
+     */
+    explicit BoundedRequestQueue(size_t capacity = defaultCapacity) :
+        mMask(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1),
+        mCells(new Cell[mMask + 1])
+    {
+        for (size_t ii = 0; ii <= mMask; ++ii)
+        {
+            mCells[ii].mSequence.store(ii, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedRequestQueue(const BoundedRequestQueue&) = delete;
+    BoundedRequestQueue& operator=(const BoundedRequestQueue&) = delete;
+
+    //! Put a (copy of, unless T is a pointer) request on the queue.  Blocks
+    //! while the queue is full.
+    void enqueue(T request)
+    {
+        waitFor(mNotFull, [&]() { return tryEnqueue(request); },
+                std::chrono::steady_clock::time_point::max());
+    }
+
+    //! Retrieve (by reference) T from the queue.  Blocks until there is one.
+    void dequeue(T& request)
+    {
+        waitFor(mNotEmpty, [&]() { return tryDequeue(request); },
+                std::chrono::steady_clock::time_point::max());
+    }
+
+    /*!
+     *  Put a request on the queue if there's room.
+     *  \return true if the request was queued, false if the queue was full
+     */
+    bool tryEnqueue(const T& request)
+    {
+        size_t pos = mEnqueue.mValue.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            const size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                    static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueue.mValue.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueue.mValue.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->mData = request;
+        cell->mSequence.store(pos + 1, std::memory_order_release);
+        wakeOne(mNotEmpty);
+        return true;
+    }
+
+    /*!
+     *  Retrieve a request from the queue if there is one.
+     *  \return true if request was set, false if the queue was empty
+     */
+    bool tryDequeue(T& request)
+    {
+        size_t pos = mDequeue.mValue.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            const size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                    static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (mDequeue.mValue.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mDequeue.mValue.load(std::memory_order_relaxed);
+            }
+        }
+
+        request = std::move(cell->mData);
+        cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+        wakeOne(mNotFull);
+        return true;
+    }
+
+    /*!
+     *  Put a request on the queue, waiting up to timeout for there to be
+     *  room.
+     *  \return true if the request was queued, false if it timed out
+     */
+    template <typename Rep, typename Period>
+    bool tryEnqueueFor(T request,
+                       const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return waitFor(mNotFull, [&]() { return tryEnqueue(request); },
+                       std::chrono::steady_clock::now() + timeout);
+    }
+
+    /*!
+     *  Retrieve a request from the queue, waiting up to timeout for one to
+     *  show up.
+     *  \return true if request was set, false if it timed out
+     */
+    template <typename Rep, typename Period>
+    bool tryDequeueFor(T& request,
+                       const std::chrono::duration<Rep, Period>& timeout)
+    {
+        return waitFor(mNotEmpty, [&]() { return tryDequeue(request); },
+                       std::chrono::steady_clock::now() + timeout);
+    }
+
+    //! Check to see if it's empty.  Only a snapshot if there are other
+    //! threads using the queue.
+    bool isEmpty() const
+    {
+        return length() == 0;
+    }
+
+    //! Check the length.  Only a snapshot if there are other threads using
+    //! the queue.
+    int length() const
+    {
+        const size_t dequeuePos = mDequeue.mValue.load(std::memory_order_acquire);
+        const size_t enqueuePos = mEnqueue.mValue.load(std::memory_order_acquire);
+        return enqueuePos > dequeuePos ?
+                static_cast<int>(std::min(enqueuePos - dequeuePos, capacity())) : 0;
+    }
+
+    //! \return The maximum number of items the queue will hold
+    size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+    //! Discard everything currently on the queue
+    void clear()
+    {
+        T request;
+        while (tryDequeue(request))
+        {
+        }
+    }
+
+private:
+    static constexpr size_t cacheLineSize = 64;
+    static constexpr size_t minSpins = 16;
+    static constexpr size_t maxSpins = 4096;
+
+    struct Cell final
+    {
+        std::atomic<size_t> mSequence;
+        T mData;
+    };
+
+    // Keeps the producer and consumer positions on their own cache lines
+    // so producers and consumers don't falsely share them.
+    struct Position final
+    {
+        std::atomic<size_t> mValue{0};
+        char mPadding[cacheLineSize - sizeof(std::atomic<size_t>)];
+    };
+
+    struct Waiters final
+    {
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::atomic<size_t> mCount{0};
+        std::atomic<size_t> mEpoch{0};
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void wakeOne(Waiters& waiters)
+    {
+        // Pairs with the fence in waitFor(): either the sleeper sees our
+        // update or we see that it's waiting.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.mCount.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(waiters.mMutex);
+            waiters.mEpoch.fetch_add(1, std::memory_order_release);
+            waiters.mCondition.notify_one();
+        }
+    }
+
+    // Calls tryOnce() until it succeeds or the deadline passes; spins for
+    // a while, then sleeps until wakeOne() is called on waiters.  tryOnce()
+    // is never called with a lock held.
+    template <typename TryT>
+    bool waitFor(Waiters& waiters,
+                 const TryT& tryOnce,
+                 const std::chrono::steady_clock::time_point& deadline)
+    {
+        const size_t spins = mSpins.load(std::memory_order_relaxed);
+        for (size_t ii = 0; ii < spins; ++ii)
+        {
+            if (tryOnce())
+            {
+                if (ii > spins / 2)
+                {
+                    mSpins.store(spins * 2 < maxSpins ? spins * 2 : maxSpins,
+                                 std::memory_order_relaxed);
+                }
+                return true;
+            }
+            std::this_thread::yield();
+        }
+
+        // Spinning didn't pay off this time
+        mSpins.store(spins / 2 > minSpins ? spins / 2 : minSpins,
+                     std::memory_order_relaxed);
+
+        bool done = false;
+        waiters.mCount.fetch_add(1, std::memory_order_relaxed);
+        while (true)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const size_t epoch = waiters.mEpoch.load(std::memory_order_acquire);
+            if (tryOnce())
+            {
+                done = true;
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(waiters.mMutex);
+            const auto woken = [&]()
+            {
+                return waiters.mEpoch.load(std::memory_order_acquire) != epoch;
+            };
+            if (deadline == std::chrono::steady_clock::time_point::max())
+            {
+                waiters.mCondition.wait(lock, woken);
+            }
+            else if (!waiters.mCondition.wait_until(lock, deadline, woken))
+            {
+                lock.unlock();
+                done = tryOnce();
+                break;
+            }
+        }
+        waiters.mCount.fetch_sub(1, std::memory_order_relaxed);
+        return done;
+    }
+
+    const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    Position mEnqueue;
+    Position mDequeue;
+    std::atomic<size_t> mSpins{minSpins * 4};
+    Waiters mNotEmpty;
+    Waiters mNotFull;
+};
+
+typedef BoundedRequestQueue<sys::Runnable*> BoundedRunnableRequestQueue;
+}
+
+#endif  // CODA_OSS_mt_BoundedRequestQueue_h_INCLUDED_
@@ -43,6 +43,21 @@ struct AbstractNextCPUProviderLinux
     virtual ~AbstractNextCPUProviderLinux() {}
 };
 
+/*!
+ * The order in which CPUAffinityInitializerLinux hands out the available
+ * CPUs.
+ *
+ * PhysicalFirst: every physical CPU, then every hyperthreaded CPU.
+ * NUMANodeFirst: fill one NUMA node (physical CPUs, then hyperthreaded
+ *                ones) before moving on to the next, so that threads
+ *                created together share a node (and its memory).
+ */
+enum class CPUOrdering
+{
+    PhysicalFirst,
+    NUMANodeFirst
+};
+
 /*!
  * \class CPUAffinityInitializerLinux
  * \brief Linux-specific class for providing thread-level affinity initializers.
@@ -57,6 +72,14 @@ public:
      */
     CPUAffinityInitializerLinux();
 
+    /*!
+     * Constructor that uses the available CPUs (possibly restricted
+     * via taskset or numactl) to set affinities, in the given order
+     *
+     * \param ordering The order to hand out CPUs in
+     */
+    explicit CPUAffinityInitializerLinux(CPUOrdering ordering);
+
     /*!
      * Constructor that uses all online CPUs to incrementally update
      * to the next CPU, starting from 'initialOffset'.
@@ -35,21 +35,38 @@
 #include "mt/CPUAffinityInitializer.h"
 #include "mt/CPUAffinityThreadInitializer.h"
 #include "mt/Runnable1D.h"
+#include "mt/WorkStealingExecutor.h"
 
 
 namespace mt
 {
-    class CODA_OSS_API TiedRequestHandler : public sys::Runnable
+    /*!
+     *  \class TiedRequestHandlerT
+     *  \brief Request handler for GenerationThreadPoolT
+     *
+     *  Pulls runnables off the pool's RequestQueue_T, runs and deletes
+     *  them, and signals the pool's semaphore after each one.  Stops when
+     *  it pulls off a nullptr.
+     */
+    template <typename RequestQueue_T>
+    class TiedRequestHandlerT : public sys::Runnable
     {
-	RunnableRequestQueue* mRequestQueue;
+	RequestQueue_T* mRequestQueue;
 	sys::Semaphore* mSem = nullptr;
 	CPUAffinityThreadInitializer* mAffinityInit;
 
     public:
-	TiedRequestHandler(RunnableRequestQueue* requestQueue) :
+	TiedRequestHandlerT(RequestQueue_T* requestQueue) :
 	    mRequestQueue(requestQueue), mAffinityInit(nullptr) {}
 		
-	virtual ~TiedRequestHandler();
+	virtual ~TiedRequestHandlerT()
+	{
+	    if (mAffinityInit)
+	    {
+		delete mAffinityInit;
+		mAffinityInit = nullptr;
+	    }
+	}
 
 	virtual void setSemaphore(sys::Semaphore* sem)
 	{
@@ -61,31 +78,74 @@ namespace mt
 	}
 
 	// If we have a thread initializer, tie down our handler to a CPU
-	virtual void initialize();
+	virtual void initialize()
+	{
+	    if (mAffinityInit)
+	    {
+		mAffinityInit->initialize();
+	    }
+	}
+
+	virtual void run() override
+	{
+	    // Call our init (gets called from within the thread package's create fn)
+	    initialize();
+
+	    while (true)
+	    {
+		// Pull a runnable off the queue
+		sys::Runnable *handler = nullptr;
+
+		mRequestQueue->dequeue(handler);
+		if (!handler) return;
+
+		// Run the runnable that we pulled off the queue
+		handler->run();
 
-	virtual void run() override;
+		// Delete the runnable we pulled off the queue
+		delete handler;
+
+		// Signal to the thread pool that we are done
+		// This will allow 1 wait() to complete
+		mSem->signal();
+	    }
+	}
     };
 
-    class CODA_OSS_API GenerationThreadPool : public BasicThreadPool<TiedRequestHandler>
+    /*!
+     *  \class GenerationThreadPoolT
+     *  \brief BasicThreadPool that runs "generations" of runnables and
+     *  waits for each generation to finish.
+     *
+     *  RequestQueue_T may be RunnableRequestQueue (GenerationThreadPool) or
+     *  any queue with the same interface, such as
+     *  BoundedRunnableRequestQueue.
+     */
+    template <typename RequestQueue_T>
+    class GenerationThreadPoolT :
+	public BasicThreadPool<TiedRequestHandlerT<RequestQueue_T>, RequestQueue_T>
     {
+	typedef TiedRequestHandlerT<RequestQueue_T> Handler_T;
+	typedef BasicThreadPool<Handler_T, RequestQueue_T> Base_T;
+
 	sys::Semaphore mGenerationSync;
 	CPUAffinityInitializer* mAffinityInit = nullptr;
 	int mGenSize = 0;
     public:
-        GenerationThreadPool() = default;
-	GenerationThreadPool(unsigned short numThreads,
-			     CPUAffinityInitializer* affinityInit = nullptr) 
-	    : BasicThreadPool<TiedRequestHandler>(numThreads), 
+        GenerationThreadPoolT() = default;
+	GenerationThreadPoolT(unsigned short numThreads,
+			      CPUAffinityInitializer* affinityInit = nullptr) 
+	    : Base_T(numThreads), 
 	    mAffinityInit(affinityInit)
 	    {
 	    }
-	virtual ~GenerationThreadPool() = default;
-	GenerationThreadPool(const GenerationThreadPool&) = delete;
-    GenerationThreadPool& operator=(const GenerationThreadPool&) = delete;
+	virtual ~GenerationThreadPoolT() = default;
+	GenerationThreadPoolT(const GenerationThreadPoolT&) = delete;
+    GenerationThreadPoolT& operator=(const GenerationThreadPoolT&) = delete;
 	
-	virtual TiedRequestHandler *newRequestHandler() override
+	virtual Handler_T *newRequestHandler() override
 	{
-	    TiedRequestHandler* handler = BasicThreadPool<TiedRequestHandler>::newRequestHandler();
+	    Handler_T* handler = Base_T::newRequestHandler();
         assert(handler != nullptr);
 	    handler->setSemaphore(&mGenerationSync);
 		
@@ -98,10 +158,25 @@ namespace mt
 	}
     
 	// Not set up for multiple producers 
-	void addGroup(const std::vector<sys::Runnable*>& toRun);
+	void addGroup(const std::vector<sys::Runnable*>& toRun)
+	{
+	    if (mGenSize)
+		throw mt::ThreadPoolException(Ctxt("The previous generation has not completed!"));
+
+	    mGenSize = static_cast<int>(toRun.size());
+	    for (int i = 0; i < mGenSize; ++i)
+		this->addRequest(toRun[i]);
+	}
 	
 	// Not set up for multiple producers 
-	void waitGroup();
+	void waitGroup()
+	{
+	    while (mGenSize)
+	    {
+		mGenerationSync.wait();
+		--mGenSize;
+	    }
+	}
 	
 	void addAndWaitGroup(const std::vector<sys::Runnable*>& toRun)
 	{
@@ -118,12 +193,37 @@ namespace mt
      *  \param op          A function-like object taking a parameter of type
      *                     size_t which will be called for each number in the
      *                     given range
+     *  \param schedule    How the elements are divided among the threads;
+     *                     use Schedule::DYNAMIC or Schedule::GUIDED when the
+     *                     cost per element varies
+     *
+     *  If the pool has not been started, the work is submitted to
+     *  WorkStealingExecutor::getInstance() instead of waiting forever on
+     *  a pool with no threads.
      */
     template <typename OpT>
-    void run1D(size_t numElements, const OpT& op)
+    void run1D(size_t numElements, const OpT& op,
+               const Schedule& schedule = Schedule())
     {
+        if (!this->mStarted)
+        {
+            parallel_for(numElements, op, schedule.mGrainSize);
+            return;
+        }
+
         std::vector<sys::Runnable*> runnables;
-        const ThreadPlanner planner(numElements, mNumThreads);
+        if (schedule.mPolicy != Schedule::STATIC)
+        {
+            ThreadPlanner planner(numElements, this->mNumThreads, schedule);
+            for (size_t ii = 0; ii < this->mNumThreads; ++ii)
+            {
+                runnables.push_back(new ScheduledRunnable1D<OpT>(planner, op));
+            }
+            addAndWaitGroup(runnables);
+            return;
+        }
+
+        const ThreadPlanner planner(numElements, this->mNumThreads, schedule);
  
         size_t threadNum(0);
         size_t startElement(0);
@@ -139,6 +239,9 @@ namespace mt
 
 
     };
+
+    typedef TiedRequestHandlerT<RunnableRequestQueue> TiedRequestHandler;
+    typedef GenerationThreadPoolT<RunnableRequestQueue> GenerationThreadPool;
 }
 #endif
 #endif
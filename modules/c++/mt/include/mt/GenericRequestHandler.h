@@ -24,6 +24,8 @@
 #ifndef __MT_GENERIC_REQUEST_HANDLER_H__
 #define __MT_GENERIC_REQUEST_HANDLER_H__
 
+#include <memory>
+
 #include "sys/Thread.h"
 #include "mt/RequestQueue.h"
 
@@ -31,35 +33,58 @@ namespace mt
 {
 
 /*!
- *  \class GenericRequestHandler
+ *  \class GenericRequestHandlerT
  *  \brief Request handler for BasicThreadPool
  *
  *  This class pulls a runnable off the BasicThreadPool
- *  request queue and runs it, in a loop that never terminates.
+ *  request queue and runs it, in a loop that only terminates when
+ *  it pulls off a nullptr.
  *  
  *  This class is really only used if you are using a BasicThreadPool.
+ *  RequestQueue_T is the pool's queue type (RunnableRequestQueue for
+ *  GenericRequestHandler).
  *  
  */
-class GenericRequestHandler : public sys::Runnable
+template <typename RequestQueue_T>
+class GenericRequestHandlerT : public sys::Runnable
 {
 public:
     //! Constructor
-    GenericRequestHandler(RunnableRequestQueue* request) :
+    GenericRequestHandlerT(RequestQueue_T* request) :
             mRequest(request)
     {}
 
     //! Deconstructor
-    ~GenericRequestHandler()
+    ~GenericRequestHandlerT()
     {}
 
     /*!
      *  Dequeue and run requests in a non-terminating loop
      */
-    virtual void run() override;
+    virtual void run() override
+    {
+        while (true)
+        {
+            // Pull a runnable off the queue
+            sys::Runnable* handler = nullptr;
+            mRequest->dequeue(handler);
+            if (!handler)
+            {
+                return;
+            }
+
+            // Run the runnable that we pulled off the queue
+            // It will get deleted when it goes out of scope below
+            std::unique_ptr<sys::Runnable> scopedHandler(handler);
+            scopedHandler->run();
+        }
+    }
 
 protected:
-    RunnableRequestQueue *mRequest;
+    RequestQueue_T *mRequest;
 };
+
+typedef GenericRequestHandlerT<RunnableRequestQueue> GenericRequestHandler;
 }
 
 
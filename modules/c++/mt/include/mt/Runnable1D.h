@@ -9,6 +9,7 @@
 #include <except/Exception.h>
 #include "mt/ThreadPlanner.h"
 #include "mt/ThreadGroup.h"
+#include "mt/WorkStealingExecutor.h"
 
 namespace mt
 {
@@ -39,17 +40,56 @@ private:
     const OpT& mOp;
 };
 
+/*!
+ * Runs op on chunks claimed from a shared ThreadPlanner (see
+ * ThreadPlanner::getNextChunk()) until all the work has been handed out.
+ * Create one per thread, all sharing the same planner.
+ */
 template <typename OpT>
-void run1D(size_t numElements, size_t numThreads, const OpT& op)
+class ScheduledRunnable1D : public sys::Runnable
+{
+public:
+    ScheduledRunnable1D(ThreadPlanner& planner, const OpT& op) :
+        mPlanner(planner),
+        mOp(op)
+    {
+    }
+
+    virtual void run() override
+    {
+        size_t startElement(0);
+        size_t numElements(0);
+        while (mPlanner.getNextChunk(startElement, numElements))
+        {
+            const size_t endElement = startElement + numElements;
+            for (size_t ii = startElement; ii < endElement; ++ii)
+            {
+                mOp(ii);
+            }
+        }
+    }
+
+private:
+    ThreadPlanner& mPlanner;
+    const OpT& mOp;
+};
+
+// The chunks are run on WorkStealingExecutor::getInstance() rather than on
+// newly created threads.
+// 'schedule' controls how elements are divided among the threads; use
+// Schedule::DYNAMIC or Schedule::GUIDED when the cost per element varies.
+template <typename OpT>
+void run1D(size_t numElements, size_t numThreads, const OpT& op,
+           const Schedule& schedule = Schedule())
 {
     if (numThreads <= 1)
     {
         Runnable1D<OpT>(0, numElements, op).run();
     }
-    else
+    else if (schedule.mPolicy == Schedule::STATIC)
     {
-        ThreadGroup threads;
-        const ThreadPlanner planner(numElements, numThreads);
+        ThreadGroup threads(WorkStealingExecutor::getInstance());
+        const ThreadPlanner planner(numElements, numThreads, schedule);
  
         size_t threadNum(0);
         size_t startElement(0);
@@ -61,14 +101,27 @@ void run1D(size_t numElements, size_t numThreads, const OpT& op)
         }
         threads.joinAll();
     }
+    else
+    {
+        ThreadGroup threads(WorkStealingExecutor::getInstance());
+        ThreadPlanner planner(numElements, numThreads, schedule);
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(new ScheduledRunnable1D<OpT>(planner, op));
+        }
+        threads.joinAll();
+    }
 }
 
 // Same as above but each thread gets their own 'op'
 // This is useful when each thread needs its own local storage and/or you
 // need access to a per-thread result afterwards (make these member variables
 // mutable since operator() is const).
+// With a dynamic or guided schedule, which elements each 'op' sees depends
+// on timing.
 template <typename OpT>
-void run1D(size_t numElements, size_t numThreads, const std::vector<OpT>& ops)
+void run1D(size_t numElements, size_t numThreads, const std::vector<OpT>& ops,
+           const Schedule& schedule = Schedule())
 {
     if (ops.size() != numThreads)
     {
@@ -82,10 +135,10 @@ void run1D(size_t numElements, size_t numThreads, const std::vector<OpT>& ops)
     {
         Runnable1D<OpT>(0, numElements, ops[0]).run();
     }
-    else
+    else if (schedule.mPolicy == Schedule::STATIC)
     {
-        ThreadGroup threads;
-        const ThreadPlanner planner(numElements, numThreads);
+        ThreadGroup threads(WorkStealingExecutor::getInstance());
+        const ThreadPlanner planner(numElements, numThreads, schedule);
 
         size_t threadNum(0);
         size_t startElement(0);
@@ -97,16 +150,27 @@ void run1D(size_t numElements, size_t numThreads, const std::vector<OpT>& ops)
         }
         threads.joinAll();
     }
+    else
+    {
+        ThreadGroup threads(WorkStealingExecutor::getInstance());
+        ThreadPlanner planner(numElements, numThreads, schedule);
+        for (size_t ii = 0; ii < numThreads; ++ii)
+        {
+            threads.createThread(new ScheduledRunnable1D<OpT>(planner, ops[ii]));
+        }
+        threads.joinAll();
+    }
 }
 
 // Same as above but each thread gets their own copy-constructed copy of 'op'
 // This is useful when each thread needs its own local storage (make this
 // scratch space mutable since operator() is const).
 template <typename OpT>
-void run1DWithCopies(size_t numElements, size_t numThreads, const OpT& op)
+void run1DWithCopies(size_t numElements, size_t numThreads, const OpT& op,
+                     const Schedule& schedule = Schedule())
 {
     const std::vector<OpT> ops(numThreads, op);
-    run1D(numElements, numThreads, ops);
+    run1D(numElements, numThreads, ops, schedule);
 }
 }
 
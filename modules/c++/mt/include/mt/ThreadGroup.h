@@ -43,6 +43,8 @@
 
 namespace mt
 {
+class WorkStealingExecutor;
+class TaskGroup;
 
 /*!
  * \class ThreadGroup
@@ -52,6 +54,13 @@ namespace mt
  * This class is a basic thread group that can create threads from
  * sys::Runnable objects and wait for all threads to complete.
  *
+ * If constructed with a WorkStealingExecutor, createThread() submits the
+ * runnable to the executor's persistent workers instead of starting a new
+ * OS thread.  Use this for short parallel regions where thread creation
+ * would dominate; don't use it when the runnables need to run concurrently
+ * with each other (e.g. they communicate), since the executor may run them
+ * one after another.
+ *
  */
 struct CODA_OSS_API ThreadGroup
 {
@@ -65,6 +74,14 @@ struct CODA_OSS_API ThreadGroup
      */
     ThreadGroup(bool pinToCPU = getDefaultPinToCPU());
 
+    /*!
+     * Constructor.  Runnables are run on 'executor' rather than on newly
+     * created threads; any CPU pinning is up to the executor.
+     * \param executor The executor to submit to, typically
+     *                 WorkStealingExecutor::getInstance()
+     */
+    explicit ThreadGroup(WorkStealingExecutor& executor);
+
     /*!
     *  Destructor. Attempts to join all threads.
     */
@@ -113,6 +130,7 @@ struct CODA_OSS_API ThreadGroup
 
 private:
     std::unique_ptr<CPUAffinityInitializer> mAffinityInit;
+    std::unique_ptr<TaskGroup> mTasks;
     size_t mLastJoined;
     std::vector<std::shared_ptr<sys::Thread> > mThreads;
     std::vector<except::Exception> mExceptions;
@@ -25,13 +25,58 @@
 
 #include <stddef.h>
 
+#include <atomic>
+
 #include <config/Exports.h>
 
 namespace mt
 {
+/*!
+ * \class Schedule
+ * \brief Describes how a ThreadPlanner hands out work
+ *
+ * STATIC divides the elements into one contiguous block per thread up
+ * front.  This has the best locality and no overhead, but if the cost per
+ * element is uneven, some threads finish early and sit idle.
+ *
+ * DYNAMIC has threads repeatedly grab the next grainSize elements from a
+ * shared atomic counter until there are none left.
+ *
+ * GUIDED is like DYNAMIC, but each grab takes the remaining elements divided
+ * by the number of threads (and at least grainSize), so chunks start out big
+ * and shrink towards the end where balancing matters.  This takes far fewer
+ * atomic operations than DYNAMIC with a small grain size.
+ *
+ * For all policies, the grain size is the minimum number of elements
+ * handed out at a time (the last chunk may be smaller); with STATIC, each
+ * thread's block is a multiple of it.
+ */
+struct CODA_OSS_API Schedule final
+{
+    enum Policy
+    {
+        STATIC,
+        DYNAMIC,
+        GUIDED
+    };
+
+    Schedule(Policy policy = STATIC, size_t grainSize = 1) :
+        mPolicy(policy),
+        mGrainSize(grainSize == 0 ? 1 : grainSize)
+    {
+    }
+
+    Policy mPolicy;
+    size_t mGrainSize;
+};
+
 /*!
  * \class ThreadPlanner
  * \brief Assists with dividing up work evenly between threads
+ *
+ * With a Schedule::STATIC schedule (the default), use getThreadInfo() to
+ * find each thread's block of work.  With any schedule, threads may instead
+ * call getNextChunk() in a loop; this is thread safe.
  */
 class CODA_OSS_API ThreadPlanner
 {
@@ -42,8 +87,19 @@ public:
      * \param numElements The total number of elements of work to be divided
      * among threads
      * \param numThreads The number of threads that will be used for the work
+     * \param schedule How the work will be handed out
      */
-    ThreadPlanner(size_t numElements, size_t numThreads);
+    ThreadPlanner(size_t numElements, size_t numThreads,
+                  const Schedule& schedule = Schedule());
+
+    ThreadPlanner(const ThreadPlanner&) = delete;
+    ThreadPlanner& operator=(const ThreadPlanner&) = delete;
+
+    //! \return The schedule work is handed out with
+    const Schedule& getSchedule() const
+    {
+        return mSchedule;
+    }
 
     /*!
      * \return The number of elements each thread will work on (this is true
@@ -86,10 +142,27 @@ public:
      */
     size_t getNumThreadsThatWillBeUsed() const;
 
+    /*!
+     * Claims the next chunk of work.  Any number of threads may call this
+     * concurrently; each element is handed out exactly once.  The chunk size
+     * depends on the schedule: getNumElementsPerThread() for STATIC, the
+     * grain size for DYNAMIC, and a shrinking size for GUIDED.
+     *
+     * \param startElement Provides the start element of the chunk
+     * \param numElementsThisChunk Provides the number of elements in the
+     * chunk
+     *
+     * \return True if a chunk was claimed, false if all the work has been
+     * handed out
+     */
+    bool getNextChunk(size_t& startElement, size_t& numElementsThisChunk);
+
 private:
    size_t mNumElements;
    size_t mNumThreads;
    size_t mNumElementsPerThread;
+   const Schedule mSchedule;
+   std::atomic<size_t> mNextElement;
 };
 }
 
@@ -8,6 +8,7 @@
 
 #include "ThreadPlanner.h"
 #include "ThreadGroup.h"
+#include "WorkStealingExecutor.h"
 
 namespace mt
 {
@@ -18,6 +19,9 @@ namespace mt
  * \param elemSize Size of each element in 'buffer'
  * \param numElements Number of elements in 'buffer'
  * \param numThreads Number of threads to use for byte-swapping
+ *
+ * The work is run on WorkStealingExecutor::getInstance(), so no threads are
+ * created per call.
  */
 inline void threadedByteSwap(void* buffer, size_t elemSize, size_t numElements, size_t numThreads)
 {
@@ -27,7 +31,7 @@ inline void threadedByteSwap(void* buffer, size_t elemSize, size_t numElements,
     }
     else
     {
-        mt::ThreadGroup threads;
+        mt::ThreadGroup threads(mt::WorkStealingExecutor::getInstance());
         const mt::ThreadPlanner planner(numElements, numThreads);
 
         size_t threadNum(0);
@@ -64,7 +68,7 @@ inline void threadedByteSwap(const void* buffer, size_t elemSize, size_t numElem
     }
     else
     {
-        mt::ThreadGroup threads;
+        mt::ThreadGroup threads(mt::WorkStealingExecutor::getInstance());
         const mt::ThreadPlanner planner(numElements, numThreads);
 
         size_t threadNum(0);
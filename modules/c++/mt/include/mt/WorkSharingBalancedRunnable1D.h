@@ -22,6 +22,7 @@
 #ifndef __MT_WORK_SHARING_BALANCED_RUNNABLE_1D_H__
 #define __MT_WORK_SHARING_BALANCED_RUNNABLE_1D_H__
 
+#include <memory>
 #include <vector>
 #include <sstream>
 
@@ -37,14 +38,15 @@
 namespace mt
 {
 typedef std::vector<std::shared_ptr<sys::AtomicCounter> > SharedAtomicCounterVec;
+typedef std::vector<std::shared_ptr<ThreadPlanner> > SharedThreadPlannerVec;
 
 /*!
  *  \class WorkSharingBalancedRunnable1D
  *  \tparam OpT The type of functor that will be used to process elements
  *
  *  This runnable takes both a reference to the associated thread's
- *  atomic counter as well as atomic counter and range information for all
- *  other threads in the thread pool.
+ *  atomic counter (or ThreadPlanner) as well as the counters (or planners)
+ *  and range information for all other threads in the thread pool.
  *
  *  Each runnable will operate on a contiguous range of elements
  *  ([startElement, startElement + numElements]). Once all work has been
@@ -52,6 +54,11 @@ typedef std::vector<std::shared_ptr<sys::AtomicCounter> > SharedAtomicCounterVec
  *  other threads will be used to grab additional work rather than let
  *  the thread die.
  *
+ *  With atomic counters, elements are grabbed one at a time, which takes
+ *  an atomic operation per element.  With planners, whole chunks are
+ *  claimed with ThreadPlanner::getNextChunk(), where each planner covers
+ *  one thread's range (starting at 0).
+ *
  *  This runnable is useful in cases where work needs to be
  *  done across a range of elements, but when dividing these elements
  *  across threads leads to balancing issues i.e certain threads
@@ -88,9 +95,39 @@ struct WorkSharingBalancedRunnable1D : public sys::Runnable
             const OpT& op) :
         mStartElement(range.mStartElement),
         mEndElement(mStartElement + range.mNumElements),
-        mCounter(counter),
-        mThreadPoolCounters(threadCounters),
-        mThreadPoolEndElements(threadPoolEndElements),
+        mCounter(&counter),
+        mThreadPoolCounters(&threadCounters),
+        mThreadPoolElements(threadPoolEndElements),
+        mOp(op)
+    {
+    }
+
+    /*!
+     *  Constructor
+     *
+     *  \param range Range of elements for this runnable to work on
+     *
+     *  \param[in,out] planner Planner this thread will initially use to
+     *  claim chunks of elements within its range to process
+     *
+     *  \param threadPoolPlanners Planners of other threads - if this thread
+     *  finishes processing the elements within its range, these planners
+     *  will be used to grab additional work
+     *
+     *  \param threadPoolStartElements Starting indices for each thread
+     *
+     */
+    WorkSharingBalancedRunnable1D(
+            const types::Range& range,
+            ThreadPlanner& planner,
+            const SharedThreadPlannerVec& threadPoolPlanners,
+            const std::vector<size_t>& threadPoolStartElements,
+            const OpT& op) :
+        mStartElement(range.mStartElement),
+        mEndElement(mStartElement + range.mNumElements),
+        mPlanner(&planner),
+        mThreadPoolPlanners(&threadPoolPlanners),
+        mThreadPoolElements(threadPoolStartElements),
         mOp(op)
     {
     }
@@ -101,15 +138,29 @@ struct WorkSharingBalancedRunnable1D : public sys::Runnable
 
     virtual void run() override
     {
+        if (mPlanner)
+        {
+            // Operate over this thread's range
+            processChunks(*mPlanner, mStartElement);
+
+            // Help other threads that have yet to process every element in
+            // their range
+            for (size_t ii = 0; ii < mThreadPoolElements.size(); ++ii)
+            {
+                processChunks(*(*mThreadPoolPlanners)[ii], mThreadPoolElements[ii]);
+            }
+            return;
+        }
+
         // Operate over this thread's range
-        processElements(mCounter, mEndElement);
+        processElements(*mCounter, mEndElement);
 
         // Help other threads that have yet to process every element in
         // their range
-        for (size_t ii = 0; ii < mThreadPoolEndElements.size(); ++ii)
+        for (size_t ii = 0; ii < mThreadPoolElements.size(); ++ii)
         {
-            const size_t threadEndElement = mThreadPoolEndElements[ii];
-            sys::AtomicCounter& threadCounter = *mThreadPoolCounters[ii];
+            const size_t threadEndElement = mThreadPoolElements[ii];
+            sys::AtomicCounter& threadCounter = *(*mThreadPoolCounters)[ii];
             processElements(threadCounter, threadEndElement);
         }
     }
@@ -131,56 +182,44 @@ private:
         }
     }
 
+    void processChunks(ThreadPlanner& planner, size_t offset)
+    {
+        size_t startElement = 0;
+        size_t numElementsThisChunk = 0;
+        while (planner.getNextChunk(startElement, numElementsThisChunk))
+        {
+            const size_t endElement = offset + startElement + numElementsThisChunk;
+            for (size_t element = offset + startElement; element < endElement; ++element)
+            {
+                mOp(element);
+            }
+        }
+    }
+
     const size_t mStartElement;
     const size_t mEndElement;
-    sys::AtomicCounter& mCounter;
-    const SharedAtomicCounterVec& mThreadPoolCounters;
-    const std::vector<size_t >& mThreadPoolEndElements;
+    sys::AtomicCounter* mCounter = nullptr;
+    const SharedAtomicCounterVec* mThreadPoolCounters = nullptr;
+    ThreadPlanner* mPlanner = nullptr;
+    const SharedThreadPlannerVec* mThreadPoolPlanners = nullptr;
+
+    // End elements with atomic counters, start elements with planners
+    const std::vector<size_t>& mThreadPoolElements;
     const OpT& mOp;
 };
 
-/*!
- *  This method will divide numElements across numThreads, associating with
- *  each thread a range of elements to work on as well as an atomic counter
- *  used to fetch those elements for processing by the provided functor.
- *
- *  Threads that finish working on their range will use the atomic counters
- *  of other threads to grab additional elements. This behavior prevents
- *  balancing issues from occurring by having certain threads that would
- *  otherwise die grab any available work.
- *
- *  By supplying each thread with its own atomic counter rather than a single
- *  atomic counter shared across threads, each thread can initially operate
- *  over a contiguous range of elements. This behavior provides better locality
- *  of reference and in practice better caching.
- *
- *  \tparam OpT The type of functor that will be used to process elements
- *
- *  \param numElements Number of elements of work
- *  \param numThreads Number of threads
- *  \param op Functor to use
- */
-template <typename OpT>
+namespace details
+{
+template <typename OpT, typename GetOpT>
 void runWorkSharingBalanced1D(size_t numElements,
                               size_t numThreads,
-                              const OpT& op)
+                              size_t grainSize,
+                              GetOpT getOp)
 {
-    std::vector<size_t> threadPoolEndElements;
-    SharedAtomicCounterVec threadPoolCounters;
+    std::vector<types::Range> threadPoolRange;
     if (numThreads <= 1)
     {
-        threadPoolEndElements.push_back(numElements);
-
-        threadPoolCounters.push_back(
-                std::shared_ptr<sys::AtomicCounter>(
-                        new sys::AtomicCounter(0)));
-
-        const types::Range range(0, numElements);
-        WorkSharingBalancedRunnable1D<OpT>(range,
-                                           *threadPoolCounters[0],
-                                           threadPoolCounters,
-                                           threadPoolEndElements,
-                                           op).run();
+        threadPoolRange.push_back(types::Range(0, numElements));
     }
     else
     {
@@ -188,35 +227,87 @@ void runWorkSharingBalanced1D(size_t numElements,
         size_t startElement = 0;
         size_t numElementsThisThread = 0;
         const ThreadPlanner planner(numElements, numThreads);
-        std::vector<types::Range> threadPoolRange;
         while (planner.getThreadInfo(
                 threadNum++, startElement, numElementsThisThread))
         {
-            const types::Range range(startElement, numElementsThisThread);
-            threadPoolRange.push_back(range);
-
-            threadPoolCounters.push_back(
-                    std::shared_ptr<sys::AtomicCounter>(
-                            new sys::AtomicCounter(static_cast<sys::AtomicCounter::ValueType>(startElement))));
-
-            threadPoolEndElements.push_back(
-                    startElement + numElementsThisThread);
+            threadPoolRange.push_back(
+                    types::Range(startElement, numElementsThisThread));
         }
+    }
 
+    // Each range is handed out in GUIDED chunks, so the thread that owns
+    // it takes big ones while any helpers take smaller ones at the end
+    const Schedule schedule(Schedule::GUIDED, grainSize);
+    SharedThreadPlannerVec threadPoolPlanners;
+    std::vector<size_t> threadPoolStartElements;
+    for (const auto& range : threadPoolRange)
+    {
+        threadPoolPlanners.push_back(std::make_shared<ThreadPlanner>(
+                range.mNumElements, threadPoolRange.size(), schedule));
+        threadPoolStartElements.push_back(range.mStartElement);
+    }
+
+    if (numThreads <= 1)
+    {
+        WorkSharingBalancedRunnable1D<OpT>(threadPoolRange[0],
+                                           *threadPoolPlanners[0],
+                                           threadPoolPlanners,
+                                           threadPoolStartElements,
+                                           getOp(0)).run();
+    }
+    else
+    {
         ThreadGroup threads;
         for (size_t ii = 0; ii < threadPoolRange.size(); ++ii)
         {
             threads.createThread(
                     new WorkSharingBalancedRunnable1D<OpT>(
                             threadPoolRange[ii],
-                            *threadPoolCounters[ii],
-                            threadPoolCounters,
-                            threadPoolEndElements,
-                            op));
+                            *threadPoolPlanners[ii],
+                            threadPoolPlanners,
+                            threadPoolStartElements,
+                            getOp(ii)));
         }
         threads.joinAll();
     }
 }
+}
+
+/*!
+ *  This method will divide numElements across numThreads, associating with
+ *  each thread a range of elements to work on as well as a ThreadPlanner
+ *  used to claim chunks of those elements for processing by the provided
+ *  functor.
+ *
+ *  Threads that finish working on their range will use the planners
+ *  of other threads to grab additional elements. This behavior prevents
+ *  balancing issues from occurring by having certain threads that would
+ *  otherwise die grab any available work.
+ *
+ *  By supplying each thread with its own planner rather than a single
+ *  counter shared across threads, each thread can initially operate
+ *  over a contiguous range of elements. This behavior provides better locality
+ *  of reference and in practice better caching.
+ *
+ *  Chunks follow a Schedule::GUIDED schedule, so they shrink as a range
+ *  runs out, but are never smaller than grainSize (except for the last one).
+ *
+ *  \tparam OpT The type of functor that will be used to process elements
+ *
+ *  \param numElements Number of elements of work
+ *  \param numThreads Number of threads
+ *  \param op Functor to use
+ *  \param grainSize The smallest number of elements to claim at a time
+ */
+template <typename OpT>
+void runWorkSharingBalanced1D(size_t numElements,
+                              size_t numThreads,
+                              const OpT& op,
+                              size_t grainSize = 1)
+{
+    details::runWorkSharingBalanced1D<OpT>(numElements, numThreads, grainSize,
+            [&op](size_t) -> const OpT& { return op; });
+}
 
 /*!
  *  Same as above, but instead of sharing a functor across runnables,
@@ -227,11 +318,13 @@ void runWorkSharingBalanced1D(size_t numElements,
  *  \param numElements Number of elements of work
  *  \param numThreads Number of threads
  *  \param ops Vector of functors to use
+ *  \param grainSize The smallest number of elements to claim at a time
  */
 template <typename OpT>
 void runWorkSharingBalanced1D(size_t numElements,
                               size_t numThreads,
-                              const std::vector<OpT>& ops)
+                              const std::vector<OpT>& ops,
+                              size_t grainSize = 1)
 {
     if (ops.size() != numThreads)
     {
@@ -241,53 +334,8 @@ void runWorkSharingBalanced1D(size_t numElements,
         throw except::Exception(Ctxt(ostr));
     }
 
-    std::vector<size_t> threadPoolEndElements;
-    SharedAtomicCounterVec threadPoolCounters;
-    if (numThreads <= 1)
-    {
-        threadPoolEndElements.push_back(numElements);
-
-        constexpr size_t zero = 0;
-        threadPoolCounters.push_back(std::make_shared<sys::AtomicCounter>(zero));
-
-        const types::Range range(0, numElements);
-        WorkSharingBalancedRunnable1D<OpT>(range,
-                                           *threadPoolCounters[0],
-                                           threadPoolCounters,
-                                           threadPoolEndElements,
-                                           ops[0]).run();
-    }
-    else
-    {
-        size_t threadNum = 0;
-        size_t startElement = 0;
-        size_t numElementsThisThread = 0;
-        const ThreadPlanner planner(numElements, numThreads);
-        std::vector<types::Range> threadPoolRange;
-        while (planner.getThreadInfo(
-                  threadNum++, startElement, numElementsThisThread))
-        {
-              const types::Range range(startElement, numElementsThisThread);
-              threadPoolRange.push_back(range);
-
-              auto counter = std::make_shared<sys::AtomicCounter>(gsl::narrow<sys::AtomicCounter::ValueType>(startElement));
-              threadPoolCounters.push_back(counter);
-              threadPoolEndElements.push_back(startElement + numElementsThisThread);
-        }
-
-        ThreadGroup threads;
-        for (size_t ii = 0; ii < threadPoolRange.size(); ++ii)
-        {
-            threads.createThread(
-                    new WorkSharingBalancedRunnable1D<OpT>(
-                            threadPoolRange[ii],
-                            *threadPoolCounters[ii],
-                            threadPoolCounters,
-                            threadPoolEndElements,
-                            ops[ii]));
-        }
-        threads.joinAll();
-    }
+    details::runWorkSharingBalanced1D<OpT>(numElements, numThreads, grainSize,
+            [&ops](size_t ii) -> const OpT& { return ops[ii]; });
 }
 
 /*!
@@ -300,14 +348,16 @@ void runWorkSharingBalanced1D(size_t numElements,
  *  \param numElements Number of elements of work
  *  \param numThreads Number of threads
  *  \param op Functor to use
+ *  \param grainSize The smallest number of elements to claim at a time
  */
 template <typename OpT>
 void runWorkSharingBalanced1DWithCopies(size_t numElements,
                                         size_t numThreads,
-                                        const OpT& op)
+                                        const OpT& op,
+                                        size_t grainSize = 1)
 {
     const std::vector<OpT> ops(numThreads, op);
-    runWorkSharingBalanced1D(numElements, numThreads, ops);
+    runWorkSharingBalanced1D(numElements, numThreads, ops, grainSize);
 }
 }
 
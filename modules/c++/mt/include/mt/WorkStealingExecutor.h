@@ -0,0 +1,250 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_mt_WorkStealingExecutor_h_INCLUDED_
+#define CODA_OSS_mt_WorkStealingExecutor_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <config/Exports.h>
+#include <math/Round.h>
+#include <mt/ThreadPlanner.h>
+
+namespace mt
+{
+/*!
+ * \class WorkStealingExecutor
+ * \brief A persistent pool of worker threads with per-worker task deques.
+ *
+ * Each worker owns a deque of tasks.  Tasks submitted from a worker are
+ * pushed onto that worker's own deque and popped LIFO (so nested work stays
+ * hot in cache); tasks submitted from any other thread are distributed
+ * round-robin.  Idle workers steal FIFO from the other deques before going
+ * to sleep.
+ *
+ * Unlike ThreadGroup, no OS threads are created per parallel region; the
+ * workers are created once and live until the executor is destroyed.  Use
+ * getInstance() for the process-wide executor, which is started lazily on
+ * first use.
+ *
+ * Tasks are normally run through a TaskGroup (or parallel_for() /
+ * parallel_invoke()), which tracks completion and propagates exceptions.
+ */
+class CODA_OSS_API WorkStealingExecutor final
+{
+public:
+    using Task = std::function<void()>;
+
+    /*!
+     * Constructor.  Starts the worker threads.
+     *
+     * \param numThreads Number of worker threads; if 0, one worker is
+     *                   created per available CPU.
+     * \param pinToCPU If true, each worker is pinned to a CPU using a
+     *                 CPUAffinityInitializer.
+     */
+    explicit WorkStealingExecutor(size_t numThreads = 0,
+                                  bool pinToCPU = false);
+
+    //! Destructor.  Waits for queued tasks to drain and joins the workers.
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /*!
+     * \return The process-wide executor.  It is created (with one worker
+     * per available CPU, pinned if ThreadGroup::getDefaultPinToCPU() is set)
+     * the first time this is called.
+     */
+    static WorkStealingExecutor& getInstance();
+
+    //! \return The number of worker threads
+    size_t getNumThreads() const
+    {
+        return mWorkers.size();
+    }
+
+    /*!
+     * Queue a task for execution.  The caller is responsible for knowing
+     * when the task has finished; prefer TaskGroup::run().  Exceptions
+     * escaping the task are swallowed.
+     */
+    void submit(Task task);
+
+    /*!
+     * Run a single queued task on the calling thread, if one is available.
+     * This lets a thread that is waiting on other tasks help out rather
+     * than block (which is what keeps nested parallel regions from
+     * deadlocking).
+     *
+     * \return true if a task was run, false if there was nothing to do
+     */
+    bool tryRunOne();
+
+private:
+    struct Worker final
+    {
+        std::mutex mMutex;
+        std::deque<Task> mTasks;
+        std::thread mThread;
+    };
+
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    size_t currentWorkerIndex();
+
+    std::vector<std::unique_ptr<Worker> > mWorkers;
+    std::atomic<size_t> mNextWorker{0};
+    std::atomic<size_t> mQueued{0};
+    std::atomic<size_t> mSleeping{0};
+    bool mStop = false;
+    std::mutex mSleepMutex;
+    std::condition_variable mWakeUp;
+};
+
+/*!
+ * \class TaskGroup
+ * \brief A set of tasks run on a WorkStealingExecutor that can be waited on
+ * as a unit.
+ *
+ * wait() runs queued tasks on the calling thread until every task in the
+ * group has finished, then rethrows the first exception thrown by any of
+ * them.  The destructor waits (but does not throw).
+ */
+class CODA_OSS_API TaskGroup final
+{
+public:
+    explicit TaskGroup(
+            WorkStealingExecutor& executor = WorkStealingExecutor::getInstance()) :
+        mExecutor(executor)
+    {
+    }
+
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    //! Queue 'task' on the executor as part of this group
+    void run(WorkStealingExecutor::Task task);
+
+    /*!
+     * Blocks until all tasks in the group have completed.
+     * \throws The first exception thrown by a task, if any
+     */
+    void wait();
+
+private:
+    void taskDone(std::exception_ptr error);
+
+    WorkStealingExecutor& mExecutor;
+    size_t mPending = 0;
+    std::exception_ptr mError;
+    std::mutex mMutex;
+    std::condition_variable mDone;
+};
+
+/*!
+ *  \brief Runs op(ii) for every ii in [0, numElements) on the executor.
+ *
+ *  The range is split into contiguous chunks of at least grainSize elements;
+ *  there are a few more chunks than workers so that idle workers have
+ *  something to steal when the per-element cost is uneven.  The calling
+ *  thread participates in the work.
+ *
+ *  \param numElements The number of elements to run
+ *  \param op          A function-like object taking a size_t
+ *  \param grainSize   Minimum number of elements per task
+ *  \param executor    The executor to run on
+ */
+template <typename OpT>
+void parallel_for(size_t numElements, const OpT& op, size_t grainSize = 1,
+                  WorkStealingExecutor& executor = WorkStealingExecutor::getInstance())
+{
+    if (grainSize == 0)
+    {
+        grainSize = 1;
+    }
+
+    constexpr size_t chunksPerThread = 4;
+    const size_t maxChunks = math::ceilingDivide(numElements, grainSize);
+    const size_t numChunks = std::min(maxChunks,
+            (executor.getNumThreads() + 1) * chunksPerThread);
+    if (numChunks <= 1)
+    {
+        for (size_t ii = 0; ii < numElements; ++ii)
+        {
+            op(ii);
+        }
+        return;
+    }
+
+    const ThreadPlanner planner(numElements, numChunks);
+    TaskGroup tasks(executor);
+
+    size_t chunkNum(0);
+    size_t startElement(0);
+    size_t numElementsThisChunk(0);
+    while (planner.getThreadInfo(chunkNum++, startElement, numElementsThisChunk))
+    {
+        const size_t endElement = startElement + numElementsThisChunk;
+        tasks.run([&op, startElement, endElement]()
+        {
+            for (size_t ii = startElement; ii < endElement; ++ii)
+            {
+                op(ii);
+            }
+        });
+    }
+    tasks.wait();
+}
+
+/*!
+ *  \brief Runs each of the given function-like objects in parallel on the
+ *  process-wide executor and waits for all of them to complete.
+ */
+template <typename... FuncTs>
+void parallel_invoke(FuncTs&&... funcs)
+{
+    TaskGroup tasks;
+    // Expand the pack in order via an initializer list
+    const int expand[] = { 0, (tasks.run(std::forward<FuncTs>(funcs)), 0)... };
+    (void)expand;
+    tasks.wait();
+}
+}
+
+#endif  // CODA_OSS_mt_WorkStealingExecutor_h_INCLUDED_
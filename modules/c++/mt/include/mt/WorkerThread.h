@@ -40,12 +40,17 @@ namespace mt
  *  operating on a consumer-producer buffer.  This class can be 
  *  implemented by deriving the performTask function.  The thread 
  *  runs until the program is stopped.
+ *
+ *  RequestQueue_T may be any queue with RequestQueue's interface, such
+ *  as BoundedRequestQueue.
  */
-template <typename Request_T> class WorkerThread : public sys::Thread
+template <typename Request_T,
+          typename RequestQueue_T = mt::RequestQueue<Request_T> >
+class WorkerThread : public sys::Thread
 {
 public:
     //! Constructor
-    WorkerThread(mt::RequestQueue<Request_T>* requestQueue) :
+    WorkerThread(RequestQueue_T* requestQueue) :
             mRequestQueue(requestQueue), mDone(false)
     {}
 
@@ -102,7 +107,7 @@ public:
     }
 protected:
 
-    mt::RequestQueue<Request_T> *mRequestQueue;
+    RequestQueue_T *mRequestQueue;
     bool mDone;
 };
 }
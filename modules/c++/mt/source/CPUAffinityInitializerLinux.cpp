@@ -47,14 +47,37 @@ std::vector<int> mergeAvailableCPUs()
     mergedCPUs.insert(mergedCPUs.end(), htCPUs.begin(), htCPUs.end());
     return mergedCPUs;
 }
+
+std::vector<int> mergeNUMANodeCPUs()
+{
+    std::vector<sys::NUMANode> nodes;
+    sys::OS().getNUMANodes(nodes);
+
+    // Fill each node (physical CPUs first) before moving to the next
+    std::vector<int> mergedCPUs;
+    for (const auto& node : nodes)
+    {
+        mergedCPUs.insert(mergedCPUs.end(),
+                          node.physicalCPUs.begin(), node.physicalCPUs.end());
+        mergedCPUs.insert(mergedCPUs.end(),
+                          node.htCPUs.begin(), node.htCPUs.end());
+    }
+    return mergedCPUs;
+}
+
+std::vector<int> mergeAvailableCPUs(mt::CPUOrdering ordering)
+{
+    return ordering == mt::CPUOrdering::NUMANodeFirst ?
+            mergeNUMANodeCPUs() : mergeAvailableCPUs();
+}
 }
 
 namespace mt
 {
 struct AvailableCPUProvider final : public AbstractNextCPUProviderLinux
 {
-    AvailableCPUProvider() :
-        mCPUs(mergeAvailableCPUs()),
+    AvailableCPUProvider(CPUOrdering ordering) :
+        mCPUs(mergeAvailableCPUs(ordering)),
         mNextCPUIndex(0)
     {
     }
@@ -99,7 +122,12 @@ private:
 };
 
 CPUAffinityInitializerLinux::CPUAffinityInitializerLinux() :
-    mCPUProvider(new AvailableCPUProvider())
+    mCPUProvider(new AvailableCPUProvider(CPUOrdering::PhysicalFirst))
+{
+}
+
+CPUAffinityInitializerLinux::CPUAffinityInitializerLinux(CPUOrdering ordering) :
+    mCPUProvider(new AvailableCPUProvider(ordering))
 {
 }
 
@@ -23,6 +23,7 @@
 
 #include <mt/ThreadGroup.h>
 #include <mt/CriticalSection.h>
+#include <mt/WorkStealingExecutor.h>
 
 namespace mt
 {
@@ -39,6 +40,12 @@ ThreadGroup::ThreadGroup(bool pinToCPU) :
 {
 }
 
+ThreadGroup::ThreadGroup(WorkStealingExecutor& executor) :
+    mTasks(new TaskGroup(executor)),
+    mLastJoined(0)
+{
+}
+
 ThreadGroup::~ThreadGroup()
 {
     try
@@ -58,6 +65,16 @@ void ThreadGroup::createThread(sys::Runnable *runnable)
 
 void ThreadGroup::createThread(std::unique_ptr<sys::Runnable>&& runnable)
 {
+    if (mTasks.get())
+    {
+        // ThreadGroupRunnable catches everything, so exceptions are reported
+        // through addException() just as they are for real threads.
+        std::shared_ptr<sys::Runnable> internalRunnable(
+                new ThreadGroupRunnable(std::move(runnable), *this));
+        mTasks->run([internalRunnable]() { internalRunnable->run(); });
+        return;
+    }
+
     // Note: If getNextInitializer throws, any previously created
     //       threads may never finish if cross-thread communication is used.
     std::unique_ptr<sys::Runnable> internalRunnable(
@@ -75,6 +92,18 @@ void ThreadGroup::createThread(std::unique_ptr<sys::Runnable>&& runnable)
 void ThreadGroup::joinAll()
 {
     bool failed = false;
+    if (mTasks.get())
+    {
+        try
+        {
+            mTasks->wait();
+        }
+        catch (...)
+        {
+            failed = true;
+        }
+    }
+
     // Keep track of which threads we've already joined.
     for (; mLastJoined < mThreads.size(); mLastJoined++)
     {
@@ -5,9 +5,13 @@
 
 namespace mt
 {
-ThreadPlanner::ThreadPlanner(size_t numElements, size_t numThreads) :
+ThreadPlanner::ThreadPlanner(size_t numElements,
+                             size_t numThreads,
+                             const Schedule& schedule) :
     mNumElements(numElements),
-    mNumThreads(numThreads)
+    mNumThreads(numThreads),
+    mSchedule(schedule),
+    mNextElement(0)
 {
     // If we got lucky and the work divides up evenly, every thread simply
     // gets numElements / numThreads elements of work
@@ -15,6 +19,11 @@ ThreadPlanner::ThreadPlanner(size_t numElements, size_t numThreads) :
     // What this will amount to meaning is that early threads will end up with
     // one more piece of work than later threads.
     mNumElementsPerThread = math::ceilingDivide(mNumElements, mNumThreads);
+
+    // Keep each thread's block a whole number of grains
+    const size_t grainSize = mSchedule.mGrainSize;
+    mNumElementsPerThread =
+            math::ceilingDivide(mNumElementsPerThread, grainSize) * grainSize;
 }
 
 bool ThreadPlanner::getThreadInfo(size_t threadNum,
@@ -49,4 +58,45 @@ size_t ThreadPlanner::getNumThreadsThatWillBeUsed() const
         return numThreads;
     }
 }
+
+bool ThreadPlanner::getNextChunk(size_t& startElement,
+                                 size_t& numElementsThisChunk)
+{
+    if (mSchedule.mPolicy == Schedule::DYNAMIC)
+    {
+        const size_t grainSize = mSchedule.mGrainSize;
+        startElement = mNextElement.fetch_add(grainSize);
+        if (startElement >= mNumElements)
+        {
+            numElementsThisChunk = 0;
+            return false;
+        }
+        numElementsThisChunk = std::min(grainSize, mNumElements - startElement);
+        return true;
+    }
+
+    startElement = mNextElement.load();
+    do
+    {
+        if (startElement >= mNumElements)
+        {
+            numElementsThisChunk = 0;
+            return false;
+        }
+
+        const size_t numElementsRemaining = mNumElements - startElement;
+        size_t chunkSize = mNumElementsPerThread;
+        if (mSchedule.mPolicy == Schedule::GUIDED)
+        {
+            chunkSize = std::max(
+                    math::ceilingDivide(numElementsRemaining, mNumThreads),
+                    mSchedule.mGrainSize);
+        }
+        numElementsThisChunk = std::min(chunkSize, numElementsRemaining);
+    }
+    while (!mNextElement.compare_exchange_weak(
+            startElement, startElement + numElementsThisChunk));
+
+    return true;
+}
 }
@@ -0,0 +1,307 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <mt/WorkStealingExecutor.h>
+
+#include <chrono>
+
+#include <sys/OS.h>
+#include <mt/ThreadGroup.h>
+#include <mt/CPUAffinityInitializer.h>
+
+namespace
+{
+// Identifies the executor (and the worker within it) that owns the
+// current thread, so nested submissions go to the local deque.
+thread_local const mt::WorkStealingExecutor* tCurrentExecutor = nullptr;
+thread_local size_t tCurrentWorker = 0;
+}
+
+namespace mt
+{
+WorkStealingExecutor::WorkStealingExecutor(size_t numThreads, bool pinToCPU)
+{
+    if (numThreads == 0)
+    {
+        numThreads = sys::OS().getNumCPUsAvailable();
+    }
+    if (numThreads == 0)
+    {
+        numThreads = 1;
+    }
+
+    std::unique_ptr<CPUAffinityInitializer> affinityInit(
+            pinToCPU ? new CPUAffinityInitializer() : nullptr);
+
+    mWorkers.reserve(numThreads);
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        mWorkers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+
+    // Don't start anything until every deque exists; workers steal from
+    // all of them.
+    for (size_t ii = 0; ii < numThreads; ++ii)
+    {
+        std::shared_ptr<CPUAffinityThreadInitializer> threadInit;
+        if (affinityInit.get())
+        {
+            threadInit = affinityInit->newThreadInitializer();
+        }
+
+        mWorkers[ii]->mThread = std::thread([this, ii, threadInit]()
+        {
+            if (threadInit)
+            {
+                threadInit->initialize();
+            }
+            workerLoop(ii);
+        });
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStop = true;
+    }
+    mWakeUp.notify_all();
+
+    for (auto& worker : mWorkers)
+    {
+        if (worker->mThread.joinable())
+        {
+            worker->mThread.join();
+        }
+    }
+}
+
+WorkStealingExecutor& WorkStealingExecutor::getInstance()
+{
+    static WorkStealingExecutor instance(0, ThreadGroup::getDefaultPinToCPU());
+    return instance;
+}
+
+size_t WorkStealingExecutor::currentWorkerIndex()
+{
+    if (tCurrentExecutor == this)
+    {
+        return tCurrentWorker;
+    }
+    return mNextWorker.fetch_add(1, std::memory_order_relaxed) % mWorkers.size();
+}
+
+void WorkStealingExecutor::submit(Task task)
+{
+    // Count the task before it becomes visible so mQueued never underflows.
+    // Workers register as sleeping before re-checking mQueued, so one of
+    // us is guaranteed to see the other's update.
+    mQueued.fetch_add(1);
+
+    Worker& worker = *mWorkers[currentWorkerIndex()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mMutex);
+        worker.mTasks.push_back(std::move(task));
+    }
+
+    if (mSleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mWakeUp.notify_one();
+    }
+}
+
+bool WorkStealingExecutor::popLocal(size_t index, Task& task)
+{
+    Worker& worker = *mWorkers[index];
+    std::lock_guard<std::mutex> lock(worker.mMutex);
+    if (worker.mTasks.empty())
+    {
+        return false;
+    }
+    task = std::move(worker.mTasks.back());
+    worker.mTasks.pop_back();
+    mQueued.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingExecutor::steal(size_t thief, Task& task)
+{
+    const size_t numWorkers = mWorkers.size();
+    for (size_t ii = 1; ii <= numWorkers; ++ii)
+    {
+        Worker& victim = *mWorkers[(thief + ii) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.mMutex);
+        if (!victim.mTasks.empty())
+        {
+            task = std::move(victim.mTasks.front());
+            victim.mTasks.pop_front();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingExecutor::tryRunOne()
+{
+    if (mQueued.load() == 0)
+    {
+        return false;
+    }
+
+    Task task;
+    const bool isWorker = (tCurrentExecutor == this);
+    const size_t index = isWorker ? tCurrentWorker : 0;
+    if ((isWorker && popLocal(index, task)) || steal(index, task))
+    {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            // Tasks run through a TaskGroup never throw; there's nobody to
+            // report to otherwise.
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingExecutor::workerLoop(size_t index)
+{
+    tCurrentExecutor = this;
+    tCurrentWorker = index;
+
+    while (true)
+    {
+        Task task;
+        if (popLocal(index, task) || steal(index, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mSleeping.fetch_add(1);
+        while (!mStop && mQueued.load() == 0)
+        {
+            mWakeUp.wait(lock);
+        }
+        mSleeping.fetch_sub(1);
+        if (mStop && mQueued.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+        // Make sure we don't throw out of the destructor.
+    }
+}
+
+void TaskGroup::run(WorkStealingExecutor::Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mPending;
+    }
+
+    mExecutor.submit([this, task = std::move(task)]()
+    {
+        std::exception_ptr error;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        taskDone(error);
+    });
+}
+
+void TaskGroup::taskDone(std::exception_ptr error)
+{
+    // Everything happens under the lock: once mPending hits zero, wait()
+    // may return and destroy this object.
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (error && !mError)
+    {
+        mError = error;
+    }
+    if (--mPending == 0)
+    {
+        mDone.notify_all();
+    }
+}
+
+void TaskGroup::wait()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (mPending == 0)
+            {
+                break;
+            }
+        }
+
+        // Help out rather than block; this is what lets a task wait on a
+        // nested group without tying up a worker.
+        if (!mExecutor.tryRunOne())
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDone.wait_for(lock, std::chrono::milliseconds(1),
+                           [this]() { return mPending == 0; });
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::swap(error, mError);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+}
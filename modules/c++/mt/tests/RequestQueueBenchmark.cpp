@@ -0,0 +1,128 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Users guide
+
+    Compares the throughput of mt::RequestQueue (mutex and condition
+    variables) against mt::BoundedRequestQueue (lock-free ring).
+
+    ./RequestQueueBenchmark [producers] [consumers] [items per producer]
+        --defaults to 4 producers, 4 consumers, 1000000 items each
+
+    Throughput is reported in millions of items per second.
+*/
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include <sys/StopWatch.h>
+#include <mt/RequestQueue.h>
+#include <mt/BoundedRequestQueue.h>
+
+namespace
+{
+template <typename QueueT>
+double millionsPerSecond(QueueT& queue,
+                         size_t numProducers,
+                         size_t numConsumers,
+                         size_t perProducer)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+
+    std::vector<std::thread> consumers;
+    for (size_t ii = 0; ii < numConsumers; ++ii)
+    {
+        consumers.emplace_back([&queue]()
+        {
+            size_t value = 0;
+            do
+            {
+                queue.dequeue(value);
+            } while (value != 0);
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t ii = 0; ii < numProducers; ++ii)
+    {
+        producers.emplace_back([&queue, perProducer]()
+        {
+            for (size_t value = 1; value <= perProducer; ++value)
+            {
+                queue.enqueue(value);
+            }
+        });
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    for (size_t ii = 0; ii < numConsumers; ++ii)
+    {
+        queue.enqueue(0);
+    }
+    for (auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    const double millis = sw.stop();
+    const double millions =
+            static_cast<double>(numProducers * perProducer) / 1.0e6;
+    return millis > 0.0 ? millions / (millis / 1000.0) : 0.0;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const size_t numProducers = argc > 1 ? static_cast<size_t>(atoi(argv[1])) : 4;
+        const size_t numConsumers = argc > 2 ? static_cast<size_t>(atoi(argv[2])) : 4;
+        const size_t perProducer = argc > 3 ? static_cast<size_t>(atoi(argv[3])) : 1000000;
+
+        mt::RequestQueue<size_t> locked;
+        mt::BoundedRequestQueue<size_t> lockFree;
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << numProducers << " producers, " << numConsumers
+                  << " consumers, " << perProducer << " items each\n"
+                  << std::setw(22) << "RequestQueue: "
+                  << millionsPerSecond(locked, numProducers, numConsumers, perProducer)
+                  << " M items/s\n"
+                  << std::setw(22) << "BoundedRequestQueue: "
+                  << millionsPerSecond(lockFree, numProducers, numConsumers, perProducer)
+                  << " M items/s\n";
+        return 0;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
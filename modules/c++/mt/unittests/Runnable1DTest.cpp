@@ -23,6 +23,7 @@
 #include <sstream>
 #include <stdio.h>
 
+#include <atomic>
 #include <vector>
 #include <iterator>
 #include <numeric>
@@ -83,7 +84,57 @@ TEST_CASE(Runnable1DWithCopiesTest)
     TEST_ASSERT_TRUE(true); // need to use hidden "testName" parameter
 }
 
+struct CountOp final
+{
+    CountOp(std::vector<std::atomic<int> >& counts) : mCounts(counts)
+    {
+    }
+    void operator()(size_t element) const
+    {
+        ++mCounts[element];
+    }
+
+private:
+    std::vector<std::atomic<int> >& mCounts;
+};
+
+TEST_CASE(Runnable1DScheduleTest)
+{
+    const mt::Schedule schedules[] = {
+        mt::Schedule(mt::Schedule::STATIC, 7),
+        mt::Schedule(mt::Schedule::DYNAMIC, 3),
+        mt::Schedule(mt::Schedule::GUIDED, 2) };
+    for (const auto& schedule : schedules)
+    {
+        std::vector<std::atomic<int> > counts(1001);
+        mt::run1D(counts.size(), 4, CountOp(counts), schedule);
+        for (const auto& count : counts)
+        {
+            TEST_ASSERT_EQ(count.load(), 1);
+        }
+
+        std::vector<std::atomic<int> > copyCounts(97);
+        mt::run1DWithCopies(copyCounts.size(), 5, CountOp(copyCounts), schedule);
+        for (const auto& count : copyCounts)
+        {
+            TEST_ASSERT_EQ(count.load(), 1);
+        }
+
+#if !defined(__APPLE_CC__)
+        std::vector<std::atomic<int> > poolCounts(513);
+        mt::GenerationThreadPool pool(3);
+        pool.start();
+        pool.run1D(poolCounts.size(), CountOp(poolCounts), schedule);
+        for (const auto& count : poolCounts)
+        {
+            TEST_ASSERT_EQ(count.load(), 1);
+        }
+#endif
+    }
+}
+
 TEST_MAIN(
     TEST_CHECK(DoRunnable1DTest);
     TEST_CHECK(Runnable1DWithCopiesTest);
+    TEST_CHECK(Runnable1DScheduleTest);
     )
@@ -20,6 +20,8 @@
  *
  */
 
+#include <vector>
+
 #include <mt/ThreadPlanner.h>
 #include "TestCase.h"
 
@@ -78,7 +80,74 @@ TEST_CASE(GetNumThreadsThatWillBeUsedTest)
     TEST_ASSERT_EQ(planner7.getNumThreadsThatWillBeUsed(), static_cast<size_t>(100));
 }
 
+TEST_CASE(StaticGrainSizeTest)
+{
+    // 500 / 16 rounds up to 32 per thread, then up to a multiple of 10
+    const mt::ThreadPlanner planner(500, 16, mt::Schedule(mt::Schedule::STATIC, 10));
+    TEST_ASSERT_EQ(planner.getNumElementsPerThread(), static_cast<size_t>(40));
+    TEST_ASSERT_EQ(planner.getNumThreadsThatWillBeUsed(), static_cast<size_t>(13));
+
+    size_t startElement(0);
+    size_t numElements(0);
+    TEST_ASSERT_TRUE(planner.getThreadInfo(12, startElement, numElements));
+    TEST_ASSERT_EQ(startElement, static_cast<size_t>(480));
+    TEST_ASSERT_EQ(numElements, static_cast<size_t>(20));
+    TEST_ASSERT_FALSE(planner.getThreadInfo(13, startElement, numElements));
+}
+
+// Claims chunks until there are none left, checking that every element is
+// handed out exactly once, in order; returns the chunk sizes.
+static std::vector<size_t> getChunks(mt::ThreadPlanner& planner,
+                                     size_t numElements)
+{
+    std::vector<size_t> chunkSizes;
+    size_t nextElement(0);
+    size_t startElement(0);
+    size_t numElementsThisChunk(0);
+    while (planner.getNextChunk(startElement, numElementsThisChunk))
+    {
+        if (startElement != nextElement || numElementsThisChunk == 0)
+        {
+            return std::vector<size_t>();
+        }
+        nextElement += numElementsThisChunk;
+        chunkSizes.push_back(numElementsThisChunk);
+    }
+    return nextElement == numElements ? chunkSizes : std::vector<size_t>();
+}
+
+TEST_CASE(GetNextChunkTest)
+{
+    mt::ThreadPlanner staticPlanner(100, 3);
+    const std::vector<size_t> staticChunks = getChunks(staticPlanner, 100);
+    TEST_ASSERT_EQ(staticChunks.size(), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(staticChunks[0], static_cast<size_t>(34));
+
+    mt::ThreadPlanner dynamicPlanner(100, 3, mt::Schedule(mt::Schedule::DYNAMIC, 8));
+    const std::vector<size_t> dynamicChunks = getChunks(dynamicPlanner, 100);
+    TEST_ASSERT_EQ(dynamicChunks.size(), static_cast<size_t>(13));
+    TEST_ASSERT_EQ(dynamicChunks[0], static_cast<size_t>(8));
+    TEST_ASSERT_EQ(dynamicChunks[12], static_cast<size_t>(4));
+
+    mt::ThreadPlanner guidedPlanner(1000, 4, mt::Schedule(mt::Schedule::GUIDED, 5));
+    const std::vector<size_t> guidedChunks = getChunks(guidedPlanner, 1000);
+    TEST_ASSERT_FALSE(guidedChunks.empty());
+    TEST_ASSERT_EQ(guidedChunks[0], static_cast<size_t>(250));
+    TEST_ASSERT_EQ(guidedChunks[1], static_cast<size_t>(188));
+    for (size_t ii = 1; ii < guidedChunks.size(); ++ii)
+    {
+        TEST_ASSERT_TRUE(guidedChunks[ii] <= guidedChunks[ii - 1]);
+    }
+    TEST_ASSERT_TRUE(guidedChunks.back() <= static_cast<size_t>(5));
+
+    // Nothing to hand out
+    mt::ThreadPlanner emptyPlanner(0, 4, mt::Schedule(mt::Schedule::GUIDED));
+    TEST_ASSERT_TRUE(getChunks(emptyPlanner, 0).empty());
+}
+
 TEST_MAIN(
     TEST_CHECK(GetThreadInfoTest);
     TEST_CHECK(GetNumThreadsThatWillBeUsedTest);
+    TEST_CHECK(StaticGrainSizeTest);
+    TEST_CHECK(GetNextChunkTest);
 )
@@ -64,6 +64,32 @@ TEST_CASE(BalancedRunnable1DTestWorkDone)
     }
 }
 
+TEST_CASE(BalancedRunnable1DTestGrainSize)
+{
+    const size_t numThreads = 4;
+    for (const size_t numElements : { 0, 1, 7, 1000, 100003 })
+    {
+        for (const size_t grainSize : { 1, 16, 5000 })
+        {
+            std::vector<size_t> workVec(numElements, 0);
+            IncOp op(workVec);
+            mt::runBalanced1D(numElements, numThreads, op, grainSize);
+
+            std::vector<size_t> copiesWorkVec(numElements, 0);
+            mt::runBalanced1DWithCopies(numElements, numThreads, IncOp(copiesWorkVec), grainSize);
+
+            std::vector<size_t> serialWorkVec(numElements, 0);
+            mt::runBalanced1D(numElements, 1, IncOp(serialWorkVec), grainSize);
+
+            const std::vector<size_t> expected(numElements, 1);
+            TEST_ASSERT(workVec == expected);
+            TEST_ASSERT(copiesWorkVec == expected);
+            TEST_ASSERT(serialWorkVec == expected);
+        }
+    }
+}
+
 TEST_MAIN(
     TEST_CHECK(BalancedRunnable1DTestWorkDone);
+    TEST_CHECK(BalancedRunnable1DTestGrainSize);
 )
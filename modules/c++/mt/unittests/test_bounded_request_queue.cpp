@@ -0,0 +1,196 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "import/sys.h"
+#include "import/mt.h"
+#include "TestCase.h"
+
+TEST_CASE(testFifo)
+{
+    mt::BoundedRequestQueue<int> queue(5);
+    TEST_ASSERT_EQ(queue.capacity(), static_cast<size_t>(8));
+    TEST_ASSERT_TRUE(queue.isEmpty());
+
+    for (int ii = 0; ii < 8; ++ii)
+    {
+        TEST_ASSERT_TRUE(queue.tryEnqueue(ii));
+    }
+    TEST_ASSERT_EQ(queue.length(), 8);
+    TEST_ASSERT_FALSE(queue.tryEnqueue(8));
+
+    int value = -1;
+    for (int ii = 0; ii < 8; ++ii)
+    {
+        queue.dequeue(value);
+        TEST_ASSERT_EQ(value, ii);
+    }
+    TEST_ASSERT_FALSE(queue.tryDequeue(value));
+
+    // Wrap around the ring a few times
+    for (int ii = 0; ii < 100; ++ii)
+    {
+        queue.enqueue(ii);
+        queue.enqueue(ii + 1);
+        queue.dequeue(value);
+        TEST_ASSERT_EQ(value, ii);
+        queue.dequeue(value);
+        TEST_ASSERT_EQ(value, ii + 1);
+    }
+
+    queue.enqueue(1);
+    queue.enqueue(2);
+    queue.clear();
+    TEST_ASSERT_TRUE(queue.isEmpty());
+}
+
+TEST_CASE(testTimeouts)
+{
+    mt::BoundedRequestQueue<int> queue(2);
+    int value = 0;
+    TEST_ASSERT_FALSE(queue.tryDequeueFor(value, std::chrono::milliseconds(10)));
+
+    TEST_ASSERT_TRUE(queue.tryEnqueueFor(1, std::chrono::milliseconds(10)));
+    TEST_ASSERT_TRUE(queue.tryEnqueueFor(2, std::chrono::milliseconds(10)));
+    TEST_ASSERT_FALSE(queue.tryEnqueueFor(3, std::chrono::milliseconds(10)));
+
+    // A consumer making room wakes up a blocked producer
+    std::thread consumer([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        int ignored;
+        queue.dequeue(ignored);
+    });
+    TEST_ASSERT_TRUE(queue.tryEnqueueFor(3, std::chrono::seconds(10)));
+    consumer.join();
+
+    TEST_ASSERT_TRUE(queue.tryDequeueFor(value, std::chrono::milliseconds(10)));
+    TEST_ASSERT_EQ(value, 2);
+}
+
+TEST_CASE(testManyProducersAndConsumers)
+{
+    // Small capacity so producers and consumers both end up blocking
+    mt::BoundedRequestQueue<size_t> queue(16);
+    constexpr size_t numProducers = 4;
+    constexpr size_t numConsumers = 4;
+    constexpr size_t perProducer = 20000;
+
+    std::atomic<size_t> sum{0};
+    std::atomic<size_t> count{0};
+    std::vector<std::thread> threads;
+    for (size_t ii = 0; ii < numConsumers; ++ii)
+    {
+        threads.emplace_back([&]()
+        {
+            while (true)
+            {
+                size_t value;
+                queue.dequeue(value);
+                if (value == 0)
+                {
+                    return;
+                }
+                sum += value;
+                ++count;
+            }
+        });
+    }
+    for (size_t ii = 0; ii < numProducers; ++ii)
+    {
+        threads.emplace_back([&]()
+        {
+            for (size_t value = 1; value <= perProducer; ++value)
+            {
+                queue.enqueue(value);
+            }
+        });
+    }
+    for (size_t ii = numConsumers; ii < threads.size(); ++ii)
+    {
+        threads[ii].join();
+    }
+    for (size_t ii = 0; ii < numConsumers; ++ii)
+    {
+        queue.enqueue(0);
+    }
+    for (size_t ii = 0; ii < numConsumers; ++ii)
+    {
+        threads[ii].join();
+    }
+
+    TEST_ASSERT_EQ(count.load(), numProducers * perProducer);
+    TEST_ASSERT_EQ(sum.load(), numProducers * perProducer * (perProducer + 1) / 2);
+}
+
+struct AddRunnable final : public sys::Runnable
+{
+    AddRunnable(std::atomic<size_t>& sum, size_t value) :
+        mSum(sum), mValue(value)
+    {
+    }
+    void run() override
+    {
+        mSum += mValue;
+    }
+    std::atomic<size_t>& mSum;
+    size_t mValue;
+};
+
+TEST_CASE(testThreadPools)
+{
+    std::atomic<size_t> sum{0};
+    {
+        mt::BasicThreadPool<mt::GenericRequestHandlerT<mt::BoundedRunnableRequestQueue>,
+                            mt::BoundedRunnableRequestQueue> pool(3);
+        pool.start();
+        for (size_t ii = 1; ii <= 1000; ++ii)
+        {
+            pool.addRequest(new AddRunnable(sum, ii));
+        }
+        pool.shutdown();
+    }
+    TEST_ASSERT_EQ(sum.load(), static_cast<size_t>(500500));
+
+#if !defined(__APPLE_CC__)
+    std::vector<size_t> values(1000, 0);
+    mt::GenerationThreadPoolT<mt::BoundedRunnableRequestQueue> pool(3);
+    pool.start();
+    pool.run1D(values.size(), [&](size_t ii) { values[ii] = ii; });
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(values[ii], ii);
+    }
+    pool.shutdown();
+#endif
+}
+
+TEST_MAIN(
+    TEST_CHECK(testFifo);
+    TEST_CHECK(testTimeouts);
+    TEST_CHECK(testManyProducersAndConsumers);
+    TEST_CHECK(testThreadPools);
+    )
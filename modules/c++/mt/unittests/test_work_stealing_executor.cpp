@@ -0,0 +1,126 @@
+/* =========================================================================
+ * This file is part of mt-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * mt-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "import/sys.h"
+#include "import/mt.h"
+#include "TestCase.h"
+
+TEST_CASE(testParallelFor)
+{
+    std::vector<size_t> values(10000, 0);
+    mt::parallel_for(values.size(), [&](size_t ii) { values[ii] = ii * 2; });
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(values[ii], ii * 2);
+    }
+
+    // Grain size larger than the range runs inline
+    std::atomic<size_t> count{0};
+    mt::parallel_for(10, [&](size_t) { ++count; }, 100);
+    TEST_ASSERT_EQ(count.load(), static_cast<size_t>(10));
+}
+
+TEST_CASE(testParallelInvoke)
+{
+    std::atomic<int> a{0}, b{0}, c{0};
+    mt::parallel_invoke([&]() { a = 1; }, [&]() { b = 2; }, [&]() { c = 3; });
+    TEST_ASSERT_EQ(a.load(), 1);
+    TEST_ASSERT_EQ(b.load(), 2);
+    TEST_ASSERT_EQ(c.load(), 3);
+}
+
+TEST_CASE(testNested)
+{
+    // Every worker may end up waiting on an inner group; waiters help run
+    // queued tasks so this must not deadlock, even with one worker.
+    mt::WorkStealingExecutor executor(1);
+    std::atomic<size_t> count{0};
+    mt::parallel_for(8, [&](size_t)
+    {
+        mt::parallel_for(100, [&](size_t) { ++count; }, 1, executor);
+    }, 1, executor);
+    TEST_ASSERT_EQ(count.load(), static_cast<size_t>(800));
+}
+
+TEST_CASE(testException)
+{
+    mt::WorkStealingExecutor executor(2);
+    mt::TaskGroup tasks(executor);
+    std::atomic<int> ran{0};
+    tasks.run([&]() { ++ran; });
+    tasks.run([]() { throw std::runtime_error("oops"); });
+    tasks.run([&]() { ++ran; });
+    TEST_THROWS(tasks.wait());
+    TEST_ASSERT_EQ(ran.load(), 2);
+
+    // The error is only reported once
+    tasks.wait();
+}
+
+struct CountRunnable final : public sys::Runnable
+{
+    CountRunnable(std::atomic<int>& count) : mCount(count) { }
+    void run() override
+    {
+        ++mCount;
+    }
+    std::atomic<int>& mCount;
+};
+
+struct ThrowRunnable final : public sys::Runnable
+{
+    void run() override
+    {
+        throw except::Exception(Ctxt("ThrowRunnable"));
+    }
+};
+
+TEST_CASE(testThreadGroupOnExecutor)
+{
+    std::atomic<int> count{0};
+    {
+        mt::ThreadGroup threads(mt::WorkStealingExecutor::getInstance());
+        TEST_ASSERT_FALSE(threads.isPinToCPUEnabled());
+        for (int ii = 0; ii < 20; ++ii)
+        {
+            threads.createThread(new CountRunnable(count));
+        }
+        threads.joinAll();
+    }
+    TEST_ASSERT_EQ(count.load(), 20);
+
+    mt::ThreadGroup threads(mt::WorkStealingExecutor::getInstance());
+    threads.createThread(new ThrowRunnable());
+    TEST_EXCEPTION(threads.joinAll());
+}
+
+TEST_MAIN(
+    TEST_CHECK(testParallelFor);
+    TEST_CHECK(testParallelInvoke);
+    TEST_CHECK(testNested);
+    TEST_CHECK(testException);
+    TEST_CHECK(testThreadGroupOnExecutor);
+    )
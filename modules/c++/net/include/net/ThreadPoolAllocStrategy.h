@@ -8,9 +8,21 @@
 
 namespace net
 {
+/*!
+ *  The queue between the thread accepting connections and the
+ *  ConnectionThread's.  By default this is an unbounded mt::RequestQueue.
+ */
+typedef mt::RequestQueue<NetConnection*> ConnectionQueue;
+
+/*!
+ *  Opt-in alternative to ConnectionQueue (see BoundedThreadPoolAllocStrategy).
+ *  It is lock-free and bounded, so if the workers fall far enough behind,
+ *  accepting new connections waits on them.
+ */
+typedef mt::BoundedRequestQueue<NetConnection*> BoundedConnectionQueue;
 
 /*!
- *  \class ConnectionThread
+ *  \class ConnectionThreadT
  *  \brief Worker thread satisfies net connections
  *
  *  This class is a very simple WorkerThread that handles
@@ -24,27 +36,29 @@ namespace net
  *  Also note that, since we are in a server, we will never shut down
  *
  */
-class ConnectionThread: public mt::WorkerThread<NetConnection*>
+template <typename ConnectionQueue_T = ConnectionQueue>
+class ConnectionThreadT: public mt::WorkerThread<NetConnection*, ConnectionQueue_T>
 {
     RequestHandler* mHandler;
 public:
     //! Each thread gets 1 unique request handler
-    ConnectionThread(mt::RequestQueue<NetConnection*>* connQueue,
+    ConnectionThreadT(ConnectionQueue_T* connQueue,
             net::RequestHandler* handler) :
-        mt::WorkerThread<NetConnection*>(connQueue), mHandler(handler)
+        mt::WorkerThread<NetConnection*, ConnectionQueue_T>(connQueue),
+        mHandler(handler)
     {
     }
 
     //! Even though ownership doesnt mean much at this point, delete ours
-    ~ConnectionThread()
+    ~ConnectionThreadT()
     {
         delete mHandler;
     }
 
-    ConnectionThread(const ConnectionThread&) = delete;
-    ConnectionThread& operator=(const ConnectionThread&) = delete;
-    ConnectionThread(ConnectionThread&&) = delete;
-    ConnectionThread& operator=(ConnectionThread&&) = delete;
+    ConnectionThreadT(const ConnectionThreadT&) = delete;
+    ConnectionThreadT& operator=(const ConnectionThreadT&) = delete;
+    ConnectionThreadT(ConnectionThreadT&&) = delete;
+    ConnectionThreadT& operator=(ConnectionThreadT&&) = delete;
 
     /*!
      *  Do this in a loop forever.
@@ -54,9 +68,10 @@ public:
         (*mHandler)(request);
     }
 };
+typedef ConnectionThreadT<> ConnectionThread;
 
 /*!
- *  \class ConnectionThreadPool
+ *  \class ConnectionThreadPoolT
  *  \brief Thread pool that creates ConnectionThread objects
  *
  *  Class implements abstract methods of AbstractThreadPool.
@@ -67,35 +82,39 @@ public:
  *  and the RequestHandler implementations are a nod to this,
  *  recognizing that all resources are safe within this thread
  */
-class ConnectionThreadPool: public mt::AbstractThreadPool<net::NetConnection*>
+template <typename ConnectionQueue_T = ConnectionQueue>
+class ConnectionThreadPoolT:
+        public mt::AbstractThreadPool<net::NetConnection*, ConnectionQueue_T>
 {
     RequestHandlerFactory* mFactory;
 
 public:
-    ConnectionThreadPool(unsigned short numThreads,
+    ConnectionThreadPoolT(unsigned short numThreads,
             net::RequestHandlerFactory* factory) :
-        mt::AbstractThreadPool<net::NetConnection*>(numThreads), mFactory(
+        mt::AbstractThreadPool<net::NetConnection*, ConnectionQueue_T>(numThreads), mFactory(
                 factory)
     {
     }
-    ~ConnectionThreadPool()
+    ~ConnectionThreadPoolT()
     {
         delete mFactory;
     }
 
-    ConnectionThreadPool(const ConnectionThreadPool&) = delete;
-    ConnectionThreadPool& operator=(const ConnectionThreadPool&) = delete;
-    ConnectionThreadPool(ConnectionThreadPool&&) = delete;
-    ConnectionThreadPool& operator=(ConnectionThreadPool&&) = delete;
+    ConnectionThreadPoolT(const ConnectionThreadPoolT&) = delete;
+    ConnectionThreadPoolT& operator=(const ConnectionThreadPoolT&) = delete;
+    ConnectionThreadPoolT(ConnectionThreadPoolT&&) = delete;
+    ConnectionThreadPoolT& operator=(ConnectionThreadPoolT&&) = delete;
 
-    mt::WorkerThread<net::NetConnection*>* newWorker() override
+    mt::WorkerThread<net::NetConnection*, ConnectionQueue_T>* newWorker() override
     {
-        return new ConnectionThread(&mRequestQueue, mFactory->create());
+        return new ConnectionThreadT<ConnectionQueue_T>(&this->mRequestQueue,
+                                                        mFactory->create());
     }
 };
+typedef ConnectionThreadPoolT<> ConnectionThreadPool;
 
 /*!
- *  \class ThreadPoolAllocStrategy
+ *  \class ThreadPoolAllocStrategyT
  *  \brief Thread pool-backed AllocStrategy
  *
  *  The net package presents the allocation strategy as orthogonal
@@ -121,27 +140,44 @@ public:
  *  Then, when a worker/consumer is ready to process the connection, it
  *  picks it up from the queue and hands it to its RequestHandler
  *
+ *  The buffer is a ConnectionQueue unless another queue type is given;
+ *  BoundedThreadPoolAllocStrategy uses a BoundedConnectionQueue.
  */
-class ThreadPoolAllocStrategy: public AllocStrategy
+template <typename ConnectionQueue_T = ConnectionQueue>
+class ThreadPoolAllocStrategyT: public AllocStrategy
 {
 
-    ConnectionThreadPool* mPool;
+    ConnectionThreadPoolT<ConnectionQueue_T>* mPool;
     unsigned short mNumThreads;
 public:
-    ThreadPoolAllocStrategy(unsigned short numThreads) :
+    ThreadPoolAllocStrategyT(unsigned short numThreads) :
         mPool(nullptr), mNumThreads(numThreads)
     {
     }
 
-    ~ThreadPoolAllocStrategy();
+    ~ThreadPoolAllocStrategyT()
+    {
+        if (mPool)
+            delete mPool;
+    }
 
     // AllocStrategy guarantees that mRequestHandlerFactory is initialized
     // by the time this function is called
-    void initialize() override;
+    void initialize() override
+    {
+        mPool = new ConnectionThreadPoolT<ConnectionQueue_T>(mNumThreads,
+                                                             mRequestHandlerFactory);
+        mPool->start();
+    }
 
-    void handleConnection(net::NetConnection* conn) override;
+    void handleConnection(net::NetConnection* conn) override
+    {
+        mPool->addRequest(conn);
+    }
 
 };
+typedef ThreadPoolAllocStrategyT<> ThreadPoolAllocStrategy;
+typedef ThreadPoolAllocStrategyT<BoundedConnectionQueue> BoundedThreadPoolAllocStrategy;
 }
 
 #endif
@@ -29,6 +29,8 @@
 #include "sio/lite/FileHeader.h"
 #include "sio/lite/FileReader.h"
 #include "sio/lite/FileWriter.h"
+#include "sio/lite/MappedImage.h"
+#include "sio/lite/ParallelFileWriter.h"
 #include "sio/lite/UserDataDictionary.h"
 
 #endif
@@ -151,6 +151,20 @@ public:
         differentByteOrdering = isDifferent;
     }
 
+    /*!
+     *  The size of the pieces to byte swap when the byte order differs:
+     *  the element size, or half of it for complex data, since complex
+     *  pixels are swapped per component.  N-byte data is bytes, not
+     *  numbers, so it isn't swapped.
+     *
+     *  \return The swap size, or 0 if there's nothing to swap
+     */
+    static size_t getSwapSize(int elementType, size_t elementSize);
+    size_t getSwapSize() const
+    {
+        return getSwapSize(et, static_cast<size_t>(es));
+    }
+
     /**
      * Does a given user data field exist?
      *
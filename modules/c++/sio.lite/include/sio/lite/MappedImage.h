@@ -0,0 +1,206 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_sio_lite_MappedImage_h_INCLUDED_
+#define CODA_OSS_sio_lite_MappedImage_h_INCLUDED_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <gsl/gsl.h>
+#include <coda_oss/mdspan.h>
+#include <coda_oss/span.h>
+#include <except/Exception.h>
+#include <sys/ByteSwap.h>
+#include <types/RowCol.h>
+#include <sio/lite/ElementType.h>
+#include <sio/lite/FileHeader.h>
+#include <sio/lite/FileReader.h>
+
+namespace sio
+{
+namespace lite
+{
+/*!
+ *  \class MappedImage
+ *  \brief Memory maps an SIO file and hands out its pixels in place
+ *
+ *  Opening only parses the header and maps the file, so it's quick no
+ *  matter how big the file is; pages are read as rows are touched.  If
+ *  the file is in our byte order (and the pixels are suitably aligned,
+ *  which depends on the header length), view() and row() point straight
+ *  into the mapping.  Otherwise each row is copied and byte swapped the
+ *  first time it's asked for, and kept for as long as this object lives.
+ *
+    \code
+
+    sio::lite::MappedImage<float> image(pathname);
+    if (image.isInPlace())
+    {
+        const auto pixels = image.view();
+        float sum = 0;
+        for (size_t col = 0; col < pixels.extent(1); ++col)
+            sum += pixels(row, col);
+    }
+    else
+    {
+        const auto pixels = image.row(row);
+        ...
+    }
+
+    \endcode
+ */
+template <typename T>
+class MappedImage final
+{
+public:
+    using extents_type = coda_oss::dextents<size_t, 2>;
+    using view_type = coda_oss::mdspan<const T, extents_type>;
+
+    /*!
+     *  \param pathname The SIO file
+     *  \param mapFlags See io::MMapInputStream::open()
+     *
+     *  \throw except::Exception if the pixels aren't of type T
+     *  \throw except::IndexOutOfRangeException if the file is too short for
+     *         the image its header describes
+     */
+    explicit MappedImage(const std::string& pathname, int mapFlags = 0) :
+        mReader(new FileReader(pathname, true, mapFlags))
+    {
+        const FileHeader& header = getHeader();
+        if (header.getElementSize() != sizeof(T) ||
+            header.getElementType() != ElementType<T>::Type)
+        {
+            throw except::Exception(Ctxt("Unexpected format"));
+        }
+        mDims.row = gsl::narrow<size_t>(header.getNumLines());
+        mDims.col = gsl::narrow<size_t>(header.getNumElements());
+
+        mPixels = mReader->view(0, mDims.area() * sizeof(T)).data();
+        const bool aligned =
+                reinterpret_cast<uintptr_t>(mPixels) % alignof(T) == 0;
+        mSwapSize = header.isDifferentByteOrdering() ? header.getSwapSize() : 0;
+        mInPlace = aligned && mSwapSize == 0;
+        if (!mInPlace)
+        {
+            mRows.reset(new Row[mDims.row]);
+        }
+    }
+
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    const FileHeader& getHeader() const
+    {
+        return *mReader->getHeader();
+    }
+
+    const types::RowCol<size_t>& getDims() const
+    {
+        return mDims;
+    }
+
+    //! \return True if view() is available, as the pixels need no copying
+    bool isInPlace() const
+    {
+        return mInPlace;
+    }
+
+    /*!
+     *  \return The whole image, straight from the mapping
+     *  \throw except::Exception if !isInPlace()
+     */
+    view_type view() const
+    {
+        if (!mInPlace)
+        {
+            throw except::Exception(Ctxt(
+                    "SIO pixels need byte swapping or aligning; use row()"));
+        }
+        return view_type(reinterpret_cast<const T*>(mPixels),
+                         extents_type(mDims.row, mDims.col));
+    }
+
+    /*!
+     *  \return One row in our byte order.  It's valid as long as this
+     *          object is.  It's safe to call from several threads at once.
+     *  \throw except::IndexOutOfRangeException if row is past the end
+     */
+    coda_oss::span<const T> row(size_t row) const
+    {
+        if (row >= mDims.row)
+        {
+            throw except::IndexOutOfRangeException(Ctxt(
+                    "Row " + std::to_string(row) + " is past the end"));
+        }
+
+        const sys::byte* const pixels = mPixels + row * mDims.col * sizeof(T);
+        if (mInPlace)
+        {
+            return coda_oss::span<const T>(
+                    reinterpret_cast<const T*>(pixels), mDims.col);
+        }
+
+        Row& cached = mRows[row];
+        std::call_once(cached.once, [&]()
+        {
+            cached.data.reset(new T[mDims.col]);
+            ::memcpy(cached.data.get(), pixels, mDims.col * sizeof(T));
+            if (mSwapSize)
+            {
+                sys::byteSwap(static_cast<void*>(cached.data.get()), mSwapSize,
+                              mDims.col * sizeof(T) / mSwapSize);
+            }
+        });
+        return coda_oss::span<const T>(cached.data.get(), mDims.col);
+    }
+
+    //! \return The pixel at (row, col), without range checking col
+    T operator()(size_t row, size_t col) const
+    {
+        return this->row(row)[col];
+    }
+
+private:
+    struct Row final
+    {
+        std::once_flag once;
+        std::unique_ptr<T[]> data;
+    };
+
+    std::unique_ptr<FileReader> mReader;
+    types::RowCol<size_t> mDims;
+    const sys::byte* mPixels = nullptr;
+    size_t mSwapSize = 0;
+    bool mInPlace = false;
+    std::unique_ptr<Row[]> mRows;
+};
+}
+}
+
+#endif  // CODA_OSS_sio_lite_MappedImage_h_INCLUDED_
@@ -0,0 +1,119 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_sio_lite_ParallelFileWriter_h_INCLUDED_
+#define CODA_OSS_sio_lite_ParallelFileWriter_h_INCLUDED_
+
+#include <string>
+
+#include <coda_oss/bit.h>
+#include <sys/File.h>
+#include "config/Exports.h"
+#include "sio/lite/FileHeader.h"
+
+namespace sio
+{
+namespace lite
+{
+/*!
+ *  \class ParallelFileWriter
+ *  \brief Writes an SIO file a block of rows at a time, from any thread
+ *
+ *  The header is written and the whole file is allocated up front, so
+ *  every block of rows has a fixed place in the file and is written there
+ *  with a positional write.  Blocks can arrive in any order, from as many
+ *  threads as like.  Pixels are given in our byte order and swapped to the
+ *  file's byte order, if that's different, on the way out.
+ *
+    \code
+
+    sio::lite::FileHeader header(numRows, numCols, sizeof(float),
+                                 sio::lite::FileHeader::FLOAT);
+    sio::lite::ParallelFileWriter writer(pathname, header);
+    mt::parallel_for(numBlocks, [&](size_t block)
+    {
+        const auto rows = process(block);
+        writer.writeRows(block * blockRows, blockRows, rows.data());
+    });
+    writer.close();
+
+    \endcode
+ */
+class CODA_OSS_API ParallelFileWriter final
+{
+public:
+    /*!
+     *  Create the file, write its header and allocate the rest.
+     *
+     *  \param pathname The file to create
+     *  \param header The image size and type, and any user data
+     *  \param byteOrder The byte order of the file.  User data is written
+     *         as is.
+     */
+    ParallelFileWriter(const std::string& pathname,
+                       const FileHeader& header,
+                       coda_oss::endian byteOrder = coda_oss::endian::native);
+
+    //! Closes the file if close() wasn't called, ignoring errors
+    ~ParallelFileWriter();
+
+    ParallelFileWriter(const ParallelFileWriter&) = delete;
+    ParallelFileWriter& operator=(const ParallelFileWriter&) = delete;
+
+    const FileHeader& getHeader() const
+    {
+        return mHeader;
+    }
+
+    /*!
+     *  Write numRows rows, starting at startRow.  This is safe to call
+     *  from several threads at once, for different rows.
+     *
+     *  \param startRow The first row
+     *  \param numRows The number of rows
+     *  \param data numRows full rows, in our byte order
+     *
+     *  \throw except::IndexOutOfRangeException if the rows aren't in the
+     *         image
+     */
+    void writeRows(size_t startRow, size_t numRows, const void* data);
+
+    /*!
+     *  Close the file.  Nothing should be writing to it.
+     *  \param flush If set, flush the file to disk first
+     */
+    void close(bool flush = false);
+
+private:
+    void writeHeader(bool swap);
+
+    FileHeader mHeader;
+    sys::File mFile;
+    size_t mRowBytes = 0;
+    size_t mSwapSize = 0;
+    sys::Off_T mDataOffset = 0;
+};
+}
+}
+
+#endif  // CODA_OSS_sio_lite_ParallelFileWriter_h_INCLUDED_
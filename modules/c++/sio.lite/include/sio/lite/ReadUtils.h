@@ -42,9 +42,30 @@ namespace sio
 {
 namespace lite
 {
+namespace details
+{
+// Reads the image data, byte swapping it on the fly if the file's byte
+// order doesn't match ours (see FileHeader::getSwapSize()).
+inline void readImage(FileReader& reader, void* buffer, size_t numBytes)
+{
+    const sio::lite::FileHeader* const header(reader.getHeader());
+    const size_t swapSize = header->isDifferentByteOrdering() ? header->getSwapSize() : 0;
+    if (swapSize)
+    {
+        reader.readAndByteSwap(buffer, numBytes, swapSize, true);
+    }
+    else
+    {
+        reader.read(buffer, numBytes, true);
+    }
+}
+}
+
 /*
  *  \function readSIO
- *  \brief Opens an SIO of a templated data type.
+ *  \brief Opens an SIO of a templated data type.  If the file was
+ *  written with a different byte order, the data is byte swapped as it's
+ *  read.
  *
  *  \param pathname The location of the sio.
  *  \param dims Output for the size of the sio.
@@ -68,7 +89,7 @@ void readSIO(const std::string& pathname,
 
     const size_t numPixels(dims.row * dims.col);
     image.reset(new InputT[numPixels]);
-    reader.read(image.get(), numPixels * sizeof(InputT), true);
+    details::readImage(reader, image.get(), numPixels * sizeof(InputT));
 }
 template <typename InputT>
 void readSIO(const coda_oss::filesystem::path& pathname,
@@ -87,7 +108,7 @@ void readSIO(const coda_oss::filesystem::path& pathname,
     }
 
     image.resize(dims.area());
-    reader.read(sys::make_span(image), true /*verifyFullRead*/);
+    details::readImage(reader, image.data(), image.size() * sizeof(InputT));
 }
 
 /*
@@ -26,6 +26,8 @@
 #include <import/sys.h>
 #include <io/Seekable.h>
 #include <io/FileInputStream.h>
+#include <io/MMapInputStream.h>
+#include <types/RowCol.h>
 #include "config/Exports.h"
 #include "sio/lite/InvalidHeaderException.h"
 #include "sio/lite/StreamReader.h"
@@ -46,8 +48,9 @@ namespace lite
  *  the StreamReader (e.g., data coming in from a socket).  If its really a file
  *  use the FileReader in conjunction with a FileInputStream.
  *
- *  To make this safer, only supports the FileInputStream and std::string 
- *  args for now:
+ *  To make this safer, only supports the FileInputStream, MMapInputStream
+ *  and std::string args for now.  With an MMapInputStream, view() gives
+ *  zero-copy access to the image data.
  *
     \code 
 
@@ -98,6 +101,12 @@ public:
     {
     }
 
+    /*!
+     *  Open file, memory mapping it if memoryMap is set.
+     *  \param mapFlags See io::MMapInputStream::open()
+     */
+    FileReader(const std::string& file, bool memoryMap, int mapFlags = 0);
+
 
     /**  Construct from stream  */
     FileReader(io::FileInputStream* is, bool adopt = false) : 
@@ -105,6 +114,12 @@ public:
     {
     }
 
+    /**  Construct from a memory mapped stream  */
+    FileReader(io::MMapInputStream* is, bool adopt = false) :
+        StreamReader(is, adopt)
+    {
+    }
+
     /*!
      *  Overloaded seek, only works if this is a FileInputStream.
      *  Reports position relative to file header if Whence == 
@@ -135,9 +150,68 @@ public:
      */
     sys::Off_T tell() override;
 
+    /*!
+     *  Read len bytes of image data, byte swapping them as elements of
+     *  elemSize bytes as they are read.  This avoids a second pass over
+     *  the data when isDifferentByteOrdering() is set on the header.
+     *  See io::FileInputStream::readAndByteSwap().
+     */
+    sys::SSize_T readAndByteSwap(void* buffer,
+                                 size_t len,
+                                 size_t elemSize,
+                                 bool verifyFullRead = false);
+
+    //!  Is the stream an io::MMapInputStream?
+    bool isMemoryMapped() const
+    {
+        return getMappedStream() != nullptr;
+    }
+
+    /*!
+     *  Borrow len bytes of image data, starting offset bytes past the
+     *  header, straight from the mapping.  The data is in file byte order.
+     *  It's valid until the stream is closed.
+     *
+     *  \throw except::Exception if the stream isn't memory mapped
+     *  \throw except::IndexOutOfRangeException if the range is past the
+     *         end of the file
+     */
+    coda_oss::span<const sys::byte> view(sys::Off_T offset, size_t len) const;
+
+
+    /*!
+     *  Read a window of the image into buffer, in raster order.  Output
+     *  pixel (r, c) is image pixel
+     *  (start.row + r * stride.row, start.col + c * stride.col), so a
+     *  stride of (4, 4) reads a quarter-resolution overview.
+     *
+     *  Rows that are close together in the file are coalesced into a
+     *  single positional read (or read straight out of the mapping), and
+     *  when whole rows are wanted they land directly in buffer.  Pixels
+     *  are byte swapped as they're placed if isDifferentByteOrdering() is
+     *  set on the header.  This doesn't move the stream position.
+     *
+     *  \param buffer At least dims.area() * element size bytes
+     *  \param start The first image pixel to read
+     *  \param dims The number of rows and columns to read
+     *  \param stride The step between pixels read in each direction
+     *  \param numThreads If more than 1, reads are done in parallel, in
+     *         up to this many tasks on the shared mt::WorkStealingExecutor
+     *
+     *  \throw except::IndexOutOfRangeException if the window isn't inside
+     *         the image
+     */
+    void readRegion(void* buffer,
+                    const types::RowCol<size_t>& start,
+                    const types::RowCol<size_t>& dims,
+                    const types::RowCol<size_t>& stride =
+                            types::RowCol<size_t>(1, 1),
+                    size_t numThreads = 1) const;
 
     void killStream() override;
 protected:
+    io::SeekableInputStream* getSeekableStream() const;
+    io::MMapInputStream* getMappedStream() const;
 };
 }
 }
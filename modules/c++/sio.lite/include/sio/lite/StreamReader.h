@@ -178,6 +178,14 @@ protected:
      */
     int getNextInteger();
 
+    /**
+     *  Read count integers in one go, byte swapping them if need be.
+     *
+     *  @throws sio::lite::InvalidHeaderException
+     *  @throws except::IOException if the stream ends first
+     */
+    void readIntegers(int* values, size_t count);
+
 
     /**
      *  Type 2 headers have user data.  This method
@@ -61,6 +61,24 @@ std::string sio::lite::FileHeader::getElementTypeAsString() const
     return type;
 }
 
+size_t sio::lite::FileHeader::getSwapSize(int elementType, size_t elementSize)
+{
+    switch (elementType)
+    {
+        case N_BYTE_UNSIGNED:
+        case N_BYTE_SIGNED:
+            return 0;
+        case COMPLEX_UNSIGNED:
+        case COMPLEX_SIGNED:
+        case COMPLEX_FLOAT:
+            elementSize /= 2;
+            break;
+        default:
+            break;
+    }
+    return elementSize > 1 ? elementSize : 0;
+}
+
 long sio::lite::FileHeader::getLength() const
 {
     size_t length = SIO_HEADER_LENGTH;
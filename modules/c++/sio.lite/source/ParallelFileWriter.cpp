@@ -0,0 +1,179 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sio/lite/ParallelFileWriter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include <except/Exception.h>
+#include <io/StringStream.h>
+#include <sys/ByteSwap.h>
+
+namespace
+{
+// Swapped pixels go out in pieces this big
+constexpr size_t SWAP_CHUNK_SIZE = 1024 * 1024;
+
+void swapInt(std::string& bytes, size_t offset)
+{
+    sys::byteSwap(&bytes[offset], 4, 1);
+}
+
+int getInt(const std::string& bytes, size_t offset)
+{
+    int value;
+    ::memcpy(&value, bytes.data() + offset, sizeof(value));
+    return value;
+}
+}
+
+namespace sio
+{
+namespace lite
+{
+ParallelFileWriter::ParallelFileWriter(const std::string& pathname,
+                                       const FileHeader& header,
+                                       coda_oss::endian byteOrder) :
+    mHeader(header)
+{
+    // That's how FileHeader::to() writes them, whatever was read
+    mHeader.setNullTerminationFlag(true);
+
+    const auto numLines = static_cast<size_t>(mHeader.getNumLines());
+    const auto elemSize = static_cast<size_t>(mHeader.getElementSize());
+    mRowBytes = static_cast<size_t>(mHeader.getNumElements()) * elemSize;
+
+    const bool swap = byteOrder != coda_oss::endian::native;
+    mSwapSize = swap ? mHeader.getSwapSize() : 0;
+
+    mFile.create(pathname, sys::File::WRITE_ONLY,
+                 sys::File::CREATE | sys::File::TRUNCATE);
+
+    // Everything has its place, so reserve it all now
+    mDataOffset = static_cast<sys::Off_T>(mHeader.getLength());
+    mFile.allocate(mDataOffset + static_cast<sys::Off_T>(numLines * mRowBytes));
+    writeHeader(swap);
+}
+
+ParallelFileWriter::~ParallelFileWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void ParallelFileWriter::writeHeader(bool swap)
+{
+    io::StringStream stream;
+    mHeader.to(1, stream);
+    std::string bytes = stream.stream().str();
+
+    if (swap)
+    {
+        // The magic number, then nl, ne, et and es
+        for (size_t offset = 0; offset < FileHeader::BASIC_HEADER_LENGTH;
+             offset += 4)
+        {
+            swapInt(bytes, offset);
+        }
+
+        // The sizes in the user data, but not the data
+        size_t offset = FileHeader::BASIC_HEADER_LENGTH;
+        if (offset < bytes.size())
+        {
+            const int numFields = getInt(bytes, offset);
+            swapInt(bytes, offset);
+            offset += 4;
+            for (int ii = 0; ii < numFields; ++ii)
+            {
+                const int keySize = getInt(bytes, offset);
+                swapInt(bytes, offset);
+                offset += 4 + keySize;
+
+                const int dataSize = getInt(bytes, offset);
+                swapInt(bytes, offset);
+                offset += 4 + dataSize;
+            }
+        }
+    }
+
+    mFile.writeAtFrom(0, bytes.data(), bytes.size());
+}
+
+void ParallelFileWriter::writeRows(size_t startRow, size_t numRows,
+                                   const void* data)
+{
+    const auto numLines = static_cast<size_t>(mHeader.getNumLines());
+    if (startRow + numRows > numLines)
+    {
+        std::ostringstream ostr;
+        ostr << "Rows " << startRow << " to " << startRow + numRows
+             << " are past the end of the " << numLines << "-row image";
+        throw except::IndexOutOfRangeException(Ctxt(ostr));
+    }
+
+    const sys::Off_T offset = mDataOffset +
+            static_cast<sys::Off_T>(startRow * mRowBytes);
+    const size_t numBytes = numRows * mRowBytes;
+    const sys::byte* const src = static_cast<const sys::byte*>(data);
+    if (mSwapSize == 0)
+    {
+        mFile.writeAtFrom(offset, src, numBytes);
+        return;
+    }
+
+    // Whole pixels per chunk
+    const size_t elemSize = static_cast<size_t>(mHeader.getElementSize());
+    const size_t chunkSize =
+            std::max<size_t>(SWAP_CHUNK_SIZE / elemSize, 1) * elemSize;
+    std::vector<sys::byte> chunk(std::min(chunkSize, numBytes));
+    for (size_t done = 0; done < numBytes; done += chunk.size())
+    {
+        const size_t len = std::min(chunk.size(), numBytes - done);
+        ::memcpy(chunk.data(), src + done, len);
+        sys::byteSwap(chunk.data(), mSwapSize, len / mSwapSize);
+        mFile.writeAtFrom(offset + static_cast<sys::Off_T>(done),
+                          chunk.data(), len);
+    }
+}
+
+void ParallelFileWriter::close(bool flush)
+{
+    if (mFile.isOpen())
+    {
+        if (flush)
+        {
+            mFile.flush();
+        }
+        mFile.close();
+    }
+}
+}
+}
@@ -21,26 +21,294 @@
  */
 #include "sio/lite/FileReader.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include <except/Exception.h>
+#include <math/Round.h>
+#include <mt/WorkStealingExecutor.h>
+#include <sys/ByteSwap.h>
+
+namespace
+{
+// Read through gaps this small rather than start another read
+constexpr size_t MAX_GAP = 64 * 1024;
+
+// Bounds scratch memory, and gives parallel reads something to split
+constexpr size_t MAX_RUN = 4 * 1024 * 1024;
+
+// Consecutive output rows covered by one read
+struct Run final
+{
+    size_t firstRow;
+    size_t numRows;
+    sys::Off_T offset;  // past the header
+    size_t numBytes;
+};
+
+template <size_t N>
+void gatherPixels(const sys::byte* src, size_t srcStep, sys::byte* dest,
+                  size_t numPixels)
+{
+    for (size_t ii = 0; ii < numPixels; ++ii, src += srcStep, dest += N)
+    {
+        ::memcpy(dest, src, N);
+    }
+}
+
+void gatherPixels(const sys::byte* src, size_t srcStep, sys::byte* dest,
+                  size_t numPixels, size_t elemSize)
+{
+    switch (elemSize)
+    {
+    case 1:
+        gatherPixels<1>(src, srcStep, dest, numPixels);
+        break;
+    case 2:
+        gatherPixels<2>(src, srcStep, dest, numPixels);
+        break;
+    case 4:
+        gatherPixels<4>(src, srcStep, dest, numPixels);
+        break;
+    case 8:
+        gatherPixels<8>(src, srcStep, dest, numPixels);
+        break;
+    case 16:
+        gatherPixels<16>(src, srcStep, dest, numPixels);
+        break;
+    default:
+        for (size_t ii = 0; ii < numPixels;
+             ++ii, src += srcStep, dest += elemSize)
+        {
+            ::memcpy(dest, src, elemSize);
+        }
+    }
+}
+
+io::InputStream* openStream(const std::string& file,
+                            bool memoryMap,
+                            int mapFlags)
+{
+    if (memoryMap)
+    {
+        return new io::MMapInputStream(file, mapFlags);
+    }
+    return new io::FileInputStream(file);
+}
+}
+
+sio::lite::FileReader::FileReader(const std::string& file,
+                                  bool memoryMap,
+                                  int mapFlags) :
+    StreamReader(openStream(file, memoryMap, mapFlags), true)
+{
+}
+
+io::SeekableInputStream* sio::lite::FileReader::getSeekableStream() const
+{
+    return dynamic_cast<io::SeekableInputStream*>(inputStream);
+}
+
+io::MMapInputStream* sio::lite::FileReader::getMappedStream() const
+{
+    return dynamic_cast<io::MMapInputStream*>(inputStream);
+}
+
 sys::Off_T sio::lite::FileReader::seek( sys::Off_T offset, Whence whence )
 {
     if (whence == START)
         offset = offset + headerLength;
     
-    ( (io::FileInputStream*)inputStream )->seek(offset, whence);
+    getSeekableStream()->seek(offset, whence);
     return this->tell();
 }
 
 sys::Off_T sio::lite::FileReader::tell()
 {
-    return ( (io::FileInputStream*)inputStream )->tell() - headerLength;
+    return getSeekableStream()->tell() - headerLength;
+}
+
+sys::SSize_T sio::lite::FileReader::readAndByteSwap(void* buffer,
+                                                    size_t len,
+                                                    size_t elemSize,
+                                                    bool verifyFullRead)
+{
+    if (io::MMapInputStream* mapped = getMappedStream())
+    {
+        return mapped->readAndByteSwap(buffer, len, elemSize, verifyFullRead);
+    }
+    return ( (io::FileInputStream*)inputStream )->readAndByteSwap(
+            buffer, len, elemSize, verifyFullRead);
+}
+
+coda_oss::span<const sys::byte> sio::lite::FileReader::view(sys::Off_T offset,
+                                                            size_t len) const
+{
+    const io::MMapInputStream* const mapped = getMappedStream();
+    if (!mapped)
+    {
+        throw except::Exception(Ctxt("SIO stream is not memory mapped"));
+    }
+    return mapped->view(offset + headerLength, len);
+}
+
+void sio::lite::FileReader::readRegion(void* buffer,
+                                       const types::RowCol<size_t>& start,
+                                       const types::RowCol<size_t>& dims,
+                                       const types::RowCol<size_t>& stride,
+                                       size_t numThreads) const
+{
+    const FileHeader* const hdr = getHeader();
+    const size_t numLines = static_cast<size_t>(hdr->getNumLines());
+    const size_t numElements = static_cast<size_t>(hdr->getNumElements());
+    const size_t elemSize = static_cast<size_t>(hdr->getElementSize());
+    if (stride.row == 0 || stride.col == 0)
+    {
+        throw except::InvalidArgumentException(Ctxt("Stride must be positive"));
+    }
+    if (dims.row == 0 || dims.col == 0)
+    {
+        return;
+    }
+    const size_t lastRow = start.row + (dims.row - 1) * stride.row;
+    const size_t lastCol = start.col + (dims.col - 1) * stride.col;
+    if (lastRow >= numLines || lastCol >= numElements)
+    {
+        std::ostringstream ostr;
+        ostr << "Window of " << dims.row << "x" << dims.col << " at ("
+             << start.row << ", " << start.col << ") with stride ("
+             << stride.row << ", " << stride.col << ") is outside the "
+             << numLines << "x" << numElements << " image";
+        throw except::IndexOutOfRangeException(Ctxt(ostr));
+    }
+
+    io::MMapInputStream* const mapped = getMappedStream();
+    io::FileInputStream* const file = mapped ? nullptr :
+            dynamic_cast<io::FileInputStream*>(inputStream);
+    if (!mapped && !file)
+    {
+        throw except::Exception(Ctxt("No input to read the region from"));
+    }
+
+    // Each output row comes from one segment of an image row
+    const size_t imageRowBytes = numElements * elemSize;
+    const size_t segmentBytes = (lastCol - start.col + 1) * elemSize;
+    const size_t outRowBytes = dims.col * elemSize;
+    const auto segmentOffset = [&](size_t row)
+    {
+        return static_cast<sys::Off_T>(
+                (start.row + row * stride.row) * imageRowBytes +
+                start.col * elemSize);
+    };
+
+    std::vector<Run> runs;
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        const sys::Off_T offset = segmentOffset(row);
+        if (!runs.empty())
+        {
+            Run& run = runs.back();
+            const sys::Off_T runEnd = run.offset +
+                    static_cast<sys::Off_T>(run.numBytes);
+            const size_t newBytes = static_cast<size_t>(offset - run.offset) +
+                    segmentBytes;
+            if (static_cast<size_t>(offset - runEnd) <= MAX_GAP &&
+                newBytes <= MAX_RUN)
+            {
+                ++run.numRows;
+                run.numBytes = newBytes;
+                continue;
+            }
+        }
+        runs.push_back(Run{row, 1, offset, segmentBytes});
+    }
+
+    const size_t swapSize = hdr->isDifferentByteOrdering() ?
+            hdr->getSwapSize() : 0;
+
+    sys::byte* const out = static_cast<sys::byte*>(buffer);
+    const sys::Off_T dataOffset = static_cast<sys::Off_T>(headerLength);
+    const auto readRun = [&](size_t ii)
+    {
+        const Run& run = runs[ii];
+        sys::byte* const dest = out + run.firstRow * outRowBytes;
+        const size_t destBytes = run.numRows * outRowBytes;
+
+        // Whole rows back to back read straight into place
+        if (run.numBytes == destBytes && file)
+        {
+            file->readAt(dataOffset + run.offset, dest, destBytes);
+        }
+        else
+        {
+            const sys::byte* src = nullptr;
+            std::vector<sys::byte> scratch;
+            if (mapped)
+            {
+                src = mapped->view(dataOffset + run.offset,
+                                   run.numBytes).data();
+            }
+            else
+            {
+                scratch.resize(run.numBytes);
+                file->readAt(dataOffset + run.offset, scratch.data(),
+                             scratch.size());
+                src = scratch.data();
+            }
+
+            for (size_t row = 0; row < run.numRows; ++row)
+            {
+                const sys::byte* const rowSrc = src +
+                        (segmentOffset(run.firstRow + row) - run.offset);
+                sys::byte* const rowDest = dest + row * outRowBytes;
+                if (stride.col == 1)
+                {
+                    ::memcpy(rowDest, rowSrc, outRowBytes);
+                }
+                else
+                {
+                    gatherPixels(rowSrc, stride.col * elemSize, rowDest,
+                                 dims.col, elemSize);
+                }
+            }
+        }
+
+        if (swapSize)
+        {
+            sys::byteSwap(dest, swapSize, destBytes / swapSize);
+        }
+    };
+
+    if (numThreads > 1 && runs.size() > 1)
+    {
+        mt::parallel_for(runs.size(), readRun,
+                         math::ceilingDivide(runs.size(), numThreads));
+    }
+    else
+    {
+        for (size_t ii = 0; ii < runs.size(); ++ii)
+        {
+            readRun(ii);
+        }
+    }
 }
 
 void sio::lite::FileReader::killStream()
 {
     if (inputStream && own)
     {
-        io::FileInputStream* file = (io::FileInputStream*)inputStream;
-        if (file->isOpen()) file->close();
+        if (io::MMapInputStream* mapped = getMappedStream())
+        {
+            mapped->close();
+        }
+        else
+        {
+            io::FileInputStream* file = (io::FileInputStream*)inputStream;
+            if (file->isOpen()) file->close();
+        }
         delete inputStream;
     }
 }
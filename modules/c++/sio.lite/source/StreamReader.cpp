@@ -21,14 +21,14 @@
  */
 #include "sio/lite/StreamReader.h"
 
-
-union _IntBuffer
+int sio::lite::StreamReader::getNextInteger()
 {
-    int iVal;
-    sys::byte bVal[4];
-};
+    int value;
+    readIntegers(&value, 1);
+    return value;
+}
 
-int sio::lite::StreamReader::getNextInteger()
+void sio::lite::StreamReader::readIntegers(int* values, size_t count)
 {
     if (header == nullptr)
         throw
@@ -36,14 +36,12 @@ int sio::lite::StreamReader::getNextInteger()
             Ctxt("Header == null")
         );
 
-    union _IntBuffer buf;
-    inputStream->read(buf.bVal, 4);
+    inputStream->read(values, count * sizeof(int), true);
 
     if (header->isDifferentByteOrdering() )
     {
-        sys::byteSwap(buf.bVal, 4, 1);
+        sys::byteSwap(values, sizeof(int), count);
     }
-    return buf.iVal;//(int) ( b[0] << 24 | b[1] << 16 | b[2] << 8 | b[3] );
 }
 
 void sio::lite::StreamReader::checkMagic(bool calledFromConstructor)
@@ -51,8 +49,8 @@ void sio::lite::StreamReader::checkMagic(bool calledFromConstructor)
     // Determine whether our platform is big or
     // little endian
     bool bigEndian = sys::isBigEndianSystem();
-    // Read the first four bytes
-    unsigned char b[4];
+    // Read the first four bytes; if there aren't four, they won't match
+    unsigned char b[4] = {};
     inputStream->read((sys::byte*)b, 4);
 
     // We are big endian
@@ -113,13 +111,29 @@ void sio::lite::StreamReader::parseHeader(bool calledFromConstructor)
     header = new FileHeader();
     checkMagic(calledFromConstructor);
 
-    header->setNumLines( getNextInteger() );
-    header->setNumElements( getNextInteger() );
-    header->setElementType( getNextInteger() );
-    header->setElementSize( getNextInteger() );
-
-    if (header->getVersion() >= 2)
-        readType2Header();
+    try
+    {
+        // The rest of the basic header in one read
+        int values[4];
+        readIntegers(values, 4);
+        header->setNumLines(values[0]);
+        header->setNumElements(values[1]);
+        header->setElementType(values[2]);
+        header->setElementSize(values[3]);
+
+        if (header->getVersion() >= 2)
+            readType2Header();
+    }
+    catch (...)
+    {
+        // As checkMagic() does, don't leak these if the header's bad
+        if (calledFromConstructor)
+        {
+            killHeader();
+            killStream();
+        }
+        throw;
+    }
 
     if (header->getVersion() > 2)
         dbg_printf("Warning: header version is [%d]\n",
@@ -145,24 +159,25 @@ void sio::lite::StreamReader::readType2Header()
     {
         // Read the id size
         int idSize = getNextInteger();
+        if (idSize <= 0)
+            throw sio::lite::InvalidHeaderException(
+                Ctxt("Invalid user data id size"));
 
-        sys::byte *tmpBytes = new sys::byte[idSize];
-        inputStream->read(tmpBytes, idSize);
-        std::string id((const char*)tmpBytes);
-        header->setNullTerminationFlag(tmpBytes[idSize-1] == 0x00);
-        delete [] tmpBytes;
+        std::vector<sys::byte> idBytes(idSize);
+        inputStream->read(idBytes.data(), idBytes.size(), true);
+        header->setNullTerminationFlag(idBytes.back() == 0x00);
+        idBytes.push_back(0x00);
+        std::string id((const char*)idBytes.data());
 
         int udSize = getNextInteger();
+        if (udSize < 0)
+            throw sio::lite::InvalidHeaderException(
+                Ctxt("Invalid user data size for " + id));
+
         // This is what we are storing in the hash table
-        std::vector<sys::byte> udEntry;
-        udEntry.reserve(udSize);
-        for (int j = 0; j < udSize; j++)
-        {
-            sys::byte x;
-            inputStream->read(&x, 1);
-            udEntry.push_back(x);
-        }
+        std::vector<sys::byte> udEntry(udSize);
+        if (udSize > 0)
+            inputStream->read(udEntry.data(), udEntry.size(), true);
         header->getUserDataSection().add(id, udEntry);
     }
 }
-
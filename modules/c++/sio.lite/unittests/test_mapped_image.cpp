@@ -0,0 +1,381 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <complex>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <io/StringStream.h>
+#include <io/TempFile.h>
+#include <sio/lite/FileHeader.h>
+#include <sio/lite/MappedImage.h>
+#include <sio/lite/StreamReader.h>
+
+static void makePixel(size_t row, size_t col, uint16_t& pixel)
+{
+    pixel = static_cast<uint16_t>(row * 256 + col);
+}
+static void makePixel(size_t row, size_t col, float& pixel)
+{
+    pixel = static_cast<float>(row * 10000 + col);
+}
+static void makePixel(size_t row, size_t col, std::complex<float>& pixel)
+{
+    pixel = std::complex<float>(static_cast<float>(row), static_cast<float>(col) + 0.5f);
+}
+
+static size_t getComponentSize(const uint16_t&)
+{
+    return sizeof(uint16_t);
+}
+static size_t getComponentSize(const float&)
+{
+    return sizeof(float);
+}
+static size_t getComponentSize(const std::complex<float>&)
+{
+    return sizeof(float);
+}
+
+// Builds an SIO by hand, so the reader isn't checked against the writer
+class SioBytes final
+{
+public:
+    explicit SioBytes(bool swap) : mSwap(swap)
+    {
+    }
+
+    void addInt(int32_t value)
+    {
+        add(&value, sizeof(value), sizeof(value));
+    }
+
+    void addBytes(const std::string& bytes)
+    {
+        mBytes += bytes;
+    }
+
+    void addHeader(int version, size_t numRows, size_t numCols, int elementType, size_t elementSize)
+    {
+        addInt((255 - version) | 127 << 8 | version << 16 | 255 << 24);
+        addInt(static_cast<int32_t>(numRows));
+        addInt(static_cast<int32_t>(numCols));
+        addInt(elementType);
+        addInt(static_cast<int32_t>(elementSize));
+    }
+
+    template <typename T>
+    void addPixels(size_t numRows, size_t numCols)
+    {
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            for (size_t col = 0; col < numCols; ++col)
+            {
+                T pixel;
+                makePixel(row, col, pixel);
+                add(&pixel, sizeof(pixel), getComponentSize(pixel));
+            }
+        }
+    }
+
+    const std::string& str() const
+    {
+        return mBytes;
+    }
+
+    void write(const std::string& pathname) const
+    {
+        std::ofstream(pathname, std::ios::binary).write(mBytes.data(), mBytes.size());
+    }
+
+private:
+    void add(const void* data, size_t size, size_t swapSize)
+    {
+        std::string bytes(static_cast<const char*>(data), size);
+        for (size_t offset = 0; mSwap && offset < size; offset += swapSize)
+        {
+            std::reverse(bytes.begin() + offset, bytes.begin() + offset + swapSize);
+        }
+        mBytes += bytes;
+    }
+
+    const bool mSwap;
+    std::string mBytes;
+};
+
+// With userDataSize bytes of user data under a one byte key, to move the
+// pixels about
+template <typename T>
+static void writeImage(const std::string& pathname, size_t numRows, size_t numCols,
+                       int elementType, bool swap, int userDataSize = -1)
+{
+    SioBytes bytes(swap);
+    bytes.addHeader(userDataSize < 0 ? 1 : 2, numRows, numCols, elementType, sizeof(T));
+    if (userDataSize >= 0)
+    {
+        bytes.addInt(1);
+        bytes.addInt(1);
+        bytes.addBytes("k");
+        bytes.addInt(userDataSize);
+        bytes.addBytes(std::string(userDataSize, 'u'));
+    }
+    bytes.addPixels<T>(numRows, numCols);
+    bytes.write(pathname);
+}
+
+template <typename T>
+static bool checkRows(const sio::lite::MappedImage<T>& image)
+{
+    bool matches = true;
+    for (size_t row = 0; row < image.getDims().row; ++row)
+    {
+        const auto pixels = image.row(row);
+        matches = matches && pixels.size() == image.getDims().col;
+        for (size_t col = 0; col < pixels.size(); ++col)
+        {
+            T expected;
+            makePixel(row, col, expected);
+            matches = matches && pixels[col] == expected && image(row, col) == expected;
+        }
+    }
+    return matches;
+}
+
+template <typename T>
+static void testInPlace(const std::string& testName, int elementType)
+{
+    const io::TempFile tempFile;
+    writeImage<T>(tempFile.pathname(), 37, 23, elementType, false /*swap*/);
+
+    const sio::lite::MappedImage<T> image(tempFile.pathname());
+    TEST_ASSERT(image.isInPlace());
+    TEST_ASSERT_EQ(image.getDims().row, static_cast<size_t>(37));
+    TEST_ASSERT_EQ(image.getDims().col, static_cast<size_t>(23));
+    TEST_ASSERT(checkRows(image));
+
+    // Rows point into the view, which points into the mapping
+    const auto view = image.view();
+    TEST_ASSERT_EQ(view.extent(0), static_cast<size_t>(37));
+    TEST_ASSERT_EQ(view.extent(1), static_cast<size_t>(23));
+    for (size_t row = 0; row < 37; ++row)
+    {
+        const auto pixels = image.row(row);
+        TEST_ASSERT(pixels.data() == &view(row, 0));
+    }
+    T expected;
+    makePixel(36, 22, expected);
+    TEST_ASSERT(view(36, 22) == expected);
+
+    TEST_EXCEPTION(image.row(37));
+}
+TEST_CASE(testInPlace)
+{
+    testInPlace<uint16_t>(testName, sio::lite::FileHeader::UNSIGNED);
+    testInPlace<float>(testName, sio::lite::FileHeader::FLOAT);
+    testInPlace<std::complex<float>>(testName, sio::lite::FileHeader::COMPLEX_FLOAT);
+}
+
+template <typename T>
+static void testSwapped(const std::string& testName, int elementType)
+{
+    const io::TempFile tempFile;
+    writeImage<T>(tempFile.pathname(), 37, 23, elementType, true /*swap*/);
+
+    const sio::lite::MappedImage<T> image(tempFile.pathname());
+    TEST_ASSERT(image.getHeader().isDifferentByteOrdering());
+    TEST_ASSERT_FALSE(image.isInPlace());
+    TEST_EXCEPTION(image.view());
+    TEST_ASSERT(checkRows(image));
+
+    // Each row is swapped once, and then kept
+    const auto first = image.row(5);
+    const auto second = image.row(5);
+    TEST_ASSERT(first.data() == second.data());
+
+    TEST_EXCEPTION(image.row(37));
+}
+TEST_CASE(testSwapped)
+{
+    testSwapped<uint16_t>(testName, sio::lite::FileHeader::UNSIGNED);
+    testSwapped<float>(testName, sio::lite::FileHeader::FLOAT);
+    testSwapped<std::complex<float>>(testName, sio::lite::FileHeader::COMPLEX_FLOAT);
+}
+
+TEST_CASE(testSwappedThreaded)
+{
+    const io::TempFile tempFile;
+    writeImage<std::complex<float>>(tempFile.pathname(), 200, 301,
+                                    sio::lite::FileHeader::COMPLEX_FLOAT, true /*swap*/);
+    const sio::lite::MappedImage<std::complex<float>> image(tempFile.pathname());
+
+    // Every thread asks for every row, so they race to swap each one
+    std::vector<const std::complex<float>*> rows[4];
+    std::vector<std::thread> threads;
+    for (auto& threadRows : rows)
+    {
+        threads.emplace_back([&image, &threadRows]()
+        {
+            for (size_t row = 0; row < image.getDims().row; ++row)
+            {
+                threadRows.push_back(image.row(row).data());
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto& threadRows : rows)
+    {
+        TEST_ASSERT(threadRows == rows[0]);
+    }
+    TEST_ASSERT(checkRows(image));
+}
+
+TEST_CASE(testMisaligned)
+{
+    // The basic header is 20 bytes, and one byte of user data under a one
+    // byte key adds 14 more, which leaves the pixels 2 bytes off
+    const io::TempFile tempFile;
+    writeImage<float>(tempFile.pathname(), 37, 23, sio::lite::FileHeader::FLOAT,
+                      false /*swap*/, 1 /*userDataSize*/);
+    {
+        const sio::lite::MappedImage<float> image(tempFile.pathname());
+        TEST_ASSERT_EQ(image.getHeader().getLength(), 34);
+        TEST_ASSERT_FALSE(image.getHeader().isDifferentByteOrdering());
+        TEST_ASSERT_FALSE(image.isInPlace());
+        TEST_EXCEPTION(image.view());
+        TEST_ASSERT(checkRows(image));
+    }
+
+    // ... but that's fine for 16-bit pixels
+    writeImage<uint16_t>(tempFile.pathname(), 37, 23, sio::lite::FileHeader::UNSIGNED,
+                         false /*swap*/, 1 /*userDataSize*/);
+    {
+        const sio::lite::MappedImage<uint16_t> image(tempFile.pathname());
+        TEST_ASSERT(image.isInPlace());
+        TEST_ASSERT(checkRows(image));
+    }
+
+    // Three bytes more and the floats line up again
+    writeImage<float>(tempFile.pathname(), 37, 23, sio::lite::FileHeader::FLOAT,
+                      false /*swap*/, 3 /*userDataSize*/);
+    {
+        const sio::lite::MappedImage<float> image(tempFile.pathname());
+        TEST_ASSERT(image.isInPlace());
+        TEST_ASSERT(checkRows(image));
+    }
+}
+
+TEST_CASE(testWrongFile)
+{
+    const io::TempFile tempFile;
+    writeImage<float>(tempFile.pathname(), 37, 23, sio::lite::FileHeader::FLOAT, false /*swap*/);
+
+    // Not the pixel type in the file
+    TEST_EXCEPTION(sio::lite::MappedImage<uint32_t>(tempFile.pathname()));
+    TEST_EXCEPTION(sio::lite::MappedImage<double>(tempFile.pathname()));
+
+    // Pixels missing off the end
+    SioBytes bytes(false /*swap*/);
+    bytes.addHeader(1, 37, 23, sio::lite::FileHeader::FLOAT, sizeof(float));
+    bytes.addPixels<float>(36, 23);
+    bytes.write(tempFile.pathname());
+    TEST_EXCEPTION(sio::lite::MappedImage<float>(tempFile.pathname()));
+}
+
+static void readHeader(const std::string& bytes)
+{
+    io::StringStream stream;
+    stream.write(bytes.data(), bytes.size());
+    sio::lite::StreamReader reader(&stream);
+}
+
+static std::string getUserDataHeader(bool swap, int32_t idSize, const std::string& id,
+                                     int32_t userDataSize, const std::string& userData)
+{
+    SioBytes bytes(swap);
+    bytes.addHeader(2, 3, 4, sio::lite::FileHeader::FLOAT, sizeof(float));
+    bytes.addInt(1);
+    bytes.addInt(idSize);
+    bytes.addBytes(id);
+    bytes.addInt(userDataSize);
+    bytes.addBytes(userData);
+    return bytes.str();
+}
+
+TEST_CASE(testTruncatedHeader)
+{
+    for (const bool swap : { false, true })
+    {
+        const std::string header = getUserDataHeader(swap, 3, "key", 5, "value");
+        readHeader(header);
+
+        // Cut off anywhere, even mid integer, it's an error
+        for (size_t size = 0; size < header.size(); ++size)
+        {
+            TEST_EXCEPTION(readHeader(header.substr(0, size)));
+        }
+    }
+
+    // Through a file, too, which the reader owns and has to clean up
+    const io::TempFile tempFile;
+    SioBytes bytes(false /*swap*/);
+    bytes.addHeader(1, 3, 4, sio::lite::FileHeader::FLOAT, sizeof(float));
+    std::ofstream(tempFile.pathname(), std::ios::binary).write(bytes.str().data(), 13);
+    TEST_EXCEPTION(sio::lite::StreamReader(new io::FileInputStream(tempFile.pathname()), true));
+    TEST_EXCEPTION(sio::lite::MappedImage<float>(tempFile.pathname()));
+}
+
+TEST_CASE(testBadSizes)
+{
+    for (const bool swap : { false, true })
+    {
+        // A negative user data size
+        TEST_EXCEPTION(readHeader(getUserDataHeader(swap, 3, "key", -5, "value")));
+
+        // ... or key size, or none at all
+        TEST_EXCEPTION(readHeader(getUserDataHeader(swap, -3, "key", 5, "value")));
+        TEST_EXCEPTION(readHeader(getUserDataHeader(swap, 0, "", 5, "value")));
+
+        // No user data is fine
+        readHeader(getUserDataHeader(swap, 3, "key", 0, ""));
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testInPlace);
+    TEST_CHECK(testSwapped);
+    TEST_CHECK(testSwappedThreaded);
+    TEST_CHECK(testMisaligned);
+    TEST_CHECK(testWrongFile);
+    TEST_CHECK(testTruncatedHeader);
+    TEST_CHECK(testBadSizes);
+    )
@@ -0,0 +1,162 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <complex>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <coda_oss/bit.h>
+#include <io/TempFile.h>
+#include <sio/lite/FileHeader.h>
+#include <sio/lite/ParallelFileWriter.h>
+#include <sio/lite/SioFileReader.h>
+
+using ComplexShort = std::complex<int16_t>;
+
+static const size_t numRows = 40;
+static const size_t numCols = 33;
+static const size_t blockRows = 4;
+
+static std::vector<ComplexShort> makeImage()
+{
+    // The real and imaginary parts are never equal
+    std::vector<ComplexShort> image(numRows * numCols);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        const auto value = static_cast<int16_t>(ii);
+        image[ii] = ComplexShort(value, static_cast<int16_t>(value ^ 0x5555));
+    }
+    return image;
+}
+
+static coda_oss::endian getOtherByteOrder()
+{
+    return coda_oss::endian::native == coda_oss::endian::little ?
+            coda_oss::endian::big : coda_oss::endian::little;
+}
+
+// Each thread writes every numThreads-th block, last first
+static void writeImage(const std::string& pathname, const std::vector<ComplexShort>& image,
+                       int elementType, coda_oss::endian byteOrder)
+{
+    sio::lite::FileHeader header(static_cast<int>(numRows), static_cast<int>(numCols),
+                                 sizeof(ComplexShort), elementType);
+    header.addUserData("name", "value");
+    sio::lite::ParallelFileWriter writer(pathname, header, byteOrder);
+
+    constexpr size_t numThreads = 3;
+    constexpr size_t numBlocks = numRows / blockRows;
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < numThreads; ++thread)
+    {
+        threads.emplace_back([&, thread]() {
+            for (size_t block = numBlocks - 1 - thread; block < numBlocks; block -= numThreads)
+            {
+                const auto startRow = block * blockRows;
+                writer.writeRows(startRow, blockRows, &image[startRow * numCols]);
+            }
+        });
+    }
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+    writer.close();
+}
+
+static std::vector<char> readPixelBytes(const std::string& pathname)
+{
+    std::ifstream in(pathname, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto numBytes = numRows * numCols * sizeof(ComplexShort);
+    return std::vector<char>(bytes.end() - numBytes, bytes.end());
+}
+
+static void testRoundTrip(const std::string& testName, int elementType, coda_oss::endian byteOrder)
+{
+    const auto image = makeImage();
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, elementType, byteOrder);
+
+    sio::lite::FileReader reader(tempFile.pathname());
+    const auto& header = *reader.getHeader();
+    TEST_ASSERT_EQ(header.isDifferentByteOrdering(), byteOrder != coda_oss::endian::native);
+    TEST_ASSERT_EQ(header.getNumLines(), static_cast<int>(numRows));
+    TEST_ASSERT_EQ(header.getNumElements(), static_cast<int>(numCols));
+    TEST_ASSERT_EQ(header.getElementType(), elementType);
+    TEST_ASSERT_TRUE(header.userDataFieldExists("name"));
+
+    std::vector<ComplexShort> actual(image.size());
+    reader.readRegion(actual.data(), { 0, 0 }, { numRows, numCols });
+    TEST_ASSERT_TRUE(actual == image);
+
+    // Each component of each pixel is in the file's byte order
+    const auto pixelBytes = readPixelBytes(tempFile.pathname());
+    std::vector<char> expected(image.size() * sizeof(ComplexShort));
+    ::memcpy(expected.data(), image.data(), expected.size());
+    if (byteOrder != coda_oss::endian::native)
+    {
+        for (size_t offset = 0; offset < expected.size(); offset += sizeof(int16_t))
+        {
+            std::reverse(&expected[offset], &expected[offset] + sizeof(int16_t));
+        }
+    }
+    TEST_ASSERT_TRUE(pixelBytes == expected);
+}
+
+TEST_CASE(testParallelFileWriter)
+{
+    testRoundTrip(testName, sio::lite::FileHeader::COMPLEX_SIGNED, coda_oss::endian::native);
+}
+
+TEST_CASE(testParallelFileWriterSwapped)
+{
+    testRoundTrip(testName, sio::lite::FileHeader::COMPLEX_SIGNED, getOtherByteOrder());
+    testRoundTrip(testName, sio::lite::FileHeader::COMPLEX_UNSIGNED, getOtherByteOrder());
+}
+
+TEST_CASE(testParallelFileWriterOutside)
+{
+    const io::TempFile tempFile;
+    const sio::lite::FileHeader header(static_cast<int>(numRows), static_cast<int>(numCols),
+                                       sizeof(float), sio::lite::FileHeader::FLOAT);
+    sio::lite::ParallelFileWriter writer(tempFile.pathname(), header);
+    const std::vector<float> rows(blockRows * numCols);
+    TEST_EXCEPTION(writer.writeRows(numRows - 1, 2, rows.data()));
+    writer.writeRows(numRows - blockRows, blockRows, rows.data());
+    writer.close();
+}
+
+TEST_MAIN(
+    TEST_CHECK(testParallelFileWriter);
+    TEST_CHECK(testParallelFileWriterSwapped);
+    TEST_CHECK(testParallelFileWriterOutside);
+    )
@@ -0,0 +1,206 @@
+/* =========================================================================
+ * This file is part of sio.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * sio.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <complex>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <io/TempFile.h>
+#include <sio/lite/FileHeader.h>
+#include <sio/lite/SioFileReader.h>
+
+using ComplexShort = std::complex<int16_t>;
+
+// Distinct, and the real and imaginary parts are never equal
+static void makePixel(size_t row, size_t col, float& pixel)
+{
+    pixel = static_cast<float>(row * 10000 + col);
+}
+static void makePixel(size_t row, size_t col, ComplexShort& pixel)
+{
+    const auto value = static_cast<int16_t>(row * 31 + col);
+    pixel = ComplexShort(value, static_cast<int16_t>(value ^ 0x5555));
+}
+static void makePixel(size_t row, size_t col, std::complex<float>& pixel)
+{
+    pixel = std::complex<float>(static_cast<float>(row), static_cast<float>(col) + 0.5f);
+}
+
+static size_t getComponentSize(const float&)
+{
+    return sizeof(float);
+}
+template <typename T>
+static size_t getComponentSize(const std::complex<T>&)
+{
+    return sizeof(T);
+}
+
+static void write(std::ofstream& out, const void* data, size_t size, bool swap)
+{
+    std::vector<char> bytes(static_cast<const char*>(data), static_cast<const char*>(data) + size);
+    if (swap)
+    {
+        std::reverse(bytes.begin(), bytes.end());
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+// Writes the SIO by hand, so the reader isn't checked against itself
+template <typename T>
+static void writeImage(const std::string& pathname, size_t numRows, size_t numCols, int elementType, bool swap)
+{
+    std::ofstream out(pathname, std::ios::binary);
+    const int32_t header[] = {
+        (255 - 1) | 127 << 8 | 1 << 16 | 255 << 24,  // version 1
+        static_cast<int32_t>(numRows), static_cast<int32_t>(numCols),
+        elementType, static_cast<int32_t>(sizeof(T)) };
+    for (const auto& value : header)
+    {
+        write(out, &value, sizeof(value), swap);
+    }
+
+    for (size_t row = 0; row < numRows; ++row)
+    {
+        for (size_t col = 0; col < numCols; ++col)
+        {
+            T pixel;
+            makePixel(row, col, pixel);
+            const auto componentSize = getComponentSize(pixel);
+            const auto bytes = reinterpret_cast<const char*>(&pixel);
+            for (size_t offset = 0; offset < sizeof(T); offset += componentSize)
+            {
+                write(out, bytes + offset, componentSize, swap);
+            }
+        }
+    }
+}
+
+template <typename T>
+static bool checkRegion(const std::string& pathname, bool memoryMap,
+                        const types::RowCol<size_t>& start,
+                        const types::RowCol<size_t>& dims,
+                        const types::RowCol<size_t>& stride,
+                        size_t numThreads = 1)
+{
+    const sio::lite::FileReader reader(pathname, memoryMap);
+    std::vector<T> actual(dims.area());
+    reader.readRegion(actual.data(), start, dims, stride, numThreads);
+
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            T expected;
+            makePixel(start.row + row * stride.row, start.col + col * stride.col, expected);
+            if (actual[row * dims.col + col] != expected)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+static void testRegions(const std::string& testName, int elementType, bool swap)
+{
+    const io::TempFile tempFile;
+    writeImage<T>(tempFile.pathname(), 37, 23, elementType, swap);
+
+    for (const auto memoryMap : { false, true })
+    {
+        // Whole rows, read straight into place
+        const auto wholeRows = checkRegion<T>(tempFile.pathname(), memoryMap, { 5, 0 }, { 10, 23 }, { 1, 1 });
+        TEST_ASSERT_TRUE(wholeRows);
+
+        // Part of each row
+        const auto window = checkRegion<T>(tempFile.pathname(), memoryMap, { 3, 4 }, { 20, 11 }, { 1, 1 });
+        TEST_ASSERT_TRUE(window);
+
+        // Strided in both directions, out to the last row and column
+        const auto strided = checkRegion<T>(tempFile.pathname(), memoryMap, { 1, 2 }, { 12, 7 }, { 3, 3 });
+        TEST_ASSERT_TRUE(strided);
+
+        const auto single = checkRegion<T>(tempFile.pathname(), memoryMap, { 36, 22 }, { 1, 1 }, { 1, 1 });
+        TEST_ASSERT_TRUE(single);
+    }
+}
+
+TEST_CASE(testReadRegion)
+{
+    testRegions<float>(testName, sio::lite::FileHeader::FLOAT, false /*swap*/);
+    testRegions<ComplexShort>(testName, sio::lite::FileHeader::COMPLEX_SIGNED, false /*swap*/);
+}
+
+TEST_CASE(testReadRegionSwapped)
+{
+    testRegions<float>(testName, sio::lite::FileHeader::FLOAT, true /*swap*/);
+    testRegions<std::complex<float>>(testName, sio::lite::FileHeader::COMPLEX_FLOAT, true /*swap*/);
+
+    // Complex integers are swapped per component too
+    testRegions<ComplexShort>(testName, sio::lite::FileHeader::COMPLEX_SIGNED, true /*swap*/);
+    testRegions<ComplexShort>(testName, sio::lite::FileHeader::COMPLEX_UNSIGNED, true /*swap*/);
+}
+
+TEST_CASE(testReadRegionThreaded)
+{
+    // 16 KiB rows; every 8th row is too far from the last to share a read
+    const io::TempFile tempFile;
+    writeImage<ComplexShort>(tempFile.pathname(), 64, 4096, sio::lite::FileHeader::COMPLEX_SIGNED, true /*swap*/);
+
+    for (const auto memoryMap : { false, true })
+    {
+        const auto strided = checkRegion<ComplexShort>(tempFile.pathname(), memoryMap,
+                                                       { 2, 100 }, { 8, 1000 }, { 8, 3 }, 4 /*numThreads*/);
+        TEST_ASSERT_TRUE(strided);
+
+        const auto wholeRows = checkRegion<ComplexShort>(tempFile.pathname(), memoryMap,
+                                                         { 0, 0 }, { 64, 4096 }, { 1, 1 }, 4 /*numThreads*/);
+        TEST_ASSERT_TRUE(wholeRows);
+    }
+}
+
+TEST_CASE(testReadRegionOutside)
+{
+    const io::TempFile tempFile;
+    writeImage<float>(tempFile.pathname(), 37, 23, sio::lite::FileHeader::FLOAT, false /*swap*/);
+    const sio::lite::FileReader reader(tempFile.pathname());
+    std::vector<float> buffer(37 * 23);
+
+    TEST_EXCEPTION(reader.readRegion(buffer.data(), { 30, 0 }, { 8, 23 }));
+    TEST_EXCEPTION(reader.readRegion(buffer.data(), { 0, 0 }, { 10, 10 }, { 1, 3 }));
+    TEST_EXCEPTION(reader.readRegion(buffer.data(), { 0, 0 }, { 10, 10 }, { 0, 1 }));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testReadRegion);
+    TEST_CHECK(testReadRegionSwapped);
+    TEST_CHECK(testReadRegionThreaded);
+    TEST_CHECK(testReadRegionOutside);
+    )
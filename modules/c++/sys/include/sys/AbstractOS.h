@@ -107,6 +107,20 @@ constexpr auto getSIMDInstructionSet() {
     #endif // CODA_OSS_ENABLE_SIMD
 }
 
+/*!
+ *  \struct NUMANode
+ *  \brief The available CPUs on one NUMA node.
+ *
+ *  physicalCPUs and htCPUs are split the same way as in
+ *  AbstractOS::getAvailableCPUs().
+ */
+struct NUMANode final
+{
+    int id = 0;
+    std::vector<int> physicalCPUs;
+    std::vector<int> htCPUs;
+};
+
 /*!
  *  \class AbstractOS
  *  \brief Interface for system independent function calls
@@ -344,6 +358,44 @@ struct CODA_OSS_API AbstractOS
     virtual void getAvailableCPUs(std::vector<int>& physicalCPUs,
                                   std::vector<int>& htCPUs) const = 0;
 
+    /*!
+     * Group the available CPUs by NUMA node.  Nodes with no available CPUs
+     * are skipped.  The default implementation reports everything from
+     * getAvailableCPUs() on a single node 0.
+     *
+     * \param[out] nodes The nodes, sorted by id
+     */
+    virtual void getNUMANodes(std::vector<NUMANode>& nodes) const;
+
+    /*!
+     * \return The NUMA node of the CPU the calling thread is running on,
+     *         or 0 if that can't be determined.  This is only stable if the
+     *         thread is pinned (e.g. with a CPUAffinityInitializer).
+     */
+    virtual int getCurrentNUMANode() const;
+
+    /*!
+     * Ask the OS to keep the pages [address, address + numBytes) on the
+     * given NUMA node, moving any that have already been touched.  The
+     * memory must be whole pages (page aligned, a multiple of the page size)
+     * that nothing else uses: binding outlives the data, so call
+     * unbindFromNUMANode() before freeing it.
+     *
+     * \return true on success, false if this isn't supported (the default),
+     *         the memory isn't whole pages, or the OS refused
+     */
+    virtual bool bindToNUMANode(void* address,
+                                size_t numBytes,
+                                int node) const;
+
+    /*!
+     * Undo bindToNUMANode(), so the pages go back to the default policy.
+     *
+     * \return true on success, false if this isn't supported (the default),
+     *         the memory isn't whole pages, or the OS refused
+     */
+    virtual bool unbindFromNUMANode(void* address, size_t numBytes) const;
+
 
     /*!
      * Figure out what SIMD instrunctions are available.  Keep in mind these
@@ -76,6 +76,14 @@ inline void byteSwap(ubyte* buffer, size_t elemSize, size_t numElems)
 
 namespace details
 {
+/*!
+ * The portable (non-SIMD) implementation behind byteSwap(); byteSwap() picks
+ * SSSE3/AVX2/AVX-512 kernels at runtime when the CPU supports them.  This is
+ * exposed for testing and benchmarking.  'buffer' and 'outputBuffer' may be
+ * the same for an in-place swap.
+ */
+void CODA_OSS_API byteSwapScalar(const void* buffer, size_t elemSize, size_t numElems, void* outputBuffer);
+
 template <typename T>
 inline void check_elemSize(size_t elemSize)
 {
@@ -234,6 +234,30 @@ struct CODA_OSS_API File
     void writeFrom(const void* buffer,
                    size_t size);
 
+    /*!
+     *  Write 'size' bytes from a buffer into the file, at offset bytes
+     *  from the beginning.  Does not use but may update the internal file
+     *  pointer, so several threads can write different parts of the file
+     *  at once.
+     *  Blocks.
+     *  If size is 0, no OS level write operation occurs.
+     *
+     *  \param offset Where to write, from the beginning of the file
+     *  \param buffer The buffer to read from
+     *  \param size The number of bytes to write out
+     */
+    void writeAtFrom(sys::Off_T offset, const void* buffer, size_t size);
+
+    /*!
+     *  Make the file at least 'length' bytes long, reserving disk space for
+     *  all of it up front where the file system allows (so it's laid out
+     *  contiguously, and a full disk shows up now rather than mid-write).
+     *  Where space can't be reserved, the file is just extended.
+     *
+     *  \param length The size of the file
+     */
+    void allocate(sys::Off_T length);
+
     /*!
      *  Seek to the specified offset, relative to 'whence.'
      *  Valid values are FROM_START, FROM_CURRENT, FROM_END.
@@ -201,6 +201,39 @@ struct OSUnix final : public AbstractOS
     virtual void getAvailableCPUs(std::vector<int>& physicalCPUs,
                                   std::vector<int>& htCPUs) const override;
 
+    /*!
+     * Group the available CPUs by NUMA node, using the nodeN/cpulist files
+     * in /sys/devices/system/node.  If those don't exist (e.g.
+     * a kernel without NUMA support), everything is on node 0.
+     *
+     * \param[out] nodes The nodes, sorted by id
+     */
+    virtual void getNUMANodes(std::vector<NUMANode>& nodes) const override;
+
+    /*!
+     * \return The NUMA node of the CPU the calling thread is running on
+     */
+    virtual int getCurrentNUMANode() const override;
+
+    /*!
+     * Bind the pages [address, address + numBytes) to the given NUMA node
+     * with mbind(2), moving any that have already been touched.  The memory
+     * must be whole pages.
+     *
+     * \return true on success, false otherwise
+     */
+    virtual bool bindToNUMANode(void* address,
+                                size_t numBytes,
+                                int node) const override;
+
+    /*!
+     * Drop the binding from bindToNUMANode() with mbind(2).
+     *
+     * \return true on success, false otherwise
+     */
+    virtual bool unbindFromNUMANode(void* address,
+                                    size_t numBytes) const override;
+
     /*!
      * Figure out what SIMD instrunctions are available.  Keep in mind these
      * are RUN-TIME, not compile-time, checks.
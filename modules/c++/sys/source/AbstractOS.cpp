@@ -464,5 +464,29 @@ std::string AbstractOS::getSpecialEnv(const std::string& envVar) const
     throw sys::SystemException(Ctxt("Unable to determine value for special environment variable: " + envVar));
 }
 
+void AbstractOS::getNUMANodes(std::vector<NUMANode>& nodes) const
+{
+    nodes.resize(1);
+    nodes[0].id = 0;
+    getAvailableCPUs(nodes[0].physicalCPUs, nodes[0].htCPUs);
+}
+
+int AbstractOS::getCurrentNUMANode() const
+{
+    return 0;
 }
 
+bool AbstractOS::bindToNUMANode(void* /*address*/,
+                                size_t /*numBytes*/,
+                                int /*node*/) const
+{
+    return false;
+}
+
+bool AbstractOS::unbindFromNUMANode(void* /*address*/,
+                                    size_t /*numBytes*/) const
+{
+    return false;
+}
+
+}
@@ -26,12 +26,15 @@
 #include <stdexcept>
 #include <type_traits>
 #include <algorithm>
+#include <array>
 #include <tuple>
+#include <utility>
 #include "coda_oss/bit.h"
 #include "coda_oss/cstddef.h"
 #include "coda_oss/span.h"
 
 #include "sys/Span.h"
+#include "sys/AbstractOS.h"
 
 // https://en.cppreference.com/w/cpp/types/endian
 using endian = coda_oss::endian;
@@ -123,65 +126,326 @@ bool sys::isLittleEndianSystem()
     return retval;
 }
 
-   /*!
- *  Swap bytes in-place.  Note that a complex pixel
- *  is equivalent to two floats so elemSize and numElems
- *  must be adjusted accordingly.
+/*
+ * Byte-swap kernels.  Every kernel has the same signature and works both
+ * in-place (input == output) and copying; each one loads a block before
+ * storing it, so aliasing is fine.
  *
- *  \param [inout] buffer to transform
- *  \param elemSize
- *  \param numElems
+ * The SIMD kernels use a byte shuffle (PSHUFB and its wider versions), which
+ * operates within 128-bit lanes; since every element size we handle divides
+ * 16, one 128-bit mask works for every ISA.  The kernel is chosen once, from
+ * the CPU we're actually running on (not the compile-time
+ * sys::getSIMDInstructionSet()), so the same binary runs at full speed on
+ * older and newer hardware.
  */
+#if CODA_OSS_ENABLE_SIMD && (defined(__x86_64__) || defined(_M_X64))
+    #if defined(__GNUC__) || defined(__clang__)
+        #define CODA_OSS_sys_byteSwap_x86 1
+        #define CODA_OSS_sys_byteSwap_target(isa) __attribute__((target(isa)))
+    #elif defined(_MSC_VER)
+        #define CODA_OSS_sys_byteSwap_x86 1
+        #define CODA_OSS_sys_byteSwap_target(isa)
+    #endif
+#endif
+#ifndef CODA_OSS_sys_byteSwap_x86
+    #define CODA_OSS_sys_byteSwap_x86 0
+#endif
+
+#if CODA_OSS_sys_byteSwap_x86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+using ByteSwapKernel = void (*)(const coda_oss::byte*, coda_oss::byte*, size_t);
+
 template <typename TUInt>
-inline auto byteSwap(coda_oss::span<TUInt> buffer)
+void byteSwapScalar_(const coda_oss::byte* in, coda_oss::byte* out, size_t numElems)
 {
     static_assert(std::is_unsigned<TUInt>::value, "TUInt must be 'unsigned'");
-    for (auto& v : buffer)
+    for (size_t ii = 0; ii < numElems; ++ii, in += sizeof(TUInt), out += sizeof(TUInt))
     {
-        v = sys::byteSwap(v);
+        TUInt value;
+        memcpy(&value, in, sizeof(value));
+        value = sys::byteSwap(value);
+        memcpy(out, &value, sizeof(value));
     }
-    return sys::as_bytes(buffer);
 }
-template <typename TUInt>
-inline auto byteSwap_n_(coda_oss::span<coda_oss::byte> buffer_)
+
+// 16-byte elements are reversed as a whole: swap each 8-byte half and
+// exchange them.
+void byteSwapScalar16_(const coda_oss::byte* in, coda_oss::byte* out, size_t numElems)
 {
-    const auto buffer = sys::make_span<TUInt>(buffer_.data(), buffer_.size_bytes() / sizeof(TUInt));
-    assert(buffer.size_bytes() == buffer_.size_bytes());
-    return byteSwap(buffer);
+    constexpr size_t elemSize = 2 * sizeof(uint64_t);
+    for (size_t ii = 0; ii < numElems; ++ii, in += elemSize, out += elemSize)
+    {
+        uint64_t lo, hi;
+        memcpy(&lo, in, sizeof(lo));
+        memcpy(&hi, in + sizeof(lo), sizeof(hi));
+        lo = sys::byteSwap(lo);
+        hi = sys::byteSwap(hi);
+        memcpy(out, &hi, sizeof(hi));
+        memcpy(out + sizeof(hi), &lo, sizeof(lo));
+    }
 }
-template <typename TUInt>
-inline auto byteSwap_n(coda_oss::span<coda_oss::byte> buffer, size_t elemSize)
+
+template <size_t elemSize>
+struct ScalarKernel;
+template <> struct ScalarKernel<2> { static void swap(const coda_oss::byte* in, coda_oss::byte* out, size_t n) { byteSwapScalar_<uint16_t>(in, out, n); } };
+template <> struct ScalarKernel<4> { static void swap(const coda_oss::byte* in, coda_oss::byte* out, size_t n) { byteSwapScalar_<uint32_t>(in, out, n); } };
+template <> struct ScalarKernel<8> { static void swap(const coda_oss::byte* in, coda_oss::byte* out, size_t n) { byteSwapScalar_<uint64_t>(in, out, n); } };
+template <> struct ScalarKernel<16> { static void swap(const coda_oss::byte* in, coda_oss::byte* out, size_t n) { byteSwapScalar16_(in, out, n); } };
+
+#if CODA_OSS_sys_byteSwap_x86
+// Index of the byte that ends up at position 'ii' of a 16-byte block.
+template <size_t elemSize>
+constexpr char shuffleIndex(size_t ii)
+{
+    return static_cast<char>((ii / elemSize) * elemSize + (elemSize - 1 - ii % elemSize));
+}
+// The shuffle masks are loaded from a table of the full register width
+// rather than broadcast from 16 bytes: GCC warns about the uninitialized
+// source operand inside _mm512_broadcast_i32x4().
+template <size_t elemSize, size_t... ii>
+constexpr std::array<char, sizeof...(ii)> makeShuffleMask(std::index_sequence<ii...>)
 {
-    if (sizeof(TUInt) != elemSize)
+    return {{ shuffleIndex<elemSize>(ii % 16)... }};
+}
+template <size_t elemSize, size_t numBytes>
+struct ShuffleMask final
+{
+    static constexpr std::array<char, numBytes> bytes = makeShuffleMask<elemSize>(std::make_index_sequence<numBytes>());
+};
+template <size_t elemSize, size_t numBytes>
+constexpr std::array<char, numBytes> ShuffleMask<elemSize, numBytes>::bytes;
+
+template <size_t elemSize>
+CODA_OSS_sys_byteSwap_target("ssse3")
+void byteSwapSSSE3(const coda_oss::byte* in, coda_oss::byte* out, size_t numElems)
+{
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ShuffleMask<elemSize, sizeof(__m128i)>::bytes.data()));
+    const size_t numBytes = numElems * elemSize;
+    size_t ii = 0;
+    for (; ii + sizeof(__m128i) <= numBytes; ii += sizeof(__m128i))
     {
-        throw std::invalid_argument("'elemSize' != sizeof(TUInt)");
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + ii));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii), _mm_shuffle_epi8(v, mask));
     }
-    return byteSwap_n_<TUInt>(buffer);
+    ScalarKernel<elemSize>::swap(in + ii, out + ii, (numBytes - ii) / elemSize);
 }
-static coda_oss::span<const coda_oss::byte> byteSwap(coda_oss::span<coda_oss::byte> buffer, size_t elemSize, size_t numElems)
+
+template <size_t elemSize>
+CODA_OSS_sys_byteSwap_target("avx2")
+void byteSwapAVX2(const coda_oss::byte* in, coda_oss::byte* out, size_t numElems)
+{
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ShuffleMask<elemSize, sizeof(__m256i)>::bytes.data()));
+    const size_t numBytes = numElems * elemSize;
+    size_t ii = 0;
+    for (; ii + sizeof(__m256i) <= numBytes; ii += sizeof(__m256i))
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + ii));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + ii), _mm256_shuffle_epi8(v, mask));
+    }
+    ScalarKernel<elemSize>::swap(in + ii, out + ii, (numBytes - ii) / elemSize);
+}
+
+template <size_t elemSize>
+CODA_OSS_sys_byteSwap_target("avx512f,avx512bw")
+void byteSwapAVX512(const coda_oss::byte* in, coda_oss::byte* out, size_t numElems)
+{
+    const __m512i mask = _mm512_loadu_si512(ShuffleMask<elemSize, sizeof(__m512i)>::bytes.data());
+    const size_t numBytes = numElems * elemSize;
+    size_t ii = 0;
+    for (; ii + sizeof(__m512i) <= numBytes; ii += sizeof(__m512i))
+    {
+        const __m512i v = _mm512_loadu_si512(in + ii);
+        _mm512_storeu_si512(out + ii, _mm512_shuffle_epi8(v, mask));
+    }
+    ScalarKernel<elemSize>::swap(in + ii, out + ii, (numBytes - ii) / elemSize);
+}
+#endif // CODA_OSS_sys_byteSwap_x86
+
+enum class ByteSwapISA
+{
+    Scalar,
+    SSSE3,
+    AVX2,
+    AVX512BW,
+};
+
+ByteSwapISA detectByteSwapISA()
+{
+#if CODA_OSS_sys_byteSwap_x86
+    #if defined(__GNUC__) || defined(__clang__)
+    // These also check that the OS saves the wider registers.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+    {
+        return ByteSwapISA::AVX512BW;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return ByteSwapISA::AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return ByteSwapISA::SSSE3;
+    }
+    #else
+    int regs[4]{};
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    const bool ssse3 = (regs[2] & (1 << 9)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool osAVX = (xcr0 & 0x6) == 0x6;  // XMM and YMM state
+    const bool osAVX512 = (xcr0 & 0xe6) == 0xe6;  // ... and opmask, ZMM state
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(regs, 7, 0);
+        const bool avx2 = (regs[1] & (1 << 5)) != 0;
+        const bool avx512f = (regs[1] & (1 << 16)) != 0;
+        const bool avx512bw = (regs[1] & (1 << 30)) != 0;
+        if (osAVX512 && avx512f && avx512bw)
+        {
+            return ByteSwapISA::AVX512BW;
+        }
+        if (osAVX && avx2)
+        {
+            return ByteSwapISA::AVX2;
+        }
+    }
+    if (ssse3)
+    {
+        return ByteSwapISA::SSSE3;
+    }
+    #endif
+#endif // CODA_OSS_sys_byteSwap_x86
+    return ByteSwapISA::Scalar;
+}
+
+template <size_t elemSize>
+ByteSwapKernel selectKernel(ByteSwapISA isa)
+{
+    switch (isa)
+    {
+#if CODA_OSS_sys_byteSwap_x86
+    case ByteSwapISA::AVX512BW: return byteSwapAVX512<elemSize>;
+    case ByteSwapISA::AVX2: return byteSwapAVX2<elemSize>;
+    case ByteSwapISA::SSSE3: return byteSwapSSSE3<elemSize>;
+#endif
+    default: return ScalarKernel<elemSize>::swap;
+    }
+}
+
+struct ByteSwapKernels final
+{
+    explicit ByteSwapKernels(ByteSwapISA isa) :
+        swap2(selectKernel<2>(isa)),
+        swap4(selectKernel<4>(isa)),
+        swap8(selectKernel<8>(isa)),
+        swap16(selectKernel<16>(isa))
+    {
+    }
+    const ByteSwapKernel swap2;
+    const ByteSwapKernel swap4;
+    const ByteSwapKernel swap8;
+    const ByteSwapKernel swap16;
+};
+const ByteSwapKernels& getKernels()
+{
+    static const ByteSwapKernels kernels(detectByteSwapISA());
+    return kernels;
+}
+const ByteSwapKernels& getScalarKernels()
+{
+    static const ByteSwapKernels kernels(ByteSwapISA::Scalar);
+    return kernels;
+}
+
+// Returns nullptr for element sizes without a dedicated kernel.
+ByteSwapKernel getKernel(const ByteSwapKernels& kernels, size_t elemSize)
 {
     switch (elemSize)
     {
-        case sizeof(uint16_t): return byteSwap_n<uint16_t>(buffer, elemSize);
-        case sizeof(uint32_t): return byteSwap_n<uint32_t>(buffer, elemSize);
-        case sizeof(uint64_t): return byteSwap_n<uint64_t>(buffer, elemSize);
-        default: break;
+    case 2: return kernels.swap2;
+    case 4: return kernels.swap4;
+    case 8: return kernels.swap8;
+    case 16: return kernels.swap16;
+    default: return nullptr;
     }
+}
 
-    auto const bufferPtr = buffer.data();
+// Any other element size: reverse each element one byte at a time.
+void byteSwapGeneric(const coda_oss::byte* in, size_t elemSize, size_t numElems, coda_oss::byte* out)
+{
     const auto half = elemSize >> 1;
-    size_t offset = 0, innerOff = 0, innerSwap = 0;
-    for (size_t i = 0; i < numElems; ++i, offset += elemSize)
+    size_t offset = 0;
+    for (size_t ii = 0; ii < numElems; ++ii, offset += elemSize)
     {
-        for (size_t j = 0; j < half; ++j)
+        for (size_t jj = 0; jj < half; ++jj)
         {
-            innerOff = offset + j;
-            innerSwap = offset + elemSize - 1 - j;
+            const size_t innerOff = offset + jj;
+            const size_t innerSwap = offset + elemSize - 1 - jj;
 
-            std::swap(bufferPtr[innerOff], bufferPtr[innerSwap]);
+            const auto tmp = in[innerOff]; // in-place: 'in' and 'out' may alias
+            out[innerOff] = in[innerSwap];
+            out[innerSwap] = tmp;
+        }
+    }
+}
+
+void byteSwap_(const ByteSwapKernels& kernels,
+               const coda_oss::byte* in, size_t elemSize, size_t numElems, coda_oss::byte* out)
+{
+    if (elemSize == 1)
+    {
+        if (in != out)
+        {
+            std::ignore = memcpy(out, in, numElems);
         }
+        return;
+    }
+
+    const auto kernel = getKernel(kernels, elemSize);
+    if (kernel != nullptr)
+    {
+        kernel(in, out, numElems);
     }
+    else
+    {
+        byteSwapGeneric(in, elemSize, numElems, out);
+    }
+}
+}
 
+void sys::details::byteSwapScalar(const void* buffer, size_t elemSize, size_t numElems, void* outputBuffer)
+{
+    if ((numElems == 0) || (buffer == nullptr) || (outputBuffer == nullptr))
+    {
+        return;
+    }
+    byteSwap_(getScalarKernels(), static_cast<const coda_oss::byte*>(buffer), elemSize, numElems,
+        static_cast<coda_oss::byte*>(outputBuffer));
+}
+
+   /*!
+ *  Swap bytes in-place.  Note that a complex pixel
+ *  is equivalent to two floats so elemSize and numElems
+ *  must be adjusted accordingly.
+ *
+ *  \param [inout] buffer to transform
+ *  \param elemSize
+ *  \param numElems
+ */
+static coda_oss::span<const coda_oss::byte> byteSwap(coda_oss::span<coda_oss::byte> buffer, size_t elemSize, size_t numElems)
+{
+    auto const bufferPtr = buffer.data();
+    byteSwap_(getKernels(), bufferPtr, elemSize, numElems, bufferPtr);
     return sys::make_const_span(buffer);
 }
 void sys::byteSwap(void* buffer_, size_t elemSize, size_t numElems)
@@ -217,67 +481,11 @@ coda_oss::span<const coda_oss::byte> sys::byteSwap(coda_oss::span<coda_oss::byte
  *  \param numElems
  *  \param[out] outputBuffer buffer to write swapped elements to
  */
-template <typename TUInt>
-inline auto byteSwap_n_(coda_oss::span<const TUInt> buffer, coda_oss::span<coda_oss::byte> outputBuffer_)
-{
-    static_assert(std::is_unsigned<TUInt>::value, "TUInt must be 'unsigned'");
-
-    assert(buffer.size_bytes() == outputBuffer_.size());
-    void* pOutputBuffer = outputBuffer_.data();
-    const auto outputBuffer = sys::make_span<TUInt>(pOutputBuffer, buffer.size());
-    assert(buffer.size_bytes() == outputBuffer.size_bytes());
-
-    const auto byteSwap = [](const auto& v) { return sys::byteSwap(v); };
-    std::transform(buffer.begin(), buffer.end(), outputBuffer.begin(), byteSwap);
-
-    return sys::as_bytes(outputBuffer);
-}
-template <typename TUInt>
-inline auto byteSwap_n(coda_oss::span<const coda_oss::byte> buffer_, size_t elemSize, coda_oss::span<coda_oss::byte> outputBuffer)
-{
-    if (sizeof(TUInt) != elemSize)
-    {
-        throw std::invalid_argument("'elemSize' != sizeof(TUInt)");
-    }
-
-    const auto buffer = sys::make_span<TUInt>(buffer_.data(), buffer_.size_bytes() / sizeof(TUInt));
-    assert(buffer.size_bytes() == buffer_.size_bytes());
-    return byteSwap_n_<TUInt>(buffer,  outputBuffer);
-}
-
 static auto byteSwap(coda_oss::span<const coda_oss::byte> buffer,
                       size_t elemSize, size_t numElems,
                       coda_oss::span<coda_oss::byte> outputBuffer)
 {
-    auto const bufferPtr = buffer.data();
-    auto const outputBufferPtr = outputBuffer.data();
-    switch (elemSize)
-    {
-        case 1:
-        {
-            std::ignore = memcpy(outputBufferPtr, bufferPtr, elemSize * numElems);
-            return sys::make_const_span(outputBuffer);
-        }
-        case 2: return byteSwap_n<uint16_t>(buffer, elemSize, outputBuffer);
-        case 4: return byteSwap_n<uint32_t>(buffer, elemSize, outputBuffer);
-        case 8: return byteSwap_n<uint64_t>(buffer, elemSize, outputBuffer);
-        default: break;
-    }
-
-    const auto half = elemSize >> 1;
-    size_t offset = 0;
-    for (size_t ii = 0; ii < numElems; ++ii, offset += elemSize)
-    {
-        for (size_t jj = 0; jj < half; ++jj)
-        {
-            const size_t innerOff = offset + jj;
-            const size_t innerSwap = offset + elemSize - 1 - jj;
-
-            outputBufferPtr[innerOff] = bufferPtr[innerSwap];
-            outputBufferPtr[innerSwap] = bufferPtr[innerOff];
-        }
-    }
-
+    byteSwap_(getKernels(), buffer.data(), elemSize, numElems, outputBuffer.data());
     return sys::make_const_span(outputBuffer);
 }
 
@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
 
 _SYS_HANDLE_TYPE sys::File::createFile(const coda_oss::filesystem::path& str_, int accessFlags, int creationFlags) noexcept
 {
@@ -165,6 +166,52 @@ void sys::File::writeFrom(const void* buffer, size_t size)
     while (bytesActuallyWritten < size);
 }
 
+void sys::File::writeAtFrom(sys::Off_T offset, const void* buffer, size_t size)
+{
+    size_t bytesActuallyWritten = 0;
+
+    const sys::byte* bufferPtr = static_cast<const sys::byte*>(buffer);
+
+    while (bytesActuallyWritten < size)
+    {
+        const SSize_T bytesThisWrite = ::pwrite(mHandle,
+                                                bufferPtr + bytesActuallyWritten,
+                                                size - bytesActuallyWritten,
+                                                offset + bytesActuallyWritten);
+        if (bytesThisWrite == -1)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            throw sys::SystemException(Ctxt("Writing to file"));
+        }
+        bytesActuallyWritten += bytesThisWrite;
+    }
+}
+
+void sys::File::allocate(sys::Off_T length)
+{
+    if (length <= this->length())
+        return;
+
+#if defined(__linux__) || defined(__linux) || defined(linux__)
+    // posix_fallocate() returns the error rather than setting errno
+    const int result = ::posix_fallocate(mHandle, 0, length);
+    if (result == 0)
+        return;
+    if (result != EOPNOTSUPP && result != EINVAL)
+    {
+        throw sys::SystemException(Ctxt(
+            "Error allocating file " + mPath + " (" + ::strerror(result) + ")"));
+    }
+#endif
+
+    // Not supported by this file system, so settle for the size
+    if (::ftruncate(mHandle, length) != 0)
+    {
+        throw sys::SystemException(Ctxt("Error extending file " + mPath));
+    }
+}
+
 sys::Off_T sys::File::seekTo(sys::Off_T offset, int whence)
 {
     sys::Off_T off = ::lseek(mHandle, offset, whence);
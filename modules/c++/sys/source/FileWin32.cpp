@@ -172,6 +172,57 @@ void sys::File::writeFrom(const void* buffer, size_t size)
     }
 }
 
+void sys::File::writeAtFrom(sys::Off_T offset, const void* buffer, size_t size)
+{
+    static const size_t MAX_WRITE_SIZE = std::numeric_limits<DWORD>::max();
+    size_t bytesRemaining = size;
+    size_t bytesWritten = 0;
+    OVERLAPPED overlapped;
+
+    const sys::byte* bufferPtr = static_cast<const sys::byte*>(buffer);
+
+    while (bytesWritten < size)
+    {
+        // Determine how many bytes to write
+        const DWORD bytesToWrite = static_cast<DWORD>(
+            std::min(MAX_WRITE_SIZE, bytesRemaining));
+
+        // Write the data
+        DWORD bytesThisWrite = 0;
+        const sys::Off_T curOffset = offset + bytesWritten;
+        ::memset(&overlapped, 0, sizeof(OVERLAPPED));
+        overlapped.Offset = curOffset & 0xFFFFFFFF;
+        overlapped.OffsetHigh = curOffset >> 32;
+        if (!WriteFile(mHandle,
+                       bufferPtr + bytesWritten,
+                       bytesToWrite,
+                       &bytesThisWrite,
+                       &overlapped))
+        {
+            throw sys::SystemException(Ctxt("Writing to file"));
+        }
+
+        // Accumulate this write until we are done
+        bytesRemaining -= bytesThisWrite;
+        bytesWritten += bytesThisWrite;
+    }
+}
+
+void sys::File::allocate(sys::Off_T length)
+{
+    if (length <= this->length())
+        return;
+
+    // Setting the end of file reserves the space on NTFS
+    FILE_END_OF_FILE_INFO info;
+    info.EndOfFile.QuadPart = length;
+    if (!SetFileInformationByHandle(mHandle, FileEndOfFileInfo, &info,
+                                    sizeof(info)))
+    {
+        throw sys::SystemException(Ctxt("Error extending file " + mPath));
+    }
+}
+
 sys::Off_T sys::File::seekTo(sys::Off_T offset, int whence)
 {
     /* Ahhh!!! */
@@ -25,6 +25,8 @@
 #include <limits.h>
 #include <errno.h>
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 #include <vector>
 #include <set>
@@ -48,6 +50,10 @@
 
 #endif
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #include "sys/OSUnix.h"
 #include "sys/File.h"
 #include "sys/ScopedCPUAffinityUnix.h"
@@ -135,6 +141,84 @@ std::set<std::string> get_unique_thread_siblings()
 
     return unique_ts;
 }
+
+// Parses a kernel CPU list such as "0-3,8-11"
+std::vector<int> parseCPUList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    const str::Tokenizer::Tokens ranges = str::Tokenizer(cpuList, ",");
+    for (const auto& range : ranges)
+    {
+        const std::string::size_type dash = range.find('-');
+        if (dash == std::string::npos)
+        {
+            cpus.push_back(str::toType<int>(range));
+        }
+        else
+        {
+            const int first = str::toType<int>(range.substr(0, dash));
+            const int last = str::toType<int>(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+// Maps each CPU to its NUMA node from
+// /sys/devices/system/node/node*/cpulist.  Empty if there's no such info.
+std::map<int, int> get_cpu_to_numa_node()
+{
+    std::map<int, int> cpuToNode;
+    const sys::Path sysNodePath("/sys/devices/system/node");
+    if (!sysNodePath.isDirectory())
+    {
+        return cpuToNode;
+    }
+
+    const std::vector<std::string> searchPaths(1, sysNodePath.getPath());
+    const std::vector<std::string> subDirs =
+        sys::FileFinder::search(
+            sys::DirectoryOnlyPredicate(),
+            searchPaths,
+            false);
+
+    const std::string prefix("node");
+    for (const auto& subDir : subDirs)
+    {
+        const std::string name = sys::Path::basename(subDir);
+        if (name.size() <= prefix.size() ||
+            name.compare(0, prefix.size(), prefix) != 0 ||
+            name.find_first_not_of("0123456789", prefix.size()) !=
+                    std::string::npos)
+        {
+            continue;
+        }
+        const int node = str::toType<int>(name.substr(prefix.size()));
+
+        const sys::Path cpuListPath(subDir, "cpulist");
+        std::ifstream cpuListIFS(cpuListPath.getPath().c_str());
+        if (!cpuListIFS.is_open())
+        {
+            continue;
+        }
+
+        // Memory-only nodes have an empty list
+        std::string cpuList;
+        cpuListIFS >> cpuList;
+        if (!cpuList.empty())
+        {
+            for (const int cpu : parseCPUList(cpuList))
+            {
+                cpuToNode[cpu] = node;
+            }
+        }
+    }
+
+    return cpuToNode;
+}
 }
 
 std::string sys::OSUnix::getPlatformName() const
@@ -423,6 +507,118 @@ void sys::OSUnix::getAvailableCPUs(std::vector<int>& physicalCPUs,
     }
 }
 
+void sys::OSUnix::getNUMANodes(std::vector<NUMANode>& nodes) const
+{
+    const std::map<int, int> cpuToNode(get_cpu_to_numa_node());
+    if (cpuToNode.empty())
+    {
+        AbstractOS::getNUMANodes(nodes);
+        return;
+    }
+
+    std::vector<int> physicalCPUs;
+    std::vector<int> htCPUs;
+    getAvailableCPUs(physicalCPUs, htCPUs);
+
+    // CPUs the node files don't mention (shouldn't happen) go on node 0
+    const auto nodeOf = [&cpuToNode](int cpu)
+    {
+        const auto iter = cpuToNode.find(cpu);
+        return iter == cpuToNode.end() ? 0 : iter->second;
+    };
+
+    std::map<int, NUMANode> nodesByID;
+    for (const int cpu : physicalCPUs)
+    {
+        nodesByID[nodeOf(cpu)].physicalCPUs.push_back(cpu);
+    }
+    for (const int cpu : htCPUs)
+    {
+        nodesByID[nodeOf(cpu)].htCPUs.push_back(cpu);
+    }
+
+    nodes.clear();
+    for (auto& entry : nodesByID)
+    {
+        NUMANode& node = entry.second;
+        node.id = entry.first;
+        std::sort(node.physicalCPUs.begin(), node.physicalCPUs.end());
+        std::sort(node.htCPUs.begin(), node.htCPUs.end());
+        nodes.push_back(std::move(node));
+    }
+}
+
+int sys::OSUnix::getCurrentNUMANode() const
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    {
+        return static_cast<int>(node);
+    }
+#endif
+    return AbstractOS::getCurrentNUMANode();
+}
+
+#if defined(__linux__) && defined(SYS_mbind)
+// mbind() works on whole pages.  Anything else would also bind (and
+// migrate) whatever else shares the pages at either end.
+static bool isWholePages(const void* address, size_t numBytes)
+{
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    return address != nullptr && numBytes != 0 &&
+            reinterpret_cast<uintptr_t>(address) % pageSize == 0 &&
+            numBytes % pageSize == 0;
+}
+#endif
+
+bool sys::OSUnix::bindToNUMANode(void* address,
+                                 size_t numBytes,
+                                 int node) const
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    if (!isWholePages(address, numBytes) || node < 0)
+    {
+        return false;
+    }
+
+    // From <linux/mempolicy.h>; we call mbind directly rather than
+    // depending on libnuma.
+    const int mpolBind = 2;
+    const unsigned int mpolMoveFlag = 1 << 1;
+
+    const size_t bitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+    const size_t nodeIndex = static_cast<size_t>(node);
+    std::vector<unsigned long> nodeMask(nodeIndex / bitsPerWord + 1, 0);
+    nodeMask[nodeIndex / bitsPerWord] = 1UL << (nodeIndex % bitsPerWord);
+
+    // The kernel ignores the last bit of maxnode
+    const unsigned long maxNode = nodeMask.size() * bitsPerWord + 1;
+    return syscall(SYS_mbind, address, numBytes, mpolBind,
+                   nodeMask.data(), maxNode, mpolMoveFlag) == 0;
+#else
+    return AbstractOS::bindToNUMANode(address, numBytes, node);
+#endif
+}
+
+bool sys::OSUnix::unbindFromNUMANode(void* address, size_t numBytes) const
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    if (!isWholePages(address, numBytes))
+    {
+        return false;
+    }
+
+    // MPOL_DEFAULT drops the range's own policy; the pages stay put
+    const int mpolDefault = 0;
+    return syscall(SYS_mbind, address, numBytes, mpolDefault,
+                   nullptr, 0UL, 0U) == 0;
+#else
+    return AbstractOS::unbindFromNUMANode(address, numBytes);
+#endif
+}
+
 sys::SIMDInstructionSet sys::OSUnix::getSIMDInstructionSet() const
 {
     // https://gcc.gnu.org/onlinedocs/gcc-4.8.2/gcc/X86-Built-in-Functions.html
@@ -0,0 +1,110 @@
+/* =========================================================================
+ * This file is part of sys-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * sys-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Users guide
+
+    Compares sys::byteSwap(), which uses the SIMD kernel selected for the
+    running CPU, against the portable scalar implementation.
+
+    ./ByteSwapBenchmark [megabytes] [iterations]
+        --defaults to 256 MB swapped 10 times for each element size
+
+    Throughput is reported in MB/s for in-place and copy-out swaps.
+*/
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <sys/ByteSwap.h>
+#include <sys/StopWatch.h>
+
+namespace
+{
+template <typename SwapT>
+double megabytesPerSecond(size_t numBytes, size_t iterations, SwapT swap)
+{
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (size_t ii = 0; ii < iterations; ++ii)
+    {
+        swap();
+    }
+    const double millis = sw.stop();
+    const double megabytes = static_cast<double>(numBytes * iterations) / (1024.0 * 1024.0);
+    return millis > 0.0 ? megabytes / (millis / 1000.0) : 0.0;
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const size_t megabytes = argc > 1 ? static_cast<size_t>(atoi(argv[1])) : 256;
+        const size_t iterations = argc > 2 ? static_cast<size_t>(atoi(argv[2])) : 10;
+        const size_t numBytes = megabytes * 1024 * 1024;
+
+        std::vector<sys::ubyte> input(numBytes);
+        for (size_t ii = 0; ii < input.size(); ++ii)
+        {
+            input[ii] = static_cast<sys::ubyte>(ii);
+        }
+        std::vector<sys::ubyte> output(numBytes);
+
+        std::cout << std::setw(10) << "elemSize"
+                  << std::setw(18) << "scalar in-place"
+                  << std::setw(18) << "byteSwap in-place"
+                  << std::setw(18) << "scalar copy"
+                  << std::setw(18) << "byteSwap copy" << " (MB/s)\n";
+
+        for (const size_t elemSize : {2, 4, 8, 16})
+        {
+            const size_t numElems = numBytes / elemSize;
+            void* const buffer = input.data();
+            void* const outputBuffer = output.data();
+
+            const auto scalarInPlace = megabytesPerSecond(numBytes, iterations, [&]() {
+                sys::details::byteSwapScalar(buffer, elemSize, numElems, buffer); });
+            const auto simdInPlace = megabytesPerSecond(numBytes, iterations, [&]() {
+                sys::byteSwap(buffer, elemSize, numElems); });
+            const auto scalarCopy = megabytesPerSecond(numBytes, iterations, [&]() {
+                sys::details::byteSwapScalar(buffer, elemSize, numElems, outputBuffer); });
+            const auto simdCopy = megabytesPerSecond(numBytes, iterations, [&]() {
+                sys::byteSwap(static_cast<const void*>(buffer), elemSize, numElems, outputBuffer); });
+
+            std::cout << std::setw(10) << elemSize
+                      << std::setw(18) << static_cast<size_t>(scalarInPlace)
+                      << std::setw(18) << static_cast<size_t>(simdInPlace)
+                      << std::setw(18) << static_cast<size_t>(scalarCopy)
+                      << std::setw(18) << static_cast<size_t>(simdCopy) << "\n";
+        }
+        return 0;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+    }
+    return 1;
+}
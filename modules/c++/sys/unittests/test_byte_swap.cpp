@@ -22,6 +22,7 @@
 
 #include "TestCase.h"
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <std/bit> // std::endian
@@ -308,6 +309,57 @@ TEST_CASE(testSixByteSwap)
     TEST_ASSERT_EQ(i, result);
 }
 
+// The runtime-selected (possibly SIMD) kernels must match the scalar path for
+// every element size, odd counts (so the scalar tail runs) and unaligned data.
+TEST_CASE(testByteSwapMatchesScalar)
+{
+    std::vector<std::byte> values(4096 + 16 + 1);
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        values[ii] = static_cast<std::byte>(ii * 7 + 3);
+    }
+
+    for (const size_t elemSize : {2, 4, 8, 16, 6, 12})
+    {
+        for (const size_t offset : {0, 1})
+        {
+            for (const size_t numElems : {1, 3, 31, 255})
+            {
+                const auto input = values.data() + offset;
+
+                std::vector<std::byte> expected(elemSize * numElems);
+                sys::details::byteSwapScalar(input, elemSize, numElems, expected.data());
+
+                // copy-out
+                std::vector<std::byte> actual(elemSize * numElems + 1);
+                sys::byteSwap(input, elemSize, numElems, actual.data() + offset);
+                TEST_ASSERT(std::equal(expected.begin(), expected.end(), actual.begin() + offset));
+
+                // in-place
+                std::vector<std::byte> inPlace(values.begin(), values.end());
+                sys::byteSwap(inPlace.data() + offset, elemSize, numElems);
+                TEST_ASSERT(std::equal(expected.begin(), expected.end(), inPlace.begin() + offset));
+
+                // ... and back again
+                sys::byteSwap(inPlace.data() + offset, elemSize, numElems);
+                TEST_ASSERT(std::equal(inPlace.begin(), inPlace.end(), values.begin()));
+            }
+        }
+    }
+
+    // A 16-byte element is reversed as a whole
+    std::array<std::byte, 16> sixteen;
+    for (size_t ii = 0; ii < sixteen.size(); ++ii)
+    {
+        sixteen[ii] = static_cast<std::byte>(ii);
+    }
+    sys::byteSwap(sixteen.data(), sixteen.size(), 1);
+    for (size_t ii = 0; ii < sixteen.size(); ++ii)
+    {
+        TEST_ASSERT(sixteen[ii] == static_cast<std::byte>(15 - ii));
+    }
+}
+
 TEST_MAIN(
     TEST_CHECK(testEndianness);
     TEST_CHECK(testByteSwapV);
@@ -317,4 +369,5 @@ TEST_MAIN(
     TEST_CHECK(testByteSwapCxValue);
     TEST_CHECK(testByteSwap12);
     TEST_CHECK(testSixByteSwap);
+    TEST_CHECK(testByteSwapMatchesScalar);
     )
@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <numeric> // std::accumulate
@@ -425,6 +426,36 @@ TEST_CASE(test_makeFile)
   TEST_ASSERT_TRUE(file.isOpen());
 }
 
+TEST_CASE(test_File_writeAt)
+{
+    const sys::OS os;
+    const auto pathname = os.getTempName(".");
+    {
+        sys::File file(sys::Path(pathname), sys::File::READ_AND_WRITE,
+                       sys::File::CREATE | sys::File::TRUNCATE);
+        file.allocate(4096);
+        TEST_ASSERT_EQ(file.length(), static_cast<sys::Off_T>(4096));
+
+        // Out of order, and past the allocation
+        file.writeAtFrom(5000, "xyz", 3);
+        file.writeAtFrom(100, "abc", 3);
+        TEST_ASSERT_EQ(file.length(), static_cast<sys::Off_T>(5003));
+
+        char buffer[3];
+        file.readAtInto(100, buffer, sizeof(buffer));
+        TEST_ASSERT_EQ(std::string(buffer, sizeof(buffer)), "abc");
+        file.readAtInto(5000, buffer, sizeof(buffer));
+        TEST_ASSERT_EQ(std::string(buffer, sizeof(buffer)), "xyz");
+        file.readAtInto(0, buffer, sizeof(buffer));
+        TEST_ASSERT_EQ(buffer[0], '\0');
+
+        // Never shrinks
+        file.allocate(10);
+        TEST_ASSERT_EQ(file.length(), static_cast<sys::Off_T>(5003));
+    }
+    os.remove(pathname);
+}
+
 static FILE* sys_fopen()
 {
     static const std::string mode("r");
@@ -522,6 +553,46 @@ TEST_CASE(test_SIMD_Instructions)
     TEST_ASSERT(isSSE2 || isAVX2 || isAVX512F);
 }
 
+TEST_CASE(test_NUMA_Nodes)
+{
+#if !defined(_WIN32) // getAvailableCPUs() isn't implemented on Windows
+    const sys::OS os;
+    std::vector<int> physicalCPUs;
+    std::vector<int> htCPUs;
+    os.getAvailableCPUs(physicalCPUs, htCPUs);
+
+    std::vector<sys::NUMANode> nodes;
+    os.getNUMANodes(nodes);
+    TEST_ASSERT_FALSE(nodes.empty());
+
+    // Every available CPU shows up on exactly one node
+    std::vector<int> nodePhysicalCPUs;
+    std::vector<int> nodeHTCPUs;
+    for (size_t ii = 0; ii < nodes.size(); ++ii)
+    {
+        if (ii > 0)
+        {
+            TEST_ASSERT(nodes[ii - 1].id < nodes[ii].id);
+        }
+        TEST_ASSERT_FALSE(nodes[ii].physicalCPUs.empty() &&
+                          nodes[ii].htCPUs.empty());
+        nodePhysicalCPUs.insert(nodePhysicalCPUs.end(),
+                                nodes[ii].physicalCPUs.begin(),
+                                nodes[ii].physicalCPUs.end());
+        nodeHTCPUs.insert(nodeHTCPUs.end(),
+                          nodes[ii].htCPUs.begin(), nodes[ii].htCPUs.end());
+    }
+    std::sort(physicalCPUs.begin(), physicalCPUs.end());
+    std::sort(htCPUs.begin(), htCPUs.end());
+    std::sort(nodePhysicalCPUs.begin(), nodePhysicalCPUs.end());
+    std::sort(nodeHTCPUs.begin(), nodeHTCPUs.end());
+    TEST_ASSERT(physicalCPUs == nodePhysicalCPUs);
+    TEST_ASSERT(htCPUs == nodeHTCPUs);
+
+    TEST_ASSERT(os.getCurrentNUMANode() >= 0);
+#endif
+}
+
 TEST_MAIN(
     //sys::AbstractOS::setArgvPathname(argv[0]);
     TEST_CHECK(testRecursiveRemove);
@@ -534,9 +605,11 @@ TEST_MAIN(
     TEST_CHECK(testSpecialEnvVars);
     TEST_CHECK(testFsFileSize);
     TEST_CHECK(test_makeFile);
+    TEST_CHECK(test_File_writeAt);
     TEST_CHECK(test_sys_fopen);
     TEST_CHECK(test_sys_fopen_failure);
     TEST_CHECK(test_sys_open);
     TEST_CHECK(test_make_ifstream);
     TEST_CHECK(test_SIMD_Instructions);
+    TEST_CHECK(test_NUMA_Nodes);
     )
@@ -82,6 +82,11 @@ public:
             SRATIONAL,
             FLOAT,
             DOUBLE,
+            IFD,
+            // BigTIFF only
+            LONG8 = 16,
+            SLONG8,
+            IFD8,
             MAX
         };
     };
@@ -143,7 +148,24 @@ public:
             DEFLATE,
             JBIG_BW,
             JBIG_COLOR,
-            PACK_BITS = 32773
+            PACK_BITS = 32773,
+            PKZIP_DEFLATE = 32946
+        };
+    };
+
+    /*
+     * Predictor
+     * http://www.awaresystems.be/imaging/tiff/tifftags/predictor.html
+     */
+
+    class PredictorType
+    {
+    public:
+        enum
+        {
+            NONE = 1,
+            HORIZONTAL,
+            FLOATING_POINT
         };
     };
 
@@ -155,11 +177,11 @@ public:
      * @param type
      *   The TIFF type to return the size of
      * @return
-     *   The size of the specified TIFF type
+     *   The size of the specified TIFF type, or 0 if it's unknown
      *****************************************************************/
     static short sizeOf(unsigned short type)
     {
-        return mTypeSizes[type];
+        return type < Type::MAX ? mTypeSizes[type] : 0;
     }
 
 private:
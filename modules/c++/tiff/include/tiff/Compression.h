@@ -0,0 +1,136 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CODA_OSS_tiff_Compression_h_INCLUDED_
+#define CODA_OSS_tiff_Compression_h_INCLUDED_
+#pragma once
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "config/Exports.h"
+
+namespace tiff
+{
+
+/**
+ *********************************************************************
+ * @class Codec
+ * @brief Compresses and decompresses a single strip or tile.
+ *
+ * Codecs keep no state between calls, so one codec can be shared by
+ * threads encoding or decoding different strips and tiles at once.
+ *********************************************************************/
+class CODA_OSS_API Codec
+{
+public:
+    virtual ~Codec() = default;
+
+    /**
+     *****************************************************************
+     * Compresses numRows rows of rowBytes bytes each, replacing the
+     * contents of dest.
+     *****************************************************************/
+    virtual void encode(const unsigned char *src, size_t numRows,
+                        size_t rowBytes,
+                        std::vector<unsigned char>& dest) const = 0;
+
+    /**
+     *****************************************************************
+     * Decompresses srcLen bytes into exactly destLen bytes.  If the
+     * data decompresses to less than that, the rest of dest is
+     * zeroed; anything past destLen is ignored.
+     *
+     * @throw except::Exception if the data is corrupt
+     *****************************************************************/
+    virtual void decode(const unsigned char *src, size_t srcLen,
+                        unsigned char *dest, size_t destLen) const = 0;
+};
+
+/**
+ *****************************************************************
+ * Returns whether createCodec() supports the specified
+ * tiff::Const::CompressionType.  NO_COMPRESSION isn't a codec, so
+ * this returns false for it.
+ *****************************************************************/
+CODA_OSS_API bool isCodecSupported(unsigned short compression);
+
+/**
+ *****************************************************************
+ * Creates the codec for the specified tiff::Const::CompressionType:
+ * LZW, PACK_BITS or (if zlib is available) DEFLATE.
+ *
+ * @throw except::NotImplementedException if it's not supported
+ *****************************************************************/
+CODA_OSS_API std::unique_ptr<Codec> createCodec(unsigned short compression);
+
+/**
+ *****************************************************************
+ * Returns whether the Predictor tag applies to the specified
+ * tiff::Const::CompressionType.  Only LZW and Deflate use it; other
+ * schemes ignore it, as libtiff does.
+ *****************************************************************/
+CODA_OSS_API bool usesPredictor(unsigned short compression);
+
+/**
+ *****************************************************************
+ * Applies a tiff::Const::PredictorType to numRows rows of a strip or
+ * tile, in place, before it's encoded.  The data must be in native
+ * byte order.
+ *
+ * @param predictor
+ *   the predictor; NONE does nothing
+ * @param data
+ *   the rows to difference
+ * @param numRows
+ *   the number of rows
+ * @param rowBytes
+ *   the size of each row, in bytes
+ * @param bytesPerSample
+ *   the size of a single sample (band) of a pixel
+ * @param samplesPerPixel
+ *   the number of samples in each pixel
+ * @throw except::NotImplementedException for an unsupported
+ *   predictor or sample size
+ *****************************************************************/
+CODA_OSS_API void applyPredictor(unsigned short predictor,
+                                 unsigned char *data, size_t numRows,
+                                 size_t rowBytes, size_t bytesPerSample,
+                                 size_t samplesPerPixel);
+
+/**
+ *****************************************************************
+ * Undoes applyPredictor() after a strip or tile is decoded.  For
+ * the horizontal predictor, the data must already be in native
+ * byte order; the floating point predictor stores its bytes in a
+ * fixed order, so its output is always native.
+ *****************************************************************/
+CODA_OSS_API void removePredictor(unsigned short predictor,
+                                  unsigned char *data, size_t numRows,
+                                  size_t rowBytes, size_t bytesPerSample,
+                                  size_t samplesPerPixel);
+
+} // End namespace.
+
+#endif // CODA_OSS_tiff_Compression_h_INCLUDED_
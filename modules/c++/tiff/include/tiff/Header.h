@@ -41,21 +41,24 @@ class CODA_OSS_API Header : public io::Serializable
 public:
     enum ByteOrder { MM, II };
 
+    //! The TIFF identifier; BigTIFF has 64-bit offsets
+    enum Version { CLASSIC = 42, BIG_TIFF = 43 };
+
     /**
      *****************************************************************
      * Constructor.  Allows the user to set the values in the header
      * and also provides resonable defaults.
      *
      * @param id
-     *   the TIFF identifier, always "42"
+     *   the TIFF identifier, "42" or "43" for BigTIFF
      * @param byteOrder
      *   the byte order of the file "MM" for Big Endian, "II" 
      *   for Little Endian
      * @param ifdOffset
      *   the offset to the first IFD
      *****************************************************************/
-    Header(const unsigned short id = 42, const char byteOrder[2] = "  ",
-            const sys::Uint32_T ifdOffset = 8) :
+    Header(const unsigned short id = CLASSIC, const char byteOrder[2] = "  ",
+            const sys::Uint64_T ifdOffset = 8) :
         mId(id), mIFDOffset(ifdOffset)
     {
         const bool isBigEndian = sys::isBigEndianSystem();
@@ -109,6 +112,46 @@ public:
      *****************************************************************/
     void deserialize(io::InputStream& input) override;
 
+    /**
+     *****************************************************************
+     * Switches between a classic TIFF header and a BigTIFF one.
+     * Must be done before the header is serialized.
+     *
+     * @param bigTIFF
+     *   whether to write a BigTIFF file
+     *****************************************************************/
+    void setBigTIFF(bool bigTIFF)
+    {
+        mId = bigTIFF ? BIG_TIFF : CLASSIC;
+        mIFDOffset = size();
+    }
+
+    //! Returns whether this is a BigTIFF header
+    bool isBigTIFF() const
+    {
+        return mId == BIG_TIFF;
+    }
+
+    /**
+     *****************************************************************
+     * Returns the size of the header in the file: 8 bytes, or 16
+     * for BigTIFF.  The offset to the first IFD is at the end.
+     *****************************************************************/
+    sys::Uint32_T size() const
+    {
+        return isBigTIFF() ? 16 : 8;
+    }
+
+    /**
+     *****************************************************************
+     * Returns the size of the file offsets: 4 bytes, or 8 for
+     * BigTIFF.
+     *****************************************************************/
+    unsigned short getOffsetSize() const
+    {
+        return isBigTIFF() ? 8 : 4;
+    }
+
     /**
      *****************************************************************
      * Prints the TIFF header to the specified output stream in
@@ -126,7 +169,7 @@ public:
      * @return
      *   the IFD offset
      *****************************************************************/
-    sys::Uint32_T getIFDOffset() const
+    sys::Uint64_T getIFDOffset() const
     {
         return mIFDOffset;
     }
@@ -153,7 +196,7 @@ private:
     unsigned short mId;
 
     //! The IFD offset
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
     
     bool mDifferentByteOrdering;
     
@@ -195,8 +195,11 @@ public:
      *
      * @param output
      *   the output stream to write the IFD to
+     * @param bigTIFF
+     *   whether to write a BigTIFF IFD (64-bit counts and offsets)
      *****************************************************************/
     void serialize(io::OutputStream& output) override;
+    void serialize(io::OutputStream& output, const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -204,9 +207,14 @@ public:
      *
      * @param input
      *   the input stream to read the IFD from
+     * @param reverseBytes
+     *   whether the file's byte order differs from the system's
+     * @param bigTIFF
+     *   whether to read a BigTIFF IFD (64-bit counts and offsets)
      *****************************************************************/
     void deserialize(io::InputStream& input) override;
-    void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF = false);
 
     /**
      *****************************************************************
@@ -238,7 +246,7 @@ public:
      * @return 
      *   the calculated image size in bytes
      *****************************************************************/
-    sys::Uint32_T getImageSize() const;
+    sys::Uint64_T getImageSize() const;
 
     /**
      *****************************************************************
@@ -281,7 +289,7 @@ public:
      * @return
      *   the offset to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffsetPosition()
+    sys::Uint64_T getNextIFDOffsetPosition()
     {
         return mNextIFDOffsetPosition;
     }
@@ -297,11 +305,13 @@ private:
      * @param offset
      *   the file offset that indicates the beginning position of 
      *   the IFD.
+     * @param bigTIFF
+     *   whether the IFD will be written to a BigTIFF file
      * @return
      *   the highest overflow offset calculated, this marks the
      *   potential beginning of the next image.
      *****************************************************************/
-    sys::Uint32_T finalize(const sys::Uint32_T offset);
+    sys::Uint64_T finalize(const sys::Uint64_T offset, const bool bigTIFF);
 
     //! The IFD entries
     IFDType mIFD;
@@ -311,7 +321,7 @@ private:
     }
 
     //! Offset where the next IFD offset can be written to
-    sys::Uint32_T mNextIFDOffsetPosition = 0;
+    sys::Uint64_T mNextIFDOffsetPosition = 0;
 };
 
 } // End namespace.
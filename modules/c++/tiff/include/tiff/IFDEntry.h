@@ -123,8 +123,11 @@ public:
      *
      * @param output
      *   the output stream to write the entry to
+     * @param bigTIFF
+     *   whether to write a BigTIFF entry (64-bit count and offset)
      *****************************************************************/
     void serialize(io::OutputStream& output) override;
+    void serialize(io::OutputStream& output, const bool bigTIFF);
 
     /**
      *****************************************************************
@@ -132,9 +135,14 @@ public:
      *
      * @param input
      *   the input stream to read the entry from
+     * @param reverseBytes
+     *   whether the file's byte order differs from the system's
+     * @param bigTIFF
+     *   whether to read a BigTIFF entry (64-bit count and offset)
      *****************************************************************/
     void deserialize(io::InputStream& input) override;
-    void deserialize(io::InputStream& input, const bool reverseBytes);
+    void deserialize(io::InputStream& input, const bool reverseBytes,
+                     const bool bigTIFF = false);
 
     /**
      *****************************************************************
@@ -199,9 +207,9 @@ public:
      * Returns the value offset.
      *
      * @return
-     *  the value offset
+     *  the value offset, or 0 if the values fit in the entry
      *****************************************************************/
-    sys::Uint32_T getOffset() const
+    sys::Uint64_T getOffset() const
     {
         return mOffset;
     }
@@ -331,32 +339,39 @@ public:
      *****************************************************************
      * Used for outputting the IFD entry to a file.  Calculates
      * a file offset to put data that overflows the size allowed for
-     * an IFD entry value (4 bytes) and sets the value count to be
-     * the number of values that were added to the IFD entry.
+     * an IFD entry value (4 bytes, or 8 for BigTIFF) and sets the
+     * value count to be the number of values that were added to the
+     * IFD entry.
      *
      * @param offset
      *   the next free file offset that the values will can be
      *   written to
+     * @param bigTIFF
+     *   whether the entry will be written to a BigTIFF file
      * @return
      *   the next free file offset, compensating for the IFD entry's
      *   values being written at the specified input offset
      *****************************************************************/
-    sys::Uint32_T finalize(const sys::Uint32_T offset);
+    sys::Uint64_T finalize(const sys::Uint64_T offset,
+                           const bool bigTIFF = false);
 
     /**
      *****************************************************************
      * According to the TIFF 6.0 spec, the size of an IFD entry is 12
-     * bytes.  The sizeof operator is thrown off by the extra members 
-     * mName of string type, and mValues of vector type (both of which
-     * are not in the specification but exist to make life simpler),
-     * hence the adjustment.  Returns the size of the IFD entry.
+     * bytes (20 in BigTIFF).  The sizeof operator is thrown off by
+     * the extra members mName of string type, and mValues of vector
+     * type (both of which are not in the specification but exist to
+     * make life simpler), hence the adjustment.  Returns the size of
+     * the IFD entry.
      *
+     * @param bigTIFF
+     *   whether to return the size of a BigTIFF entry
      * @return
-     *   the size of an IFD entry (12 bytes).
+     *   the size of an IFD entry (12 or 20 bytes).
      *****************************************************************/
-    static unsigned short sizeOf()
+    static unsigned short sizeOf(const bool bigTIFF = false)
     {
-        return 12;
+        return bigTIFF ? 20 : 12;
     }
 
 private:
@@ -383,7 +398,7 @@ private:
     sys::Uint32_T mCount;
 
     //! The file offset to values for the IFD entry
-    sys::Uint32_T mOffset;
+    sys::Uint64_T mOffset;
 
     //! The name of the IFD entry (i.e. "ImageWidth")
     std::string mName;
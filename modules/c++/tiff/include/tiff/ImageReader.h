@@ -23,9 +23,13 @@
 #ifndef __TIFF_IMAGE_READER_H__
 #define __TIFF_IMAGE_READER_H__
 
+#include <memory>
+#include <vector>
 #include <import/io.h>
 #include <config/Exports.h>
 
+#include "tiff/Common.h"
+#include "tiff/Compression.h"
 #include "tiff/IFDEntry.h"
 #include "tiff/IFD.h"
 
@@ -52,7 +56,25 @@ public:
      *   the stream to read the TIFF image from
      *****************************************************************/
     ImageReader(io::FileInputStream *input) :
-        mIFD(), mStripByteCounts(nullptr), mStripOffsets(nullptr), mInput(input),
+        mIFD(), mInput(input),
+                mFileInput(input), mMapInput(nullptr),
+                mNextOffset(0), mBytePosition(0), mStripIndex(0),
+                mElementSize(0), mReverseBytes(false)
+    {
+    }
+
+    /**
+     *****************************************************************
+     * Constructor.  Sets the image reader to read from the specified
+     * memory mapped file; image data is copied straight out of the
+     * mapping.
+     *
+     * @param input
+     *   the stream to read the TIFF image from
+     *****************************************************************/
+    ImageReader(io::MMapInputStream *input) :
+        mIFD(), mInput(input),
+                mFileInput(nullptr), mMapInput(input),
                 mNextOffset(0), mBytePosition(0), mStripIndex(0),
                 mElementSize(0), mReverseBytes(false)
     {
@@ -67,8 +89,13 @@ public:
      *****************************************************************
      * Processes the image from the file.  Reads the image's IFD
      * and stores it for later use.
+     *
+     * @param reverseBytes
+     *   whether the file's byte order differs from the system's
+     * @param bigTIFF
+     *   whether the file is a BigTIFF
      *****************************************************************/
-    void process(const bool reverseBytes = false);
+    void process(const bool reverseBytes = false, const bool bigTIFF = false);
 
     /**
      *****************************************************************
@@ -79,6 +106,20 @@ public:
      *****************************************************************/
     void print(io::OutputStream &output) const;
 
+    /**
+     *****************************************************************
+     * Sets the number of threads used to decode a compressed image.
+     * getData() decodes a full row of strips or tiles at a time, in
+     * parallel when this is more than 1.
+     *
+     * @param numThreads
+     *   the number of strips or tiles to decode at once
+     *****************************************************************/
+    void setNumThreads(size_t numThreads)
+    {
+        mNumThreads = numThreads;
+    }
+
     /**
      *****************************************************************
      * Gets the specified number of elements from the TIFF image and
@@ -92,6 +133,35 @@ public:
      *****************************************************************/
     void getData(unsigned char *buffer, const sys::Uint32_T numElementsToRead);
 
+    /**
+     *****************************************************************
+     * Reads a rectangular window of the image into the specified
+     * buffer, in raster order (numRows rows of numCols elements).
+     * Each strip or tile the window touches is read with a single
+     * positional read (or straight out of the mapping, if the image
+     * is memory mapped) and scattered into place, so tiled images
+     * don't turn into one small read per tile row.  This doesn't
+     * affect where the next getData() call picks up.
+     *
+     * @param buffer
+     *   the buffer to populate; at least numRows * numCols elements
+     * @param startRow
+     *   the first row of the window
+     * @param startCol
+     *   the first column of the window
+     * @param numRows
+     *   the number of rows in the window
+     * @param numCols
+     *   the number of columns in the window
+     * @param numThreads
+     *   if more than 1, strips or tiles are read and scattered in
+     *   parallel, in up to this many tasks on the shared
+     *   mt::WorkStealingExecutor
+     *****************************************************************/
+    void readWindow(unsigned char *buffer, sys::Uint32_T startRow,
+                    sys::Uint32_T startCol, sys::Uint32_T numRows,
+                    sys::Uint32_T numCols, size_t numThreads = 1);
+
     /**
      *****************************************************************
      * Returns a pointer to the IFD for this image.
@@ -123,11 +193,29 @@ public:
      * @return
      *   the next IFD offset
      *****************************************************************/
-    sys::Uint32_T getNextOffset() const
+    sys::Uint64_T getNextOffset() const
     {
         return mNextOffset;
     }
 
+    /**
+     *****************************************************************
+     * Reads image data through an io::AsyncFileReader on the same
+     * file, keeping up to readAhead strip or tile row reads in
+     * flight at once.  Pass nullptr to go back to reading
+     * synchronously from the input stream.
+     *
+     * @param reader
+     *   the reader to use; it must outlive this ImageReader
+     * @param readAhead
+     *   the number of reads to keep in flight
+     *****************************************************************/
+    void setAsyncReader(io::AsyncFileReader *reader, size_t readAhead)
+    {
+        mAsyncReader = reader;
+        mReadAhead = readAhead;
+    }
+
 private:
 
     /**
@@ -154,23 +242,125 @@ private:
      *****************************************************************/
     void getTileData(unsigned char *buffer, sys::Uint32_T numElementsToRead);
 
+    /**
+     *****************************************************************
+     * Reads the specified number of bytes from the current position
+     * in the input stream, byte swapping them (as they're read) if
+     * the file's byte order differs from the native byte order.
+     * @param buffer
+     *   the buffer to populate with image data
+     * @param numBytes
+     *   the number of bytes to read
+     *****************************************************************/
+    void readData(unsigned char *buffer, sys::Uint32_T numBytes);
+
+    /**
+     *****************************************************************
+     * Queues a read of numBytes at offset into buffer.  Nothing is
+     * read until readQueued() is called.
+     *****************************************************************/
+    void queueRead(sys::Uint64_T offset, unsigned char *buffer,
+                   sys::Uint32_T numBytes);
+
+    /**
+     *****************************************************************
+     * Does the reads queued by queueRead(), asynchronously if there's
+     * an async reader, and byte swaps them if necessary.
+     *****************************************************************/
+    void readQueued();
+
+    /**
+     *****************************************************************
+     * Reads the specified number of elements into the specified
+     * buffer from a compressed image, decoding a row of strips or
+     * tiles at a time.
+     *****************************************************************/
+    void getCompressedData(unsigned char *buffer,
+                           sys::Uint32_T numElementsToRead);
+
+    /**
+     *****************************************************************
+     * Throws if the image's compression isn't supported.
+     *****************************************************************/
+    void checkCompression();
+
+    /**
+     *****************************************************************
+     * Decodes a whole strip or tile from src into decoded, in native
+     * byte order.
+     *****************************************************************/
+    void decodeChunk(const unsigned char *src, size_t srcLen,
+                     std::vector<unsigned char>& decoded);
+
+    /**
+     *****************************************************************
+     * Reads the strip or tile at chunkIndex that's part of the
+     * window and copies its part of the window into buffer.
+     *****************************************************************/
+    void readWindowChunk(size_t chunkIndex, unsigned char *buffer,
+                         sys::Uint32_T startRow, sys::Uint32_T startCol,
+                         sys::Uint32_T numRows, sys::Uint32_T numCols);
+
     //! Contains the IFD for this image.
     tiff::IFD mIFD;
 
-    //! A pointer to the "StripByteCounts" IFDEntry to make reading faster.
-    tiff::IFDEntry *mStripByteCounts;
+    //! The strip or tile offsets, decoded once by process().
+    std::vector<sys::Uint64_T> mChunkOffsets;
+
+    //! The strip or tile byte counts, decoded once by process().
+    std::vector<sys::Uint64_T> mChunkByteCounts;
+
+    //! The tile size, in elements; a strip is a full width tile.
+    sys::Uint32_T mChunkWidth = 0;
+    sys::Uint32_T mChunkLength = 0;
+
+    //! The number of tiles across the image (1 for strips).
+    sys::Uint32_T mChunksAcross = 0;
+
+    //! The image's tiff::Const::CompressionType.
+    unsigned short mCompression = tiff::Const::CompressionType::NO_COMPRESSION;
 
-    //! A pointer to the "StripOffsets" IFDEntry to make reading faster.
-    tiff::IFDEntry *mStripOffsets;
+    //! Decodes strips or tiles; null if the image isn't compressed.
+    std::unique_ptr<tiff::Codec> mCodec;
+
+    //! The image's tiff::Const::PredictorType.
+    unsigned short mPredictor = tiff::Const::PredictorType::NONE;
+
+    //! The size of each sample, and the number of them in an element.
+    size_t mBytesPerSample = 1;
+    size_t mSamplesPerPixel = 1;
+
+    //! See setNumThreads().
+    size_t mNumThreads = 1;
+
+    //! The most recently decoded row of strips or tiles, for getData().
+    std::vector<unsigned char> mBand;
+    sys::Uint32_T mBandIndex = 0;
+    bool mHaveBand = false;
 
     //! Points to the input file stream.
-    io::FileInputStream *mInput;
+    io::SeekableInputStream *mInput;
+
+    //! mInput, if it's a FileInputStream.
+    io::FileInputStream *mFileInput;
+
+    //! mInput, if it's a MMapInputStream.
+    io::MMapInputStream *mMapInput;
+
+    //! Used for image data instead of mInput, if set.
+    io::AsyncFileReader *mAsyncReader = nullptr;
+
+    //! The number of reads to keep in flight on mAsyncReader.
+    size_t mReadAhead = 0;
+
+    //! Reads queued by queueRead().
+    std::vector<io::AsyncFileReader::Request> mQueuedReads;
 
     //! The offset to the next IFD.
-    sys::Uint32_T mNextOffset;
+    sys::Uint64_T mNextOffset;
 
     //! Used to keep track of the current read position in the file.
-    sys::Uint32_T mBytePosition;
+    sys::Uint64_T mBytePosition;
     
     sys::Uint32_T mStripIndex;
 
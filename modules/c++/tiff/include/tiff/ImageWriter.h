@@ -23,10 +23,15 @@
 #ifndef __TIFF_IMAGE_WRITER_H__
 #define __TIFF_IMAGE_WRITER_H__
 
+#include <limits>
+#include <memory>
+#include <vector>
 #include <import/io.h>
 #include <config/Exports.h>
 
 #include "tiff/Common.h"
+#include "tiff/Compression.h"
+#include "tiff/Header.h"
 #include "tiff/IFDEntry.h"
 #include "tiff/IFD.h"
 
@@ -61,9 +66,15 @@ public:
      *   the output stream to write the image to
      * @param ifdOffset
      *   the offset to the beginning of the IFD for this image
+     * @param header
+     *   the file's header, if it's been written.  The image is
+     *   written as BigTIFF if the header is.  If this image would
+     *   take a classic TIFF past 4 GB and nothing follows the header
+     *   yet, the header is rewritten as BigTIFF.
      *****************************************************************/
-    ImageWriter(io::FileOutputStream *output, const sys::Uint32_T ifdOffset) :
-                mOutput(output), mIFDOffset(ifdOffset)
+    ImageWriter(io::FileOutputStream *output, const sys::Uint64_T ifdOffset,
+                tiff::Header *header = nullptr) :
+                mOutput(output), mIFDOffset(ifdOffset), mHeader(header)
     {
     }
 
@@ -74,6 +85,11 @@ public:
      * Writes data from the specified buffer into the stream.  The
      * data in the buffer must be in raster format.
      *
+     * If the IFD's Compression is LZW, PACK_BITS or DEFLATE, data is
+     * buffered until a full row of strips or tiles is in; they're
+     * then compressed (in parallel, see setNumThreads()) and written
+     * one after another.  A Predictor in the IFD is applied first.
+     *
      * @param buffer
      *   the data to write to the output stream
      * @param numElementsToWrite
@@ -111,11 +127,32 @@ public:
      * @return
      *   the position to write the next IFD offset to
      *****************************************************************/
-    sys::Uint32_T getNextIFDOffset() const
+    sys::Uint64_T getNextIFDOffset() const
     {
         return mIFDOffset;
     }
 
+    //! Returns whether the image is written as BigTIFF
+    bool isBigTIFF() const
+    {
+        return mHeader && mHeader->isBigTIFF();
+    }
+
+    /**
+     *****************************************************************
+     * Sets the largest file, in bytes, that this image can leave as
+     * a classic TIFF; past that it's switched to BigTIFF.  The
+     * default is the classic TIFF limit of 4 GB.  A smaller limit is
+     * mostly useful for testing.
+     *
+     * @param size
+     *   the largest classic TIFF file size
+     *****************************************************************/
+    void setMaxClassicSize(sys::Uint64_T size)
+    {
+        mMaxClassicSize = size;
+    }
+
     /**
      *****************************************************************
      * Sets the ideal tile size.  Used if the image is a tiled image.
@@ -132,6 +169,19 @@ public:
         mIdealChunkSize = size;
     }
 
+    /**
+     *****************************************************************
+     * Sets the number of threads used to compress strips or tiles.
+     * Up to this many are buffered and compressed at once.
+     *
+     * @param numThreads
+     *   the number of strips or tiles to compress at once
+     *****************************************************************/
+    void setNumThreads(size_t numThreads)
+    {
+        mNumThreads = numThreads;
+    }
+
     /**
      *****************************************************************
      * Sets the image format to either TILED or STRIPPED.  The 
@@ -169,6 +219,19 @@ public:
     void validate();
 
 private:
+    /**
+     *****************************************************************
+     * Switches the file to BigTIFF if this image would take it past
+     * 4 GB (see setMaxClassicSize()).
+     *
+     * @throw except::Exception if the file is too big for classic
+     *   TIFF and already has data in it
+     *****************************************************************/
+    void checkFileSize();
+
+    //! Returns the width and length of a tile, in elements
+    sys::Uint32_T getTileSize() const;
+
     /**
      *****************************************************************
      * Adds IFD entries to the IFD that indicate that the image 
@@ -207,6 +270,33 @@ private:
     void putTileData(const unsigned char *buffer,
                      sys::Uint32_T numElementsToWrite);
 
+    /**
+     *****************************************************************
+     * Sets up the strip or tile layout for compressed data, once
+     * initStrips() or initTiles() has added the IFD entries.
+     *****************************************************************/
+    void initCompression();
+
+    /**
+     *****************************************************************
+     * Buffers data for a compressed image, compressing and writing
+     * each row of strips or tiles once it's complete.
+     *
+     * @param buffer
+     *   the buffer to write to the file
+     * @param numElementsToWrite
+     *   the number of elements (not bytes) to write to the file
+     *****************************************************************/
+    void putCompressedData(const unsigned char *buffer,
+                           sys::Uint32_T numElementsToWrite);
+
+    /**
+     *****************************************************************
+     * Compresses and writes the strips or tiles in mBand, and starts
+     * the next band.
+     *****************************************************************/
+    void flushBand();
+
     //! The TIFF IFD for this image
     tiff::IFD mIFD;
 
@@ -229,13 +319,16 @@ private:
     io::FileOutputStream *mOutput = nullptr;
 
     //! The position to write the next IFD to
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
+
+    //! The file's header, if known; see isBigTIFF()
+    tiff::Header *mHeader = nullptr;
 
     //! The ideal size of a tile
     sys::Uint32_T mIdealChunkSize = CHUNK_SIZE;
 
     //! Used to determine the position in the image
-    sys::Uint32_T mBytePosition = 0;
+    sys::Uint64_T mBytePosition = 0;
 
     //! The image's element size.  Stored here to prevent frequent IFD access
     unsigned short mElementSize = 0;
@@ -245,6 +338,40 @@ private:
 
     //! The format of the file, either TILED or STRIPPED
     ImageFormat mFormat = STRIPPED;
+
+    //! Compresses strips or tiles; null if the image isn't compressed
+    std::unique_ptr<tiff::Codec> mCodec;
+
+    //! The image's tiff::Const::PredictorType
+    unsigned short mPredictor = tiff::Const::PredictorType::NONE;
+
+    //! The size of each sample, and the number of them in an element
+    size_t mBytesPerSample = 1;
+    size_t mSamplesPerPixel = 1;
+
+    //! See setNumThreads()
+    size_t mNumThreads = 1;
+
+    //! See setMaxClassicSize()
+    sys::Uint64_T mMaxClassicSize = std::numeric_limits<sys::Uint32_T>::max();
+
+    //! The strip or tile size, in elements; a strip is a full width tile
+    sys::Uint32_T mChunkWidth = 0;
+    sys::Uint32_T mChunkLength = 0;
+
+    //! The number of tiles across the image (1 for strips)
+    sys::Uint32_T mChunksAcross = 0;
+
+    //! The strip or tile offsets and byte counts, filled in as written
+    tiff::IFDEntry *mChunkOffsets = nullptr;
+    tiff::IFDEntry *mChunkByteCounts = nullptr;
+
+    //! Where the next compressed strip or tile goes
+    sys::Uint64_T mNextChunkOffset = 0;
+
+    //! Rows of raster data waiting to be compressed, starting at mBandTop
+    std::vector<unsigned char> mBand;
+    sys::Uint32_T mBandTop = 0;
 };
 
 } // End namespace.
@@ -77,6 +77,7 @@ struct CODA_OSS_API KnownTags final
     static constexpr auto SAMPLES_PER_PIXEL = "SamplesPerPixel";
     static constexpr auto PHOTOMETRIC_INTERPRETATION = "PhotometricInterpretation";
     static constexpr auto SAMPLE_FORMAT = "SampleFormat";
+    static constexpr auto PREDICTOR = "Predictor";
 
     /**
      *****************************************************************
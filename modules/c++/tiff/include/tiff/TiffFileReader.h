@@ -23,6 +23,7 @@
 #ifndef __TIFF_FILE_READER_H__
 #define __TIFF_FILE_READER_H__
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,23 @@ struct CODA_OSS_API FileReader
         openFile(fileName);
     }
 
+    /**
+     *****************************************************************
+     * Constructor.  Opens and parses the specified file as a TIFF
+     * file, memory mapping it if requested.
+     *
+     * @param fileName
+     *   the file to open and parse as a TIFF file
+     * @param memoryMap
+     *   whether to read through an io::MMapInputStream
+     * @param mapFlags
+     *   flags for io::MMapInputStream::open()
+     *****************************************************************/
+    FileReader(const std::string& fileName, bool memoryMap, int mapFlags = 0)
+    {
+        openFile(fileName, memoryMap, mapFlags);
+    }
+
     //! Destructor
     ~FileReader()
     {
@@ -74,7 +92,19 @@ struct CODA_OSS_API FileReader
      * Processes the TIFF file.  Reads the TIFF header, and every
      * IFD the file has, creating a new ImageReader for each.
      *****************************************************************/
-    void openFile(const std::string& fileName);
+    void openFile(const std::string& fileName)
+    {
+        openFile(fileName, false);
+    }
+
+    /**
+     *****************************************************************
+     * Processes the TIFF file, as above.  If memoryMap is set, the
+     * file is memory mapped and image data is read straight out of
+     * the mapping.
+     *****************************************************************/
+    void openFile(const std::string& fileName, bool memoryMap,
+                  int mapFlags = 0);
 
     //! Closes the TIFF file and clears out member data.
     void close();
@@ -128,11 +158,26 @@ struct CODA_OSS_API FileReader
         return static_cast <sys::Uint32_T>(mImages.size());
     }
 
+    /**
+     *****************************************************************
+     * Reads image data asynchronously (see io::AsyncFileReader),
+     * keeping up to readAhead strip or tile row reads in flight.
+     * This helps most with tiled images, which are read a tile row
+     * at a time.  May be called before or after openFile().
+     *
+     * @param readAhead
+     *   the number of reads to keep in flight; 0 (the default)
+     *   reads synchronously
+     *****************************************************************/
+    void setReadAhead(size_t readAhead);
+
     
 private:
 
     //! The input stream to use to read the TIFF file
     io::FileInputStream mInput;
+    //! Used instead of mInput when the file is memory mapped
+    io::MMapInputStream mMapInput;
 
     //! The TIFF file header
     tiff::Header mHeader;
@@ -142,6 +187,13 @@ private:
 
     //! Whether to reverse bytes while reading.
     bool mReverseBytes = false;
+    //! The open file, for the async reader
+    std::string mFileName;
+    //! See setReadAhead()
+    size_t mReadAhead = 0;
+    std::unique_ptr<io::AsyncFileReader> mAsyncReader;
+
+    void openAsyncReader();
     
 };
 
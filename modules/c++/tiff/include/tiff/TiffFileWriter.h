@@ -114,15 +114,36 @@ struct CODA_OSS_API FileWriter
      *****************************************************************
      * Writes the TIFF header to the file.  There is only one header
      * in a TIFF file regardless of how many images are in it.
+     *
+     * The file is a classic TIFF unless setBigTIFF() says otherwise;
+     * if the first image turns out to be too large for 32-bit
+     * offsets, it's switched to BigTIFF automatically.
      *****************************************************************/
     void writeHeader();
 
+    /**
+     *****************************************************************
+     * Writes a BigTIFF (64-bit offsets) rather than a classic TIFF.
+     * Must be called before writeHeader().  This is only needed if
+     * images after the first will take the file past 4 GB.
+     *
+     * @param bigTIFF
+     *   whether to write a BigTIFF file
+     *****************************************************************/
+    void setBigTIFF(bool bigTIFF);
+
+    //! Returns whether the file is (so far) a BigTIFF
+    bool isBigTIFF() const
+    {
+        return mHeader.isBigTIFF();
+    }
+
     FileWriter(const FileWriter&) = delete;
     FileWriter& operator=(const FileWriter&) = delete;
 
 private:
     //! The position to write the offset to the first IFD to
-    sys::Uint32_T mIFDOffset;
+    sys::Uint64_T mIFDOffset;
 
     //! The output stream
     io::FileOutputStream mOutput;
@@ -159,10 +180,13 @@ enum { AUTO = -1 };
  *         defaults to automatically guessing based on the input data size
  *  \param es The element size, which can be any size, but defaults to automatically
  *         guessing based on the input data size
+ *  \param compression Any tiff::Const::CompressionType that tiff::createCodec()
+ *         supports, or NO_COMPRESSION (the default)
  *
  */
 template<typename T> void writeTIFF(const T* image, size_t rows, size_t cols,
-                                    std::string imageFile, unsigned short et = AUTO, int es = AUTO)
+                                    std::string imageFile, unsigned short et = AUTO, int es = AUTO,
+                                    unsigned short compression = ::tiff::Const::CompressionType::NO_COMPRESSION)
 {
 
     if (es == AUTO)
@@ -220,8 +244,7 @@ template<typename T> void writeTIFF(const T* image, size_t rows, size_t cols,
     ifd->addEntry(::tiff::KnownTags::IMAGE_WIDTH, cols);
     ifd->addEntry(::tiff::KnownTags::IMAGE_LENGTH, rows);
        
-    ifd->addEntry(::tiff::KnownTags::COMPRESSION,
-                  (unsigned short) ::tiff::Const::CompressionType::NO_COMPRESSION);
+    ifd->addEntry(::tiff::KnownTags::COMPRESSION, compression);
 
     
     ifd->addEntry(::tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, photoInterp);
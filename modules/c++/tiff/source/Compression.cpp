@@ -0,0 +1,555 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tiff/Compression.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <import/except.h>
+#include <import/str.h>
+#include <sys/Conf.h>
+
+#include "tiff/Common.h"
+
+#if !defined(TIFF_HAVE_ZLIB)
+#include "tiff/tiff_config.h"
+#endif
+#if TIFF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+
+/*
+ * PackBits: runs of a repeated byte and literal sequences, each with a
+ * signed count byte.  Runs don't cross rows.
+ */
+class PackBitsCodec final : public tiff::Codec
+{
+public:
+    void encode(const unsigned char *src, size_t numRows, size_t rowBytes,
+                std::vector<unsigned char>& dest) const override
+    {
+        dest.clear();
+        dest.reserve(numRows * (rowBytes + (rowBytes + 127) / 128));
+        for (size_t row = 0; row < numRows; ++row, src += rowBytes)
+        {
+            size_t ii = 0;
+            while (ii < rowBytes)
+            {
+                size_t run = 1;
+                while (ii + run < rowBytes && run < 128 &&
+                       src[ii + run] == src[ii])
+                    ++run;
+
+                if (run > 1)
+                {
+                    dest.push_back(static_cast<unsigned char>(1 - static_cast<int>(run)));
+                    dest.push_back(src[ii]);
+                    ii += run;
+                    continue;
+                }
+
+                // A literal, up to the start of the next run
+                const size_t start = ii++;
+                while (ii < rowBytes && ii - start < 128 &&
+                       !(ii + 1 < rowBytes && src[ii] == src[ii + 1]))
+                    ++ii;
+                dest.push_back(static_cast<unsigned char>(ii - start - 1));
+                dest.insert(dest.end(), src + start, src + ii);
+            }
+        }
+    }
+
+    void decode(const unsigned char *src, size_t srcLen,
+                unsigned char *dest, size_t destLen) const override
+    {
+        const unsigned char* const srcEnd = src + srcLen;
+        size_t out = 0;
+        while (src < srcEnd && out < destLen)
+        {
+            const int n = static_cast<signed char>(*src++);
+            if (n >= 0)
+            {
+                const size_t literal = std::min<size_t>(n + 1, srcEnd - src);
+                const size_t count = std::min(literal, destLen - out);
+                ::memcpy(dest + out, src, count);
+                src += literal;
+                out += count;
+            }
+            else if (n != -128 && src < srcEnd)
+            {
+                const size_t count = std::min<size_t>(1 - n, destLen - out);
+                ::memset(dest + out, *src++, count);
+                out += count;
+            }
+        }
+        ::memset(dest + out, 0, destLen - out);
+    }
+};
+
+/*
+ * LZW as TIFF does it: MSB-first codes of 9 to 12 bits, with the code
+ * width going up one code early.
+ */
+class LZWCodec final : public tiff::Codec
+{
+    static constexpr unsigned CLEAR = 256;
+    static constexpr unsigned EOI = 257;
+    static constexpr unsigned FIRST = 258;
+    static constexpr unsigned MIN_BITS = 9;
+    static constexpr unsigned MAX_BITS = 12;
+    static constexpr unsigned MAX_CODE = (1u << MAX_BITS) - 1;
+
+    class BitWriter final
+    {
+    public:
+        explicit BitWriter(std::vector<unsigned char>& dest) : mDest(dest)
+        {
+        }
+
+        void put(unsigned code, unsigned numBits)
+        {
+            mBits = (mBits << numBits) | code;
+            mNumBits += numBits;
+            while (mNumBits >= 8)
+            {
+                mNumBits -= 8;
+                mDest.push_back(static_cast<unsigned char>(mBits >> mNumBits));
+            }
+        }
+
+        void flush()
+        {
+            if (mNumBits > 0)
+                mDest.push_back(static_cast<unsigned char>(mBits << (8 - mNumBits)));
+            mNumBits = 0;
+        }
+
+    private:
+        std::vector<unsigned char>& mDest;
+        unsigned long mBits = 0;
+        unsigned mNumBits = 0;
+    };
+
+public:
+    void encode(const unsigned char *src, size_t numRows, size_t rowBytes,
+                std::vector<unsigned char>& dest) const override
+    {
+        const size_t srcLen = numRows * rowBytes;
+        dest.clear();
+        dest.reserve(srcLen / 2 + 16);
+
+        // Open addressed (prefix, byte) -> code table
+        constexpr size_t HASH_SIZE = 9029; // prime, > 2 * 4096
+        std::vector<unsigned> keys(HASH_SIZE);
+        std::vector<unsigned short> codes(HASH_SIZE);
+        const auto clearTable = [&]() { std::fill(keys.begin(), keys.end(), 0u); };
+
+        BitWriter writer(dest);
+        unsigned numBits = MIN_BITS;
+        unsigned next = FIRST;
+        writer.put(CLEAR, numBits);
+        clearTable();
+        if (srcLen == 0)
+        {
+            writer.put(EOI, numBits);
+            writer.flush();
+            return;
+        }
+
+        unsigned prefix = src[0];
+        for (size_t ii = 1; ii < srcLen; ++ii)
+        {
+            const unsigned char c = src[ii];
+            // Keys are offset by one so that zero marks an empty slot
+            const unsigned key = ((prefix << 8) | c) + 1;
+            size_t slot = key % HASH_SIZE;
+            while (keys[slot] != 0 && keys[slot] != key)
+                slot = (slot + 1) % HASH_SIZE;
+            if (keys[slot] == key)
+            {
+                prefix = codes[slot];
+                continue;
+            }
+
+            writer.put(prefix, numBits);
+            if (next == MAX_CODE - 1)
+            {
+                writer.put(CLEAR, numBits);
+                numBits = MIN_BITS;
+                next = FIRST;
+                clearTable();
+            }
+            else
+            {
+                keys[slot] = key;
+                codes[slot] = static_cast<unsigned short>(next++);
+                if (next == (1u << numBits))
+                    ++numBits;
+            }
+            prefix = c;
+        }
+
+        // The decoder adds an entry for the last code before it reads EOI
+        writer.put(prefix, numBits);
+        if (next == MAX_CODE - 1)
+        {
+            writer.put(CLEAR, numBits);
+            numBits = MIN_BITS;
+        }
+        else if (++next == (1u << numBits))
+        {
+            ++numBits;
+        }
+        writer.put(EOI, numBits);
+        writer.flush();
+    }
+
+    void decode(const unsigned char *src, size_t srcLen,
+                unsigned char *dest, size_t destLen) const override
+    {
+        // Every string in the table has already been written to dest, so
+        // an entry is just where its first copy is.
+        struct Entry final
+        {
+            size_t offset;
+            size_t length;
+        };
+        std::vector<Entry> table(MAX_CODE + 1);
+
+        size_t bitPos = 0;
+        const size_t totalBits = srcLen * 8;
+        unsigned numBits = MIN_BITS;
+        unsigned next = FIRST;
+        bool havePrev = false;
+        Entry prev{0, 0};
+        size_t out = 0;
+
+        while (out < destLen && bitPos + numBits <= totalBits)
+        {
+            unsigned code = 0;
+            for (unsigned bit = 0; bit < numBits; ++bit, ++bitPos)
+                code = (code << 1) | ((src[bitPos >> 3] >> (7 - (bitPos & 7))) & 1);
+
+            if (code == EOI)
+                break;
+            if (code == CLEAR)
+            {
+                numBits = MIN_BITS;
+                next = FIRST;
+                havePrev = false;
+                continue;
+            }
+
+            Entry entry{out, 1};
+            if (code < CLEAR)
+            {
+                dest[out] = static_cast<unsigned char>(code);
+            }
+            else if (code < next && havePrev)
+            {
+                entry.length = table[code].length;
+                const size_t count = std::min(entry.length, destLen - out);
+                ::memmove(dest + out, dest + table[code].offset, count);
+            }
+            else if (code == next && havePrev)
+            {
+                // The string being defined: the previous one plus its own
+                // first byte
+                entry.length = prev.length + 1;
+                const size_t count = std::min(prev.length, destLen - out);
+                ::memmove(dest + out, dest + prev.offset, count);
+                if (out + prev.length < destLen)
+                    dest[out + prev.length] = dest[prev.offset];
+            }
+            else
+            {
+                throw except::Exception(Ctxt(
+                        str::Format("Corrupt LZW data: unexpected code %d", code)));
+            }
+
+            if (havePrev && next <= MAX_CODE)
+            {
+                table[next].offset = prev.offset;
+                table[next].length = prev.length + 1;
+                if (++next == (1u << numBits) - 1 && numBits < MAX_BITS)
+                    ++numBits;
+            }
+            prev = entry;
+            havePrev = true;
+            out += std::min(entry.length, destLen - out);
+        }
+        ::memset(dest + out, 0, destLen - out);
+    }
+};
+
+#if TIFF_HAVE_ZLIB
+class DeflateCodec final : public tiff::Codec
+{
+public:
+    void encode(const unsigned char *src, size_t numRows, size_t rowBytes,
+                std::vector<unsigned char>& dest) const override
+    {
+        const size_t srcLen = numRows * rowBytes;
+        if (srcLen > std::numeric_limits<uLong>::max())
+            throw except::Exception(Ctxt("Strip or tile is too large to compress"));
+
+        uLongf destLen = compressBound(static_cast<uLong>(srcLen));
+        dest.resize(destLen);
+        const int status = compress2(dest.data(), &destLen, src,
+                                     static_cast<uLong>(srcLen),
+                                     Z_DEFAULT_COMPRESSION);
+        if (status != Z_OK)
+            throw except::Exception(Ctxt(str::Format("zlib compress2 failed: %d", status)));
+        dest.resize(destLen);
+    }
+
+    void decode(const unsigned char *src, size_t srcLen,
+                unsigned char *dest, size_t destLen) const override
+    {
+        if (srcLen > std::numeric_limits<uInt>::max() ||
+            destLen > std::numeric_limits<uInt>::max())
+            throw except::Exception(Ctxt("Strip or tile is too large to decompress"));
+        // zlib rejects a null output buffer, even an empty one
+        if (destLen == 0)
+            return;
+
+        z_stream stream;
+        ::memset(&stream, 0, sizeof(stream));
+        if (inflateInit(&stream) != Z_OK)
+            throw except::Exception(Ctxt("zlib inflateInit failed"));
+
+        stream.next_in = const_cast<Bytef*>(src);
+        stream.avail_in = static_cast<uInt>(srcLen);
+        stream.next_out = dest;
+        stream.avail_out = static_cast<uInt>(destLen);
+        const int status = inflate(&stream, Z_FINISH);
+        const size_t out = destLen - stream.avail_out;
+        inflateEnd(&stream);
+
+        // Z_BUF_ERROR just means it didn't all fit, or the data was short
+        if (status != Z_STREAM_END && status != Z_BUF_ERROR && status != Z_OK)
+            throw except::Exception(Ctxt(str::Format("Corrupt Deflate data: %d", status)));
+        ::memset(dest + out, 0, destLen - out);
+    }
+};
+#endif
+
+template <typename T>
+void horizontalDifference(unsigned char *row, size_t numSamples, size_t stride)
+{
+    for (size_t ii = numSamples; ii-- > stride;)
+    {
+        T value, previous;
+        ::memcpy(&value, row + ii * sizeof(T), sizeof(T));
+        ::memcpy(&previous, row + (ii - stride) * sizeof(T), sizeof(T));
+        value = static_cast<T>(value - previous);
+        ::memcpy(row + ii * sizeof(T), &value, sizeof(T));
+    }
+}
+
+template <typename T>
+void horizontalAccumulate(unsigned char *row, size_t numSamples, size_t stride)
+{
+    for (size_t ii = stride; ii < numSamples; ++ii)
+    {
+        T value, previous;
+        ::memcpy(&value, row + ii * sizeof(T), sizeof(T));
+        ::memcpy(&previous, row + (ii - stride) * sizeof(T), sizeof(T));
+        value = static_cast<T>(value + previous);
+        ::memcpy(row + ii * sizeof(T), &value, sizeof(T));
+    }
+}
+
+template <typename T>
+void horizontal(bool apply, unsigned char *data, size_t numRows,
+                size_t rowBytes, size_t samplesPerPixel)
+{
+    for (size_t row = 0; row < numRows; ++row, data += rowBytes)
+    {
+        if (apply)
+            horizontalDifference<T>(data, rowBytes / sizeof(T), samplesPerPixel);
+        else
+            horizontalAccumulate<T>(data, rowBytes / sizeof(T), samplesPerPixel);
+    }
+}
+
+void horizontalPredictor(bool apply, unsigned char *data, size_t numRows,
+                         size_t rowBytes, size_t bytesPerSample,
+                         size_t samplesPerPixel)
+{
+    switch (bytesPerSample)
+    {
+    case 1:
+        horizontal<uint8_t>(apply, data, numRows, rowBytes, samplesPerPixel);
+        break;
+    case 2:
+        horizontal<uint16_t>(apply, data, numRows, rowBytes, samplesPerPixel);
+        break;
+    case 4:
+        horizontal<uint32_t>(apply, data, numRows, rowBytes, samplesPerPixel);
+        break;
+    case 8:
+        horizontal<uint64_t>(apply, data, numRows, rowBytes, samplesPerPixel);
+        break;
+    default:
+        throw except::NotImplementedException(Ctxt(str::Format(
+                "Horizontal predictor doesn't support %d byte samples",
+                static_cast<int>(bytesPerSample))));
+    }
+}
+
+/*
+ * The floating point predictor splits each row into byte planes, most
+ * significant first, and differences the bytes.
+ */
+void floatingPointPredictor(bool apply, unsigned char *data, size_t numRows,
+                            size_t rowBytes, size_t bytesPerSample,
+                            size_t samplesPerPixel)
+{
+    const size_t numSamples = rowBytes / bytesPerSample;
+    const bool bigEndian = sys::isBigEndianSystem();
+    std::vector<unsigned char> planes(rowBytes);
+    for (size_t row = 0; row < numRows; ++row, data += rowBytes)
+    {
+        if (apply)
+        {
+            for (size_t ii = 0; ii < numSamples; ++ii)
+                for (size_t byte = 0; byte < bytesPerSample; ++byte)
+                {
+                    const size_t plane = bigEndian ? byte : bytesPerSample - byte - 1;
+                    planes[plane * numSamples + ii] = data[ii * bytesPerSample + byte];
+                }
+            horizontalDifference<uint8_t>(planes.data(), rowBytes, samplesPerPixel);
+            ::memcpy(data, planes.data(), rowBytes);
+        }
+        else
+        {
+            horizontalAccumulate<uint8_t>(data, rowBytes, samplesPerPixel);
+            ::memcpy(planes.data(), data, rowBytes);
+            for (size_t ii = 0; ii < numSamples; ++ii)
+                for (size_t byte = 0; byte < bytesPerSample; ++byte)
+                {
+                    const size_t plane = bigEndian ? byte : bytesPerSample - byte - 1;
+                    data[ii * bytesPerSample + byte] = planes[plane * numSamples + ii];
+                }
+        }
+    }
+}
+
+void runPredictor(bool apply, unsigned short predictor, unsigned char *data,
+                  size_t numRows, size_t rowBytes, size_t bytesPerSample,
+                  size_t samplesPerPixel)
+{
+    if (samplesPerPixel == 0 || bytesPerSample == 0)
+        throw except::InvalidArgumentException(Ctxt("Invalid sample size"));
+
+    switch (predictor)
+    {
+    case tiff::Const::PredictorType::NONE:
+        break;
+    case tiff::Const::PredictorType::HORIZONTAL:
+        horizontalPredictor(apply, data, numRows, rowBytes, bytesPerSample,
+                            samplesPerPixel);
+        break;
+    case tiff::Const::PredictorType::FLOATING_POINT:
+        floatingPointPredictor(apply, data, numRows, rowBytes, bytesPerSample,
+                               samplesPerPixel);
+        break;
+    default:
+        throw except::NotImplementedException(Ctxt(
+                str::Format("Unsupported predictor: %d", predictor)));
+    }
+}
+}
+
+bool tiff::isCodecSupported(unsigned short compression)
+{
+    switch (compression)
+    {
+    case tiff::Const::CompressionType::LZW:
+    case tiff::Const::CompressionType::PACK_BITS:
+        return true;
+#if TIFF_HAVE_ZLIB
+    case tiff::Const::CompressionType::DEFLATE:
+    case tiff::Const::CompressionType::PKZIP_DEFLATE:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool tiff::usesPredictor(unsigned short compression)
+{
+    // PackBits works on runs of raw bytes; like libtiff, ignore the tag
+    switch (compression)
+    {
+    case tiff::Const::CompressionType::LZW:
+    case tiff::Const::CompressionType::DEFLATE:
+    case tiff::Const::CompressionType::PKZIP_DEFLATE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::unique_ptr<tiff::Codec> tiff::createCodec(unsigned short compression)
+{
+    switch (compression)
+    {
+    case tiff::Const::CompressionType::LZW:
+        return std::unique_ptr<tiff::Codec>(new LZWCodec());
+    case tiff::Const::CompressionType::PACK_BITS:
+        return std::unique_ptr<tiff::Codec>(new PackBitsCodec());
+#if TIFF_HAVE_ZLIB
+    case tiff::Const::CompressionType::DEFLATE:
+    case tiff::Const::CompressionType::PKZIP_DEFLATE:
+        return std::unique_ptr<tiff::Codec>(new DeflateCodec());
+#endif
+    default:
+        throw except::NotImplementedException(Ctxt(
+                str::Format("Unsupported compression type: %d", compression)));
+    }
+}
+
+void tiff::applyPredictor(unsigned short predictor, unsigned char *data,
+                          size_t numRows, size_t rowBytes,
+                          size_t bytesPerSample, size_t samplesPerPixel)
+{
+    runPredictor(true, predictor, data, numRows, rowBytes, bytesPerSample,
+                 samplesPerPixel);
+}
+
+void tiff::removePredictor(unsigned short predictor, unsigned char *data,
+                           size_t numRows, size_t rowBytes,
+                           size_t bytesPerSample, size_t samplesPerPixel)
+{
+    runPredictor(false, predictor, data, numRows, rowBytes, bytesPerSample,
+                 samplesPerPixel);
+}
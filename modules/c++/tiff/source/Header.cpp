@@ -23,28 +23,68 @@
 #include "tiff/Header.h"
 #include <sstream>
 #include <import/io.h>
+#include <import/except.h>
+
+#include "gsl/gsl.h"
 
 // INCOMPLETE
 void tiff::Header::serialize(io::OutputStream& output)
 {
     output.write((sys::byte *)&mByteOrder, sizeof(mByteOrder));
     output.write((sys::byte *)&mId, sizeof(mId));
-    output.write((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+    if (isBigTIFF())
+    {
+        // The offset size, then a reserved field that's always zero
+        const unsigned short offsetSize = getOffsetSize();
+        const unsigned short reserved = 0;
+        output.write((sys::byte *)&offsetSize, sizeof(offsetSize));
+        output.write((sys::byte *)&reserved, sizeof(reserved));
+        output.write((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+    }
+    else
+    {
+        const auto ifdOffset = gsl::narrow<sys::Uint32_T>(mIFDOffset);
+        output.write((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+    }
 }
 
 void tiff::Header::deserialize(io::InputStream& input)
 {
     input.read((sys::byte *)&mByteOrder, sizeof(mByteOrder));
     input.read((sys::byte *)&mId, sizeof(mId));
-    input.read((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
     
     mDifferentByteOrdering = sys::isBigEndianSystem() ? \
             getByteOrder() != tiff::Header::MM : getByteOrder() != tiff::Header::II;
     
     if (mDifferentByteOrdering)
-    {
         mId = sys::byteSwap(mId);
-        mIFDOffset = sys::byteSwap(mIFDOffset);
+
+    if (mId == BIG_TIFF)
+    {
+        unsigned short offsetSize = 0;
+        unsigned short reserved = 0;
+        input.read((sys::byte *)&offsetSize, sizeof(offsetSize));
+        input.read((sys::byte *)&reserved, sizeof(reserved));
+        input.read((sys::byte *)&mIFDOffset, sizeof(mIFDOffset));
+        if (mDifferentByteOrdering)
+        {
+            offsetSize = sys::byteSwap(offsetSize);
+            mIFDOffset = sys::byteSwap(mIFDOffset);
+        }
+        if (offsetSize != 8)
+            throw except::Exception(Ctxt(str::Format("Unsupported BigTIFF offset size: %d", offsetSize)));
+    }
+    else if (mId == CLASSIC)
+    {
+        sys::Uint32_T ifdOffset = 0;
+        input.read((sys::byte *)&ifdOffset, sizeof(ifdOffset));
+        if (mDifferentByteOrdering)
+            ifdOffset = sys::byteSwap(ifdOffset);
+        mIFDOffset = ifdOffset;
+    }
+    else
+    {
+        throw except::Exception(Ctxt(str::Format("Not a TIFF file; unknown version: %d", mId)));
     }
 }
 
@@ -27,11 +27,14 @@
 #include "tiff/IFDEntry.h"
 #include "tiff/KnownTags.h"
 
+#include <memory>
 #include <string>
 #include <sstream>
 #include <import/io.h>
 #include <import/except.h>
 
+#include "gsl/gsl.h"
+
 tiff::IFDEntry *tiff::IFD::operator[](const char *name)
 {
     tiff::IFDEntry *mapEntry = tiff::KnownTagsRegistry::getInstance()[name];
@@ -103,22 +106,43 @@ void tiff::IFD::deserialize(io::InputStream& input)
     deserialize(input, false);
 }
 
-void tiff::IFD::deserialize(io::InputStream& input, const bool reverseBytes)
+void tiff::IFD::deserialize(io::InputStream& input, const bool reverseBytes,
+                            const bool bigTIFF)
 {
-    unsigned short ifdEntryCount;
-    input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
-    if (reverseBytes)
-        ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    sys::Uint64_T ifdEntryCount = 0;
+    if (bigTIFF)
+    {
+        input.read((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+        if (reverseBytes)
+            ifdEntryCount = sys::byteSwap(ifdEntryCount);
+    }
+    else
+    {
+        unsigned short count = 0;
+        input.read((sys::byte *)&count, sizeof(count));
+        if (reverseBytes)
+            count = sys::byteSwap(count);
+        ifdEntryCount = count;
+    }
 
-    for (unsigned short i = 0; i < ifdEntryCount; i++)
+    for (sys::Uint64_T i = 0; i < ifdEntryCount; i++)
     {
-        tiff::IFDEntry *entry = new tiff::IFDEntry();
-        entry->deserialize(input, reverseBytes);
-        mIFD[entry->getTagID()] = entry;
+        std::unique_ptr<tiff::IFDEntry> entry(new tiff::IFDEntry());
+        entry->deserialize(input, reverseBytes, bigTIFF);
+
+        // Don't leak an entry that's repeated
+        const auto tag = entry->getTagID();
+        delete mIFD[tag];
+        mIFD[tag] = entry.release();
     }
 }
 
 void tiff::IFD::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFD::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -128,26 +152,35 @@ void tiff::IFD::serialize(io::OutputStream& output)
     // Makes sure all data offsets are defined for each entry.
     // Keep the offset just past the end of the IFD.  This offset
     // is where the next potential image could be written.
-    const auto endOffset = finalize(static_cast<sys::Uint32_T>(seekable->tell()));
+    const auto endOffset = finalize(seekable->tell(), bigTIFF);
 
     // Write out IFD entry count.
-    const auto ifdEntryCount = static_cast<uint16_t>(mIFD.size());
-    output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    if (bigTIFF)
+    {
+        const sys::Uint64_T ifdEntryCount = mIFD.size();
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
+    else
+    {
+        const auto ifdEntryCount = gsl::narrow<uint16_t>(mIFD.size());
+        output.write((sys::byte *)&ifdEntryCount, sizeof(ifdEntryCount));
+    }
 
     // Write out each IFD entry.
     for (IFDType::const_iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         tiff::IFDEntry *entry = i->second;
-        entry->serialize(output);
+        entry->serialize(output, bigTIFF);
     }
 
     // Remember the current position in case there is another IFD after
     // this one.
-    mNextIFDOffsetPosition = static_cast<sys::Uint32_T>(seekable->tell());
+    mNextIFDOffsetPosition = seekable->tell();
 
     // Write out the default next IFD location.
-    sys::Uint32_T nextOffset = 0;
-    output.write((sys::byte *)&nextOffset, sizeof(sys::Uint32_T));
+    const sys::Uint64_T nextOffset = 0;
+    output.write((sys::byte *)&nextOffset,
+                 bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T));
 
     // Seek the end of the IFD, the next image can begin here.
     seekable->seek(endOffset, io::Seekable::START);
@@ -192,11 +225,11 @@ sys::Uint32_T tiff::IFD::getImageLength() const
     return *(tiff::GenericType<unsigned short> *)(*imageLength)[0];
 }
 
-sys::Uint32_T tiff::IFD::getImageSize() const
+sys::Uint64_T tiff::IFD::getImageSize() const
 {
-    sys::Uint32_T width = getImageWidth();
-    sys::Uint32_T length = getImageLength();
-    unsigned short elementSize = getElementSize();
+    const sys::Uint64_T width = getImageWidth();
+    const sys::Uint64_T length = getImageLength();
+    const unsigned short elementSize = getElementSize();
 
     return width * length * elementSize;
 }
@@ -225,21 +258,23 @@ unsigned short tiff::IFD::getElementSize() const
     return static_cast<unsigned short>(bytesPerSample * getNumBands());
 }
 
-sys::Uint32_T tiff::IFD::finalize(const sys::Uint32_T offset)
+sys::Uint64_T tiff::IFD::finalize(const sys::Uint64_T offset, const bool bigTIFF)
 {
     // Find the beginning offset to extra IFD data.  The IFD length is
     // the size of an IFD entry multiplied by the number of entries, plus
     // 4 bytes to hold the offset to the next IFD, and 2 bytes to hold the
-    // IFD entry count.
-    auto dataOffset = static_cast<sys::Uint32_T>(offset + sizeof(short) + (mIFD.size()
-            * tiff::IFDEntry::sizeOf()) + sizeof(sys::Uint32_T));
+    // IFD entry count (8 and 8 for BigTIFF).
+    const size_t countSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(short);
+    const size_t offsetSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    auto dataOffset = offset + countSize + (mIFD.size()
+            * tiff::IFDEntry::sizeOf(bigTIFF)) + offsetSize;
 
     for (IFDType::iterator i = mIFD.begin(); i != mIFD.end(); ++i)
     {
         // Send in the current offset.  If the value size of the IFD entry
         // requires that data be placed outside the IFD entry, the offset that
         // is returned will be adjusted to compensate for that data.
-        dataOffset = i->second->finalize(dataOffset);
+        dataOffset = i->second->finalize(dataOffset, bigTIFF);
     }
 
     return dataOffset;
@@ -22,7 +22,9 @@
 
 #include <string>
 #include <string.h>
+#include <limits>
 #include <sstream>
+#include <vector>
 #include <import/io.h>
 #include <import/except.h>
 #include <import/mem.h>
@@ -33,8 +35,32 @@
 #include "tiff/TypeFactory.h"
 #include "tiff/IFDEntry.h"
 
+#include "gsl/gsl.h"
+
+
+namespace
+{
+// Byte swaps count values of the specified type in place.  Rationals
+// are a pair of 4-byte values.
+void swapValues(sys::byte *buffer, unsigned short type, sys::Uint64_T count)
+{
+    auto elementSize = tiff::Const::sizeOf(type);
+    if ((type == tiff::Const::Type::RATIONAL) || (type == tiff::Const::Type::SRATIONAL))
+    {
+        elementSize /= 2;
+        count *= 2;
+    }
+    if (elementSize > 1)
+        sys::byteSwap(buffer, elementSize, static_cast<size_t>(count));
+}
+}
 
 void tiff::IFDEntry::serialize(io::OutputStream& output)
+{
+    serialize(output, false);
+}
+
+void tiff::IFDEntry::serialize(io::OutputStream& output, const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable *>(&output);
@@ -43,11 +69,21 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
 
     output.write((sys::byte *)&mTag, sizeof(mTag));
     output.write((sys::byte *)&mType, sizeof(mType));
-    output.write((sys::byte *)&mCount, sizeof(mCount));
+    if (bigTIFF)
+    {
+        const sys::Uint64_T count = mCount;
+        output.write((sys::byte *)&count, sizeof(count));
+    }
+    else
+    {
+        output.write((sys::byte *)&mCount, sizeof(mCount));
+    }
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
+    // The value (or the offset to it) takes up the rest of the entry
+    const size_t fieldSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    const sys::Uint64_T size = static_cast<sys::Uint64_T>(mCount) * tiff::Const::sizeOf(mType);
 
-    if (size > 4)
+    if (size > fieldSize)
     {
         // Keep the current position and jump to the write position.
         const auto current = seekable->tell();
@@ -62,20 +98,27 @@ void tiff::IFDEntry::serialize(io::OutputStream& output)
         seekable->seek(current, io::Seekable::START);
 
         // Write out the data offset.
-        output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        if (bigTIFF)
+        {
+            output.write((sys::byte *)&mOffset, sizeof(mOffset));
+        }
+        else
+        {
+            const auto offset = gsl::narrow<sys::Uint32_T>(mOffset);
+            output.write((sys::byte *)&offset, sizeof(offset));
+        }
     }
     else
     {
+        // The values are left justified in the field
+        sys::byte field[sizeof(sys::Uint64_T)] = {};
+        size_t fieldOffset = 0;
         for (sys::Uint32_T i = 0; i < mCount; ++i)
         {
-            // The value must take up four bytes.  If the number of bytes is
-            // less than four, duplicate the value until you hit 4 bytes in length.
-            const auto iterations = (4 / mCount) / mValues[i]->size();
-
-            for (size_t j = 0; j < iterations; ++j)
-                output.write((sys::byte *)mValues[i]->data(),
-                        mValues[i]->size());
+            ::memcpy(field + fieldOffset, mValues[i]->data(), mValues[i]->size());
+            fieldOffset += mValues[i]->size();
         }
+        output.write(field, fieldSize);
     }
 }
 
@@ -84,7 +127,8 @@ void tiff::IFDEntry::deserialize(io::InputStream& input)
     deserialize(input, false);
 }
 
-void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes)
+void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes,
+                                 const bool bigTIFF)
 {
     io::Seekable *seekable =
             dynamic_cast<io::Seekable*>(&input);
@@ -93,58 +137,77 @@ void tiff::IFDEntry::deserialize(io::InputStream& input, const bool reverseBytes
 
     input.read((char *)&mTag, sizeof(mTag));
     input.read((char *)&mType, sizeof(mType));
-    input.read((char *)&mCount, sizeof(mCount));
-    input.read((char *)&mOffset, sizeof(mOffset));
+
+    sys::Uint64_T count = 0;
+    if (bigTIFF)
+    {
+        input.read((char *)&count, sizeof(count));
+        if (reverseBytes)
+            count = sys::byteSwap(count);
+    }
+    else
+    {
+        sys::Uint32_T count32 = 0;
+        input.read((char *)&count32, sizeof(count32));
+        if (reverseBytes)
+            count32 = sys::byteSwap(count32);
+        count = count32;
+    }
+
+    // The value (or the offset to it) takes up the rest of the entry
+    const size_t fieldSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    sys::byte field[sizeof(sys::Uint64_T)] = {};
+    input.read(field, fieldSize);
 
     if (reverseBytes)
     {
         mTag = sys::byteSwap(mTag);
         mType =  sys::byteSwap(mType);
-        mCount = sys::byteSwap(mCount);
-        mOffset = sys::byteSwap(mOffset);
     }
+    if (count > std::numeric_limits<sys::Uint32_T>::max())
+        throw except::Exception(Ctxt(str::Format("Too many values in IFD entry %d", mTag)));
+    mCount = static_cast<sys::Uint32_T>(count);
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
+    const sys::Uint64_T size = count * tiff::Const::sizeOf(mType);
 
-    if (size > 4)
+    if (size > fieldSize)
     {
+        if (bigTIFF)
+        {
+            ::memcpy(&mOffset, field, sizeof(mOffset));
+            if (reverseBytes)
+                mOffset = sys::byteSwap(mOffset);
+        }
+        else
+        {
+            sys::Uint32_T offset = 0;
+            ::memcpy(&offset, field, sizeof(offset));
+            if (reverseBytes)
+                offset = sys::byteSwap(offset);
+            mOffset = offset;
+        }
+
         // Keep the current position and jump to the read position.
         const auto current = seekable->tell();
         seekable->seek(mOffset, io::Seekable::START);
 
         // Read in the value(s);
-        sys::byte *buffer = new sys::byte[size];
-
-        input.read(buffer, size);
+        std::vector<sys::byte> buffer(static_cast<size_t>(size));
+        input.read(buffer.data(), buffer.size());
         if (reverseBytes)
-        {
-            auto elementSize = tiff::Const::sizeOf(mType);
-            sys::Uint32_T numElements = mCount;
-            if ((mType == tiff::Const::Type::RATIONAL) || (mType == tiff::Const::Type::SRATIONAL))
-            {
-                elementSize = tiff::Const::sizeOf(mType) / 2;
-                numElements = mCount * 2;
-            }
-            if (elementSize > 1)
-                sys::byteSwap(buffer, elementSize, numElements);
-        }
+            swapValues(buffer.data(), mType, mCount);
 
-        parseValues((const unsigned char *)buffer);
-        delete[] buffer;
+        parseValues((const unsigned char *)buffer.data());
 
         // Reset the cursor position.
         seekable->seek(current, io::Seekable::START);
     }
     else
     {
+        mOffset = 0;
         if (reverseBytes)
-        {
-            // Re-reverse because a value may be less than 4 bytes.
-            mOffset = sys::byteSwap(mOffset);
-            const auto elementSize = tiff::Const::sizeOf(mType);
-            sys::byteSwap((sys::byte*)&mOffset, elementSize, sizeof(mOffset) / elementSize);
-        }
-        parseValues((unsigned char *)&mOffset);
+            swapValues(field, mType, mCount);
+        parseValues((const unsigned char *)field);
     }
 
     //try to retrieve the name as well
@@ -161,7 +224,7 @@ void tiff::IFDEntry::print(io::OutputStream& output) const
     message << "Number of Elements:  " << mCount << std::endl;
 
     // Print the offset if one exists
-    if (mCount * tiff::Const::sizeOf(mType) > 4)
+    if (mOffset)
         message << "Offset:              " << mOffset << std::endl;
 
     message << "Value(s):            ";
@@ -218,16 +281,19 @@ void tiff::IFDEntry::parseValues(const unsigned char *buffer)
     }
 }
 
-sys::Uint32_T tiff::IFDEntry::finalize(const sys::Uint32_T offset)
+sys::Uint64_T tiff::IFDEntry::finalize(const sys::Uint64_T offset,
+                                      const bool bigTIFF)
 {
     mCount = static_cast<sys::Uint32_T>(mValues.size());
 
-    sys::Uint32_T size = mCount * tiff::Const::sizeOf(mType);
-    if (size > 4)
+    const size_t fieldSize = bigTIFF ? sizeof(sys::Uint64_T) : sizeof(sys::Uint32_T);
+    const sys::Uint64_T size = static_cast<sys::Uint64_T>(mCount) * tiff::Const::sizeOf(mType);
+    if (size > fieldSize)
     {
         mOffset = offset;
         return offset + size;
     }
 
+    mOffset = 0;
     return offset;
 }
@@ -22,28 +22,132 @@
 
 #include "tiff/ImageReader.h"
 
+#include <string.h>
+#include <algorithm>
 #include <sstream>
 #include <import/io.h>
 #include <import/except.h>
+#include <math/Round.h>
+#include <mt/WorkStealingExecutor.h>
 #include "tiff/Common.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
 
-void tiff::ImageReader::process(const bool reverseBytes)
+namespace
+{
+// Offsets, byte counts, and tile sizes can be SHORT, LONG, or in BigTIFF,
+// LONG8
+sys::Uint64_T getValue(const tiff::IFDEntry& entry, sys::Uint32_T index)
+{
+    switch (entry.getType())
+    {
+    case tiff::Const::Type::SHORT:
+        return *(tiff::GenericType<unsigned short> *)entry[index];
+    case tiff::Const::Type::LONG8:
+    case tiff::Const::Type::IFD8:
+        return *(tiff::GenericType<sys::Uint64_T> *)entry[index];
+    default:
+        return *(tiff::GenericType<sys::Uint32_T> *)entry[index];
+    }
+}
+
+std::vector<sys::Uint64_T> getValues(const tiff::IFDEntry *entry)
+{
+    std::vector<sys::Uint64_T> values;
+    if (entry)
+    {
+        values.resize(entry->getCount());
+        for (sys::Uint32_T i = 0; i < entry->getCount(); ++i)
+            values[i] = getValue(*entry, i);
+    }
+    return values;
+}
+}
+
+void tiff::ImageReader::process(const bool reverseBytes, const bool bigTIFF)
 {
     mReverseBytes = reverseBytes;
 
-    mIFD.deserialize(*mInput, mReverseBytes);
+    mIFD.deserialize(*mInput, mReverseBytes, bigTIFF);
 
-    mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
-    if (mReverseBytes)
-        mNextOffset = sys::byteSwap(mNextOffset);
+    if (bigTIFF)
+    {
+        mInput->read((sys::byte *)&mNextOffset, sizeof(mNextOffset));
+        if (mReverseBytes)
+            mNextOffset = sys::byteSwap(mNextOffset);
+    }
+    else
+    {
+        sys::Uint32_T nextOffset = 0;
+        mInput->read((sys::byte *)&nextOffset, sizeof(nextOffset));
+        if (mReverseBytes)
+            nextOffset = sys::byteSwap(nextOffset);
+        mNextOffset = nextOffset;
+    }
 
     // Done here to lower the number of calls to it later.
     mElementSize = mIFD.getElementSize();
 
-    mStripByteCounts = mIFD["StripByteCounts"];
-    mStripOffsets = mIFD["StripOffsets"];
+    // Decode the strip or tile layout once, rather than going through the
+    // IFD for every piece that's read.  A strip is treated as a tile that's
+    // the full width of the image.
+    const sys::Uint32_T imageWidth = mIFD.getImageWidth();
+    const sys::Uint32_T imageLength = mIFD.getImageLength();
+    if (mIFD["TileOffsets"] && !mIFD["StripOffsets"])
+    {
+        mChunkOffsets = getValues(mIFD["TileOffsets"]);
+        mChunkByteCounts = getValues(mIFD["TileByteCounts"]);
+
+        tiff::IFDEntry *tileWidth = mIFD["TileWidth"];
+        tiff::IFDEntry *tileLength = mIFD["TileLength"];
+        if (!tileWidth || !tileLength)
+            throw except::Exception(Ctxt("Tiled image is missing its tile size"));
+        mChunkWidth = static_cast<sys::Uint32_T>(getValue(*tileWidth, 0));
+        mChunkLength = static_cast<sys::Uint32_T>(getValue(*tileLength, 0));
+        if (mChunkWidth == 0 || mChunkLength == 0)
+            throw except::Exception(Ctxt("Invalid tile size"));
+        mChunksAcross = (imageWidth + mChunkWidth - 1) / mChunkWidth;
+    }
+    else
+    {
+        mChunkOffsets = getValues(mIFD["StripOffsets"]);
+        mChunkByteCounts = getValues(mIFD["StripByteCounts"]);
+
+        // RowsPerStrip defaults to the whole image
+        tiff::IFDEntry *rowsPerStrip = mIFD["RowsPerStrip"];
+        mChunkWidth = imageWidth;
+        mChunkLength = imageLength;
+        if (rowsPerStrip)
+        {
+            const auto rows = getValue(*rowsPerStrip, 0);
+            if (rows > 0 && rows < imageLength)
+                mChunkLength = static_cast<sys::Uint32_T>(rows);
+        }
+        mChunksAcross = 1;
+    }
+
+    if (mChunkByteCounts.size() < mChunkOffsets.size())
+        throw except::Exception(Ctxt("Missing strip or tile byte counts"));
+
+    // Unsupported compression is only an error when reading data
+    mCompression = tiff::Const::CompressionType::NO_COMPRESSION;
+    mCodec.reset();
+    if (tiff::IFDEntry *compression = mIFD["Compression"])
+        mCompression = static_cast<unsigned short>(getValue(*compression, 0));
+    if (tiff::isCodecSupported(mCompression))
+        mCodec = tiff::createCodec(mCompression);
+
+    mPredictor = tiff::Const::PredictorType::NONE;
+    tiff::IFDEntry *predictor = mIFD["Predictor"];
+    if (predictor && tiff::usesPredictor(mCompression))
+        mPredictor = static_cast<unsigned short>(getValue(*predictor, 0));
+
+    mBytesPerSample = 1;
+    if (tiff::IFDEntry *bitsPerSample = mIFD["BitsPerSample"])
+        mBytesPerSample = std::max<size_t>(getValue(*bitsPerSample, 0) / 8, 1);
+    mSamplesPerPixel = std::max<size_t>(mElementSize / mBytesPerSample, 1);
+
+    mHaveBand = false;
 }
 
 void tiff::ImageReader::print(io::OutputStream &output) const
@@ -56,27 +160,80 @@ void tiff::ImageReader::print(io::OutputStream &output) const
     output.write(message.str());
 }
 
+void tiff::ImageReader::checkCompression()
+{
+    if (mCompression != tiff::Const::CompressionType::NO_COMPRESSION && !mCodec)
+        throw except::Exception(Ctxt(str::Format("Unsupported compression type: %d", mCompression)));
+}
+
 void tiff::ImageReader::getData(unsigned char *buffer,
         const sys::Uint32_T numElementsToRead)
 {
-    //see if it is uncompressed
-    tiff::IFDEntry *compression = mIFD["Compression"];
-    if (compression)
-    {
-        unsigned short c = *(tiff::GenericType<unsigned short> *)(*compression)[0];
-        if (c != tiff::Const::CompressionType::NO_COMPRESSION)
-            throw except::Exception(Ctxt(str::Format("Unsupported compression type: %d", c)));
-    }
-    
-    if (mIFD["StripOffsets"])
+    checkCompression();
+
+    mQueuedReads.clear();
+    if (mCodec)
+        getCompressedData(buffer, numElementsToRead);
+    else if (mIFD["StripOffsets"])
         getStripData(buffer, numElementsToRead);
     else if (mIFD["TileOffsets"])
         getTileData(buffer, numElementsToRead);
     else
         throw except::Exception(Ctxt("Unsupported TIFF file format"));
+}
+
+void tiff::ImageReader::readData(unsigned char *buffer,
+        sys::Uint32_T numBytes)
+{
+    if (mReverseBytes && mMapInput)
+        mMapInput->readAndByteSwap(buffer, numBytes, mElementSize);
+    else if (mReverseBytes)
+        mFileInput->readAndByteSwap(buffer, numBytes, mElementSize);
+    else
+        mInput->read((sys::byte *)buffer, numBytes);
+}
+
+void tiff::ImageReader::queueRead(sys::Uint64_T offset,
+        unsigned char *buffer, sys::Uint32_T numBytes)
+{
+    io::AsyncFileReader::Request request;
+    request.offset = static_cast<sys::Off_T>(offset);
+    request.length = numBytes;
+    request.buffer = buffer;
+    mQueuedReads.push_back(request);
+}
+
+void tiff::ImageReader::readQueued()
+{
+    std::vector<io::AsyncFileReader::Request> reads;
+    reads.swap(mQueuedReads);
+
+    if (!mAsyncReader)
+    {
+        for (const auto& request : reads)
+        {
+            mInput->seek(request.offset, io::Seekable::START);
+            readData(static_cast<unsigned char *>(request.buffer),
+                     static_cast<sys::Uint32_T>(request.length));
+        }
+        return;
+    }
 
-    if (mReverseBytes)
-        sys::byteSwap(buffer, mElementSize, numElementsToRead);
+    // Swap each piece as it arrives while the later ones are in flight
+    io::ReadAheadQueue queue(*mAsyncReader, reads, mReadAhead);
+    while (!queue.isDone())
+    {
+        const io::AsyncFileReader::Completion completion = queue.next();
+        const io::AsyncFileReader::Request& request = reads[completion.tag];
+        unsigned char *buffer = static_cast<unsigned char *>(request.buffer);
+
+        // Match FileInputStream, which zeroes what it couldn't read
+        ::memset(buffer + completion.bytesRead, 0,
+                 request.length - completion.bytesRead);
+        if (mReverseBytes && mElementSize > 1)
+            sys::byteSwap(buffer, mElementSize,
+                          completion.bytesRead / mElementSize);
+    }
 }
 
 void tiff::ImageReader::getStripData(unsigned char *buffer,
@@ -85,26 +242,26 @@ void tiff::ImageReader::getStripData(unsigned char *buffer,
     sys::Uint32_T bufferOffset = 0;
     
     //figure out how far we are in the current strip
-    sys::Uint32_T stripOffset = 0;
+    sys::Uint64_T stripOffset = 0;
     for (sys::Uint32_T i = 0; i < mStripIndex; ++i)
-        stripOffset += *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[i];
-    sys::Uint32_T stripPosition = mBytePosition - stripOffset;
+        stripOffset += mChunkByteCounts[i];
+    sys::Uint64_T stripPosition = mBytePosition - stripOffset;
     
     //how many bytes do we need to read?
     sys::Uint32_T numBytesToRead = numElementsToRead * mElementSize;
 
     while (numBytesToRead)
     {
-        if (mStripIndex >= mStripOffsets->getCount())
+        if (mStripIndex >= mChunkOffsets.size())
             throw except::Exception(Ctxt("Invalid strip offset index"));
 
-        sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[mStripIndex];
+        const sys::Uint64_T stripSize = mChunkByteCounts[mStripIndex];
 
         // Calculate what remains to be read in the current strip.
-        sys::Uint32_T remainingBytesInStrip = stripSize - stripPosition;
+        const sys::Uint64_T remainingBytesInStrip = stripSize - stripPosition;
 
         // Seek to the strip offset plus the last read position.
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*mStripOffsets)[mStripIndex]) + stripPosition;
+        const sys::Uint64_T seekPos = mChunkOffsets[mStripIndex] + stripPosition;
 
         
         sys::Uint32_T thisRead = numBytesToRead;
@@ -113,13 +270,12 @@ void tiff::ImageReader::getStripData(unsigned char *buffer,
         // in the current strip, just read what can be read from the current strip.
         if (numBytesToRead > remainingBytesInStrip)
         {
-            thisRead = remainingBytesInStrip;
+            thisRead = static_cast<sys::Uint32_T>(remainingBytesInStrip);
             mStripIndex++; //increment the strip index for next time
         }
         
-        // Go to the offset, and read.
-        mInput->seek(seekPos, io::Seekable::START);
-        mInput->read((sys::byte *)buffer + bufferOffset, thisRead);
+        // Queue the read; they're all done together below.
+        queueRead(seekPos, buffer + bufferOffset, thisRead);
 
         // Update the tile position in bytes.
         mBytePosition += thisRead;
@@ -131,6 +287,8 @@ void tiff::ImageReader::getStripData(unsigned char *buffer,
         //reset to 0
         stripPosition = 0;
     }
+
+    readQueued();
 }
 
 void tiff::ImageReader::getTileData(unsigned char*buffer,
@@ -140,26 +298,11 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
     sys::Uint32_T imageElemWidth = mIFD.getImageWidth();
     sys::Uint32_T imageByteWidth = imageElemWidth * mElementSize;
 
-    // Get the tile width.
-    tiff::IFDEntry *tileWidth = mIFD["TileWidth"];
-    sys::Uint32_T tileElemWidth = 0;
-    if (tileWidth->getType() == tiff::Const::Type::LONG)
-        tileElemWidth = *(tiff::GenericType<sys::Uint32_T> *)(*tileWidth)[0];
-    else
-        tileElemWidth = *(tiff::GenericType<unsigned short> *)(*tileWidth)[0];
+    // The tile layout was decoded by process().
+    sys::Uint32_T tileElemWidth = mChunkWidth;
     sys::Uint32_T tileByteWidth = tileElemWidth * mElementSize;
-
-    // Get the tile length.
-    tiff::IFDEntry *tileLength = mIFD["TileLength"];
-    sys::Uint32_T tileElemLength = 0;
-    if (tileLength->getType() == tiff::Const::Type::LONG)
-        tileElemLength = *(tiff::GenericType<sys::Uint32_T> *)(*tileLength)[0];
-    else
-        tileElemLength = *(tiff::GenericType<unsigned short> *)(*tileLength)[0];
-
-    // Compute the number of tiles wide the image is.
-    sys::Uint32_T tilesAcross = (imageElemWidth + tileElemWidth - 1)
-            / tileElemWidth;
+    sys::Uint32_T tileElemLength = mChunkLength;
+    sys::Uint32_T tilesAcross = mChunksAcross;
 
     // Determine how many bytes were used to pad the right edge.
     sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
@@ -170,12 +313,12 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
         sys::Uint32_T bytesToRead = mElementSize * numElementsToRead;
 
         // Compute the row in image, row in tile, and tile row.
-        sys::Uint32_T row = mBytePosition / imageByteWidth;
+        sys::Uint32_T row = static_cast<sys::Uint32_T>(mBytePosition / imageByteWidth);
         sys::Uint32_T tileRow = row / tileElemLength;
         sys::Uint32_T rowInTile = row % tileElemLength;
 
         // Compute the column in image, column in tile, and tile column.
-        sys::Uint32_T column = mBytePosition - (row * imageByteWidth);
+        sys::Uint32_T column = static_cast<sys::Uint32_T>(mBytePosition - (static_cast<sys::Uint64_T>(row) * imageByteWidth));
         sys::Uint32_T tileColumn = column / tileByteWidth;
         sys::Uint32_T colInTile = column % tileByteWidth;
 
@@ -194,16 +337,15 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
         if (bytesToRead> remainingBytesThisLine)
             bytesToRead = remainingBytesThisLine;
 
-        // Seek to the tile offset plus the last read position.
-        tiff::IFDEntry *tileOffsets = mIFD["TileOffsets"];
-        sys::Uint32_T seekPos = (*(tiff::GenericType<sys::Uint32_T> *)(*tileOffsets)[tileIndex]) + (rowInTile * tileByteWidth)
-                + colInTile;
+        if (tileIndex >= mChunkOffsets.size())
+            throw except::Exception(Ctxt("Invalid tile offset index"));
 
-        // Go to the offset.
-        mInput->seek(seekPos, io::Seekable::START);
+        // Seek to the tile offset plus the last read position.
+        const sys::Uint64_T seekPos = mChunkOffsets[tileIndex] +
+                (static_cast<sys::Uint64_T>(rowInTile) * tileByteWidth) + colInTile;
 
-        // Read the data.
-        mInput->read((sys::byte *)buffer + bufferOffset, bytesToRead);
+        // Queue the read; they're all done together below.
+        queueRead(seekPos, buffer + bufferOffset, bytesToRead);
 
         // Update the strip position in bytes.
         mBytePosition += bytesToRead;
@@ -212,4 +354,198 @@ void tiff::ImageReader::getTileData(unsigned char*buffer,
         bufferOffset += bytesToRead;
         numElementsToRead -= (bytesToRead / mElementSize);
     }
+
+    readQueued();
+}
+
+void tiff::ImageReader::readWindow(unsigned char *buffer,
+        sys::Uint32_T startRow, sys::Uint32_T startCol,
+        sys::Uint32_T numRows, sys::Uint32_T numCols, size_t numThreads)
+{
+    checkCompression();
+
+    if (mChunkOffsets.empty())
+        throw except::Exception(Ctxt("Unsupported TIFF file format"));
+
+    const sys::Uint64_T imageLength = mIFD.getImageLength();
+    const sys::Uint64_T imageWidth = mIFD.getImageWidth();
+    if (static_cast<sys::Uint64_T>(startRow) + numRows > imageLength ||
+        static_cast<sys::Uint64_T>(startCol) + numCols > imageWidth)
+    {
+        std::ostringstream ostr;
+        ostr << "Window of " << numRows << "x" << numCols << " at ("
+             << startRow << ", " << startCol << ") is outside the "
+             << imageLength << "x" << imageWidth << " image";
+        throw except::IndexOutOfRangeException(Ctxt(ostr));
+    }
+    if (numRows == 0 || numCols == 0)
+        return;
+
+    // Every strip or tile the window touches, in file order
+    const sys::Uint32_T firstChunkRow = startRow / mChunkLength;
+    const sys::Uint32_T lastChunkRow = (startRow + numRows - 1) / mChunkLength;
+    const sys::Uint32_T firstChunkCol = startCol / mChunkWidth;
+    const sys::Uint32_T lastChunkCol = (startCol + numCols - 1) / mChunkWidth;
+
+    std::vector<size_t> chunks;
+    chunks.reserve(static_cast<size_t>(lastChunkRow - firstChunkRow + 1) *
+                   (lastChunkCol - firstChunkCol + 1));
+    for (sys::Uint32_T chunkRow = firstChunkRow; chunkRow <= lastChunkRow; ++chunkRow)
+        for (sys::Uint32_T chunkCol = firstChunkCol; chunkCol <= lastChunkCol; ++chunkCol)
+            chunks.push_back(static_cast<size_t>(chunkRow) * mChunksAcross + chunkCol);
+
+    // Each chunk lands in its own part of buffer, so they're independent
+    const auto readChunk = [&](size_t ii)
+    {
+        readWindowChunk(chunks[ii], buffer, startRow, startCol, numRows, numCols);
+    };
+    if (numThreads > 1 && chunks.size() > 1)
+    {
+        // Split the chunks into (at most) numThreads tasks
+        mt::parallel_for(chunks.size(), readChunk,
+                         math::ceilingDivide(chunks.size(), numThreads));
+    }
+    else
+    {
+        for (size_t ii = 0; ii < chunks.size(); ++ii)
+            readChunk(ii);
+    }
+}
+
+void tiff::ImageReader::readWindowChunk(size_t chunkIndex,
+        unsigned char *buffer, sys::Uint32_T startRow, sys::Uint32_T startCol,
+        sys::Uint32_T numRows, sys::Uint32_T numCols)
+{
+    if (chunkIndex >= mChunkOffsets.size())
+        throw except::Exception(Ctxt("Invalid strip or tile offset index"));
+
+    const sys::Uint32_T chunkRow = static_cast<sys::Uint32_T>(chunkIndex / mChunksAcross);
+    const sys::Uint32_T chunkCol = static_cast<sys::Uint32_T>(chunkIndex % mChunksAcross);
+    const sys::Uint32_T chunkTop = chunkRow * mChunkLength;
+    const sys::Uint32_T chunkLeft = chunkCol * mChunkWidth;
+
+    // The part of the window in this chunk
+    const sys::Uint32_T rowBegin = std::max(startRow, chunkTop);
+    const sys::Uint32_T rowEnd = std::min(startRow + numRows, chunkTop + mChunkLength);
+    const sys::Uint32_T colBegin = std::max(startCol, chunkLeft);
+    const sys::Uint32_T colEnd = std::min(startCol + numCols, chunkLeft + mChunkWidth);
+
+    // Read every row of the chunk the window needs in one go; for a tile
+    // that's entirely inside the window, that's the whole tile.
+    const size_t chunkRowBytes = static_cast<size_t>(mChunkWidth) * mElementSize;
+    const size_t numBytes = (rowEnd - rowBegin) * chunkRowBytes;
+    const sys::Uint64_T startByte = (rowBegin - chunkTop) * chunkRowBytes;
+    if (!mCodec && startByte + numBytes > mChunkByteCounts[chunkIndex])
+        throw except::Exception(Ctxt("Strip or tile is smaller than its dimensions"));
+    const sys::Off_T offset = static_cast<sys::Off_T>(mChunkOffsets[chunkIndex] + startByte);
+
+    // A compressed chunk has to be read and decoded in full
+    const sys::Off_T readOffset = mCodec ?
+            static_cast<sys::Off_T>(mChunkOffsets[chunkIndex]) : offset;
+    const size_t readBytes = mCodec ?
+            static_cast<size_t>(mChunkByteCounts[chunkIndex]) : numBytes;
+
+    const unsigned char *src = nullptr;
+    std::vector<unsigned char> scratch;
+    if (mMapInput)
+    {
+        src = reinterpret_cast<const unsigned char *>(
+                mMapInput->view(readOffset, readBytes).data());
+    }
+    else if (mFileInput)
+    {
+        scratch.resize(readBytes);
+        mFileInput->readAt(readOffset, scratch.data(), readBytes);
+        src = scratch.data();
+    }
+    else
+    {
+        throw except::Exception(Ctxt("No input to read the window from"));
+    }
+
+    // Decoded data is already in native byte order
+    bool reverseBytes = mReverseBytes && mElementSize > 1;
+    std::vector<unsigned char> decoded;
+    if (mCodec)
+    {
+        decodeChunk(src, readBytes, decoded);
+        src = decoded.data() + startByte;
+        reverseBytes = false;
+    }
+
+    // Scatter the rows into the window, byte swapping on the way
+    const size_t rowBytes = static_cast<size_t>(colEnd - colBegin) * mElementSize;
+    src += static_cast<size_t>(colBegin - chunkLeft) * mElementSize;
+    unsigned char *dest = buffer +
+            ((static_cast<size_t>(rowBegin - startRow) * numCols) + (colBegin - startCol)) * mElementSize;
+    const size_t destRowBytes = static_cast<size_t>(numCols) * mElementSize;
+    for (sys::Uint32_T row = rowBegin; row < rowEnd; ++row)
+    {
+        if (reverseBytes)
+            sys::byteSwap(src, mElementSize, rowBytes / mElementSize, dest);
+        else
+            ::memcpy(dest, src, rowBytes);
+        src += chunkRowBytes;
+        dest += destRowBytes;
+    }
+}
+
+void tiff::ImageReader::decodeChunk(const unsigned char *src, size_t srcLen,
+        std::vector<unsigned char>& decoded)
+{
+    // The last strip can be short; decode() zero fills the rest
+    const sys::Uint32_T numRows = mChunkLength;
+    const size_t rowBytes = static_cast<size_t>(mChunkWidth) * mElementSize;
+
+    decoded.resize(static_cast<size_t>(numRows) * rowBytes);
+    mCodec->decode(src, srcLen, decoded.data(), decoded.size());
+
+    // The floating point predictor has its own byte order
+    if (mReverseBytes && mBytesPerSample > 1 &&
+        mPredictor != tiff::Const::PredictorType::FLOATING_POINT)
+    {
+        sys::byteSwap(decoded.data(), mBytesPerSample,
+                      decoded.size() / mBytesPerSample);
+    }
+    tiff::removePredictor(mPredictor, decoded.data(), numRows, rowBytes,
+                          mBytesPerSample, mSamplesPerPixel);
+}
+
+void tiff::ImageReader::getCompressedData(unsigned char *buffer,
+        sys::Uint32_T numElementsToRead)
+{
+    const sys::Uint32_T imageWidth = mIFD.getImageWidth();
+    const sys::Uint32_T imageLength = mIFD.getImageLength();
+    const size_t imageRowBytes = static_cast<size_t>(imageWidth) * mElementSize;
+    if (imageRowBytes == 0)
+        throw except::Exception(Ctxt("Image has no columns"));
+
+    size_t numBytesToRead = static_cast<size_t>(numElementsToRead) * mElementSize;
+    while (numBytesToRead)
+    {
+        const sys::Uint32_T row = static_cast<sys::Uint32_T>(mBytePosition / imageRowBytes);
+        if (row >= imageLength)
+            throw except::Exception(Ctxt("Tried to read past the end of the image"));
+
+        // Decode the whole row of strips or tiles this is in
+        const sys::Uint32_T bandIndex = row / mChunkLength;
+        const sys::Uint32_T bandTop = bandIndex * mChunkLength;
+        if (!mHaveBand || bandIndex != mBandIndex)
+        {
+            const sys::Uint32_T numRows = std::min(mChunkLength, imageLength - bandTop);
+            mBand.resize(numRows * imageRowBytes);
+            mHaveBand = false;
+            readWindow(mBand.data(), bandTop, 0, numRows, imageWidth, mNumThreads);
+            mBandIndex = bandIndex;
+            mHaveBand = true;
+        }
+
+        const size_t bandOffset = static_cast<size_t>(mBytePosition - bandTop * imageRowBytes);
+        const size_t thisRead = std::min(numBytesToRead, mBand.size() - bandOffset);
+        ::memcpy(buffer, mBand.data() + bandOffset, thisRead);
+
+        buffer += thisRead;
+        numBytesToRead -= thisRead;
+        mBytePosition += thisRead;
+    }
 }
@@ -22,24 +22,91 @@
 
 #include "tiff/ImageWriter.h"
 
+#include <string.h>
 #include <sstream>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <import/except.h>
-
-#include "gsl/gsl.h"
+#include <math/Round.h>
+#include <mt/WorkStealingExecutor.h>
 
 #include "tiff/Common.h"
 #include "tiff/GenericType.h"
 #include "tiff/IFDEntry.h"
+#include "tiff/KnownTags.h"
 
 const unsigned short tiff::ImageWriter::CHUNK_SIZE = 8192;
 
+namespace
+{
+// Strip and tile offsets and byte counts are LONG, or LONG8 in BigTIFF
+void addChunkEntry(tiff::IFD& ifd, const std::string& name, bool bigTIFF)
+{
+    if (!bigTIFF)
+    {
+        ifd.addEntry(name);
+        return;
+    }
+    const tiff::IFDEntry *known = tiff::KnownTagsRegistry::getInstance()[name];
+    const tiff::IFDEntry entry(known->getTagID(), tiff::Const::Type::LONG8, name);
+    ifd.addEntry(&entry);
+}
+
+void checkClassicValue(sys::Uint64_T value)
+{
+    if (value > std::numeric_limits<sys::Uint32_T>::max())
+        throw except::Exception(Ctxt("File is too large for classic TIFF; write a BigTIFF"));
+}
+
+void addChunkValue(tiff::IFD& ifd, const std::string& name, sys::Uint64_T value)
+{
+    if (ifd[name]->getType() == tiff::Const::Type::LONG8)
+    {
+        ifd.addEntryValue(name, value);
+    }
+    else
+    {
+        checkClassicValue(value);
+        ifd.addEntryValue(name, static_cast<sys::Uint32_T>(value));
+    }
+}
+
+sys::Uint64_T getValue(const tiff::IFDEntry& entry, size_t index)
+{
+    const auto value = entry[static_cast<sys::Uint32_T>(index)];
+    if (entry.getType() == tiff::Const::Type::LONG8)
+        return *(tiff::GenericType<sys::Uint64_T> *)value;
+    return *(tiff::GenericType<sys::Uint32_T> *)value;
+}
+
+// Fills in a value that was added as a placeholder
+void setValue(tiff::IFDEntry& entry, size_t index, sys::Uint64_T value)
+{
+    unsigned char *data = entry[static_cast<sys::Uint32_T>(index)]->data();
+    if (entry.getType() == tiff::Const::Type::LONG8)
+    {
+        ::memcpy(data, &value, sizeof(value));
+    }
+    else
+    {
+        checkClassicValue(value);
+        const auto value32 = static_cast<sys::Uint32_T>(value);
+        ::memcpy(data, &value32, sizeof(value32));
+    }
+}
+}
+
 void tiff::ImageWriter::putData(const unsigned char *buffer,
                                 sys::Uint32_T numElementsToWrite)
 {
     validate();
 
-    if (mFormat == TILED)
+    if (mCodec)
+    {
+        putCompressedData(buffer, numElementsToWrite);
+    }
+    else if (mFormat == TILED)
     {
         putTileData(buffer, numElementsToWrite);
     }
@@ -51,18 +118,40 @@ void tiff::ImageWriter::putData(const unsigned char *buffer,
 
 void tiff::ImageWriter::writeIFD()
 {
+    // Compress whatever's still buffered; anything never written is zero
+    if (mCodec && mValidated)
+    {
+        const size_t imageRowBytes = static_cast<size_t>(mIFD.getImageWidth()) * mElementSize;
+        while (!mBand.empty())
+        {
+            mBytePosition = mBandTop * imageRowBytes + mBand.size();
+            flushBand();
+        }
+        mOutput->seek(mNextChunkOffset, io::Seekable::START);
+    }
+
     // Retain the current file offset.
-    const auto offset = gsl::narrow<int32_t>(mOutput->tell()); // Per TIFF spec, "offset" MUST be a 32-bit value!
+    const sys::Uint64_T offset = mOutput->tell();
 
     // Seek to the position to write the current offset to.
     mOutput->seek(mIFDOffset, io::Seekable::START);
 
-    // Write the current offset.
-    mOutput->write((sys::byte *)&offset, sizeof(offset));
+    // Write the current offset.  Per TIFF spec, it's a 32-bit value, or
+    // 64-bit in BigTIFF.
+    if (isBigTIFF())
+    {
+        mOutput->write((sys::byte *)&offset, sizeof(offset));
+    }
+    else
+    {
+        checkClassicValue(offset);
+        const auto offset32 = static_cast<sys::Uint32_T>(offset);
+        mOutput->write((sys::byte *)&offset32, sizeof(offset32));
+    }
 
     // Reseek to the current offset and write out the IFD.
     mOutput->seek(offset, io::Seekable::START);
-    mIFD.serialize(*mOutput);
+    mIFD.serialize(*mOutput, isBigTIFF());
 
     // Keep the position in the file that the offset to the next
     // IFD can be written to, in case there is another IFD.
@@ -85,13 +174,28 @@ void tiff::ImageWriter::validate()
         throw except::Exception(Ctxt("ImageLength must be defined"));
 
     // Compression
+    unsigned short type = tiff::Const::CompressionType::NO_COMPRESSION;
     tiff::IFDEntry *compression = mIFD["Compression"];
     if (!compression)
         mIFD.addEntry("Compression", (unsigned short) 1);
     else
     {
-        if (*(tiff::GenericType<unsigned short> *)(*compression)[0] != 1)
-            throw except::Exception(Ctxt("Unsupported compression type"));
+        type = *(tiff::GenericType<unsigned short> *)(*compression)[0];
+        if (type != tiff::Const::CompressionType::NO_COMPRESSION)
+        {
+            if (!tiff::isCodecSupported(type))
+                throw except::Exception(Ctxt(str::Format("Unsupported compression type: %d", type)));
+            mCodec = tiff::createCodec(type);
+        }
+    }
+
+    // Predictor
+    tiff::IFDEntry *predictor = mIFD["Predictor"];
+    if (predictor)
+    {
+        mPredictor = *(tiff::GenericType<unsigned short> *)(*predictor)[0];
+        if (mPredictor != tiff::Const::PredictorType::NONE && !tiff::usesPredictor(type))
+            throw except::Exception(Ctxt("A Predictor requires LZW or Deflate compression"));
     }
 
     // XResolution
@@ -125,7 +229,9 @@ void tiff::ImageWriter::validate()
     if (!photoInterp)
         throw except::Exception(Ctxt("No default for PhotometricInterpretation; it must be defined"));
 
-    switch (*(tiff::GenericType<unsigned short> *)(*photoInterp)[0])
+    const unsigned short photometric = *(tiff::GenericType<unsigned short> *)(*photoInterp)[0];
+    const bool isRGB = photometric == tiff::Const::PhotoInterpType::RGB;
+    switch (photometric)
     {
     case tiff::Const::PhotoInterpType::BLACK_IS_ZERO:
     case tiff::Const::PhotoInterpType::WHITE_IS_ZERO:
@@ -178,7 +284,7 @@ void tiff::ImageWriter::validate()
                 {
                     unsigned short value =
                             *(tiff::GenericType<unsigned short> *)(*bitsPerSample)[i];
-                    if (value != 8 && i < 3)
+                    if (isRGB && value != 8 && i < 3)
                         throw except::Exception(Ctxt("BitsPerSample values must be 8 for RGB files"));
                 }
             }
@@ -193,7 +299,7 @@ void tiff::ImageWriter::validate()
                 {
                     unsigned short value =
                             *(tiff::GenericType<unsigned short> *)(*sampleFormat)[i];
-                    if (value != 1 && i < 3)
+                    if (isRGB && value != 1 && i < 3)
                         throw except::Exception(Ctxt("SampleFormat values must be 1 for RGB files"));
                 }
             }
@@ -205,11 +311,16 @@ void tiff::ImageWriter::validate()
 
     mElementSize = mIFD.getElementSize();
 
+    checkFileSize();
+
     if (mFormat == TILED)
         initTiles();
     else
         initStrips();
 
+    if (mCodec)
+        initCompression();
+
     //  if (mGeoTIFFReader)
     //  {
     //    tiff::IFDEntry *entry = nullptr;
@@ -230,32 +341,72 @@ void tiff::ImageWriter::validate()
     mValidated = true;
 }
 
-void tiff::ImageWriter::initTiles()
+void tiff::ImageWriter::checkFileSize()
+{
+    if (!mHeader || mHeader->isBigTIFF())
+        return;
+
+    // Project the file size from the uncompressed image (tiles are padded
+    // out to full size) and the IFD, with its strip or tile offsets
+    sys::Uint64_T imageSize = mIFD.getImageSize();
+    sys::Uint64_T numChunks = mIFD.getImageLength();
+    if (mFormat == TILED)
+    {
+        const sys::Uint64_T tileSize = getTileSize();
+        const sys::Uint64_T tilesAcross = (mIFD.getImageWidth() + tileSize - 1) / tileSize;
+        const sys::Uint64_T tilesDown = (mIFD.getImageLength() + tileSize - 1) / tileSize;
+        numChunks = tilesAcross * tilesDown;
+        imageSize = numChunks * tileSize * tileSize * mElementSize;
+    }
+    const sys::Uint64_T ifdSize = mIFD.size() * tiff::IFDEntry::sizeOf() +
+            numChunks * 2 * sizeof(sys::Uint32_T) + 4096;
+    const sys::Uint64_T projectedSize =
+            static_cast<sys::Uint64_T>(mOutput->tell()) + imageSize + ifdSize;
+    if (projectedSize <= mMaxClassicSize)
+        return;
+
+    // The header can only be rewritten if nothing's been written after it
+    if (static_cast<sys::Uint64_T>(mOutput->tell()) != mHeader->size())
+        throw except::Exception(Ctxt("Image is too large for classic TIFF; "
+                "call FileWriter::setBigTIFF() before writing the first image"));
+
+    mHeader->setBigTIFF(true);
+    mOutput->seek(0, io::Seekable::START);
+    mHeader->serialize(*mOutput);
+    mIFDOffset = mHeader->size() - mHeader->getOffsetSize();
+}
+
+sys::Uint32_T tiff::ImageWriter::getTileSize() const
 {
     const sys::Uint32_T root = (sys::Uint32_T)sqrt((double)mIdealChunkSize
             / (double)mIFD.getElementSize());
     const sys::Uint32_T ceiling = (sys::Uint32_T)ceil(((double)root) / 16);
-    const sys::Uint32_T tileSize = ceiling * 16;
+    return ceiling * 16;
+}
+
+void tiff::ImageWriter::initTiles()
+{
+    const sys::Uint32_T tileSize = getTileSize();
 
     mIFD.addEntry("TileWidth", (sys::Uint32_T) tileSize);
     mIFD.addEntry("TileLength", (sys::Uint32_T) tileSize);
 
-    auto fileOffset = mOutput->tell();
+    sys::Uint64_T fileOffset = mOutput->tell();
     const sys::Uint32_T tilesAcross = (mIFD.getImageWidth() + tileSize - 1)
             / tileSize;
     const sys::Uint32_T tilesDown = (mIFD.getImageLength() + tileSize - 1) / tileSize;
 
     const unsigned short elementSize = mIFD.getElementSize();
 
-    mIFD.addEntry("TileByteCounts");
-    mIFD.addEntry("TileOffsets");
+    addChunkEntry(mIFD, "TileByteCounts", isBigTIFF());
+    addChunkEntry(mIFD, "TileOffsets", isBigTIFF());
     for (sys::Uint32_T y = 0; y < tilesDown; ++y)
     {
         for (sys::Uint32_T x = 0; x < tilesAcross; ++x)
         {
-            const sys::Uint32_T byteCount = tileSize * tileSize * elementSize;
-            mIFD.addEntryValue("TileOffsets", (sys::Uint32_T) fileOffset);
-            mIFD.addEntryValue("TileByteCounts", (sys::Uint32_T) byteCount);
+            const sys::Uint64_T byteCount = static_cast<sys::Uint64_T>(tileSize) * tileSize * elementSize;
+            addChunkValue(mIFD, "TileOffsets", fileOffset);
+            addChunkValue(mIFD, "TileByteCounts", byteCount);
             fileOffset += byteCount;
         }
     }
@@ -288,28 +439,28 @@ void tiff::ImageWriter::initStrips()
             (sys::Uint32_T)floor(static_cast<double>(length + rowsPerStrip - 1)
                     / static_cast<double>(rowsPerStrip));
 
-    auto offset = mOutput->tell();
+    sys::Uint64_T offset = mOutput->tell();
 
     // Add counts and offsets for all but the last strip.
-    mIFD.addEntry("StripOffsets");
-    mIFD.addEntry("StripByteCounts");
+    addChunkEntry(mIFD, "StripOffsets", isBigTIFF());
+    addChunkEntry(mIFD, "StripByteCounts", isBigTIFF());
     for (sys::Uint32_T i = 0; i < stripsPerImage - 1; ++i)
     {
-        mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
-        mIFD.addEntryValue("StripByteCounts", (sys::Uint32_T) stripByteCount);
+        addChunkValue(mIFD, "StripOffsets", offset);
+        addChunkValue(mIFD, "StripByteCounts", stripByteCount);
         offset += stripByteCount;
     }
 
     // Add the last offset.
-    mIFD.addEntryValue("StripOffsets", (sys::Uint32_T) offset);
+    addChunkValue(mIFD, "StripOffsets", offset);
 
     // The last byte count can be less than the previous counts.  This occurs
     // (for example) if RowsPerStrip is even, and ImageLength is odd.
-    sys::Uint32_T remainingBytes = mIFD.getImageSize() - ((stripsPerImage - 1)
-            * stripByteCount);
+    const sys::Uint64_T remainingBytes = mIFD.getImageSize() -
+            (static_cast<sys::Uint64_T>(stripsPerImage - 1) * stripByteCount);
 
     // Add the last byteCount.
-    mIFD.addEntryValue("StripByteCounts", remainingBytes);
+    addChunkValue(mIFD, "StripByteCounts", remainingBytes);
     mStripByteCounts = mIFD["StripByteCounts"];
 }
 
@@ -330,7 +481,7 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
     // Determine how many bytes were used to pad the right edge.
     const sys::Uint32_T widthPadding = (tileByteWidth * tilesAcross) - imageByteWidth;
     sys::Uint32_T globalReadOffset = 0;
-    sys::Uint32_T tempBytePosition = mBytePosition;
+    sys::Uint64_T tempBytePosition = mBytePosition;
     const sys::Uint32_T numBytesToWrite = numElementsToWrite * mElementSize;
     sys::Uint32_T currentNumBytesRead = 0;
     sys::Uint32_T remainingElementsToWrite = numElementsToWrite;
@@ -345,17 +496,18 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
         }
 
         // Compute the row and tile row.
-        const sys::Uint32_T row = tempBytePosition / imageByteWidth;
+        const auto row = static_cast<sys::Uint32_T>(tempBytePosition / imageByteWidth);
         const sys::Uint32_T tileRow = row / tileElemLength;
 
         // Compute the column and tile column.
-        const sys::Uint32_T column = tempBytePosition - (row * imageByteWidth);
+        const auto column = static_cast<sys::Uint32_T>(tempBytePosition -
+                static_cast<sys::Uint64_T>(row) * imageByteWidth);
         const sys::Uint32_T tileColumn = column / tileByteWidth;
 
         // Compute the 1D tile index from the tile row and tile column.
         const sys::Uint32_T tileIndex = (tileRow * tilesAcross) + tileColumn;
 
-        const sys::Uint32_T tileByteCount = *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[tileIndex];
+        const auto tileByteCount = static_cast<sys::Uint32_T>(getValue(*mTileByteCounts, tileIndex));
 
         const sys::Uint32_T rowInTile = row % tileElemLength;
         sys::Uint32_T paddedBytes = ((tileColumn + 1) / tilesAcross) * widthPadding;
@@ -409,8 +561,8 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
             currentNumBytesRead += numBytesToCopy;
         }
 
-        sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[tileIndex];
-        seekPos += (row % tileElemLength) * tileByteWidth;
+        sys::Uint64_T seekPos = getValue(*mTileOffsets, tileIndex);
+        seekPos += static_cast<sys::Uint64_T>(row % tileElemLength) * tileByteWidth;
         seekPos += (column % tileByteWidth);
         mOutput->seek(seekPos, io::Seekable::START);
         mOutput->write(copyBuffer, copyOffset);
@@ -436,8 +588,8 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
 
             for (sys::Uint32_T i = 0; i < tilesAcross; ++i)
             {
-                sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[startIndex + i];
-                seekPos += paddingStartLine * tileByteWidth;
+                sys::Uint64_T seekPos = getValue(*mTileOffsets, startIndex + i);
+                seekPos += static_cast<sys::Uint64_T>(paddingStartLine) * tileByteWidth;
                 mOutput->seek(seekPos, io::Seekable::START);
                 mOutput->write(padBuffer, paddedLines * tileByteWidth);
             }
@@ -452,8 +604,8 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
         else
         {
             auto lastTileIndex = static_cast<sys::Uint32_T>(mTileOffsets->getValues().size() - 1);
-            sys::Uint32_T seekPos = *(tiff::GenericType<sys::Uint32_T> *)(*mTileOffsets)[lastTileIndex];
-            seekPos += *(tiff::GenericType<sys::Uint32_T> *)(*mTileByteCounts)[lastTileIndex];
+            sys::Uint64_T seekPos = getValue(*mTileOffsets, lastTileIndex);
+            seekPos += getValue(*mTileByteCounts, lastTileIndex);
             mOutput->seek(seekPos, io::Seekable::START);
         }
     }
@@ -462,26 +614,152 @@ void tiff::ImageWriter::putTileData(const unsigned char *buffer,
 void tiff::ImageWriter::putStripData(const unsigned char *buffer,
                                      sys::Uint32_T numElementsToWrite)
 {
-    sys::Uint32_T stripSize = *(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[0];
-    sys::Uint32_T bufferIndex = 0;
+    const sys::Uint64_T stripSize = getValue(*mStripByteCounts, 0);
+    size_t bufferIndex = 0;
 
     while (numElementsToWrite)
     {
-        sys::Uint32_T bytesToWrite = mElementSize * numElementsToWrite;
-        sys::Uint32_T stripIndex = mBytePosition / stripSize;
-        sys::Uint32_T stripPosition = mBytePosition % stripSize;
+        sys::Uint64_T bytesToWrite = static_cast<sys::Uint64_T>(mElementSize) * numElementsToWrite;
+        const sys::Uint64_T stripIndex = mBytePosition / stripSize;
+        const sys::Uint64_T stripPosition = mBytePosition % stripSize;
 
         // Calculate what remains to be written in the current strip.
-        sys::Uint32_T remainingBytesInStrip =
-                (*(tiff::GenericType<sys::Uint32_T> *)(*mStripByteCounts)[stripIndex]) - stripPosition;
+        const sys::Uint64_T remainingBytesInStrip =
+                getValue(*mStripByteCounts, static_cast<size_t>(stripIndex)) - stripPosition;
 
         if (bytesToWrite > remainingBytesInStrip)
             bytesToWrite = remainingBytesInStrip;
 
-        mOutput->write((sys::byte *)buffer + bufferIndex, bytesToWrite);
-        bufferIndex += bytesToWrite;
+        mOutput->write((sys::byte *)buffer + bufferIndex, static_cast<size_t>(bytesToWrite));
+        bufferIndex += static_cast<size_t>(bytesToWrite);
 
-        numElementsToWrite -= (bytesToWrite / mElementSize);
+        numElementsToWrite -= static_cast<sys::Uint32_T>(bytesToWrite / mElementSize);
         mBytePosition += bytesToWrite;
     }
 }
+
+void tiff::ImageWriter::initCompression()
+{
+    const sys::Uint32_T imageWidth = mIFD.getImageWidth();
+    if (mFormat == TILED)
+    {
+        mChunkWidth = *(tiff::GenericType<sys::Uint32_T> *)(*mTileWidth)[0];
+        mChunkLength = *(tiff::GenericType<sys::Uint32_T> *)(*mTileLength)[0];
+        mChunksAcross = (imageWidth + mChunkWidth - 1) / mChunkWidth;
+        mChunkOffsets = mTileOffsets;
+        mChunkByteCounts = mTileByteCounts;
+    }
+    else
+    {
+        mChunkWidth = imageWidth;
+        mChunkLength = *(tiff::GenericType<sys::Uint32_T> *)(*mIFD["RowsPerStrip"])[0];
+        mChunksAcross = 1;
+        mChunkOffsets = mIFD["StripOffsets"];
+        mChunkByteCounts = mStripByteCounts;
+    }
+
+    // Strips and tiles are written one after another as they're compressed,
+    // starting where the uncompressed data would have
+    mNextChunkOffset = getValue(*mChunkOffsets, 0);
+
+    mBytesPerSample = 1;
+    if (tiff::IFDEntry *bitsPerSample = mIFD["BitsPerSample"])
+        mBytesPerSample = std::max(*(tiff::GenericType<unsigned short> *)(*bitsPerSample)[0] / 8, 1);
+    mSamplesPerPixel = std::max<size_t>(mElementSize / mBytesPerSample, 1);
+
+    // Buffer enough rows to give every thread a strip or tile
+    const size_t chunkRowsPerBand = std::max<size_t>(
+            math::ceilingDivide(mNumThreads, mChunksAcross), 1);
+    const sys::Uint32_T bandRows = std::min(
+            static_cast<sys::Uint32_T>(chunkRowsPerBand * mChunkLength),
+            mIFD.getImageLength());
+    mBandTop = 0;
+    mBand.assign(static_cast<size_t>(bandRows) * imageWidth * mElementSize, 0);
+}
+
+void tiff::ImageWriter::putCompressedData(const unsigned char *buffer,
+                                          sys::Uint32_T numElementsToWrite)
+{
+    const size_t imageRowBytes = static_cast<size_t>(mIFD.getImageWidth()) * mElementSize;
+    size_t numBytesToWrite = static_cast<size_t>(numElementsToWrite) * mElementSize;
+    while (numBytesToWrite)
+    {
+        if (mBand.empty())
+            throw except::Exception(Ctxt("Tried to write past the end of the image"));
+
+        const size_t bandOffset = static_cast<size_t>(mBytePosition - mBandTop * imageRowBytes);
+        const size_t thisWrite = std::min(numBytesToWrite, mBand.size() - bandOffset);
+        ::memcpy(mBand.data() + bandOffset, buffer, thisWrite);
+
+        buffer += thisWrite;
+        numBytesToWrite -= thisWrite;
+        mBytePosition += thisWrite;
+
+        if (bandOffset + thisWrite == mBand.size())
+            flushBand();
+    }
+}
+
+void tiff::ImageWriter::flushBand()
+{
+    const sys::Uint32_T imageWidth = mIFD.getImageWidth();
+    const sys::Uint32_T imageLength = mIFD.getImageLength();
+    const size_t imageRowBytes = static_cast<size_t>(imageWidth) * mElementSize;
+    const size_t chunkRowBytes = static_cast<size_t>(mChunkWidth) * mElementSize;
+    const sys::Uint32_T bandRows = static_cast<sys::Uint32_T>(mBand.size() / imageRowBytes);
+    const sys::Uint32_T chunkRowsInBand = (bandRows + mChunkLength - 1) / mChunkLength;
+    const size_t numChunks = static_cast<size_t>(chunkRowsInBand) * mChunksAcross;
+
+    std::vector<std::vector<unsigned char> > encoded(numChunks);
+    const auto encodeChunk = [&](size_t ii)
+    {
+        const sys::Uint32_T chunkRow = static_cast<sys::Uint32_T>(ii / mChunksAcross);
+        const sys::Uint32_T chunkCol = static_cast<sys::Uint32_T>(ii % mChunksAcross);
+        const sys::Uint32_T top = chunkRow * mChunkLength;
+        const sys::Uint32_T left = chunkCol * mChunkWidth;
+
+        // Tiles are always whole (zero padded); the last strip is short
+        const sys::Uint32_T dataRows = std::min(mChunkLength, bandRows - top);
+        const sys::Uint32_T numRows = mFormat == TILED ? mChunkLength : dataRows;
+        const size_t dataBytes =
+                static_cast<size_t>(std::min(mChunkWidth, imageWidth - left)) * mElementSize;
+
+        std::vector<unsigned char> raw(numRows * chunkRowBytes, 0);
+        for (sys::Uint32_T row = 0; row < dataRows; ++row)
+        {
+            ::memcpy(raw.data() + row * chunkRowBytes,
+                     mBand.data() + (top + row) * imageRowBytes + left * mElementSize,
+                     dataBytes);
+        }
+        tiff::applyPredictor(mPredictor, raw.data(), numRows, chunkRowBytes,
+                             mBytesPerSample, mSamplesPerPixel);
+        mCodec->encode(raw.data(), numRows, chunkRowBytes, encoded[ii]);
+    };
+    if (mNumThreads > 1 && numChunks > 1)
+    {
+        mt::parallel_for(numChunks, encodeChunk,
+                         math::ceilingDivide(numChunks, mNumThreads));
+    }
+    else
+    {
+        for (size_t ii = 0; ii < numChunks; ++ii)
+            encodeChunk(ii);
+    }
+
+    // Write them out in order
+    const size_t firstChunk = static_cast<size_t>(mBandTop / mChunkLength) * mChunksAcross;
+    mOutput->seek(mNextChunkOffset, io::Seekable::START);
+    for (size_t ii = 0; ii < numChunks; ++ii)
+    {
+        const auto numBytes = encoded[ii].size();
+        mOutput->write(encoded[ii].data(), numBytes);
+        setValue(*mChunkOffsets, firstChunk + ii, mNextChunkOffset);
+        setValue(*mChunkByteCounts, firstChunk + ii, numBytes);
+        mNextChunkOffset += numBytes;
+    }
+
+    // Start the next band
+    mBandTop += bandRows;
+    const sys::Uint32_T nextRows = std::min(bandRows, imageLength - mBandTop);
+    mBand.assign(static_cast<size_t>(nextRows) * imageRowBytes, 0);
+}
@@ -31,9 +31,10 @@
 #include "tiff/IFD.h"
 
 
-void tiff::FileReader::openFile(const std::string& fileName)
+void tiff::FileReader::openFile(const std::string& fileName, bool memoryMap,
+                                int mapFlags)
 {
-    if (mInput.isOpen())
+    if (mInput.isOpen() || mMapInput.isOpen())
         throw except::Exception(Ctxt("Last file not closed; call close() first."));
 
     if (fileName == "-")
@@ -42,32 +43,71 @@ void tiff::FileReader::openFile(const std::string& fileName)
     if (fileName == "")
         throw except::Exception(Ctxt("No file name provided"));
 
-    mInput.create(fileName.c_str());
-    if (!mInput.isOpen())
-        throw except::Exception(Ctxt("File was not opened"));
+    io::SeekableInputStream* input = &mInput;
+    if (memoryMap)
+    {
+        mMapInput.open(fileName, mapFlags);
+        input = &mMapInput;
+    }
+    else
+    {
+        mInput.create(fileName.c_str());
+        if (!mInput.isOpen())
+            throw except::Exception(Ctxt("File was not opened"));
+    }
 
     // Read TIFF header from input
-    mHeader.deserialize(mInput);
+    mHeader.deserialize(*input);
     
     mReverseBytes = mHeader.isDifferentByteOrdering();
-    sys::Uint32_T offset = mHeader.getIFDOffset();
+    sys::Uint64_T offset = mHeader.getIFDOffset();
     while (offset != 0)
     {
-        tiff::ImageReader *imageReader = new tiff::ImageReader(&mInput);
-
-        mInput.seek(offset, io::Seekable::START);
-        imageReader->process(mReverseBytes);
+        tiff::ImageReader *imageReader = memoryMap ?
+                new tiff::ImageReader(&mMapInput) :
+                new tiff::ImageReader(&mInput);
         mImages.push_back(imageReader);
 
+        input->seek(offset, io::Seekable::START);
+        imageReader->process(mReverseBytes, mHeader.isBigTIFF());
+
         offset = imageReader->getNextOffset();
     }
+
+    mFileName = fileName;
+    openAsyncReader();
+}
+
+void tiff::FileReader::setReadAhead(size_t readAhead)
+{
+    mReadAhead = readAhead;
+    if (!mFileName.empty())
+        openAsyncReader();
+}
+
+void tiff::FileReader::openAsyncReader()
+{
+    for (auto image : mImages)
+        image->setAsyncReader(nullptr, 0);
+    mAsyncReader.reset();
+
+    if (mReadAhead == 0)
+        return;
+
+    mAsyncReader.reset(new io::AsyncFileReader(mFileName,
+            io::AsyncFileReader::AUTO, mReadAhead));
+    for (auto image : mImages)
+        image->setAsyncReader(mAsyncReader.get(), mReadAhead);
 }
 
 void tiff::FileReader::close()
 {
     mHeader = tiff::Header{};
 
+    mAsyncReader.reset();
+    mFileName.clear();
     mInput.close();
+    mMapInput.close();
 
     std::vector<tiff::ImageReader *>::iterator readIter;
     for (readIter = mImages.begin(); readIter != mImages.end(); ++readIter)
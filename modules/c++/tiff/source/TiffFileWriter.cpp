@@ -95,18 +95,26 @@ tiff::ImageWriter *tiff::FileWriter::addImage()
     if (!mImages.empty())
         mIFDOffset = mImages.back()->getNextIFDOffset();
 
-    auto image = std::make_unique<tiff::ImageWriter>(&mOutput, mIFDOffset);
+    auto image = std::make_unique<tiff::ImageWriter>(&mOutput, mIFDOffset, &mHeader);
     mImages.push_back(image.get());
     tiff::ImageWriter* const writer = image.release();
 
     return writer;
 }
 
+void tiff::FileWriter::setBigTIFF(bool bigTIFF)
+{
+    if (mOutput.isOpen() && mOutput.tell() != 0)
+        throw except::Exception(Ctxt("The TIFF header has already been written"));
+
+    mHeader.setBigTIFF(bigTIFF);
+}
+
 void tiff::FileWriter::writeHeader()
 {
     mHeader.serialize(mOutput);
 
     // Have to rewind a few bytes to write out the actual IFD offset.
-    mIFDOffset = static_cast <sys::Uint32_T>(mOutput.tell());
-    mIFDOffset -= (int)sizeof(sys::Uint32_T);
+    mIFDOffset = static_cast<sys::Uint64_T>(mOutput.tell());
+    mIFDOffset -= mHeader.getOffsetSize();
 }
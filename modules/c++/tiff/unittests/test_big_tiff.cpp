@@ -0,0 +1,194 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <import/tiff.h>
+#include <io/TempFile.h>
+
+static std::vector<uint16_t> makeImage(size_t numRows, size_t numCols, size_t seed)
+{
+    std::vector<uint16_t> image(numRows * numCols);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<uint16_t>((ii + seed) * 2654435761u >> 20);
+    }
+    return image;
+}
+
+static tiff::ImageWriter* addImage(tiff::FileWriter& fileWriter, size_t numRows, size_t numCols,
+                                   bool tiled, unsigned short compression)
+{
+    tiff::ImageWriter* imageWriter = fileWriter.addImage();
+    if (tiled)
+    {
+        imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+        imageWriter->setIdealChunkSize(16 * 16 * sizeof(uint16_t));
+    }
+    else
+    {
+        imageWriter->setIdealChunkSize(300);
+    }
+
+    tiff::IFD* ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, static_cast<sys::Uint32_T>(numCols));
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, static_cast<sys::Uint32_T>(numRows));
+    ifd->addEntry(tiff::KnownTags::COMPRESSION, compression);
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
+    unsigned short bitsPerSample = 16;
+    (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE]->addValue(tiff::TypeFactory::create(
+            reinterpret_cast<unsigned char*>(&bitsPerSample), tiff::Const::Type::SHORT));
+    ifd->addEntry("ImageDescription");
+    (*ifd)["ImageDescription"]->addValues("big tiff");
+    return imageWriter;
+}
+
+static void putImage(tiff::ImageWriter& imageWriter, const std::vector<uint16_t>& image)
+{
+    imageWriter.putData(reinterpret_cast<const unsigned char*>(image.data()),
+                        static_cast<sys::Uint32_T>(image.size()));
+    imageWriter.writeIFD();
+}
+
+// 42 for classic TIFF, 43 for BigTIFF, in either byte order
+static int getVersion(const std::string& pathname)
+{
+    std::ifstream in(pathname, std::ios::binary);
+    unsigned char header[4] = {};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    return header[2] | header[3];
+}
+
+static void checkImage(const std::string& testName, const tiff::FileReader& reader,
+                       size_t index, const std::vector<uint16_t>& expected)
+{
+    tiff::ImageReader* const imageReader = reader[static_cast<sys::Uint32_T>(index)];
+    std::vector<uint16_t> image(expected.size());
+    imageReader->getData(reinterpret_cast<unsigned char*>(image.data()),
+                         static_cast<sys::Uint32_T>(image.size()));
+    TEST_ASSERT(image == expected);
+
+    const tiff::IFDEntry* const description = (*imageReader->getIFD())["ImageDescription"];
+    TEST_ASSERT_NOT_NULL(description);
+}
+
+TEST_CASE(testBigTIFFRoundTrip)
+{
+    const io::TempFile tempFile;
+    const auto first = makeImage(70, 90, 1);
+    const auto second = makeImage(33, 17, 2);
+    for (const unsigned short compression : { tiff::Const::CompressionType::NO_COMPRESSION,
+                                              tiff::Const::CompressionType::LZW })
+    {
+        for (const bool tiled : { false, true })
+        {
+            {
+                tiff::FileWriter fileWriter(tempFile.pathname());
+                fileWriter.setBigTIFF(true);
+                fileWriter.writeHeader();
+                TEST_EXCEPTION(fileWriter.setBigTIFF(false));
+                TEST_ASSERT(fileWriter.isBigTIFF());
+
+                tiff::ImageWriter* imageWriter = addImage(fileWriter, 70, 90, tiled, compression);
+                TEST_ASSERT(imageWriter->isBigTIFF());
+                putImage(*imageWriter, first);
+                imageWriter = addImage(fileWriter, 33, 17, !tiled, compression);
+                putImage(*imageWriter, second);
+                fileWriter.close();
+            }
+            TEST_ASSERT_EQ(getVersion(tempFile.pathname()), 43);
+
+            for (const bool memoryMap : { false, true })
+            {
+                const tiff::FileReader reader(tempFile.pathname(), memoryMap);
+                TEST_ASSERT_EQ(reader.getImageCount(), static_cast<sys::Uint32_T>(2));
+                checkImage(testName, reader, 0, first);
+                checkImage(testName, reader, 1, second);
+            }
+        }
+    }
+}
+
+TEST_CASE(testAutoBigTIFF)
+{
+    const io::TempFile tempFile;
+    const auto image = makeImage(100, 100, 3);
+    for (const bool tiled : { false, true })
+    {
+        {
+            // 20000 bytes of pixels can't be a classic TIFF of at most 10000
+            tiff::FileWriter fileWriter(tempFile.pathname());
+            fileWriter.writeHeader();
+            tiff::ImageWriter* const imageWriter = addImage(fileWriter, 100, 100, tiled,
+                    tiff::Const::CompressionType::NO_COMPRESSION);
+            imageWriter->setMaxClassicSize(10000);
+            TEST_ASSERT_FALSE(fileWriter.isBigTIFF());
+            putImage(*imageWriter, image);
+            TEST_ASSERT(fileWriter.isBigTIFF());
+            TEST_ASSERT(imageWriter->isBigTIFF());
+            fileWriter.close();
+        }
+        TEST_ASSERT_EQ(getVersion(tempFile.pathname()), 43);
+
+        const tiff::FileReader reader(tempFile.pathname());
+        TEST_ASSERT_EQ(reader.getImageCount(), static_cast<sys::Uint32_T>(1));
+        checkImage(testName, reader, 0, image);
+    }
+}
+
+TEST_CASE(testClassicTIFF)
+{
+    const io::TempFile tempFile;
+    const auto image = makeImage(100, 100, 4);
+    {
+        // Under the limit, it stays classic
+        tiff::FileWriter fileWriter(tempFile.pathname());
+        fileWriter.writeHeader();
+        tiff::ImageWriter* imageWriter = addImage(fileWriter, 100, 100, false,
+                tiff::Const::CompressionType::NO_COMPRESSION);
+        imageWriter->setMaxClassicSize(100000);
+        putImage(*imageWriter, image);
+        TEST_ASSERT_FALSE(fileWriter.isBigTIFF());
+
+        // Too late to switch once there's data after the header
+        imageWriter = addImage(fileWriter, 100, 100, false,
+                tiff::Const::CompressionType::NO_COMPRESSION);
+        imageWriter->setMaxClassicSize(30000);
+        TEST_EXCEPTION(putImage(*imageWriter, image));
+        TEST_ASSERT_FALSE(fileWriter.isBigTIFF());
+    }
+    TEST_ASSERT_EQ(getVersion(tempFile.pathname()), 42);
+}
+
+TEST_MAIN(
+    TEST_CHECK(testBigTIFFRoundTrip);
+    TEST_CHECK(testAutoBigTIFF);
+    TEST_CHECK(testClassicTIFF);
+    )
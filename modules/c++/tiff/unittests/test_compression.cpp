@@ -0,0 +1,431 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <import/tiff.h>
+#include <io/TempFile.h>
+#include <tiff/Compression.h>
+
+using Bytes = std::vector<unsigned char>;
+
+static Bytes roundTrip(const tiff::Codec& codec, const Bytes& data, size_t numRows = 1)
+{
+    Bytes encoded;
+    codec.encode(data.data(), numRows, data.size() / numRows, encoded);
+    Bytes decoded(data.size());
+    codec.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+    return decoded;
+}
+
+static Bytes randomBytes(size_t size, unsigned alphabet, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    Bytes bytes(size);
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<unsigned char>(generator() % alphabet);
+    }
+    return bytes;
+}
+
+TEST_CASE(testLZWKnownAnswer)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::LZW);
+
+    // Clear, 'A', 'B', EOI as 9-bit codes
+    const Bytes data{ 'A', 'B' };
+    Bytes encoded;
+    codec->encode(data.data(), 1, data.size(), encoded);
+    const Bytes expected{ 0x80, 0x10, 0x48, 0x50, 0x10 };
+    TEST_ASSERT(encoded == expected);
+
+    Bytes decoded(2);
+    codec->decode(expected.data(), expected.size(), decoded.data(), decoded.size());
+    TEST_ASSERT(decoded == data);
+
+    // Nothing at all is still a clear and an EOI
+    codec->encode(nullptr, 0, 0, encoded);
+    TEST_ASSERT_FALSE(encoded.empty());
+    TEST_ASSERT_EQ(encoded[0], 0x80);
+}
+
+TEST_CASE(testLZWCodeWidths)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::LZW);
+
+    // Random bytes add about one code per byte, so this walks each change of
+    // code width (and the first table reset) one code at a time
+    const Bytes data = randomBytes(5000, 256, 5);
+    for (size_t size = 0; size <= data.size(); ++size)
+    {
+        const Bytes expected(data.begin(), data.begin() + size);
+        const Bytes decoded = roundTrip(*codec, expected);
+        TEST_ASSERT(decoded == expected);
+    }
+}
+
+TEST_CASE(testLZWTableReset)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::LZW);
+
+    // Enough codes for many resets, with both long and short strings
+    for (const unsigned alphabet : { 2u, 3u, 17u, 256u })
+    {
+        const Bytes data = randomBytes(300000, alphabet, alphabet);
+        const Bytes decoded = roundTrip(*codec, data);
+        TEST_ASSERT(decoded == data);
+    }
+
+    // A single byte repeated makes the decoder see codes it's still defining
+    for (const size_t size : { 1, 2, 3, 4, 100, 10000, 100000 })
+    {
+        const Bytes data(size, 0x42);
+        const Bytes decoded = roundTrip(*codec, data);
+        TEST_ASSERT(decoded == data);
+    }
+}
+
+TEST_CASE(testLZWCorrupt)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::LZW);
+
+    // Clear, then code 300, which hasn't been defined
+    const Bytes corrupt{ 0x80, 0x4B, 0x00, 0x00 };
+    Bytes decoded(16);
+    TEST_EXCEPTION(codec->decode(corrupt.data(), corrupt.size(), decoded.data(), decoded.size()));
+
+    // Short data leaves the rest zeroed
+    const Bytes data = randomBytes(1000, 256, 7);
+    Bytes encoded;
+    codec->encode(data.data(), 1, data.size(), encoded);
+    decoded.assign(data.size() + 50, 0xFF);
+    codec->decode(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+    TEST_ASSERT(Bytes(decoded.begin(), decoded.begin() + data.size()) == data);
+    TEST_ASSERT(Bytes(decoded.begin() + data.size(), decoded.end()) == Bytes(50, 0));
+}
+
+TEST_CASE(testPackBitsKnownAnswer)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::PACK_BITS);
+
+    // The example from the TIFF 6.0 specification
+    const Bytes packed{ 0xFE, 0xAA, 0x02, 0x80, 0x00, 0x2A, 0xFD, 0xAA,
+                        0x03, 0x80, 0x00, 0x2A, 0x22, 0xF7, 0xAA };
+    const Bytes unpacked{ 0xAA, 0xAA, 0xAA, 0x80, 0x00, 0x2A, 0xAA, 0xAA,
+                          0xAA, 0xAA, 0x80, 0x00, 0x2A, 0x22, 0xAA, 0xAA,
+                          0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA };
+    Bytes decoded(unpacked.size());
+    codec->decode(packed.data(), packed.size(), decoded.data(), decoded.size());
+    TEST_ASSERT(decoded == unpacked);
+
+    TEST_ASSERT(roundTrip(*codec, unpacked) == unpacked);
+
+    // -128 is a no-op
+    const Bytes noOp{ 0x80, 0x01, 0x07, 0x08 };
+    decoded.assign(2, 0);
+    codec->decode(noOp.data(), noOp.size(), decoded.data(), decoded.size());
+    TEST_ASSERT(decoded == Bytes({ 0x07, 0x08 }));
+}
+
+TEST_CASE(testPackBitsBoundaries)
+{
+    const auto codec = tiff::createCodec(tiff::Const::CompressionType::PACK_BITS);
+
+    // Literals and runs either side of the 128 byte limit, in every order
+    const size_t sizes[] = { 0, 1, 2, 3, 127, 128, 129, 130, 255, 256, 257 };
+    for (const size_t literalSize : sizes)
+    {
+        for (const size_t runSize : sizes)
+        {
+            Bytes data;
+            for (size_t ii = 0; ii < literalSize; ++ii)
+            {
+                data.push_back(static_cast<unsigned char>(ii * 7 + 1));
+            }
+            data.insert(data.end(), runSize, 0);
+            TEST_ASSERT(roundTrip(*codec, data) == data);
+
+            Bytes reversed(data.rbegin(), data.rend());
+            TEST_ASSERT(roundTrip(*codec, reversed) == reversed);
+        }
+    }
+
+    // Rows are packed separately, so runs mustn't span them
+    const Bytes rows(4 * 200, 0x11);
+    TEST_ASSERT(roundTrip(*codec, rows, 4) == rows);
+    Bytes encoded;
+    codec->encode(rows.data(), 4, 200, encoded);
+    TEST_ASSERT_EQ(encoded.size(), 4 * 4);
+
+    // Random runs of random lengths
+    std::mt19937 generator(11);
+    Bytes data;
+    while (data.size() < 100000)
+    {
+        data.insert(data.end(), generator() % 300 + 1,
+                    static_cast<unsigned char>(generator() % 4));
+    }
+    TEST_ASSERT(roundTrip(*codec, data) == data);
+}
+
+TEST_CASE(testDeflate)
+{
+    if (!tiff::isCodecSupported(tiff::Const::CompressionType::DEFLATE))
+    {
+        TEST_EXCEPTION(tiff::createCodec(tiff::Const::CompressionType::DEFLATE));
+        return;
+    }
+
+    for (const unsigned short compression : { tiff::Const::CompressionType::DEFLATE,
+                                              tiff::Const::CompressionType::PKZIP_DEFLATE })
+    {
+        const auto codec = tiff::createCodec(compression);
+        const Bytes data = randomBytes(100000, 5, 13);
+        TEST_ASSERT(roundTrip(*codec, data) == data);
+        TEST_ASSERT(roundTrip(*codec, Bytes()) == Bytes());
+    }
+}
+
+TEST_CASE(testUnsupportedCodec)
+{
+    TEST_ASSERT_FALSE(tiff::isCodecSupported(tiff::Const::CompressionType::NO_COMPRESSION));
+    TEST_ASSERT_FALSE(tiff::isCodecSupported(tiff::Const::CompressionType::JPEG));
+    TEST_EXCEPTION(tiff::createCodec(tiff::Const::CompressionType::JPEG));
+
+    TEST_ASSERT(tiff::usesPredictor(tiff::Const::CompressionType::LZW));
+    TEST_ASSERT_FALSE(tiff::usesPredictor(tiff::Const::CompressionType::PACK_BITS));
+}
+
+TEST_CASE(testHorizontalPredictor)
+{
+    const auto predictor = tiff::Const::PredictorType::HORIZONTAL;
+
+    // Each sample is the difference from the one before it in the row
+    Bytes data{ 10, 12, 15, 15, 9,
+                200, 100, 0, 255, 255 };
+    tiff::applyPredictor(predictor, data.data(), 2, 5, 1, 1);
+    TEST_ASSERT(data == Bytes({ 10, 2, 3, 0, 250,
+                                200, 156, 156, 255, 0 }));
+    tiff::removePredictor(predictor, data.data(), 2, 5, 1, 1);
+    TEST_ASSERT(data == Bytes({ 10, 12, 15, 15, 9,
+                                200, 100, 0, 255, 255 }));
+
+    // ... or from the same band of the pixel before it
+    Bytes rgb{ 1, 2, 3, 4, 6, 8 };
+    tiff::applyPredictor(predictor, rgb.data(), 1, 6, 1, 3);
+    TEST_ASSERT(rgb == Bytes({ 1, 2, 3, 3, 4, 5 }));
+
+    std::vector<uint16_t> samples{ 1000, 999, 65535, 0 };
+    tiff::applyPredictor(predictor, reinterpret_cast<unsigned char*>(samples.data()),
+                         1, 8, 2, 1);
+    TEST_ASSERT(samples == std::vector<uint16_t>({ 1000, 65535, 64536, 1 }));
+
+    for (const size_t bytesPerSample : { 1, 2, 4, 8 })
+    {
+        for (const size_t samplesPerPixel : { 1, 3 })
+        {
+            const size_t rowBytes = 37 * bytesPerSample * samplesPerPixel;
+            const Bytes expected = randomBytes(rowBytes * 5, 256, 17);
+            Bytes predicted = expected;
+            tiff::applyPredictor(predictor, predicted.data(), 5, rowBytes,
+                                 bytesPerSample, samplesPerPixel);
+            TEST_ASSERT(predicted != expected);
+            tiff::removePredictor(predictor, predicted.data(), 5, rowBytes,
+                                  bytesPerSample, samplesPerPixel);
+            TEST_ASSERT(predicted == expected);
+        }
+    }
+
+    // NONE leaves the data alone
+    Bytes untouched(10, 3);
+    tiff::applyPredictor(tiff::Const::PredictorType::NONE, untouched.data(), 1, 10, 1, 1);
+    TEST_ASSERT(untouched == Bytes(10, 3));
+}
+
+template <typename T>
+static void testFloatingPointPredictor(const std::string& testName)
+{
+    const auto predictor = tiff::Const::PredictorType::FLOATING_POINT;
+    const size_t numRows = 6;
+    const size_t numCols = 41;
+    std::vector<T> expected(numRows * numCols);
+    for (size_t ii = 0; ii < expected.size(); ++ii)
+    {
+        expected[ii] = static_cast<T>(ii % numCols) * static_cast<T>(0.37) -
+                static_cast<T>(ii / numCols);
+    }
+    expected[3] = std::numeric_limits<T>::infinity();
+    expected[4] = -std::numeric_limits<T>::max();
+    expected[5] = std::numeric_limits<T>::denorm_min();
+    expected[6] = -static_cast<T>(0);
+
+    const size_t rowBytes = numCols * sizeof(T);
+    std::vector<T> data = expected;
+    auto bytes = reinterpret_cast<unsigned char*>(data.data());
+    tiff::applyPredictor(predictor, bytes, numRows, rowBytes, sizeof(T), 1);
+    TEST_ASSERT(::memcmp(data.data(), expected.data(), rowBytes * numRows) != 0);
+    tiff::removePredictor(predictor, bytes, numRows, rowBytes, sizeof(T), 1);
+    TEST_ASSERT(::memcmp(data.data(), expected.data(), rowBytes * numRows) == 0);
+}
+TEST_CASE(testFloatingPointPredictor)
+{
+    testFloatingPointPredictor<float>(testName);
+    testFloatingPointPredictor<double>(testName);
+}
+
+template <typename T>
+static void writeImage(const std::string& pathname, const std::vector<T>& data,
+                       size_t numRows, size_t numCols, bool tiled,
+                       unsigned short compression, unsigned short predictor,
+                       unsigned short sampleFormat, size_t numThreads)
+{
+    tiff::FileWriter fileWriter(pathname);
+    fileWriter.writeHeader();
+    tiff::ImageWriter* imageWriter = fileWriter.addImage();
+    if (tiled)
+    {
+        imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+        imageWriter->setIdealChunkSize(16 * 16 * sizeof(T));
+    }
+    else
+    {
+        imageWriter->setIdealChunkSize(300);
+    }
+    imageWriter->setNumThreads(numThreads);
+
+    tiff::IFD* ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, static_cast<sys::Uint32_T>(numCols));
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, static_cast<sys::Uint32_T>(numRows));
+    ifd->addEntry(tiff::KnownTags::COMPRESSION, compression);
+    if (predictor != tiff::Const::PredictorType::NONE)
+    {
+        ifd->addEntry(tiff::KnownTags::PREDICTOR, predictor);
+    }
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
+    ifd->addEntry(tiff::KnownTags::SAMPLE_FORMAT);
+    unsigned short bitsPerSample = sizeof(T) * 8;
+    (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE]->addValue(tiff::TypeFactory::create(
+            reinterpret_cast<unsigned char*>(&bitsPerSample), tiff::Const::Type::SHORT));
+    (*ifd)[tiff::KnownTags::SAMPLE_FORMAT]->addValue(tiff::TypeFactory::create(
+            reinterpret_cast<unsigned char*>(&sampleFormat), tiff::Const::Type::SHORT));
+
+    // In pieces that don't line up with strips or tiles
+    const size_t split = numCols * 7 + 3;
+    imageWriter->putData(reinterpret_cast<const unsigned char*>(data.data()),
+                         static_cast<sys::Uint32_T>(split));
+    imageWriter->putData(reinterpret_cast<const unsigned char*>(data.data() + split),
+                         static_cast<sys::Uint32_T>(data.size() - split));
+    imageWriter->writeIFD();
+    fileWriter.close();
+}
+
+template <typename T>
+static void testImageRoundTrip(const std::string& testName, unsigned short sampleFormat,
+                               unsigned short predictor)
+{
+    const size_t numRows = 70;
+    const size_t numCols = 90;
+    std::vector<T> expected(numRows * numCols);
+    std::mt19937 generator(3);
+    for (size_t ii = 0; ii < expected.size(); ++ii)
+    {
+        const size_t row = ii / numCols;
+        const size_t col = ii % numCols;
+        expected[ii] = sampleFormat == tiff::Const::SampleFormatType::IEEE_FLOAT ?
+                static_cast<T>(col * 0.5 + row * 0.25) :
+                static_cast<T>(col / 3 + row + generator() % 5);
+    }
+
+    const io::TempFile tempFile;
+    for (const unsigned short compression : { tiff::Const::CompressionType::LZW,
+                                              tiff::Const::CompressionType::DEFLATE,
+                                              tiff::Const::CompressionType::PACK_BITS })
+    {
+        if (!tiff::isCodecSupported(compression) ||
+            (predictor != tiff::Const::PredictorType::NONE && !tiff::usesPredictor(compression)))
+        {
+            continue;
+        }
+        for (const bool tiled : { false, true })
+        {
+            for (const size_t numThreads : { 1, 4 })
+            {
+                writeImage(tempFile.pathname(), expected, numRows, numCols, tiled,
+                           compression, predictor, sampleFormat, numThreads);
+                for (const bool memoryMap : { false, true })
+                {
+                    tiff::FileReader reader(tempFile.pathname(), memoryMap);
+                    reader[0]->setNumThreads(numThreads);
+
+                    // Also in pieces that don't line up
+                    std::vector<T> data(expected.size());
+                    const size_t split = numCols * 10 + 5;
+                    reader.getData(reinterpret_cast<unsigned char*>(data.data()),
+                                   static_cast<sys::Uint32_T>(split));
+                    reader.getData(reinterpret_cast<unsigned char*>(data.data() + split),
+                                   static_cast<sys::Uint32_T>(data.size() - split));
+                    TEST_ASSERT(data == expected);
+                }
+            }
+        }
+    }
+}
+TEST_CASE(testImageRoundTrip)
+{
+    testImageRoundTrip<uint8_t>(testName, tiff::Const::SampleFormatType::UNSIGNED_INT,
+                                tiff::Const::PredictorType::NONE);
+    testImageRoundTrip<uint8_t>(testName, tiff::Const::SampleFormatType::UNSIGNED_INT,
+                                tiff::Const::PredictorType::HORIZONTAL);
+    testImageRoundTrip<uint16_t>(testName, tiff::Const::SampleFormatType::UNSIGNED_INT,
+                                 tiff::Const::PredictorType::HORIZONTAL);
+    testImageRoundTrip<uint32_t>(testName, tiff::Const::SampleFormatType::UNSIGNED_INT,
+                                 tiff::Const::PredictorType::HORIZONTAL);
+    testImageRoundTrip<float>(testName, tiff::Const::SampleFormatType::IEEE_FLOAT,
+                              tiff::Const::PredictorType::FLOATING_POINT);
+    testImageRoundTrip<double>(testName, tiff::Const::SampleFormatType::IEEE_FLOAT,
+                               tiff::Const::PredictorType::FLOATING_POINT);
+}
+
+TEST_MAIN(
+    TEST_CHECK(testLZWKnownAnswer);
+    TEST_CHECK(testLZWCodeWidths);
+    TEST_CHECK(testLZWTableReset);
+    TEST_CHECK(testLZWCorrupt);
+    TEST_CHECK(testPackBitsKnownAnswer);
+    TEST_CHECK(testPackBitsBoundaries);
+    TEST_CHECK(testDeflate);
+    TEST_CHECK(testUnsupportedCodec);
+    TEST_CHECK(testHorizontalPredictor);
+    TEST_CHECK(testFloatingPointPredictor);
+    TEST_CHECK(testImageRoundTrip);
+    )
@@ -0,0 +1,243 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <import/tiff.h>
+#include <io/TempFile.h>
+
+static const size_t NUM_ROWS = 83;
+static const size_t NUM_COLS = 61;
+static const size_t ROWS_PER_STRIP = 2;
+
+static std::vector<uint16_t> makeImage()
+{
+    std::vector<uint16_t> image(NUM_ROWS * NUM_COLS);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<uint16_t>(ii * 2654435761u >> 16);
+    }
+    return image;
+}
+
+static void writeImage(const std::string& pathname, const std::vector<uint16_t>& image,
+                       bool tiled)
+{
+    tiff::FileWriter fileWriter(pathname);
+    fileWriter.writeHeader();
+    tiff::ImageWriter* imageWriter = fileWriter.addImage();
+    if (tiled)
+    {
+        imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+        imageWriter->setIdealChunkSize(16 * 16 * sizeof(uint16_t));
+    }
+    else
+    {
+        imageWriter->setIdealChunkSize(ROWS_PER_STRIP * NUM_COLS * sizeof(uint16_t));
+    }
+
+    tiff::IFD* ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, static_cast<sys::Uint32_T>(NUM_COLS));
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, static_cast<sys::Uint32_T>(NUM_ROWS));
+    ifd->addEntry(tiff::KnownTags::COMPRESSION,
+                  static_cast<unsigned short>(tiff::Const::CompressionType::NO_COMPRESSION));
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
+    unsigned short bitsPerSample = 16;
+    (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE]->addValue(tiff::TypeFactory::create(
+            reinterpret_cast<unsigned char*>(&bitsPerSample), tiff::Const::Type::SHORT));
+    imageWriter->putData(reinterpret_cast<const unsigned char*>(image.data()),
+                         static_cast<sys::Uint32_T>(image.size()));
+    imageWriter->writeIFD();
+    fileWriter.close();
+}
+
+static void put16(std::vector<unsigned char>& bytes, uint16_t value)
+{
+    bytes.push_back(static_cast<unsigned char>(value >> 8));
+    bytes.push_back(static_cast<unsigned char>(value));
+}
+static void put32(std::vector<unsigned char>& bytes, uint32_t value)
+{
+    put16(bytes, static_cast<uint16_t>(value >> 16));
+    put16(bytes, static_cast<uint16_t>(value));
+}
+static void putEntry(std::vector<unsigned char>& bytes, uint16_t tag, uint16_t type,
+                     uint32_t count, uint32_t value)
+{
+    put16(bytes, tag);
+    put16(bytes, type);
+    put32(bytes, count);
+    if (type == 3 && count == 1)
+    {
+        // SHORT values are left-justified in the value field
+        put16(bytes, static_cast<uint16_t>(value));
+        put16(bytes, 0);
+    }
+    else
+    {
+        put32(bytes, value);
+    }
+}
+
+// A big endian ("MM") strip image, written by hand so the reader has to
+// byte swap it
+static void writeBigEndianImage(const std::string& pathname, const std::vector<uint16_t>& image)
+{
+    const uint32_t numStrips = static_cast<uint32_t>((NUM_ROWS + ROWS_PER_STRIP - 1) / ROWS_PER_STRIP);
+    const uint32_t stripBytes = static_cast<uint32_t>(ROWS_PER_STRIP * NUM_COLS * sizeof(uint16_t));
+    const uint16_t numEntries = 9;
+    const uint32_t ifdOffset = 8;
+    const uint32_t offsetsOffset = ifdOffset + 2 + numEntries * 12 + 4;
+    const uint32_t countsOffset = offsetsOffset + numStrips * 4;
+    const uint32_t dataOffset = countsOffset + numStrips * 4;
+
+    std::vector<unsigned char> bytes{ 'M', 'M' };
+    put16(bytes, 42);
+    put32(bytes, ifdOffset);
+
+    put16(bytes, numEntries);
+    putEntry(bytes, 256, 4, 1, static_cast<uint32_t>(NUM_COLS));    // ImageWidth
+    putEntry(bytes, 257, 4, 1, static_cast<uint32_t>(NUM_ROWS));    // ImageLength
+    putEntry(bytes, 258, 3, 1, 16);                                 // BitsPerSample
+    putEntry(bytes, 259, 3, 1, 1);                                  // Compression
+    putEntry(bytes, 262, 3, 1, 1);                                  // PhotometricInterpretation
+    putEntry(bytes, 273, 4, numStrips, offsetsOffset);              // StripOffsets
+    putEntry(bytes, 277, 3, 1, 1);                                  // SamplesPerPixel
+    putEntry(bytes, 278, 4, 1, static_cast<uint32_t>(ROWS_PER_STRIP)); // RowsPerStrip
+    putEntry(bytes, 279, 4, numStrips, countsOffset);               // StripByteCounts
+    put32(bytes, 0);
+
+    const uint32_t imageBytes = static_cast<uint32_t>(image.size() * sizeof(uint16_t));
+    for (uint32_t strip = 0; strip < numStrips; ++strip)
+    {
+        put32(bytes, dataOffset + strip * stripBytes);
+    }
+    for (uint32_t strip = 0; strip < numStrips; ++strip)
+    {
+        put32(bytes, std::min(stripBytes, imageBytes - strip * stripBytes));
+    }
+    for (const uint16_t pixel : image)
+    {
+        put16(bytes, pixel);
+    }
+
+    std::ofstream out(pathname, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static std::vector<uint16_t> getData(const std::string& pathname, bool memoryMap,
+                                     size_t readAhead, size_t numPieces)
+{
+    tiff::FileReader reader;
+    reader.setReadAhead(readAhead);
+    reader.openFile(pathname, memoryMap);
+
+    // Reading in pieces starts and ends reads in the middle of strips
+    std::vector<uint16_t> image(NUM_ROWS * NUM_COLS);
+    const size_t pieceSize = (image.size() + numPieces - 1) / numPieces;
+    for (size_t start = 0; start < image.size(); start += pieceSize)
+    {
+        const size_t numElements = std::min(pieceSize, image.size() - start);
+        reader.getData(reinterpret_cast<unsigned char*>(image.data() + start),
+                       static_cast<sys::Uint32_T>(numElements));
+    }
+    return image;
+}
+
+static void testReadAhead(const std::string& testName, const std::string& pathname,
+                          const std::vector<uint16_t>& expected)
+{
+    for (const bool memoryMap : { false, true })
+    {
+        const auto synchronous = getData(pathname, memoryMap, 0, 1);
+        TEST_ASSERT(synchronous == expected);
+
+        for (const size_t readAhead : { 1, 3, 64 })
+        {
+            for (const size_t numPieces : { 1, 7 })
+            {
+                TEST_ASSERT(getData(pathname, memoryMap, readAhead, numPieces) == synchronous);
+            }
+        }
+    }
+}
+
+TEST_CASE(testReadAheadStripped)
+{
+    const auto image = makeImage();
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, false /*tiled*/);
+    testReadAhead(testName, tempFile.pathname(), image);
+}
+
+TEST_CASE(testReadAheadTiled)
+{
+    const auto image = makeImage();
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, true /*tiled*/);
+    testReadAhead(testName, tempFile.pathname(), image);
+}
+
+TEST_CASE(testReadAheadSwapped)
+{
+    const auto image = makeImage();
+    const io::TempFile tempFile;
+    writeBigEndianImage(tempFile.pathname(), image);
+    testReadAhead(testName, tempFile.pathname(), image);
+}
+
+TEST_CASE(testReadAheadAfterOpen)
+{
+    const auto image = makeImage();
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, false /*tiled*/);
+
+    // Turning read-ahead on and off partway through keeps the position
+    tiff::FileReader reader(tempFile.pathname());
+    std::vector<uint16_t> data(image.size());
+    const size_t split = data.size() / 3;
+    reader.getData(reinterpret_cast<unsigned char*>(data.data()),
+                   static_cast<sys::Uint32_T>(split));
+    reader.setReadAhead(4);
+    reader.getData(reinterpret_cast<unsigned char*>(data.data() + split),
+                   static_cast<sys::Uint32_T>(split));
+    reader.setReadAhead(0);
+    reader.getData(reinterpret_cast<unsigned char*>(data.data() + 2 * split),
+                   static_cast<sys::Uint32_T>(data.size() - 2 * split));
+    TEST_ASSERT(data == image);
+}
+
+TEST_MAIN(
+    TEST_CHECK(testReadAheadStripped);
+    TEST_CHECK(testReadAheadTiled);
+    TEST_CHECK(testReadAheadSwapped);
+    TEST_CHECK(testReadAheadAfterOpen);
+    )
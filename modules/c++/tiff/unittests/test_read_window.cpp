@@ -0,0 +1,216 @@
+/* =========================================================================
+ * This file is part of tiff-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * tiff-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <TestCase.h>
+
+#include <import/tiff.h>
+#include <io/TempFile.h>
+
+static const size_t NUM_ROWS = 70;
+static const size_t NUM_COLS = 90;
+
+// Strips are 3 rows of 8-bit pixels; tiles are always 16 x 16
+static const size_t STRIP_LENGTH = 3;
+static const size_t TILE_SIZE = 16;
+
+template <typename T>
+static std::vector<T> makeImage()
+{
+    std::vector<T> image(NUM_ROWS * NUM_COLS);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<T>(ii * 7 + ii / 13);
+    }
+    return image;
+}
+
+template <typename T>
+static void writeImage(const std::string& pathname, const std::vector<T>& image, bool tiled,
+                       unsigned short compression)
+{
+    tiff::FileWriter fileWriter(pathname);
+    fileWriter.writeHeader();
+    tiff::ImageWriter* imageWriter = fileWriter.addImage();
+    if (tiled)
+    {
+        imageWriter->setImageFormat(tiff::ImageWriter::TILED);
+        imageWriter->setIdealChunkSize(TILE_SIZE * TILE_SIZE * sizeof(T));
+    }
+    else
+    {
+        imageWriter->setIdealChunkSize(STRIP_LENGTH * NUM_COLS * sizeof(T) * 2 / 3);
+    }
+
+    tiff::IFD* ifd = imageWriter->getIFD();
+    ifd->addEntry(tiff::KnownTags::IMAGE_WIDTH, static_cast<sys::Uint32_T>(NUM_COLS));
+    ifd->addEntry(tiff::KnownTags::IMAGE_LENGTH, static_cast<sys::Uint32_T>(NUM_ROWS));
+    ifd->addEntry(tiff::KnownTags::COMPRESSION, compression);
+    ifd->addEntry(tiff::KnownTags::PHOTOMETRIC_INTERPRETATION, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::SAMPLES_PER_PIXEL, static_cast<unsigned short>(1));
+    ifd->addEntry(tiff::KnownTags::BITS_PER_SAMPLE);
+    unsigned short bitsPerSample = sizeof(T) * 8;
+    (*ifd)[tiff::KnownTags::BITS_PER_SAMPLE]->addValue(tiff::TypeFactory::create(
+            reinterpret_cast<unsigned char*>(&bitsPerSample), tiff::Const::Type::SHORT));
+    imageWriter->putData(reinterpret_cast<const unsigned char*>(image.data()),
+                         static_cast<sys::Uint32_T>(image.size()));
+    imageWriter->writeIFD();
+    fileWriter.close();
+}
+
+// The first and last rows (or columns) of windows: on, just inside and just
+// outside strip and tile edges, and in the middle of them
+static std::vector<std::pair<size_t, size_t>> getRanges(size_t chunkSize, size_t size)
+{
+    const size_t edges[] = { 0, 1, chunkSize / 2, chunkSize - 1, chunkSize, chunkSize + 1,
+                             2 * chunkSize + chunkSize / 2, size - 2, size - 1 };
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const size_t first : edges)
+    {
+        for (const size_t last : edges)
+        {
+            if (first <= last && last < size)
+            {
+                ranges.emplace_back(first, last);
+            }
+        }
+    }
+    return ranges;
+}
+
+template <typename T>
+static void testReadWindow(const std::string& testName, bool tiled, unsigned short compression)
+{
+    const auto image = makeImage<T>();
+    const io::TempFile tempFile;
+    writeImage(tempFile.pathname(), image, tiled, compression);
+
+    const auto rowRanges = getRanges(tiled ? TILE_SIZE : STRIP_LENGTH, NUM_ROWS);
+    const auto colRanges = getRanges(TILE_SIZE, NUM_COLS);
+    for (const bool memoryMap : { false, true })
+    {
+        const tiff::FileReader reader(tempFile.pathname(), memoryMap);
+        tiff::ImageReader* const imageReader = reader[0];
+        const std::string chunkLength = tiled ?
+                (*imageReader->getIFD())["TileLength"]->getValues()[0]->toString() :
+                (*imageReader->getIFD())["RowsPerStrip"]->getValues()[0]->toString();
+        TEST_ASSERT_EQ(chunkLength, std::to_string(tiled ? TILE_SIZE : STRIP_LENGTH));
+
+        for (const size_t numThreads : { 1, 4 })
+        {
+            for (const auto& rows : rowRanges)
+            {
+                for (const auto& cols : colRanges)
+                {
+                    const size_t numRows = rows.second - rows.first + 1;
+                    const size_t numCols = cols.second - cols.first + 1;
+
+                    // With a guard element after the window
+                    std::vector<T> window(numRows * numCols + 1, static_cast<T>(0x5A));
+                    imageReader->readWindow(reinterpret_cast<unsigned char*>(window.data()),
+                                            static_cast<sys::Uint32_T>(rows.first),
+                                            static_cast<sys::Uint32_T>(cols.first),
+                                            static_cast<sys::Uint32_T>(numRows),
+                                            static_cast<sys::Uint32_T>(numCols), numThreads);
+
+                    bool matches = window.back() == static_cast<T>(0x5A);
+                    for (size_t row = 0; row < numRows; ++row)
+                    {
+                        for (size_t col = 0; col < numCols; ++col)
+                        {
+                            matches = matches && window[row * numCols + col] ==
+                                    image[(rows.first + row) * NUM_COLS + cols.first + col];
+                        }
+                    }
+                    TEST_ASSERT(matches);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(testReadWindowStripped)
+{
+    testReadWindow<uint8_t>(testName, false /*tiled*/, tiff::Const::CompressionType::NO_COMPRESSION);
+    testReadWindow<uint8_t>(testName, false /*tiled*/, tiff::Const::CompressionType::LZW);
+}
+TEST_CASE(testReadWindowTiled)
+{
+    testReadWindow<uint8_t>(testName, true /*tiled*/, tiff::Const::CompressionType::NO_COMPRESSION);
+    testReadWindow<uint8_t>(testName, true /*tiled*/, tiff::Const::CompressionType::LZW);
+    testReadWindow<uint32_t>(testName, true /*tiled*/, tiff::Const::CompressionType::NO_COMPRESSION);
+    testReadWindow<uint32_t>(testName, true /*tiled*/, tiff::Const::CompressionType::PACK_BITS);
+}
+
+TEST_CASE(testReadWindowOutside)
+{
+    const auto image = makeImage<uint8_t>();
+    const io::TempFile tempFile;
+    for (const bool tiled : { false, true })
+    {
+        writeImage(tempFile.pathname(), image, tiled, tiff::Const::CompressionType::NO_COMPRESSION);
+        const tiff::FileReader reader(tempFile.pathname());
+        tiff::ImageReader* const imageReader = reader[0];
+
+        std::vector<unsigned char> window(image.size() + 1, 0xAB);
+        TEST_EXCEPTION(imageReader->readWindow(window.data(), 60, 0, 11, 1));
+        TEST_EXCEPTION(imageReader->readWindow(window.data(), 0, 80, 1, 11));
+
+        // An empty window reads nothing
+        imageReader->readWindow(window.data(), 10, 10, 0, 0);
+        TEST_ASSERT(window == std::vector<unsigned char>(image.size() + 1, 0xAB));
+    }
+}
+
+TEST_CASE(testReadWindowKeepsPosition)
+{
+    const auto image = makeImage<uint8_t>();
+    const io::TempFile tempFile;
+    for (const bool tiled : { false, true })
+    {
+        writeImage(tempFile.pathname(), image, tiled, tiff::Const::CompressionType::LZW);
+        for (const bool memoryMap : { false, true })
+        {
+            tiff::FileReader reader(tempFile.pathname(), memoryMap);
+            std::vector<unsigned char> data(image.size());
+            const size_t split = NUM_COLS * 20 + 7;
+            reader.getData(data.data(), static_cast<sys::Uint32_T>(split));
+
+            std::vector<unsigned char> window(40 * 40);
+            reader[0]->readWindow(window.data(), 25, 45, 40, 40, 2);
+
+            reader.getData(data.data() + split, static_cast<sys::Uint32_T>(data.size() - split));
+            TEST_ASSERT(data == image);
+        }
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testReadWindowStripped);
+    TEST_CHECK(testReadWindowTiled);
+    TEST_CHECK(testReadWindowOutside);
+    TEST_CHECK(testReadWindowKeepsPosition);
+    )
@@ -34,6 +34,9 @@
 #include "xml/lite/XMLReader.h"
 #include "xml/lite/MinidomHandler.h"
 #include "xml/lite/MinidomParser.h"
+#include "xml/lite/CompactDocument.h"
+#include "xml/lite/XMLSerializer.h"
+#include "xml/lite/XMLPullReader.h"
 #include "xml/lite/Serializable.h"
 #include "xml/lite/Validator.h"
 
@@ -0,0 +1,338 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_xml_lite_CompactDocument_h_INCLUDED_
+#define CODA_OSS_xml_lite_CompactDocument_h_INCLUDED_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "coda_oss/string.h"
+
+#include <config/Exports.h>
+#include <io/InputStream.h>
+
+#include "xml/lite/Element.h"
+
+namespace xml
+{
+namespace lite
+{
+class CompactDocument;
+
+/*!
+ *  \class CompactAttributes
+ *  \brief Read-only view of a CompactElement's attributes
+ *
+ *  The same lookups as Attributes, without copying anything.
+ */
+class CODA_OSS_API CompactAttributes final
+{
+    const CompactDocument* mDocument = nullptr;
+    size_t mFirst = 0;
+    size_t mSize = 0;
+
+public:
+    CompactAttributes() = default;
+    CompactAttributes(const CompactDocument& document, size_t first, size_t size) :
+        mDocument(&document), mFirst(first), mSize(size)
+    {
+    }
+
+    size_t size() const
+    {
+        return mSize;
+    }
+    int getLength() const
+    {
+        return static_cast<int>(size());
+    }
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    const std::string& getQName(int i) const;
+    const std::string& getLocalName(int i) const;
+    const std::string& getUri(int i) const;
+    std::string getValue(int i) const;
+
+    //! \return The index of the attribute, or -1 if there isn't one
+    int getIndex(const std::string& qname) const;
+    int getIndex(const xml::lite::QName&) const;
+
+    /*!
+     *  \return The value of the attribute
+     *  \throw except::NoSuchKeyException if there isn't one
+     */
+    std::string getValue(const std::string& qname) const;
+    bool getValue(const std::string& qname, std::string& result) const;
+    std::string getValue(const xml::lite::QName&) const;
+    bool getValue(const xml::lite::QName&, std::string& result) const;
+
+    bool contains(const std::string& qname) const
+    {
+        return getIndex(qname) >= 0;
+    }
+
+    //! Copy into Attributes, say for Element::setAttributes()
+    Attributes toAttributes() const;
+};
+
+/*!
+ *  \class CompactElement
+ *  \brief A handle to an element of a CompactDocument
+ *
+ *  This is just a document pointer and an index, so it's cheap to copy and
+ *  pass by value; it's valid as long as the document is (and isn't parsed
+ *  into again).  A default-constructed handle refers to no element, which
+ *  is what the std::nothrow lookups return when there's no match.
+ *
+ *  The read API follows Element's; lookups return handles rather than
+ *  Element pointers.
+ */
+class CODA_OSS_API CompactElement final
+{
+    const CompactDocument* mDocument = nullptr;
+    uint32_t mIndex = 0;
+
+public:
+    CompactElement() = default;
+    CompactElement(const CompactDocument& document, uint32_t index) :
+        mDocument(&document), mIndex(index)
+    {
+    }
+
+    //! \return True if this refers to an element
+    explicit operator bool() const
+    {
+        return mDocument != nullptr;
+    }
+    bool operator==(const CompactElement& rhs) const
+    {
+        return (mDocument == rhs.mDocument) && (mIndex == rhs.mIndex);
+    }
+    bool operator!=(const CompactElement& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    const std::string& getQName() const;
+    const std::string& getLocalName() const;
+    const std::string& getUri() const;
+
+    CompactAttributes getAttributes() const;
+
+    //! Character data in the native encoding, as Element::getCharacterData()
+    std::string getCharacterData() const;
+    const coda_oss::u8string& getCharacterData(coda_oss::u8string& result) const;
+
+    //! \return The parent element; nothing for the root
+    CompactElement getParent() const;
+    CompactElement getFirstChild() const;
+    CompactElement getNextSibling() const;
+    std::vector<CompactElement> getChildren() const;
+
+    void getElementsByTagName(const std::string& localName,
+                              std::vector<CompactElement>& elements,
+                              bool recurse = false) const;
+    std::vector<CompactElement> getElementsByTagName(const std::string& localName,
+                                                     bool recurse = false) const
+    {
+        std::vector<CompactElement> v;
+        getElementsByTagName(localName, v, recurse);
+        return v;
+    }
+    void getElementsByTagName(const xml::lite::QName& name,
+                              std::vector<CompactElement>& elements,
+                              bool recurse = false) const;
+    std::vector<CompactElement> getElementsByTagName(const xml::lite::QName& name,
+                                                     bool recurse = false) const
+    {
+        std::vector<CompactElement> v;
+        getElementsByTagName(name, v, recurse);
+        return v;
+    }
+    void getElementsByTagNameNS(const std::string& qname,
+                                std::vector<CompactElement>& elements,
+                                bool recurse = false) const;
+    std::vector<CompactElement> getElementsByTagNameNS(const std::string& qname,
+                                                       bool recurse = false) const
+    {
+        std::vector<CompactElement> v;
+        getElementsByTagNameNS(qname, v, recurse);
+        return v;
+    }
+
+    /*!
+     *  \return The one matching element
+     *  \throw XMLException unless there's exactly one
+     */
+    CompactElement getElementByTagName(const std::string& localName,
+                                       bool recurse = false) const;
+    CompactElement getElementByTagName(const xml::lite::QName&,
+                                       bool recurse = false) const;
+    //! \return The one matching element, or nothing
+    CompactElement getElementByTagName(std::nothrow_t, const std::string& localName,
+                                       bool recurse = false) const;
+    CompactElement getElementByTagName(std::nothrow_t, const xml::lite::QName&,
+                                       bool recurse = false) const;
+
+    bool hasElement(const std::string& localName) const;
+    bool hasElement(const xml::lite::QName&) const;
+
+    //! Build an Element from this one and its descendants, say to modify it
+    std::unique_ptr<Element> toElement() const;
+
+private:
+    template <typename TMatch>
+    void findElements(TMatch match, std::vector<CompactElement>&, bool recurse) const;
+};
+
+/*!
+ *  \class CompactDocument
+ *  \brief A read-only parsed XML document, stored for fast traversal
+ *
+ *  Where MinidomParser news an Element (several strings and a vector of
+ *  children) for every element, a CompactDocument keeps all elements in
+ *  one array, in document order: each is a few indices.  Names and URIs
+ *  are interned once per document, and character data and attribute values
+ *  are appended to shared buffers.  Parsing allocates little, lookups
+ *  compare interned ids (a name the document never uses can't match, so
+ *  there's nothing to search), a recursive search is a linear scan, and
+ *  destruction frees a handful of buffers.
+ *
+ *  \code
+    xml::lite::CompactDocument doc;
+    doc.parse(input);
+    for (auto&& record : doc.getRootElement().getElementsByTagName("Record", true))
+    {
+        const auto id = record.getAttributes().getValue("id");
+        ...
+    }
+    \endcode
+ *
+ *  Character data is trimmed as with MinidomParser unless
+ *  preserveCharacterData() is set.  Use CompactElement::toElement() for
+ *  a modifiable copy of part of the document.
+ */
+class CODA_OSS_API CompactDocument final
+{
+public:
+    CompactDocument() = default;
+    ~CompactDocument() = default;
+
+    CompactDocument(const CompactDocument&) = delete;
+    CompactDocument& operator=(const CompactDocument&) = delete;
+
+    /*!
+     *  Parse the XML in is, replacing what was here.  As with MinidomParser,
+     *  UTF-8 is tried first, then Windows-1252.
+     */
+    void parse(io::InputStream& is, int size = io::InputStream::IS_END);
+    void parse(io::InputStream& is, const void* pInitialEncoding,
+               const void* pFallbackEncoding, int size = io::InputStream::IS_END);
+
+    //! If true, whitespace around character data is kept
+    void preserveCharacterData(bool preserve)
+    {
+        mPreserveCharData = preserve;
+    }
+
+    void clear();
+
+    bool empty() const
+    {
+        return mNodes.empty();
+    }
+
+    //! \return The root element; nothing if there isn't a document
+    CompactElement getRootElement() const
+    {
+        return empty() ? CompactElement() : CompactElement(*this, 0);
+    }
+
+    //! \return How many elements there are
+    size_t getNumElements() const
+    {
+        return mNodes.size();
+    }
+
+private:
+    friend class CompactElement;
+    friend class CompactAttributes;
+    struct Handler;
+
+    static constexpr uint32_t NONE = static_cast<uint32_t>(-1);
+
+    struct Node final
+    {
+        uint32_t qname = NONE;
+        uint32_t localName = NONE;
+        uint32_t uri = NONE;
+        uint32_t parent = NONE;
+        uint32_t nextSibling = NONE;
+        // One past the last descendant; elements are in document order
+        uint32_t end = NONE;
+        uint32_t firstAttribute = 0;
+        uint32_t numAttributes = 0;
+        size_t characterData = 0;
+        size_t characterDataLength = 0;
+    };
+
+    struct Attribute final
+    {
+        uint32_t qname = NONE;
+        uint32_t localName = NONE;
+        uint32_t uri = NONE;
+        size_t value = 0;
+        size_t valueLength = 0;
+    };
+
+    uint32_t intern(const std::string&);
+    //! \return The id of s, or NONE if it's not in the document
+    uint32_t find(const std::string& s) const;
+    const std::string& string(uint32_t id) const
+    {
+        return mStrings[id];
+    }
+
+    std::vector<Node> mNodes;
+    std::vector<Attribute> mAttributes;
+    coda_oss::u8string mCharacterData;
+    std::string mAttributeValues;
+
+    std::vector<std::string> mStrings;
+    std::unordered_map<std::string, uint32_t> mStringIds;
+
+    bool mPreserveCharData = false;
+};
+}
+}
+
+#endif  // CODA_OSS_xml_lite_CompactDocument_h_INCLUDED_
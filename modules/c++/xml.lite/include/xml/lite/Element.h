@@ -56,6 +56,7 @@ namespace xml
 namespace lite
 {
 struct AttributeNode;
+class XMLSerializer;
 
 /*!
  * \class Element
@@ -492,6 +493,7 @@ private:
                    const std::string& uri);
 
     void depthPrint(io::OutputStream& stream, int depth, const std::string& formatter, bool isConsoleOutput = false) const;
+    friend class XMLSerializer;  // to read mCharacterData without a copy
 
     Element* mParent = nullptr;
     //! The attributes for this element
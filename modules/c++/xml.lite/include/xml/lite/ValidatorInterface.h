@@ -129,6 +129,8 @@ public:
     /*!
      *  Validation against the internal schema pool
      *  \param xml     Input stream to the xml document to validate
+     *  \param oss     Stream to copy the document into, which sets how
+     *                 the characters are interpreted
      *  \param xmlID   Identifier for this input xml within the error log
      *  \param errors  Object for returning errors found (errors are appended)
      */
@@ -142,13 +144,38 @@ public:
         xml.streamTo(oss);
         return validate(oss.stream().str(), xmlID, errors);
     }
-    bool validate(io::InputStream& xml,
-                  const std::string& xmlID,
-                  std::vector<ValidationInfo>& errors) const
+
+    /*!
+     *  Validation against the internal schema pool
+     *  \param xml     Input stream to the xml document to validate
+     *  \param xmlID   Identifier for this input xml within the error log
+     *  \param errors  Object for returning errors found (errors are appended)
+     *
+     *  By default, the whole document is copied into a string first.
+     */
+    virtual bool validate(io::InputStream& xml,
+                          const std::string& xmlID,
+                          std::vector<ValidationInfo>& errors) const
     {
         return vallidateT(xml, io::StringStream(), xmlID, errors);
     }
 
+    /*!
+     *  Validation against the internal schema pool
+     *  \param pXml    The bytes of the xml document to validate
+     *  \param size    The number of bytes
+     *  \param xmlID   Identifier for this input xml within the error log
+     *  \param errors  Object for returning errors found (errors are appended)
+     *
+     *  By default, the document is copied into a string first.
+     */
+    virtual bool validate(const void* pXml, size_t size,
+                          const std::string& xmlID,
+                          std::vector<ValidationInfo>& errors) const
+    {
+        return validate(std::string(static_cast<const char*>(pXml), size), xmlID, errors);
+    }
+
     /*!
      *  Validation against the internal schema pool
      *  \param xml     Input stream to the xml document to validate
@@ -88,6 +88,11 @@ private:
  * \brief Schema validation is done here.
  *
  * This class is the Xercesc schema validator
+ *
+ * The compiled schemas are cached for the life of the process: another
+ * validator for the same set of XSD files (however they're found) reuses
+ * them rather than loading and compiling them again.  validate() may be
+ * called from any number of threads at once; each borrows its own parser.
  */
 struct CODA_OSS_API ValidatorXerces : public ValidatorInterface
 {
@@ -106,10 +111,13 @@ struct CODA_OSS_API ValidatorXerces : public ValidatorInterface
                     logging::Logger* log = nullptr,
                     bool recursive = true);
 
+    ~ValidatorXerces();
+
     ValidatorXerces(const ValidatorXerces&) = delete;
     ValidatorXerces& operator=(const ValidatorXerces&) = delete;
-    ValidatorXerces(ValidatorXerces&&) = default;
-    ValidatorXerces& operator=(ValidatorXerces&&) = default;
+    //! A moved-from validator can only be destroyed or assigned to
+    ValidatorXerces(ValidatorXerces&&);
+    ValidatorXerces& operator=(ValidatorXerces&&);
 
     using ValidatorInterface::validate;
 
@@ -125,20 +133,36 @@ struct CODA_OSS_API ValidatorXerces : public ValidatorInterface
     bool validate(const coda_oss::u8string&, const std::string& xmlID, std::vector<ValidationInfo>&) const override;
     bool validate(const str::W1252string&, const std::string& xmlID, std::vector<ValidationInfo>&) const override;
 
+    /*!
+     *  Validate the bytes as Xerces reads them, rather than copying the
+     *  whole document into a string (and then again as UTF-16).  A document
+     *  without an encoding declaration is handled as validate(std::string)
+     *  would, which requires reading all of it first.
+     */
+    bool validate(io::InputStream& xml, const std::string& xmlID, std::vector<ValidationInfo>&) const override;
+    bool validate(const void* pXml, size_t size, const std::string& xmlID, std::vector<ValidationInfo>&) const override;
+
     // Search each directory for XSD files
     static std::vector<coda_oss::filesystem::path> loadSchemas(const std::vector<coda_oss::filesystem::path>& schemaPaths, bool recursive=true);
 
+    //! Forget the cached schemas; validators already using them are unaffected.
+    static void clearSchemaCache();
+
 private:
     XercesContext mCtxt;
 
     bool validate_(const coda_oss::u8string& xml, 
                    const std::string& xmlID,
                    std::vector<ValidationInfo>& errors) const;
+    bool validate_(xercesc::DOMLSInput& input,
+                   const std::string& xmlID,
+                   std::vector<ValidationInfo>& errors) const;
 
-    std::unique_ptr<xercesc::XMLGrammarPool> mSchemaPool;
-    std::unique_ptr<xml::lite::ValidationErrorHandler> mErrorHandler;
-    std::unique_ptr<xercesc::DOMLSParser> mValidator;
+    struct SchemaPool;  // compiled schemas, shared by validators using the same ones
+    std::shared_ptr<const SchemaPool> mSchemaPool;
 
+    struct Parsers;  // a DOMLSParser for each thread validating at once
+    std::unique_ptr<Parsers> mParsers;
 };
 
 //! stream the entire log -- newline separated
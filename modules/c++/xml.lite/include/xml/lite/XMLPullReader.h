@@ -0,0 +1,232 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_xml_lite_XMLPullReader_h_INCLUDED_
+#define CODA_OSS_xml_lite_XMLPullReader_h_INCLUDED_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "coda_oss/string.h"
+
+#include <config/Exports.h>
+#include <io/InputStream.h>
+
+#include "xml/lite/XMLReader.h"
+#include "xml/lite/Element.h"
+
+namespace xml
+{
+namespace lite
+{
+/*!
+ *  \class XMLPullReader
+ *  \brief Reads XML one event at a time, at the caller's pace
+ *
+ *  Unlike MinidomParser, nothing is built unless asked for: next() returns
+ *  the next start element, end element or run of character data, and the
+ *  accessors refer to buffers owned by the reader (valid until the next
+ *  call to next()) rather than copies.  Xerces parses progressively, so
+ *  only as much of the input is read as the events need, and memory stays
+ *  bounded by the size of one element's start tag or character data.
+ *
+ *  readSubtree() builds an Element from the current start element to its
+ *  end, for the parts of a document worth a DOM.
+ *
+ *  \code
+    xml::lite::XMLPullReader reader(input);
+    while (reader.next() != xml::lite::XMLPullReader::EventType::EndDocument)
+    {
+        if (reader.isStartElement() && reader.getLocalName() == "Record")
+        {
+            auto record = reader.readSubtree();
+            ...
+        }
+    }
+    \endcode
+ *
+ *  Adjacent character data is reported as one Characters event, untrimmed
+ *  (whitespace between elements included).  There's no Windows-1252
+ *  fallback as with XMLReaderXerces::parse(): the input can't be read
+ *  twice, so pass the encoding if it's known not to be UTF-8.
+ */
+class CODA_OSS_API XMLPullReader final
+{
+public:
+    enum class EventType
+    {
+        StartElement,
+        EndElement,
+        Characters,
+        EndDocument
+    };
+
+    /*!
+     *  \param is The XML to read, which must outlive this reader
+     *  \param pEncoding The encoding to assume (as an XMLCh*, see
+     *         XMLReaderXerces::getWindows1252Encoding()); nullptr to use the
+     *         XML declaration, or UTF-8.
+     */
+    explicit XMLPullReader(io::InputStream& is, const void* pEncoding = nullptr);
+
+    ~XMLPullReader();
+
+    XMLPullReader(const XMLPullReader&) = delete;
+    XMLPullReader& operator=(const XMLPullReader&) = delete;
+
+    /*!
+     *  Move to the next event.  Once EndDocument is returned, it's
+     *  returned from then on.
+     *
+     *  \throw except::Error or XMLParseException if the XML is malformed
+     */
+    EventType next();
+
+    //! \return The current event
+    EventType getEventType() const
+    {
+        return mEventType;
+    }
+    bool isStartElement() const
+    {
+        return mEventType == EventType::StartElement;
+    }
+    bool isEndElement() const
+    {
+        return mEventType == EventType::EndElement;
+    }
+    bool isCharacters() const
+    {
+        return mEventType == EventType::Characters;
+    }
+
+    /*!
+     *  The name of the current start or end element.  These (and
+     *  getAttributes() and getCharacterData()) are empty for other events.
+     */
+    const std::string& getQName() const
+    {
+        return current().qname;
+    }
+    const std::string& getLocalName() const
+    {
+        return current().localName;
+    }
+    const std::string& getUri() const
+    {
+        return current().uri;
+    }
+
+    //! The attributes of the current start element
+    const Attributes& getAttributes() const
+    {
+        return current().attributes;
+    }
+
+    //! The current character data, as it appears in the document
+    const coda_oss::u8string& getCharacterData() const
+    {
+        return current().characters;
+    }
+
+    /*!
+     *  \return How many elements are open, counting the current start or
+     *          end element: 1 for the root, 0 at EndDocument.
+     */
+    size_t getDepth() const
+    {
+        return mDepth;
+    }
+
+    /*!
+     *  Build an Element from the current start element, its attributes,
+     *  character data and descendants.  Afterwards the current event is
+     *  the matching end element.  Character data is trimmed as
+     *  MinidomHandler does unless preserveCharacterData() is set.
+     *
+     *  \throw XMLException if the current event isn't a start element
+     */
+    std::unique_ptr<Element> readSubtree();
+
+    /*!
+     *  Skip the current start element and all it contains; afterwards the
+     *  current event is the matching end element.
+     *
+     *  \throw XMLException if the current event isn't a start element
+     */
+    void skipSubtree();
+
+    //! Whether readSubtree() keeps whitespace around character data
+    void preserveCharacterData(bool preserve)
+    {
+        mPreserveCharData = preserve;
+    }
+
+private:
+    struct Event final
+    {
+        EventType type = EventType::EndDocument;
+        std::string uri;
+        std::string localName;
+        std::string qname;
+        Attributes attributes;
+        coda_oss::u8string characters;
+    };
+
+    // Queues the events Xerces fires while scanning
+    struct Handler;
+
+    const Event& current() const
+    {
+        return mCurrent < mNumEvents ? mEvents[mCurrent] : mEmpty;
+    }
+    Event& push(EventType type);
+    void parseNext();
+    void checkStartElement(const char* method) const;
+
+    XercesContext mCtxt;
+    std::unique_ptr<InputSource> mSource;
+    std::unique_ptr<Handler> mHandler;
+    std::unique_ptr<XercesContentHandler> mDriverContentHandler;
+    std::unique_ptr<XercesErrorHandler> mErrorHandler;
+    std::unique_ptr<SAX2XMLReader> mNative;
+    XMLPScanToken mToken;
+    bool mStarted = false;
+    bool mDone = false;
+
+    // Events are reused rather than reallocated, so the strings keep
+    // their capacity; [mNext, mNumEvents) haven't been returned yet.
+    std::vector<Event> mEvents;
+    size_t mNumEvents = 0;
+    size_t mNext = 0;
+    size_t mCurrent = 0;
+    Event mEmpty;
+
+    EventType mEventType = EventType::EndDocument;
+    size_t mDepth = 0;
+    bool mPreserveCharData = false;
+};
+}
+}
+
+#endif  // CODA_OSS_xml_lite_XMLPullReader_h_INCLUDED_
@@ -116,6 +116,13 @@ public:
 
     static const void* getWindows1252Encoding();
 
+    /*!
+     *  \return A Xerces SAX2 reader with the features parse() uses (no
+     *          validation, no external DTDs), for other drivers of the
+     *          same handlers; see XMLPullReader.
+     */
+    static std::unique_ptr<SAX2XMLReader> createNativeReader();
+
 private:
     void write(const void*, size_t) override
     {
@@ -0,0 +1,121 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_xml_lite_XMLSerializer_h_INCLUDED_
+#define CODA_OSS_xml_lite_XMLSerializer_h_INCLUDED_
+
+#include <string>
+
+#include <config/Exports.h>
+#include <io/OutputStream.h>
+
+#include "xml/lite/Element.h"
+
+namespace xml
+{
+namespace lite
+{
+/*!
+ *  \class XMLSerializer
+ *  \brief Writes an Element and its descendants with one write() call
+ *
+ *  The whole tree is formatted into a buffer that's reused from one call
+ *  to the next, and then written at once, rather than as a handful of
+ *  small writes (each of a freshly concatenated string) per element.
+ *  Each qualified name is built once per element, for both tags, and
+ *  character data and attribute values are escaped in one pass that skips
+ *  eight bytes at a time when there's nothing to escape.
+ *
+ *  \code
+    xml::lite::XMLSerializer serializer;  // compact
+    serializer.write(root, output);
+    \endcode
+ *
+ *  Element::print() and prettyPrint() use this, but without escaping, as
+ *  they always have.
+ */
+class CODA_OSS_API XMLSerializer final
+{
+public:
+    /*!
+     *  \param formatter The indentation for each level, as with
+     *         Element::prettyPrint(); empty for compact output, without
+     *         newlines.
+     *  \param escape Whether to escape &, < and > (and " in attribute
+     *         values).
+     */
+    explicit XMLSerializer(const std::string& formatter = "", bool escape = true);
+
+    XMLSerializer(const XMLSerializer&) = delete;
+    XMLSerializer& operator=(const XMLSerializer&) = delete;
+
+    void setFormatter(const std::string& formatter)
+    {
+        mFormatter = formatter;
+    }
+    void setEscape(bool escape)
+    {
+        mEscape = escape;
+    }
+
+    /*!
+     *  Write character data in the native encoding rather than UTF-8; see
+     *  Element::consoleOutput_().  Only for the console: XML should be UTF-8.
+     */
+    void setNativeCharacterData(bool native)
+    {
+        mNativeCharacterData = native;
+    }
+
+    /*!
+     *  Format element (and its descendants) into the buffer, replacing what
+     *  was there.
+     *
+     *  \param depth The indentation of element
+     *  \return The buffer, valid until the next call
+     */
+    const std::string& serialize(const Element& element, int depth = 0);
+
+    //! serialize() element, then write it to stream
+    void write(const Element& element, io::OutputStream& stream, int depth = 0);
+
+    //! Free the buffer, which otherwise keeps the size of the largest output
+    void clear();
+
+private:
+    void writeElement(const Element&, int depth);
+    void writeIndent(int depth);
+    void writeText(const char*, size_t, bool isAttribute);
+    void writeCharacterData(const coda_oss::u8string&);
+
+    std::string mFormatter;
+    bool mEscape = true;
+    bool mNativeCharacterData = false;
+
+    std::string mBuffer;
+    std::string mValue;
+};
+}
+}
+
+#endif  // CODA_OSS_xml_lite_XMLSerializer_h_INCLUDED_
@@ -0,0 +1,523 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "xml/lite/CompactDocument.h"
+
+#include <assert.h>
+
+#include <limits>
+#include <stdexcept>
+#include <std/string>
+#include <utility>
+
+#include "except/Exception.h"
+#include "str/Format.h"
+#include "str/Manip.h"
+#include "str/Encoding.h"
+
+#include "xml/lite/XMLReader.h"
+
+constexpr uint32_t xml::lite::CompactDocument::NONE;
+
+/*!
+ *  \class CompactDocument::Handler
+ *  \brief Appends elements to a CompactDocument as they're parsed
+ *
+ *  The MinidomHandler approach, with the document's arrays instead of
+ *  Element objects.  Character data for the open elements is accumulated
+ *  in buffers that are reused as the depth goes up and down.
+ */
+struct xml::lite::CompactDocument::Handler final : public ContentHandler
+{
+    CompactDocument& mDocument;
+    std::vector<uint32_t> mOpen;  // indices of the open elements
+    std::vector<uint32_t> mLastChild;  // of each open element
+    std::vector<coda_oss::u8string> mCharacterData;  // of each open element
+
+    Handler(CompactDocument& document) : mDocument(document)
+    {
+    }
+
+    // The Windows-1252 retry in XMLReaderXerces::parse() starts over
+    void startDocument() override
+    {
+        mDocument.clear();
+        mOpen.clear();
+        mLastChild.clear();
+    }
+
+    coda_oss::u8string& characterData()
+    {
+        assert(!mOpen.empty());
+        return mCharacterData[mOpen.size() - 1];
+    }
+
+    void characters(const char* value, int length) override
+    {
+        // As with MinidomHandler, we're only here if vcharacters() failed
+        characterData() += str::u8FromNative(std::string(value, length));
+    }
+
+    bool vcharacters(const void /*XMLCh*/* chars_, size_t length) override
+    {
+        if (chars_ == nullptr)
+        {
+            throw std::invalid_argument("chars_ is NULL.");
+        }
+
+        static_assert(sizeof(XMLCh) == sizeof(char16_t), "XMLCh should be 16-bits.");
+        auto pChars16 = static_cast<const char16_t*>(chars_);
+        characterData() += str::to_u8string(pChars16, length);
+        return true; // vcharacters() processed
+    }
+
+    void startElement(const std::string& uri,
+                      const std::string& /*localName*/,
+                      const std::string& qname,
+                      const Attributes& atts) override
+    {
+        auto& doc = mDocument;
+        if (doc.mNodes.size() >= NONE)
+        {
+            throw xml::lite::XMLException(Ctxt("Too many elements"));
+        }
+        const auto index = static_cast<uint32_t>(doc.mNodes.size());
+        doc.mNodes.emplace_back();
+        auto& node = doc.mNodes.back();
+
+        // Like QName::setQName(), the local name is after the prefix
+        node.qname = doc.intern(qname);
+        const auto colon = qname.find(':');
+        node.localName = (colon == std::string::npos) ? node.qname :
+                doc.intern(qname.substr(colon + 1));
+        node.uri = doc.intern(uri);
+
+        node.firstAttribute = static_cast<uint32_t>(doc.mAttributes.size());
+        node.numAttributes = static_cast<uint32_t>(atts.size());
+        for (int ii = 0; ii < atts.getLength(); ++ii)
+        {
+            const auto& attributeNode = atts.getNode(ii);
+            Attribute attribute;
+            attribute.qname = doc.intern(attributeNode.getQName());
+            attribute.localName = doc.intern(attributeNode.getLocalName());
+            attribute.uri = doc.intern(attributeNode.getUri());
+            const auto& value = attributeNode.getValue();
+            attribute.value = doc.mAttributeValues.size();
+            attribute.valueLength = value.size();
+            doc.mAttributeValues += value;
+            doc.mAttributes.push_back(attribute);
+        }
+
+        if (!mOpen.empty())
+        {
+            node.parent = mOpen.back();
+            auto& lastChild = mLastChild.back();
+            if (lastChild != NONE)
+            {
+                doc.mNodes[lastChild].nextSibling = index;
+            }
+            lastChild = index;
+        }
+
+        mOpen.push_back(index);
+        mLastChild.push_back(NONE);
+        if (mCharacterData.size() < mOpen.size())
+        {
+            mCharacterData.emplace_back();
+        }
+        characterData().clear();
+    }
+
+    void endElement(const std::string& /*uri*/,
+                    const std::string& /*localName*/,
+                    const std::string& /*qname*/) override
+    {
+        auto& doc = mDocument;
+        auto& node = doc.mNodes[mOpen.back()];
+        node.end = static_cast<uint32_t>(doc.mNodes.size());
+
+        auto& s = characterData();
+        if (!doc.mPreserveCharData && !s.empty())
+        {
+            str::trim(s);
+        }
+        node.characterData = doc.mCharacterData.size();
+        node.characterDataLength = s.size();
+        doc.mCharacterData += s;
+
+        mOpen.pop_back();
+        mLastChild.pop_back();
+    }
+};
+
+uint32_t xml::lite::CompactDocument::intern(const std::string& s)
+{
+    const auto it = mStringIds.find(s);
+    if (it != mStringIds.end())
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<uint32_t>(mStrings.size());
+    mStrings.push_back(s);
+    mStringIds.emplace(s, id);
+    return id;
+}
+
+uint32_t xml::lite::CompactDocument::find(const std::string& s) const
+{
+    const auto it = mStringIds.find(s);
+    return it == mStringIds.end() ? NONE : it->second;
+}
+
+void xml::lite::CompactDocument::clear()
+{
+    mNodes.clear();
+    mAttributes.clear();
+    mCharacterData.clear();
+    mAttributeValues.clear();
+    mStrings.clear();
+    mStringIds.clear();
+}
+
+void xml::lite::CompactDocument::parse(io::InputStream& is, int size)
+{
+    parse(is, nullptr /*pInitialEncoding*/, XMLReader::getWindows1252Encoding(), size);
+}
+void xml::lite::CompactDocument::parse(io::InputStream& is, const void* pInitialEncoding,
+                                       const void* pFallbackEncoding, int size)
+{
+    clear();
+
+    Handler handler(*this);
+    XMLReader reader;
+    reader.setContentHandler(&handler);
+    try
+    {
+        reader.parse(is, pInitialEncoding, pFallbackEncoding, size);
+    }
+    catch (...)
+    {
+        // Don't leave part of a document
+        clear();
+        throw;
+    }
+}
+
+const std::string& xml::lite::CompactAttributes::getQName(int i) const
+{
+    return mDocument->string(mDocument->mAttributes[mFirst + i].qname);
+}
+const std::string& xml::lite::CompactAttributes::getLocalName(int i) const
+{
+    return mDocument->string(mDocument->mAttributes[mFirst + i].localName);
+}
+const std::string& xml::lite::CompactAttributes::getUri(int i) const
+{
+    return mDocument->string(mDocument->mAttributes[mFirst + i].uri);
+}
+std::string xml::lite::CompactAttributes::getValue(int i) const
+{
+    const auto& attribute = mDocument->mAttributes[mFirst + i];
+    return mDocument->mAttributeValues.substr(attribute.value, attribute.valueLength);
+}
+
+int xml::lite::CompactAttributes::getIndex(const std::string& qname) const
+{
+    if (empty())
+    {
+        return -1;
+    }
+    const auto id = mDocument->find(qname);
+    if (id == CompactDocument::NONE)
+    {
+        return -1;
+    }
+    for (size_t ii = 0; ii < mSize; ++ii)
+    {
+        if (mDocument->mAttributes[mFirst + ii].qname == id)
+        {
+            return static_cast<int>(ii);
+        }
+    }
+    return -1;
+}
+int xml::lite::CompactAttributes::getIndex(const QName& name) const
+{
+    if (empty())
+    {
+        return -1;
+    }
+    const auto uri = mDocument->find(name.getUri().value);
+    const auto localName = mDocument->find(name.getName());
+    if ((uri == CompactDocument::NONE) || (localName == CompactDocument::NONE))
+    {
+        return -1;
+    }
+    for (size_t ii = 0; ii < mSize; ++ii)
+    {
+        const auto& attribute = mDocument->mAttributes[mFirst + ii];
+        if ((attribute.uri == uri) && (attribute.localName == localName))
+        {
+            return static_cast<int>(ii);
+        }
+    }
+    return -1;
+}
+
+bool xml::lite::CompactAttributes::getValue(const std::string& qname, std::string& result) const
+{
+    const auto i = getIndex(qname);
+    if (i < 0)
+    {
+        return false; // not found
+    }
+    result = getValue(i);
+    return true;
+}
+std::string xml::lite::CompactAttributes::getValue(const std::string& qname) const
+{
+    std::string retval;
+    if (!getValue(qname, retval))
+    {
+        throw except::NoSuchKeyException(Ctxt(str::Format("QName '%s' could not be found", qname)));
+    }
+    return retval;
+}
+bool xml::lite::CompactAttributes::getValue(const QName& name, std::string& result) const
+{
+    const auto i = getIndex(name);
+    if (i < 0)
+    {
+        return false; // not found
+    }
+    result = getValue(i);
+    return true;
+}
+std::string xml::lite::CompactAttributes::getValue(const QName& name) const
+{
+    std::string retval;
+    if (!getValue(name, retval))
+    {
+        throw except::NoSuchKeyException(Ctxt(str::Format("(uri: %s, localName: %s",
+                                                          name.getUri().value, name.getName())));
+    }
+    return retval;
+}
+
+xml::lite::Attributes xml::lite::CompactAttributes::toAttributes() const
+{
+    Attributes retval;
+    for (int ii = 0; ii < getLength(); ++ii)
+    {
+        AttributeNode node;
+        node.setQName(getQName(ii));
+        node.setUri(getUri(ii));
+        node.setValue(getValue(ii));
+        retval.add(node);
+    }
+    return retval;
+}
+
+const std::string& xml::lite::CompactElement::getQName() const
+{
+    return mDocument->string(mDocument->mNodes[mIndex].qname);
+}
+const std::string& xml::lite::CompactElement::getLocalName() const
+{
+    return mDocument->string(mDocument->mNodes[mIndex].localName);
+}
+const std::string& xml::lite::CompactElement::getUri() const
+{
+    return mDocument->string(mDocument->mNodes[mIndex].uri);
+}
+
+xml::lite::CompactAttributes xml::lite::CompactElement::getAttributes() const
+{
+    const auto& node = mDocument->mNodes[mIndex];
+    return CompactAttributes(*mDocument, node.firstAttribute, node.numAttributes);
+}
+
+const coda_oss::u8string& xml::lite::CompactElement::getCharacterData(coda_oss::u8string& result) const
+{
+    const auto& node = mDocument->mNodes[mIndex];
+    result.assign(mDocument->mCharacterData, node.characterData, node.characterDataLength);
+    return result;
+}
+std::string xml::lite::CompactElement::getCharacterData() const
+{
+    coda_oss::u8string result;
+    return str::to_native(getCharacterData(result));
+}
+
+xml::lite::CompactElement xml::lite::CompactElement::getParent() const
+{
+    const auto parent = mDocument->mNodes[mIndex].parent;
+    return parent == CompactDocument::NONE ? CompactElement() : CompactElement(*mDocument, parent);
+}
+xml::lite::CompactElement xml::lite::CompactElement::getFirstChild() const
+{
+    // Elements are in document order, so a first child is next
+    const auto first = mIndex + 1;
+    return first < mDocument->mNodes[mIndex].end ? CompactElement(*mDocument, first) : CompactElement();
+}
+xml::lite::CompactElement xml::lite::CompactElement::getNextSibling() const
+{
+    const auto next = mDocument->mNodes[mIndex].nextSibling;
+    return next == CompactDocument::NONE ? CompactElement() : CompactElement(*mDocument, next);
+}
+std::vector<xml::lite::CompactElement> xml::lite::CompactElement::getChildren() const
+{
+    std::vector<CompactElement> retval;
+    for (auto child = getFirstChild(); child; child = child.getNextSibling())
+    {
+        retval.push_back(child);
+    }
+    return retval;
+}
+
+template <typename TMatch>
+void xml::lite::CompactElement::findElements(TMatch match, std::vector<CompactElement>& elements,
+                                             bool recurse) const
+{
+    const auto& nodes = mDocument->mNodes;
+    if (recurse)
+    {
+        // Descendants are contiguous, and in the order Element's recursion visits them
+        for (auto ii = mIndex + 1; ii < nodes[mIndex].end; ++ii)
+        {
+            if (match(nodes[ii]))
+            {
+                elements.emplace_back(*mDocument, ii);
+            }
+        }
+        return;
+    }
+
+    for (auto child = getFirstChild(); child; child = child.getNextSibling())
+    {
+        if (match(nodes[child.mIndex]))
+        {
+            elements.push_back(child);
+        }
+    }
+}
+
+void xml::lite::CompactElement::getElementsByTagName(const std::string& localName,
+                                                     std::vector<CompactElement>& elements,
+                                                     bool recurse) const
+{
+    // A name that isn't in the document can't match
+    const auto id = mDocument->find(localName);
+    if (id != CompactDocument::NONE)
+    {
+        const auto match = [id](const CompactDocument::Node& node) { return node.localName == id; };
+        findElements(match, elements, recurse);
+    }
+}
+void xml::lite::CompactElement::getElementsByTagName(const QName& name,
+                                                     std::vector<CompactElement>& elements,
+                                                     bool recurse) const
+{
+    const auto uri = mDocument->find(name.getUri().value);
+    const auto localName = mDocument->find(name.getName());
+    if ((uri != CompactDocument::NONE) && (localName != CompactDocument::NONE))
+    {
+        const auto match = [uri, localName](const CompactDocument::Node& node) {
+            return (node.localName == localName) && (node.uri == uri); };
+        findElements(match, elements, recurse);
+    }
+}
+void xml::lite::CompactElement::getElementsByTagNameNS(const std::string& qname,
+                                                       std::vector<CompactElement>& elements,
+                                                       bool recurse) const
+{
+    const auto id = mDocument->find(qname);
+    if (id != CompactDocument::NONE)
+    {
+        const auto match = [id](const CompactDocument::Node& node) { return node.qname == id; };
+        findElements(match, elements, recurse);
+    }
+}
+
+static xml::lite::CompactElement getElement(const std::vector<xml::lite::CompactElement>& elements)
+{
+    return elements.size() == 1 ? elements[0] : xml::lite::CompactElement();
+}
+template <typename TMakeContext>
+static xml::lite::CompactElement getElement(const std::vector<xml::lite::CompactElement>& elements,
+                                            TMakeContext makeContext)
+{
+    if (elements.size() != 1)
+    {
+        throw xml::lite::XMLException(makeContext(std::to_string(elements.size())));
+    }
+    return elements[0];
+}
+
+xml::lite::CompactElement xml::lite::CompactElement::getElementByTagName(
+    const std::string& localName, bool recurse) const
+{
+    auto makeContext = [&](const std::string& sz) {
+        return Ctxt("Expected exactly one '" + localName + "'; but got " + sz); };
+    return getElement(getElementsByTagName(localName, recurse), makeContext);
+}
+xml::lite::CompactElement xml::lite::CompactElement::getElementByTagName(
+    const QName& name, bool recurse) const
+{
+    auto makeContext = [&](const std::string& sz) {
+        return Ctxt("Expected exactly one '" + name.getName() + "' (uri=" +
+                    name.getUri().value + "); but got " + sz); };
+    return getElement(getElementsByTagName(name, recurse), makeContext);
+}
+xml::lite::CompactElement xml::lite::CompactElement::getElementByTagName(std::nothrow_t,
+    const std::string& localName, bool recurse) const
+{
+    return getElement(getElementsByTagName(localName, recurse));
+}
+xml::lite::CompactElement xml::lite::CompactElement::getElementByTagName(std::nothrow_t,
+    const QName& name, bool recurse) const
+{
+    return getElement(getElementsByTagName(name, recurse));
+}
+
+bool xml::lite::CompactElement::hasElement(const std::string& localName) const
+{
+    return !getElementsByTagName(localName).empty();
+}
+bool xml::lite::CompactElement::hasElement(const QName& name) const
+{
+    return !getElementsByTagName(name).empty();
+}
+
+std::unique_ptr<xml::lite::Element> xml::lite::CompactElement::toElement() const
+{
+    auto retval = Element::create(getQName(), getUri());
+    retval->setAttributes(getAttributes().toAttributes());
+    coda_oss::u8string characterData;
+    retval->setCharacterData(getCharacterData(characterData));
+    for (auto child = getFirstChild(); child; child = child.getNextSibling())
+    {
+        retval->addChild(child.toElement());
+    }
+    return retval;
+}
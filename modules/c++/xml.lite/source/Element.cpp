@@ -32,6 +32,7 @@
 #include <sys/OS.h>
 #include <str/Encoding.h>
 #include "xml/lite/Attributes.h"
+#include "xml/lite/XMLSerializer.h"
 
 std::unique_ptr<xml::lite::Element> xml::lite::Element::create(const std::string& qname, const std::string& uri, const std::string& characterData)
 {
@@ -272,18 +273,7 @@ coda_oss::u8string xml::lite::getCharacterData(const Element& e)
     return e.getCharacterData(retval);
 }
 
-static void writeCharacterData_utf8(io::OutputStream& stream, const std::u8string& characterData)
-{
-    stream.write(characterData);  // call UTF-8 overload
-}
-static void writeCharacterData_native(io::OutputStream& stream, const std::u8string& characterData)
-{
-    stream.write(str::to_native(characterData));
-}
-
-static void depthPrint_(const xml::lite::Element& element,
-    io::OutputStream& stream, int depth, const std::string& formatter,
-    void(*writeCharacterData)(io::OutputStream&, const std::u8string&))
+void xml::lite::Element::depthPrint(io::OutputStream& stream, int depth, const std::string& formatter, bool isConsoleOutput) const
 {
     // XML must be stored in UTF-8 (or UTF-16/32), in particular, not Windows-1252. 
     //
@@ -291,61 +281,9 @@ static void depthPrint_(const xml::lite::Element& element,
     // and Windows-1252 won't display nicely on Linux.  Of course, "console output" is a bit
     // iffy since both Windows and Linux support redirection ... so the user could still generate
     // a bad XML file.
-
-    std::string prefix = "";
-    for (int i = 0; i < depth; ++i)
-        prefix += formatter;
-
-    // Printing in XML form, recursively
-    std::string lBrack = "<";
-    static const std::string rBrack = ">";
-
-    const auto name = element.getQName();
-    std::string acc = prefix + lBrack + name;
-
-    auto&& attributes = element.getAttributes();
-    for (int i = 0; i < attributes.getLength(); i++)
-    {
-        acc += std::string(" ");
-        acc += attributes.getQName(i);
-        acc += std::string("=\"");
-        acc += attributes.getValue(i);
-        acc += std::string("\"");
-    }
-
-    const auto characterData = getCharacterData(element);
-    auto&& children = element.getChildren();
-    if (characterData.empty() && children.empty())
-    {
-        //simple type - just end it here
-        stream.write(acc + "/" + rBrack);
-    }
-    else
-    {
-        stream.write(acc + rBrack);            
-        writeCharacterData(stream, characterData);
-
-        for (auto&& child: children)
-        {
-            if (!formatter.empty())
-                stream.write("\n");
-            depthPrint_(*child, stream, depth + 1, formatter, writeCharacterData);
-        }
-
-        if (!children.empty() && !formatter.empty())
-        {
-            stream.write("\n" + prefix);
-        }
-
-        lBrack += "/";
-        stream.write(lBrack + name + rBrack);
-    }
-}
-void xml::lite::Element::depthPrint(io::OutputStream& stream, int depth, const std::string& formatter, bool isConsoleOutput) const
-{
-    const auto f = isConsoleOutput ? writeCharacterData_native // write to the console using the platform native encoding
-        : writeCharacterData_utf8;
-    depthPrint_(*this, stream, depth, formatter, f);
+    XMLSerializer serializer(formatter, false /*escape*/);  // never have escaped
+    serializer.setNativeCharacterData(isConsoleOutput);
+    serializer.write(*this, stream, depth);
 }
 
 void xml::lite::Element::addChild(xml::lite::Element * node)
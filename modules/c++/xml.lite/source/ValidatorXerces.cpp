@@ -22,10 +22,13 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <mutex>
 #include <std/filesystem>
 #include <std/memory>
 #include <std/string>
 #include <regex>
+#include <string.h>
 #include <tuple> // std::ignore
 
 #include <config/compiler_extensions.h>
@@ -46,6 +49,7 @@ namespace fs = std::filesystem;
 #include <xml/lite/xml_lite_config.h>
 #ifdef USE_XERCES
 #include <xml/lite/ValidatorXerces.h>
+#include <xml/lite/XMLReaderXerces.h>
 
 namespace xml
 {
@@ -90,40 +94,24 @@ bool ValidationErrorHandler::handleError(
     return true;
 }
 
-ValidatorXerces::ValidatorXerces(
-        const std::vector<fs::path>& schemaPaths,
-        logging::Logger* log,
-        bool recursive) :
-    ValidatorXerces(sys::convertPaths(schemaPaths), log, recursive)
+static std::unique_ptr<xercesc::DOMLSParser> createParser(xercesc::XMLGrammarPool& schemaPool,
+                                                          ValidationErrorHandler& errorHandler)
 {
-}
-ValidatorXerces::ValidatorXerces(
-    const std::vector<std::string>& schemaPaths, 
-    logging::Logger* log,
-    bool recursive) :
-    ValidatorInterface(schemaPaths, log, recursive)
-{
-    // add each schema into a grammar pool --
-    // this allows reuse
-    mSchemaPool.reset(
-        new xercesc::XMLGrammarPoolImpl(
-            xercesc::XMLPlatformUtils::fgMemoryManager));
-
     const XMLCh ls_id [] = {xercesc::chLatin_L, 
                             xercesc::chLatin_S, 
                             xercesc::chNull};
 
     // create the validator
-    mValidator.reset(
+    std::unique_ptr<xercesc::DOMLSParser> retval(
         xercesc::DOMImplementationRegistry::
             getDOMImplementation (ls_id)->createLSParser(
                 xercesc::DOMImplementationLS::MODE_SYNCHRONOUS,
                 nullptr, 
                 xercesc::XMLPlatformUtils::fgMemoryManager,
-                mSchemaPool.get()));
+                &schemaPool));
 
     // set the configuration settings
-    xercesc::DOMConfiguration* config = mValidator->getDomConfig();
+    xercesc::DOMConfiguration* config = retval->getDomConfig();
     config->setParameter(xercesc::XMLUni::fgDOMComments, false);
     config->setParameter(xercesc::XMLUni::fgDOMDatatypeNormalization, true);
     config->setParameter(xercesc::XMLUni::fgDOMEntities, false);
@@ -148,34 +136,171 @@ ValidatorXerces::ValidatorXerces(
     config->setParameter(xercesc::XMLUni::fgXercesUserAdoptsDOMDocument, true);
 
     // add a error handler we still have control over
-    mErrorHandler.reset(
-            new ValidationErrorHandler());
     config->setParameter(xercesc::XMLUni::fgDOMErrorHandler, 
-                         mErrorHandler.get());
+                         &errorHandler);
 
-    // load our schemas --
-    // search each directory for schemas
-    const auto schemas = loadSchemas(sys::convertPaths(schemaPaths), recursive);
+    return retval;
+}
+
+/*!
+ *  Once locked, a Xerces grammar pool can be used by any number of parsers
+ *  at once; so there's just one for each set of schemas.
+ */
+struct ValidatorXerces::SchemaPool final
+{
+    XercesContext mCtxt;  // Xerces must outlive the pool
+    std::unique_ptr<xercesc::XMLGrammarPool> mPool;
 
-    //  add the schema to the validator
-    //  add the schema to the validator
-    for (auto&& schema : schemas)
+    SchemaPool(const std::vector<fs::path>& schemas, logging::Logger* log) :
+        mPool(new xercesc::XMLGrammarPoolImpl(xercesc::XMLPlatformUtils::fgMemoryManager))
     {
-        if (!mValidator->loadGrammar(schema.c_str(),
+        // add each schema into a grammar pool --
+        // this allows reuse
+        ValidationErrorHandler errorHandler;
+        const auto parser = createParser(*mPool, errorHandler);
+        for (auto&& schema : schemas)
+        {
+            if (!parser->loadGrammar(schema.c_str(),
                                      xercesc::Grammar::SchemaGrammarType,
                                      true))
+            {
+                if (log != nullptr)
+                {
+                    std::ostringstream oss;
+                    oss << "Error: Failure to load schema " << schema;
+                    log->warn(Ctxt(oss));
+                }
+            }
+        }
+
+        //! no additional schemas will be loaded after this point!
+        mPool->lockPool();
+    }
+
+    using key_type = std::vector<std::string>;
+    struct Cache final
+    {
+        std::mutex mMutex;
+        std::map<key_type, std::shared_ptr<const SchemaPool>> mPools;
+    };
+    static Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+
+    static std::shared_ptr<const SchemaPool> get(const std::vector<fs::path>& schemas, logging::Logger* log)
+    {
+        // The same schemas in a different order are still the same schemas
+        key_type key;
+        std::transform(schemas.begin(), schemas.end(), std::back_inserter(key),
+                       [](const fs::path& schema) { return fs::absolute(schema).string(); });
+        std::sort(key.begin(), key.end());
+        key.erase(std::unique(key.begin(), key.end()), key.end());
+
+        // Holding the lock while loading keeps two threads from compiling
+        // the same schemas; it's rare for different ones to be wanted at once.
+        auto& cache = getCache();
+        std::lock_guard<std::mutex> lock(cache.mMutex);
+        auto& retval = cache.mPools[key];
+        if (retval == nullptr)
+        {
+            retval = std::make_shared<const SchemaPool>(schemas, log);
+        }
+        return retval;
+    }
+};
+
+namespace
+{
+struct Parser final
+{
+    ValidationErrorHandler mErrorHandler;
+    std::unique_ptr<xercesc::DOMLSParser> mParser;
+};
+}
+
+//! A DOMLSParser can only parse one document at a time
+struct ValidatorXerces::Parsers final
+{
+    xercesc::XMLGrammarPool& mSchemaPool;
+    std::mutex mMutex;
+    std::vector<std::unique_ptr<Parser>> mIdle;
+
+    Parsers(xercesc::XMLGrammarPool& schemaPool) : mSchemaPool(schemaPool)
+    {
+    }
+
+    std::unique_ptr<Parser> acquire()
+    {
         {
-            if (log != nullptr)
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mIdle.empty())
             {
-                std::ostringstream oss;
-                oss << "Error: Failure to load schema " << schema;
-                log->warn(Ctxt(oss));
+                auto retval = std::move(mIdle.back());
+                mIdle.pop_back();
+                return retval;
             }
         }
+
+        // Every thread is busy parsing: make another
+        auto retval = std::make_unique<Parser>();
+        retval->mParser = createParser(mSchemaPool, retval->mErrorHandler);
+        return retval;
+    }
+
+    void release(std::unique_ptr<Parser>&& parser)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIdle.push_back(std::move(parser));
+    }
+};
+
+ValidatorXerces::ValidatorXerces(
+        const std::vector<fs::path>& schemaPaths,
+        logging::Logger* log,
+        bool recursive) :
+    ValidatorXerces(sys::convertPaths(schemaPaths), log, recursive)
+{
+}
+ValidatorXerces::ValidatorXerces(
+    const std::vector<std::string>& schemaPaths, 
+    logging::Logger* log,
+    bool recursive) :
+    ValidatorInterface(schemaPaths, log, recursive)
+{
+    // load our schemas --
+    // search each directory for schemas
+    const auto schemas = loadSchemas(sys::convertPaths(schemaPaths), recursive);
+    mSchemaPool = SchemaPool::get(schemas, log);
+    mParsers = std::make_unique<Parsers>(*mSchemaPool->mPool);
+}
+ValidatorXerces::~ValidatorXerces() = default;
+
+// Each validator has its own XercesContext, which can't be moved; the
+// schemas and parsers can.
+ValidatorXerces::ValidatorXerces(ValidatorXerces&& other) :
+    ValidatorInterface(std::move(other)),
+    mSchemaPool(std::move(other.mSchemaPool)),
+    mParsers(std::move(other.mParsers))
+{
+}
+ValidatorXerces& ValidatorXerces::operator=(ValidatorXerces&& other)
+{
+    if (this != &other)
+    {
+        // The parsers use the schemas, so they go first
+        mParsers = std::move(other.mParsers);
+        mSchemaPool = std::move(other.mSchemaPool);
     }
+    return *this;
+}
 
-    //! no additional schemas will be loaded after this point!
-    mSchemaPool->lockPool();
+void ValidatorXerces::clearSchemaCache()
+{
+    auto& cache = SchemaPool::getCache();
+    std::lock_guard<std::mutex> lock(cache.mMutex);
+    cache.mPools.clear();
 }
 
 std::vector<coda_oss::filesystem::path> ValidatorXerces::loadSchemas(const std::vector<coda_oss::filesystem::path>& schemaPaths, bool recursive)
@@ -218,38 +343,54 @@ static std::unique_ptr<XMLCh_string> setStringData(xercesc::DOMLSInputImpl& inpu
     return retval;
 }
 
-bool ValidatorXerces::validate_(const std::u8string& xml, 
-                               const std::string& xmlID,
-                               std::vector<ValidationInfo>& errors) const
+bool ValidatorXerces::validate_(xercesc::DOMLSInput& input,
+                                const std::string& xmlID,
+                                std::vector<ValidationInfo>& errors) const
 {
+    auto parser = mParsers->acquire();
+    auto& errorHandler = parser->mErrorHandler;
+
     // clear the log before its use -- 
     // however we do not clear the users 'errors' because 
     // they might want an accumulation of errors
-    mErrorHandler->clearErrorLog();
+    errorHandler.clearErrorLog();
 
     // set the id so all errors coming from this session 
     // get a matching id
-    mErrorHandler->setID(xmlID);
-
-    // get a vehicle to validate data
-    xercesc::DOMLSInputImpl input(
-        xercesc::XMLPlatformUtils::fgMemoryManager);
-
-    // expand to the wide character data for use with xerces
-    auto pWString = setStringData(input, xml);
+    errorHandler.setID(xmlID);
 
     // validate the document
-    mValidator->parse(&input)->release();
+    auto pDocument = parser->mParser->parse(&input);
+    if (pDocument != nullptr)
+    {
+        pDocument->release();
+    }
 
     // add the new errors to the vector 
     errors.insert(errors.end(), 
-                  mErrorHandler->getErrorLog().begin(), 
-                  mErrorHandler->getErrorLog().end());
+                  errorHandler.getErrorLog().begin(), 
+                  errorHandler.getErrorLog().end());
+    const auto retval = !errorHandler.getErrorLog().empty();
 
     // reset the id
-    mErrorHandler->setID("");
+    errorHandler.setID("");
 
-    return (!mErrorHandler->getErrorLog().empty());
+    mParsers->release(std::move(parser));
+    return retval;
+}
+
+bool ValidatorXerces::validate_(const std::u8string& xml, 
+                               const std::string& xmlID,
+                               std::vector<ValidationInfo>& errors) const
+{
+    // get a vehicle to validate data
+    xercesc::DOMLSInputImpl input(
+        xercesc::XMLPlatformUtils::fgMemoryManager);
+
+    // expand to the wide character data for use with xerces
+    auto pWString = setStringData(input, xml);
+
+    return validate_(input, xmlID, errors);
 }
 
 static coda_oss::u8string encodeXml(const std::string& xml)
@@ -304,6 +445,155 @@ bool ValidatorXerces::validate(const str::W1252string& xml,
     return validate(str::to_u8string(xml), xmlID, errors);
 }
 
+// Xerces figures out the encoding from a BOM or an encoding declaration
+static bool hasEncoding(const std::string& prefix)
+{
+    static const std::string utf8Bom("\xEF\xBB\xBF");
+    if ((prefix.compare(0, utf8Bom.size(), utf8Bom) == 0) ||
+        (prefix.compare(0, 2, "\xFE\xFF") == 0) || (prefix.compare(0, 2, "\xFF\xFE") == 0))
+    {
+        return true;
+    }
+    if (prefix.compare(0, 5, "<?xml") != 0)
+    {
+        return false;
+    }
+    const auto end = prefix.find("?>");
+    return prefix.find("encoding", 5) < end;
+}
+
+// Otherwise, XML is UTF-8; but validate(std::string) has always taken such
+// XML to be "native," falling back to Windows-1252 if it isn't valid UTF-8.
+static const XMLCh* getEncoding(const char* pXml, size_t size)
+{
+    if ((sys::Platform == sys::PlatformType::Linux) && utf8::is_valid(pXml, pXml + size))
+    {
+        return xercesc::XMLUni::fgUTF8EncodingString;
+    }
+    return xercesc::XMLUni::fgWin1252EncodingString;
+}
+
+// Append up to size bytes to buffer; false at the end of the stream
+static bool read(io::InputStream& is, std::string& buffer, size_t size)
+{
+    auto offset = buffer.size();
+    buffer.resize(offset + size);
+    while (offset < buffer.size())
+    {
+        const auto numBytes = is.read(&buffer[offset], buffer.size() - offset);
+        if (numBytes <= 0)
+        {
+            break;
+        }
+        offset += static_cast<size_t>(numBytes);
+    }
+    const auto retval = offset == buffer.size();
+    buffer.resize(offset);
+    return retval;
+}
+
+namespace
+{
+// Hands Xerces what's already been read, then the rest of the stream
+class StreamBinInputStream final : public xercesc::BinInputStream
+{
+    const std::string& mPrefix;
+    io::InputStream& mInput;
+    XMLFilePos mPos = 0;
+
+public:
+    StreamBinInputStream(const std::string& prefix, io::InputStream& input) :
+        mPrefix(prefix), mInput(input)
+    {
+    }
+
+    XMLFilePos curPos() const override
+    {
+        return mPos;
+    }
+
+    XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead) override
+    {
+        XMLSize_t retval = 0;
+        if (mPos < mPrefix.size())
+        {
+            retval = std::min(static_cast<XMLSize_t>(mPrefix.size() - mPos), maxToRead);
+            memcpy(toFill, mPrefix.data() + mPos, retval);
+        }
+        else
+        {
+            const auto numBytes = mInput.read(toFill, maxToRead);
+            retval = numBytes <= 0 ? 0 : static_cast<XMLSize_t>(numBytes);
+        }
+        mPos += retval;
+        return retval;
+    }
+
+    const XMLCh* getContentType() const override
+    {
+        return nullptr;
+    }
+};
+
+class StreamInputSource final : public xercesc::InputSource
+{
+    const std::string& mPrefix;
+    io::InputStream& mInput;
+
+public:
+    StreamInputSource(const std::string& prefix, io::InputStream& input) :
+        InputSource(XMLReaderXerces::MEM_BUFFER_ID()),
+        mPrefix(prefix), mInput(input)
+    {
+    }
+
+    xercesc::BinInputStream* makeStream() const override
+    {
+        return new StreamBinInputStream(mPrefix, mInput);
+    }
+};
+}
+
+bool ValidatorXerces::validate(io::InputStream& xml,
+                               const std::string& xmlID,
+                               std::vector<ValidationInfo>& errors) const
+{
+    // Enough to see the XML declaration
+    std::string buffer;
+    auto more = read(xml, buffer, io::InputStream::DEFAULT_CHUNK_SIZE);
+    if (hasEncoding(buffer))
+    {
+        StreamInputSource source(buffer, xml);
+        xercesc::DOMLSInputImpl input(xercesc::XMLPlatformUtils::fgMemoryManager);
+        input.setByteStream(&source);
+        return validate_(input, xmlID, errors);
+    }
+
+    // Have to look at all of it to know the encoding
+    while (more)
+    {
+        more = read(xml, buffer, buffer.size());
+    }
+    return validate(buffer.data(), buffer.size(), xmlID, errors);
+}
+bool ValidatorXerces::validate(const void* pXml, size_t size,
+                               const std::string& xmlID,
+                               std::vector<ValidationInfo>& errors) const
+{
+    const auto p = static_cast<const char*>(pXml);
+    xercesc::MemBufInputSource source(reinterpret_cast<const XMLByte*>(p), size,
+                                      XMLReaderXerces::MEM_BUFFER_ID(), false /*adoptBuffer*/);
+    xercesc::DOMLSInputImpl input(xercesc::XMLPlatformUtils::fgMemoryManager);
+    input.setByteStream(&source);
+
+    const std::string prefix(p, std::min(size, static_cast<size_t>(io::InputStream::DEFAULT_CHUNK_SIZE)));
+    if (!hasEncoding(prefix))
+    {
+        input.setEncoding(getEncoding(p, size));  // not source: Xerces only looks at input
+    }
+    return validate_(input, xmlID, errors);
+}
+
 }
 }
 #endif
@@ -0,0 +1,335 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "xml/lite/XMLPullReader.h"
+
+#include <stdexcept>
+#include <std/string>
+#include <utility>
+
+#include "str/Manip.h"
+#include "str/Encoding.h"
+
+#if defined(USE_XERCES)
+
+namespace
+{
+// Hands Xerces the bytes of an io::InputStream as it asks for them
+class StreamBinInputStream final : public BinInputStream
+{
+    io::InputStream& mInput;
+    XMLFilePos mPos = 0;
+
+public:
+    StreamBinInputStream(io::InputStream& input) : mInput(input)
+    {
+    }
+
+    XMLFilePos curPos() const override
+    {
+        return mPos;
+    }
+
+    XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead) override
+    {
+        const auto numBytes = mInput.read(toFill, maxToRead);
+        if (numBytes <= 0)
+        {
+            return 0;
+        }
+        mPos += static_cast<XMLFilePos>(numBytes);
+        return static_cast<XMLSize_t>(numBytes);
+    }
+
+    const XMLCh* getContentType() const override
+    {
+        return nullptr;
+    }
+};
+
+class StreamInputSource final : public InputSource
+{
+    io::InputStream& mInput;
+
+public:
+    StreamInputSource(io::InputStream& input) :
+        InputSource(xml::lite::XMLReaderXerces::MEM_BUFFER_ID()),
+        mInput(input)
+    {
+    }
+
+    BinInputStream* makeStream() const override
+    {
+        return new StreamBinInputStream(mInput);
+    }
+};
+}
+
+struct xml::lite::XMLPullReader::Handler final : public ContentHandler
+{
+    XMLPullReader& mReader;
+
+    Handler(XMLPullReader& reader) : mReader(reader)
+    {
+    }
+
+    void endDocument() override
+    {
+        mReader.mDone = true;
+    }
+
+    // Coalesce with queued character data, but leave the current event alone
+    coda_oss::u8string& characterData()
+    {
+        auto& reader = mReader;
+        if ((reader.mNumEvents > reader.mNext) &&
+            (reader.mEvents[reader.mNumEvents - 1].type == EventType::Characters))
+        {
+            return reader.mEvents[reader.mNumEvents - 1].characters;
+        }
+        return reader.push(EventType::Characters).characters;
+    }
+
+    void characters(const char* value, int length) override
+    {
+        // As with MinidomHandler, we're only here if vcharacters() failed
+        characterData() += str::u8FromNative(std::string(value, length));
+    }
+
+    bool vcharacters(const void /*XMLCh*/* chars_, size_t length) override
+    {
+        if (chars_ == nullptr)
+        {
+            throw std::invalid_argument("chars_ is NULL.");
+        }
+
+        static_assert(sizeof(XMLCh) == sizeof(char16_t), "XMLCh should be 16-bits.");
+        auto pChars16 = static_cast<const char16_t*>(chars_);
+        characterData() += str::to_u8string(pChars16, length);
+        return true; // vcharacters() processed
+    }
+
+    void startElement(const std::string& uri,
+                      const std::string& localName,
+                      const std::string& qname,
+                      const Attributes& atts) override
+    {
+        auto& event = mReader.push(EventType::StartElement);
+        event.uri = uri;
+        event.localName = localName;
+        event.qname = qname;
+        event.attributes = atts;
+    }
+
+    void endElement(const std::string& uri,
+                    const std::string& localName,
+                    const std::string& qname) override
+    {
+        auto& event = mReader.push(EventType::EndElement);
+        event.uri = uri;
+        event.localName = localName;
+        event.qname = qname;
+    }
+};
+
+xml::lite::XMLPullReader::XMLPullReader(io::InputStream& is, const void* pEncoding) :
+    mSource(new StreamInputSource(is)),
+    mHandler(new Handler(*this))
+{
+    if (pEncoding != nullptr)
+    {
+        mSource->setEncoding(static_cast<const XMLCh*>(pEncoding));
+    }
+
+    mDriverContentHandler.reset(new XercesContentHandler(mHandler.get()));
+    mErrorHandler.reset(new XercesErrorHandler());
+
+    mNative = XMLReaderXerces::createNativeReader();
+    mNative->setContentHandler(mDriverContentHandler.get());
+    mNative->setErrorHandler(mErrorHandler.get());
+}
+
+xml::lite::XMLPullReader::~XMLPullReader()
+{
+    // Xerces holds on to the input until a progressive parse is reset
+    if (mStarted)
+    {
+        try
+        {
+            mNative->parseReset(mToken);
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+xml::lite::XMLPullReader::Event& xml::lite::XMLPullReader::push(EventType type)
+{
+    if (mNumEvents == mEvents.size())
+    {
+        mEvents.emplace_back();
+    }
+
+    auto& event = mEvents[mNumEvents++];
+    event.type = type;
+    event.uri.clear();
+    event.localName.clear();
+    event.qname.clear();
+    event.attributes.clear();
+    event.characters.clear();
+    return event;
+}
+
+void xml::lite::XMLPullReader::parseNext()
+{
+    try
+    {
+        if (!mStarted)
+        {
+            mStarted = true;
+            if (!mNative->parseFirst(*mSource, mToken))
+            {
+                mDone = true;
+                throw xml::lite::XMLParseException(Ctxt("Unable to start parsing"));
+            }
+        }
+        else if (!mNative->parseNext(mToken))
+        {
+            mDone = true;
+        }
+    }
+    catch (...)
+    {
+        // There's no picking up after an error
+        mDone = true;
+        throw;
+    }
+}
+
+xml::lite::XMLPullReader::EventType xml::lite::XMLPullReader::next()
+{
+    if (mEventType == EventType::EndElement)
+    {
+        --mDepth;
+    }
+
+    // Everything queued has been returned; start reusing events
+    if (mNext == mNumEvents)
+    {
+        mNext = mNumEvents = 0;
+    }
+
+    // Character data can arrive in pieces; wait for all of it
+    while (!mDone &&
+           ((mNext == mNumEvents) ||
+            ((mNumEvents - mNext == 1) &&
+             (mEvents[mNext].type == EventType::Characters))))
+    {
+        parseNext();
+    }
+
+    if (mNext == mNumEvents)
+    {
+        mCurrent = mNumEvents;
+        mEventType = EventType::EndDocument;
+        return mEventType;
+    }
+
+    mCurrent = mNext++;
+    mEventType = mEvents[mCurrent].type;
+    if (mEventType == EventType::StartElement)
+    {
+        ++mDepth;
+    }
+    return mEventType;
+}
+
+void xml::lite::XMLPullReader::checkStartElement(const char* method) const
+{
+    if (!isStartElement())
+    {
+        throw xml::lite::XMLException(Ctxt(std::string(method) +
+                                           "() must be called at a start element"));
+    }
+}
+
+std::unique_ptr<xml::lite::Element> xml::lite::XMLPullReader::readSubtree()
+{
+    checkStartElement("readSubtree");
+
+    auto retval = Element::create(getQName(), getUri());
+    retval->setAttributes(getAttributes());
+
+    // As MinidomHandler does, but without the Document
+    std::vector<Element*> nodeStack{ retval.get() };
+    std::vector<coda_oss::u8string> characterData(1);
+    while (!nodeStack.empty())
+    {
+        switch (next())
+        {
+        case EventType::StartElement:
+        {
+            auto child = Element::create(getQName(), getUri());
+            child->setAttributes(getAttributes());
+            nodeStack.push_back(&nodeStack.back()->addChild(std::move(child)));
+            characterData.emplace_back();
+            break;
+        }
+        case EventType::Characters:
+            characterData.back() += getCharacterData();
+            break;
+        case EventType::EndElement:
+        {
+            auto& s = characterData.back();
+            if (!mPreserveCharData && !s.empty())
+            {
+                str::trim(s);
+            }
+            nodeStack.back()->setCharacterData(std::move(s));
+            nodeStack.pop_back();
+            characterData.pop_back();
+            break;
+        }
+        case EventType::EndDocument:
+        default:
+            throw xml::lite::XMLParseException(Ctxt("Unexpected end of document"));
+        }
+    }
+    return retval;
+}
+
+void xml::lite::XMLPullReader::skipSubtree()
+{
+    checkStartElement("skipSubtree");
+
+    const auto depth = getDepth();
+    while (!(isEndElement() && (getDepth() == depth)))
+    {
+        if (next() == EventType::EndDocument)
+        {
+            throw xml::lite::XMLParseException(Ctxt("Unexpected end of document"));
+        }
+    }
+}
+
+#endif
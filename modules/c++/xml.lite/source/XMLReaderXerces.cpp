@@ -104,21 +104,27 @@ void xml::lite::XMLReaderXerces::parse(io::InputStream& is, int size)
     parse(is, nullptr /*pInitialEncoding*/, getWindows1252Encoding(), size);
 }
 
+std::unique_ptr<SAX2XMLReader> xml::lite::XMLReaderXerces::createNativeReader()
+{
+    std::unique_ptr<SAX2XMLReader> retval(XMLReaderFactory::createXMLReader());
+    retval->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+    retval->setFeature(XMLUni::fgSAX2CoreValidation, false);   // optional
+    retval->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);    // optional
+    retval->setFeature(XMLUni::fgXercesSchema, false);
+    // We do schema validation as an option not DTDs
+    retval->setFeature(XMLUni::fgXercesSkipDTDValidation, true);
+    // Trying to load external DTDs can cause the parser to hang
+    retval->setFeature(XMLUni::fgXercesLoadExternalDTD, false);
+    return retval;
+}
+
 // This function creates the parser
 void xml::lite::XMLReaderXerces::create()
 {
     mDriverContentHandler.reset(new XercesContentHandler());
     mErrorHandler.reset(new XercesErrorHandler());
 
-    mNative.reset(XMLReaderFactory::createXMLReader());
-    mNative->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
-    mNative->setFeature(XMLUni::fgSAX2CoreValidation, false);   // optional
-    mNative->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);    // optional
-    mNative->setFeature(XMLUni::fgXercesSchema, false);
-    // We do schema validation as an option not DTDs
-    mNative->setFeature(XMLUni::fgXercesSkipDTDValidation, true);
-    // Trying to load external DTDs can cause the parser to hang
-    mNative->setFeature(XMLUni::fgXercesLoadExternalDTD, false);
+    mNative = createNativeReader();
     mNative->setContentHandler(mDriverContentHandler.get());
     mNative->setErrorHandler(mErrorHandler.get());
 }
@@ -0,0 +1,228 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "xml/lite/XMLSerializer.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <str/Encoding.h>
+
+namespace
+{
+// Word-at-a-time byte tests; see "Determine if a word has a byte equal to
+// n" in Sean Anderson's Bit Twiddling Hacks.
+constexpr uint64_t ONES = 0x0101010101010101ULL;
+constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+
+inline uint64_t hasByte(uint64_t word, unsigned char c)
+{
+    const uint64_t x = word ^ (ONES * c);
+    return (x - ONES) & ~x & HIGHS;
+}
+
+inline bool needsEscape(uint64_t word, bool isAttribute)
+{
+    uint64_t result = hasByte(word, '&') | hasByte(word, '<') | hasByte(word, '>');
+    if (isAttribute)
+    {
+        result |= hasByte(word, '"');
+    }
+    return result != 0;
+}
+
+inline uint64_t load(const char* p)
+{
+    uint64_t retval;
+    memcpy(&retval, p, sizeof(retval));
+    return retval;
+}
+
+inline const char* getEscape(char c, bool isAttribute)
+{
+    switch (c)
+    {
+    case '&': return "&amp;";
+    case '<': return "&lt;";
+    case '>': return "&gt;";
+    case '"': return isAttribute ? "&quot;" : nullptr;
+    default: return nullptr;
+    }
+}
+
+// ASCII is the same in UTF-8 and the native encoding
+bool isAscii(const coda_oss::u8string& s)
+{
+    const auto p = reinterpret_cast<const char*>(s.data());
+    const auto size = s.size();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        if (load(p + i) & HIGHS)
+        {
+            return false;
+        }
+    }
+    for (; i < size; ++i)
+    {
+        if (static_cast<unsigned char>(p[i]) & 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+xml::lite::XMLSerializer::XMLSerializer(const std::string& formatter, bool escape) :
+    mFormatter(formatter),
+    mEscape(escape)
+{
+}
+
+const std::string& xml::lite::XMLSerializer::serialize(const Element& element, int depth)
+{
+    mBuffer.clear();
+    writeElement(element, depth);
+    return mBuffer;
+}
+
+void xml::lite::XMLSerializer::write(const Element& element, io::OutputStream& stream, int depth)
+{
+    serialize(element, depth);
+    stream.write(mBuffer.data(), mBuffer.size());
+}
+
+void xml::lite::XMLSerializer::clear()
+{
+    std::string().swap(mBuffer);
+    std::string().swap(mValue);
+}
+
+void xml::lite::XMLSerializer::writeIndent(int depth)
+{
+    for (int i = 0; i < depth; ++i)
+    {
+        mBuffer += mFormatter;
+    }
+}
+
+void xml::lite::XMLSerializer::writeText(const char* p, size_t size, bool isAttribute)
+{
+    if (!mEscape)
+    {
+        mBuffer.append(p, size);
+        return;
+    }
+
+    // Copy runs of bytes that don't need escaping, skipping a word at a time
+    size_t start = 0;
+    size_t i = 0;
+    while (i < size)
+    {
+        while ((i + sizeof(uint64_t) <= size) && !needsEscape(load(p + i), isAttribute))
+        {
+            i += sizeof(uint64_t);
+        }
+        for (const auto end = std::min(i + sizeof(uint64_t), size); i < end; ++i)
+        {
+            const auto escaped = getEscape(p[i], isAttribute);
+            if (escaped != nullptr)
+            {
+                mBuffer.append(p + start, i - start);
+                mBuffer += escaped;
+                start = i + 1;
+            }
+        }
+    }
+    mBuffer.append(p + start, size - start);
+}
+
+void xml::lite::XMLSerializer::writeCharacterData(const coda_oss::u8string& characterData)
+{
+    // Converting to native is only needed (and only costs) for non-ASCII
+    if (mNativeCharacterData && !isAscii(characterData))
+    {
+        const auto native = str::to_native(characterData);
+        writeText(native.data(), native.size(), false /*isAttribute*/);
+        return;
+    }
+    writeText(reinterpret_cast<const char*>(characterData.data()), characterData.size(),
+              false /*isAttribute*/);
+}
+
+void xml::lite::XMLSerializer::writeElement(const Element& element, int depth)
+{
+    writeIndent(depth);
+
+    // The name goes in the start tag here, and is copied from there for the
+    // end tag; the buffer may move in between, but not the offset.
+    mBuffer += '<';
+    const auto nameOffset = mBuffer.size();
+    mBuffer += element.getQName();
+    const auto nameLength = mBuffer.size() - nameOffset;
+
+    const auto& attributes = element.getAttributes();
+    for (int i = 0; i < attributes.getLength(); i++)
+    {
+        mBuffer += ' ';
+        mBuffer += attributes.getQName(i);
+        mBuffer += "=\"";
+        attributes.getValue(i, mValue);
+        writeText(mValue.data(), mValue.size(), true /*isAttribute*/);
+        mBuffer += '"';
+    }
+
+    const auto& characterData = element.mCharacterData;
+    const auto& children = element.getChildren();
+    if (characterData.empty() && children.empty())
+    {
+        //simple type - just end it here
+        mBuffer += "/>";
+        return;
+    }
+
+    mBuffer += '>';
+    writeCharacterData(characterData);
+
+    for (auto&& child : children)
+    {
+        if (!mFormatter.empty())
+        {
+            mBuffer += '\n';
+        }
+        writeElement(*child, depth + 1);
+    }
+
+    if (!children.empty() && !mFormatter.empty())
+    {
+        mBuffer += '\n';
+        writeIndent(depth);
+    }
+
+    mBuffer += "</";
+    mBuffer.reserve(mBuffer.size() + nameLength + 1);
+    mBuffer.append(mBuffer.data() + nameOffset, nameLength);
+    mBuffer += '>';
+}
@@ -0,0 +1,177 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Times writing a parsed document (e.g., large_benchmark1.xml) with
+// xml::lite::XMLSerializer, against the depthPrint_() that Element::print()
+// used before it.  Both write to the same kind of stream, unescaped, as
+// print() does; the output is checked to be the same before it's timed.
+
+#if defined (USE_EXPAT) || defined(USE_XERCES) || defined(USE_LIBXML)
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <string>
+
+#include <import/except.h>
+#include <import/io.h>
+#include <import/sys.h>
+#include <import/xml/lite.h>
+
+static void report(const std::string& name, double millis, size_t bytes, int iterations)
+{
+    const auto seconds = millis / 1000.0;
+    const auto megabytes = static_cast<double>(bytes) * iterations / (1024.0 * 1024.0);
+    std::cout << name << ": " << (millis / iterations) << " ms, "
+              << (megabytes / seconds) << " MB/s\n";
+}
+
+// The old Element::depthPrint(), several small writes per element
+static void depthPrint(const xml::lite::Element& element, io::OutputStream& stream,
+                       int depth, const std::string& formatter)
+{
+    std::string prefix = "";
+    for (int i = 0; i < depth; ++i)
+        prefix += formatter;
+
+    std::string lBrack = "<";
+    static const std::string rBrack = ">";
+
+    const auto name = element.getQName();
+    std::string acc = prefix + lBrack + name;
+
+    auto&& attributes = element.getAttributes();
+    for (int i = 0; i < attributes.getLength(); i++)
+    {
+        acc += std::string(" ");
+        acc += attributes.getQName(i);
+        acc += std::string("=\"");
+        acc += attributes.getValue(i);
+        acc += std::string("\"");
+    }
+
+    const auto characterData = getCharacterData(element);
+    auto&& children = element.getChildren();
+    if (characterData.empty() && children.empty())
+    {
+        stream.write(acc + "/" + rBrack);
+    }
+    else
+    {
+        stream.write(acc + rBrack);
+        stream.write(characterData);
+
+        for (auto&& child : children)
+        {
+            if (!formatter.empty())
+                stream.write("\n");
+            depthPrint(*child, stream, depth + 1, formatter);
+        }
+
+        if (!children.empty() && !formatter.empty())
+        {
+            stream.write("\n" + prefix);
+        }
+
+        lBrack += "/";
+        stream.write(lBrack + name + rBrack);
+    }
+}
+
+template<typename TFunc>
+static void benchmark(const std::string& name, int iterations, TFunc func)
+{
+    size_t bytes = 0;
+    sys::RealTimeStopWatch sw;
+    sw.start();
+    for (int i = 0; i < iterations; ++i)
+    {
+        bytes = func();
+    }
+    report(name, sw.stop(), bytes, iterations);
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc < 2 || argc > 3)
+        {
+            throw except::Exception(Ctxt(str::Format("Usage: %s <xml file> [iterations]\n", argv[0])));
+        }
+        const int iterations = argc == 3 ? atoi(argv[2]) : 10;
+
+        io::FileInputStream xmlFile(argv[1]);
+        xml::lite::MinidomParser treeBuilder;
+        treeBuilder.parse(xmlFile);
+        const auto& root = getRootElement(getDocument(treeBuilder));
+
+        for (const std::string formatter : { "", "    " })
+        {
+            const std::string mode = formatter.empty() ? "compact" : "pretty";
+
+            const auto oldWrite = [&]()
+            {
+                io::StringStream output;
+                depthPrint(root, output, 0, formatter);
+                return output.stream().str();
+            };
+            xml::lite::XMLSerializer serializer(formatter, false /*escape*/);
+            const auto newWrite = [&]()
+            {
+                io::StringStream output;
+                serializer.write(root, output);
+                return output.stream().str();
+            };
+            if (oldWrite() != newWrite())
+            {
+                throw except::Exception(Ctxt("XMLSerializer output, " + mode +
+                                             ", differs from depthPrint()"));
+            }
+
+            benchmark("depthPrint(), " + mode, iterations, [&]() {
+                return oldWrite().size();
+            });
+            benchmark("XMLSerializer, " + mode, iterations, [&]() {
+                return newWrite().size();
+            });
+        }
+
+        // Escaping is extra work the old code never did
+        xml::lite::XMLSerializer escaped;
+        benchmark("XMLSerializer, compact, escaped", iterations, [&]() {
+            io::StringStream output;
+            escaped.write(root, output);
+            return output.stream().str().size();
+        });
+    }
+    catch (const except::Throwable& t)
+    {
+        std::cout << "Caught Throwable: " << t.toString() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+#else
+int main()
+{}
+#endif
@@ -0,0 +1,154 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "io/StringStream.h"
+#include <TestCase.h>
+
+#include "xml/lite/CompactDocument.h"
+#include "xml/lite/MinidomParser.h"
+
+static const std::string& strXml()
+{
+    static const std::string retval =
+        "<root xmlns=\"urn:test\" version=\"2\">"
+          "<a>1</a>"
+          "<b><a>2</a><c id=\"x\"/><a>3</a></b>"
+          "<a>  4  </a>"
+          "text"
+        "</root>";
+    return retval;
+}
+
+static void parse(xml::lite::CompactDocument& doc, const std::string& strXml)
+{
+    io::StringStream ss;
+    ss.stream() << strXml;
+    doc.parse(ss);
+}
+
+static std::string print(const xml::lite::Element& element)
+{
+    io::StringStream output;
+    element.print(output);
+    return output.stream().str();
+}
+
+TEST_CASE(testTraverse)
+{
+    xml::lite::CompactDocument doc;
+    parse(doc, strXml());
+    TEST_ASSERT_EQ(doc.getNumElements(), static_cast<size_t>(7));
+
+    const auto root = doc.getRootElement();
+    TEST_ASSERT_TRUE(static_cast<bool>(root));
+    TEST_ASSERT_EQ(root.getLocalName(), "root");
+    TEST_ASSERT_EQ(root.getUri(), "urn:test");
+    TEST_ASSERT_EQ(root.getCharacterData(), "text");
+    TEST_ASSERT_FALSE(static_cast<bool>(root.getParent()));
+
+    const auto children = root.getChildren();
+    TEST_ASSERT_EQ(children.size(), static_cast<size_t>(3));
+    TEST_ASSERT_EQ(children[1].getLocalName(), "b");
+    TEST_ASSERT(children[1].getParent() == root);
+    TEST_ASSERT_EQ(children[2].getCharacterData(), "4");
+
+    // Same order as Element::getElementsByTagName()
+    const auto aElements = root.getElementsByTagName("a", true /*recurse*/);
+    TEST_ASSERT_EQ(aElements.size(), static_cast<size_t>(4));
+    std::string s;
+    for (auto&& a : aElements)
+    {
+        s += a.getCharacterData();
+    }
+    TEST_ASSERT_EQ(s, "1234");
+    TEST_ASSERT_EQ(root.getElementsByTagName("a").size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(root.getElementsByTagName(xml::lite::QName("urn:test", "a"), true).size(),
+                   static_cast<size_t>(4));
+    TEST_ASSERT_TRUE(root.getElementsByTagName(xml::lite::QName("urn:other", "a"), true).empty());
+    TEST_ASSERT_TRUE(root.getElementsByTagName("notInTheDocument", true).empty());
+
+    const auto c = root.getElementByTagName("c", true);
+    TEST_ASSERT_EQ(c.getAttributes().getValue("id"), "x");
+    TEST_ASSERT_TRUE(c.getCharacterData().empty());
+    TEST_ASSERT_TRUE(root.hasElement("b"));
+    TEST_ASSERT_FALSE(root.hasElement("c"));
+    TEST_EXCEPTION(root.getElementByTagName("a"));
+    TEST_ASSERT_FALSE(static_cast<bool>(root.getElementByTagName(std::nothrow, "a")));
+}
+
+TEST_CASE(testAttributes)
+{
+    xml::lite::CompactDocument doc;
+    parse(doc, strXml());
+
+    const auto attributes = doc.getRootElement().getAttributes();
+    const auto i = attributes.getIndex("version");
+    TEST_ASSERT(i >= 0);
+    TEST_ASSERT_EQ(attributes.getLocalName(i), "version");
+    TEST_ASSERT_EQ(attributes.getValue(i), "2");
+    TEST_ASSERT_EQ(attributes.getValue("version"), "2");
+    TEST_ASSERT_EQ(attributes.getIndex("nope"), -1);
+    TEST_EXCEPTION(attributes.getValue("nope"));
+
+    std::string value;
+    TEST_ASSERT_TRUE(attributes.getValue("version", value));
+    TEST_ASSERT_EQ(value, "2");
+    TEST_ASSERT_EQ(attributes.toAttributes().getValue("version"), "2");
+}
+
+TEST_CASE(testMatchesMinidom)
+{
+    xml::lite::CompactDocument doc;
+    parse(doc, strXml());
+
+    io::StringStream ss;
+    ss.stream() << strXml();
+    xml::lite::MinidomParser xmlParser;
+    xmlParser.parse(ss);
+
+    const auto& expected = getRootElement(getDocument(xmlParser));
+    const auto actual = doc.getRootElement().toElement();
+    TEST_ASSERT_EQ(print(*actual), print(expected));
+}
+
+TEST_CASE(testPreserveCharacterData)
+{
+    xml::lite::CompactDocument doc;
+    doc.preserveCharacterData(true);
+    parse(doc, strXml());
+    const auto children = doc.getRootElement().getChildren();
+    TEST_ASSERT_EQ(children.back().getCharacterData(), "  4  ");
+
+    // Parsing again starts over
+    parse(doc, "<other/>");
+    TEST_ASSERT_EQ(doc.getNumElements(), static_cast<size_t>(1));
+    TEST_ASSERT_EQ(doc.getRootElement().getLocalName(), "other");
+}
+
+TEST_MAIN(
+    TEST_CHECK(testTraverse);
+    TEST_CHECK(testAttributes);
+    TEST_CHECK(testMatchesMinidom);
+    TEST_CHECK(testPreserveCharacterData);
+)
@@ -20,6 +20,9 @@
  *
  */
 
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <std/string>
 #include <std/filesystem>
 #include <std/optional>
@@ -504,6 +507,59 @@ TEST_CASE(testValidateXmlFile)
     testValidateXmlFile(testName, "encoding_windows-1252.xml", io::W1252StringStream());
 }
 
+static std::string readFile(const std::filesystem::path& path)
+{
+    io::FileInputStream fis(path);
+    io::StringStream ss;
+    fis.streamTo(ss);
+    return ss.stream().str();
+}
+TEST_CASE(testValidateXmlBuffer)
+{
+    static const auto xsd = find_unittest_file("doc.xsd");
+    const std::vector<std::filesystem::path> schemaPaths{xsd.parent_path()};
+    const xml::lite::Validator validator(schemaPaths);
+
+    for (auto&& xmlFile : {"ascii.xml", "utf-8.xml", "encoding_utf-8.xml", "windows-1252.xml", "encoding_windows-1252.xml"})
+    {
+        const auto xml = readFile(find_unittest_file(xmlFile));
+        std::vector<xml::lite::ValidationInfo> errors;
+        TEST_ASSERT_FALSE(validator.validate(xml.data(), xml.size(), xmlFile, errors));
+        TEST_ASSERT_TRUE(errors.empty());
+    }
+}
+
+TEST_CASE(testValidateXmlThreads)
+{
+    static const auto xsd = find_unittest_file("doc.xsd");
+    const std::vector<std::filesystem::path> schemaPaths{xsd.parent_path()};
+    const xml::lite::Validator validator(schemaPaths);
+    const xml::lite::Validator sameSchemas(schemaPaths);  // cached, not loaded again
+
+    const auto xml = readFile(find_unittest_file("utf-8.xml"));
+    std::atomic<size_t> failures{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&]() {
+            for (size_t j = 0; j < 10; j++)
+            {
+                std::vector<xml::lite::ValidationInfo> errors;
+                const auto& v = (j % 2 == 0) ? validator : sameSchemas;
+                if (v.validate(xml.data(), xml.size(), "utf-8.xml", errors) || !errors.empty())
+                {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+    TEST_ASSERT_EQ(failures.load(), static_cast<size_t>(0));
+}
+
 int main(int, char**)
 {
     TEST_CHECK(testXmlParseSimple);
@@ -522,4 +578,6 @@ int main(int, char**)
     TEST_CHECK(testReadEmbeddedXml);
 
     TEST_CHECK(testValidateXmlFile);
+    TEST_CHECK(testValidateXmlBuffer);
+    TEST_CHECK(testValidateXmlThreads);
 }
@@ -0,0 +1,172 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "io/StringStream.h"
+#include "str/Encoding.h"
+#include <TestCase.h>
+
+#include "xml/lite/XMLPullReader.h"
+
+using EventType = xml::lite::XMLPullReader::EventType;
+
+static const std::string& strXml()
+{
+    static const std::string retval =
+        "<root xmlns=\"urn:test\">"
+          "<skip><a>1</a><a>2</a></skip>"
+          "<record id=\"7\"> <name>  TEXT  </name><empty/>tail</record>"
+        "</root>";
+    return retval;
+}
+
+static void readAll(xml::lite::XMLPullReader& reader)
+{
+    while (reader.next() != EventType::EndDocument)
+    {
+    }
+}
+
+static std::string characterData(const xml::lite::XMLPullReader& reader)
+{
+    return str::str<std::string>(reader.getCharacterData());
+}
+
+TEST_CASE(testEvents)
+{
+    io::StringStream ss;
+    ss.stream() << "<root><a x=\"1\">TEXT</a><b/></root>";
+    xml::lite::XMLPullReader reader(ss);
+
+    TEST_ASSERT(reader.next() == EventType::StartElement);
+    TEST_ASSERT_EQ(reader.getQName(), "root");
+    TEST_ASSERT_EQ(reader.getDepth(), static_cast<size_t>(1));
+
+    TEST_ASSERT(reader.next() == EventType::StartElement);
+    TEST_ASSERT_EQ(reader.getLocalName(), "a");
+    TEST_ASSERT_EQ(reader.getAttributes().getValue("x"), "1");
+    TEST_ASSERT_EQ(reader.getDepth(), static_cast<size_t>(2));
+
+    TEST_ASSERT(reader.next() == EventType::Characters);
+    TEST_ASSERT_EQ(characterData(reader), "TEXT");
+
+    TEST_ASSERT(reader.next() == EventType::EndElement);
+    TEST_ASSERT_EQ(reader.getLocalName(), "a");
+    TEST_ASSERT_EQ(reader.getDepth(), static_cast<size_t>(2));
+
+    // An empty element is still a start and an end
+    TEST_ASSERT(reader.next() == EventType::StartElement);
+    TEST_ASSERT_EQ(reader.getLocalName(), "b");
+    TEST_ASSERT(reader.next() == EventType::EndElement);
+    TEST_ASSERT_EQ(reader.getLocalName(), "b");
+
+    TEST_ASSERT(reader.next() == EventType::EndElement);
+    TEST_ASSERT_EQ(reader.getLocalName(), "root");
+    TEST_ASSERT_EQ(reader.getDepth(), static_cast<size_t>(1));
+
+    TEST_ASSERT(reader.next() == EventType::EndDocument);
+    TEST_ASSERT_EQ(reader.getDepth(), static_cast<size_t>(0));
+    TEST_ASSERT_TRUE(reader.getLocalName().empty());
+    TEST_ASSERT(reader.next() == EventType::EndDocument);
+}
+
+TEST_CASE(testSubtree)
+{
+    io::StringStream ss;
+    ss.stream() << strXml();
+    xml::lite::XMLPullReader reader(ss);
+
+    std::unique_ptr<xml::lite::Element> record;
+    while (reader.next() != EventType::EndDocument)
+    {
+        if (!reader.isStartElement())
+        {
+            continue;
+        }
+        if (reader.getLocalName() == "skip")
+        {
+            reader.skipSubtree();
+            TEST_ASSERT_TRUE(reader.isEndElement());
+            TEST_ASSERT_EQ(reader.getLocalName(), "skip");
+        }
+        else if (reader.getLocalName() == "record")
+        {
+            record = reader.readSubtree();
+            TEST_ASSERT_TRUE(reader.isEndElement());
+            TEST_ASSERT_EQ(reader.getLocalName(), "record");
+        }
+        else
+        {
+            // Nothing inside <skip> or <record> should get here
+            TEST_ASSERT_EQ(reader.getLocalName(), "root");
+        }
+    }
+    TEST_ASSERT_NOT_NULL(record.get());
+
+    TEST_ASSERT_EQ(record->getLocalName(), "record");
+    TEST_ASSERT_EQ(record->getUri(), "urn:test");
+    TEST_ASSERT_EQ(record->getAttributes().getValue("id"), "7");
+    TEST_ASSERT_EQ(record->getCharacterData(), "tail");
+    TEST_ASSERT_EQ(record->getChildren().size(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(record->getElementByTagName("name").getCharacterData(), "TEXT");
+    TEST_ASSERT_TRUE(record->getElementByTagName("empty").getCharacterData().empty());
+}
+
+TEST_CASE(testPreserveCharacterData)
+{
+    io::StringStream ss;
+    ss.stream() << strXml();
+    xml::lite::XMLPullReader reader(ss);
+    reader.preserveCharacterData(true);
+
+    while ((reader.next() != EventType::StartElement) || (reader.getLocalName() != "name"))
+    {
+    }
+    const auto name = reader.readSubtree();
+    TEST_ASSERT_EQ(name->getCharacterData(), "  TEXT  ");
+}
+
+TEST_CASE(testErrors)
+{
+    {
+        io::StringStream ss;
+        ss.stream() << "<root>";
+        xml::lite::XMLPullReader reader(ss);
+        TEST_EXCEPTION(reader.readSubtree());  // not at a start element
+        TEST_ASSERT(reader.next() == EventType::StartElement);
+        TEST_EXCEPTION(reader.readSubtree());  // the document ends first
+    }
+    {
+        io::StringStream ss;
+        ss.stream() << "<root><a></b></root>";
+        xml::lite::XMLPullReader reader(ss);
+        TEST_EXCEPTION(readAll(reader));
+    }
+}
+
+TEST_MAIN(
+    TEST_CHECK(testEvents);
+    TEST_CHECK(testSubtree);
+    TEST_CHECK(testPreserveCharacterData);
+    TEST_CHECK(testErrors);
+)
@@ -0,0 +1,100 @@
+/* =========================================================================
+ * This file is part of xml.lite-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * xml.lite-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "io/StringStream.h"
+#include <TestCase.h>
+
+#include "xml/lite/Element.h"
+#include "xml/lite/XMLSerializer.h"
+
+static std::unique_ptr<xml::lite::Element> makeTree()
+{
+    auto root = xml::lite::Element::create("root");
+    root->getAttributes()["version"] = "2";
+    auto& a = root->addChild(xml::lite::Element::create("a", "", "TEXT"));
+    a.getAttributes()["id"] = "x";
+    auto& b = root->addChild(xml::lite::Element::create("b"));
+    b.addChild(xml::lite::Element::create("c"));
+    return root;
+}
+
+TEST_CASE(testCompactAndPretty)
+{
+    const auto root = makeTree();
+
+    xml::lite::XMLSerializer serializer;
+    const auto& compact = serializer.serialize(*root);
+    TEST_ASSERT_EQ(compact, "<root version=\"2\"><a id=\"x\">TEXT</a><b><c/></b></root>");
+
+    io::StringStream print;
+    root->print(print);
+    TEST_ASSERT_EQ(print.stream().str(), compact);
+
+    serializer.setFormatter("  ");
+    io::StringStream output;
+    serializer.write(*root, output);
+    const std::string pretty = output.stream().str();
+    TEST_ASSERT_EQ(pretty, "<root version=\"2\">\n  <a id=\"x\">TEXT</a>\n  <b>\n    <c/>\n  </b>\n</root>");
+
+    io::StringStream prettyPrint;
+    root->prettyPrint(prettyPrint, "  ");
+    TEST_ASSERT_EQ(prettyPrint.stream().str(), pretty + "\n");
+}
+
+TEST_CASE(testEscape)
+{
+    // Long enough that the specials straddle and fill whole words
+    const std::string text = "a<b && c>d 0123456789 \"quoted\" <<<<<<<<&";
+    auto root = xml::lite::Element::create("root", "", text);
+    root->getAttributes()["attr"] = "x\"y<z&" + text;
+
+    xml::lite::XMLSerializer serializer;
+    const auto& actual = serializer.serialize(*root);
+    const std::string escapedText =
+        "a&lt;b &amp;&amp; c&gt;d 0123456789 \"quoted\" &lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&amp;";
+    const std::string escapedAttr =
+        "x&quot;y&lt;z&amp;a&lt;b &amp;&amp; c&gt;d 0123456789 &quot;quoted&quot; &lt;&lt;&lt;&lt;&lt;&lt;&lt;&lt;&amp;";
+    TEST_ASSERT_EQ(actual, "<root attr=\"" + escapedAttr + "\">" + escapedText + "</root>");
+
+    // Element::print() has never escaped
+    serializer.setEscape(false);
+    io::StringStream print;
+    root->print(print);
+    TEST_ASSERT_EQ(serializer.serialize(*root), print.stream().str());
+    TEST_ASSERT(print.stream().str().find(text) != std::string::npos);
+}
+
+TEST_CASE(testDepth)
+{
+    const auto root = makeTree();
+    xml::lite::XMLSerializer serializer("\t");
+    const auto& actual = serializer.serialize(root->getElementByTagName("b"), 1);
+    TEST_ASSERT_EQ(actual, "\t<b>\n\t\t<c/>\n\t</b>");
+}
+
+TEST_MAIN(
+    TEST_CHECK(testCompactAndPretty);
+    TEST_CHECK(testEscape);
+    TEST_CHECK(testDepth);
+)
@@ -23,9 +23,14 @@
 #ifndef __IMPORT_ZIP_H__
 #define __IMPORT_ZIP_H__
 
+#include "zip/ArchiveSource.h"
+#include "zip/BGZF.h"
+#include "zip/BGZFInputStream.h"
+#include "zip/BGZFOutputStream.h"
 #include "zip/GZipInputStream.h"
 #include "zip/GZipOutputStream.h"
 #include "zip/ZipEntry.h"
+#include "zip/ZipEntryInputStream.h"
 #include "zip/ZipFile.h"
 #include "zip/ZipOutputStream.h"
 
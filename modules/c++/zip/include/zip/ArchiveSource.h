@@ -0,0 +1,69 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_zip_ArchiveSource_h_INCLUDED_
+#define CODA_OSS_zip_ArchiveSource_h_INCLUDED_
+
+#include <stddef.h>
+
+#include "config/Exports.h"
+#include "sys/Conf.h"
+
+namespace zip
+{
+/*!
+ *  \class ArchiveSource
+ *  \brief Random access to the bytes of a zip archive
+ *
+ *  ZipFile reads the central directory through this, and each
+ *  ZipEntryInputStream reads its entry's compressed data through it.
+ *  readAt() may be called from several threads at once.
+ */
+class CODA_OSS_API ArchiveSource
+{
+public:
+    virtual ~ArchiveSource() = default;
+
+    //! \return The size of the archive, in bytes
+    virtual sys::Uint64_T getSize() const = 0;
+
+    /*!
+     *  Read exactly len bytes, starting offset bytes into the archive.
+     *
+     *  \throw except::IOException if the range isn't in the archive
+     */
+    virtual void readAt(sys::Uint64_T offset, void* buffer, size_t len) const = 0;
+
+    /*!
+     *  \return A pointer to len bytes at offset if the archive is in memory
+     *          (or memory-mapped), otherwise nullptr.  The pointer is valid
+     *          as long as the source is.
+     */
+    virtual const sys::ubyte* view(sys::Uint64_T /*offset*/, size_t /*len*/) const
+    {
+        return nullptr;
+    }
+};
+}
+
+#endif  // CODA_OSS_zip_ArchiveSource_h_INCLUDED_
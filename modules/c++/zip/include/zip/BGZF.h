@@ -0,0 +1,123 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_zip_BGZF_h_INCLUDED_
+#define CODA_OSS_zip_BGZF_h_INCLUDED_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "config/Exports.h"
+
+#include "zip/Types.h"
+
+/*!
+ *  \file BGZF.h
+ *  \brief Blocked gzip (BGZF), as used by bgzip and htslib
+ *
+ *  A BGZF file is an ordinary multi-member gzip file (so gunzip reads it)
+ *  in which each member holds at most 64 KiB and records its compressed
+ *  size in a "BC" extra field.  Members can be found without inflating
+ *  anything, so they can be compressed and inflated independently, in
+ *  parallel, and a reader can seek to any member.
+ */
+
+namespace zip
+{
+namespace bgzf
+{
+enum
+{
+    //! Uncompressed bytes per block (what bgzip uses)
+    BLOCK_DATA_SIZE = 0xff00,
+
+    //! Compressed blocks, header and trailer included, are at most this big
+    MAX_BLOCK_SIZE = 0x10000,
+
+    //! Header with only the BC extra field
+    HEADER_SIZE = 18,
+
+    //! CRC-32 and input size
+    TRAILER_SIZE = 8
+};
+
+/*!
+ *  \struct Block
+ *  \brief Where a block starts, in the file and in the uncompressed data
+ */
+struct Block final
+{
+    sys::Uint64_T compressedOffset = 0;
+    sys::Uint64_T uncompressedOffset = 0;
+};
+
+/*!
+ *  Block offsets, in order.  The first block (0, 0) is always included.
+ */
+using Index = std::vector<Block>;
+
+/*!
+ *  Write index in bgzip's .gzi format: a count, then each (compressed,
+ *  uncompressed) offset pair after the first, as little-endian 64-bit
+ *  integers.
+ */
+CODA_OSS_API void writeIndex(const Index& index, io::OutputStream& output);
+
+/*!
+ *  Read an index written by writeIndex() or bgzip -i
+ *
+ *  \throw except::IOException if the index is truncated
+ */
+CODA_OSS_API Index readIndex(io::InputStream& input);
+
+namespace details
+{
+/*!
+ *  Compress [data, data + len) into a complete block.  len must be no more
+ *  than BLOCK_DATA_SIZE.  If it doesn't compress enough to fit in
+ *  MAX_BLOCK_SIZE, it's stored.
+ */
+CODA_OSS_API void compressBlock(const sys::ubyte* data, size_t len,
+                                int level, std::vector<sys::ubyte>& block);
+
+/*!
+ *  \return The size of the block starting at header, from its BC field, or
+ *          0 if the header isn't a BGZF header.  headerLen bytes are
+ *          available; 12 are enough to get the extra field's length, and
+ *          the whole extra field is needed after that.
+ */
+CODA_OSS_API size_t getBlockSize(const sys::ubyte* header, size_t headerLen);
+
+/*!
+ *  Inflate a complete block, checking its CRC-32 and size.
+ *
+ *  \throw except::IOException if the block is corrupt
+ */
+CODA_OSS_API void inflateBlock(const sys::ubyte* block, size_t blockLen,
+                               std::vector<sys::ubyte>& data);
+}
+}
+}
+
+#endif  // CODA_OSS_zip_BGZF_h_INCLUDED_
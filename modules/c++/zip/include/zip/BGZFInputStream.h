@@ -0,0 +1,162 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_zip_BGZFInputStream_h_INCLUDED_
+#define CODA_OSS_zip_BGZFInputStream_h_INCLUDED_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/Exports.h"
+#include "io/FileInputStream.h"
+#include "io/SeekableStreams.h"
+#include "mt/WorkStealingExecutor.h"
+
+#include "zip/BGZF.h"
+
+namespace zip
+{
+/*!
+ *  \class BGZFInputStream
+ *  \brief Reads gzip files, inflating BGZF blocks in parallel
+ *
+ *  If the file is BGZF (see BGZFOutputStream), block boundaries are read
+ *  from the block headers and batches of blocks are inflated on an
+ *  mt::WorkStealingExecutor; the next batch is read and inflated while the
+ *  caller consumes the current one.  Any other gzip file (including
+ *  multi-member ones) is inflated sequentially.
+ *
+ *  Seeking (in uncompressed offsets) uses the block index: either one
+ *  passed to setIndex() (say, from bgzf::readIndex()), or one built by
+ *  scanning the block headers on the first seek.  Batches restart small
+ *  after a seek, so random access doesn't inflate much it won't use.
+ *  Seeking in plain gzip works, but has to inflate from the start to go
+ *  backwards.
+ */
+class CODA_OSS_API BGZFInputStream final : public io::SeekableInputStream
+{
+public:
+    /*!
+     *  \param file The file to read
+     *  \param numThreads How many blocks to inflate at once; 0 means one
+     *         per executor thread.  With 1, blocks are inflated on the
+     *         calling thread.
+     *
+     *  \throw except::IOException if the file isn't gzip
+     */
+    explicit BGZFInputStream(const std::string& file, size_t numThreads = 0);
+
+    //! Read from input, which must outlive this stream
+    explicit BGZFInputStream(io::SeekableInputStream& input,
+                             size_t numThreads = 0);
+
+    ~BGZFInputStream();
+
+    BGZFInputStream(const BGZFInputStream&) = delete;
+    BGZFInputStream& operator=(const BGZFInputStream&) = delete;
+
+    //! \return True if the input is BGZF, and so can be read in parallel
+    bool isBGZF() const
+    {
+        return mIsBGZF;
+    }
+
+    /*!
+     *  \return The block index, scanning the block headers for it if it
+     *          wasn't set.  It's empty for plain gzip.
+     */
+    const bgzf::Index& getIndex();
+
+    //! Use index (which must match the file) rather than scanning for one
+    void setIndex(const bgzf::Index& index);
+
+    //! Seek to an uncompressed offset
+    virtual sys::Off_T seek(sys::Off_T offset, Whence whence) override;
+
+    //! \return The uncompressed offset
+    virtual sys::Off_T tell() override
+    {
+        return static_cast<sys::Off_T>(mPosition);
+    }
+
+    //! Close the file (if this stream opened it)
+    void close();
+
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len) override;
+
+private:
+    struct Batch final
+    {
+        sys::Uint64_T start = 0;
+        sys::Uint64_T size = 0;
+        std::vector<std::vector<sys::ubyte> > blocks;
+        std::vector<std::vector<sys::ubyte> > data;
+        std::unique_ptr<mt::TaskGroup> tasks;
+    };
+
+    void init(size_t numThreads);
+    size_t readBlockHeader(sys::Uint64_T offset, std::vector<sys::ubyte>& block);
+    void startBatch();
+    bool nextBatch();
+    void discardBatches();
+    void scanIndex();
+    void skip(sys::Uint64_T numBytes);
+    void restartGZip();
+    sys::SSize_T readBGZF(sys::ubyte* buffer, size_t len);
+    sys::SSize_T readGZip(sys::ubyte* buffer, size_t len);
+
+    std::unique_ptr<io::FileInputStream> mOwned;
+    io::SeekableInputStream* mInput;
+    sys::Uint64_T mInputSize = 0;
+    size_t mNumThreads = 1;
+    bool mIsBGZF = false;
+
+    // Uncompressed offset of the next byte read() returns
+    sys::Uint64_T mPosition = 0;
+
+    // BGZF: the next block to read, and the batches in use
+    sys::Uint64_T mNextBlockOffset = 0;
+    sys::Uint64_T mNextBlockStart = 0;
+    size_t mBatchBlocks = 1;
+    size_t mMaxBatchBlocks = 1;
+    std::unique_ptr<Batch> mCurrent;
+    std::unique_ptr<Batch> mAhead;
+    size_t mBlock = 0;
+    size_t mBlockPos = 0;
+    bgzf::Index mIndex;
+    bool mHaveIndex = false;
+    bool mHaveSize = false;
+    sys::Uint64_T mUncompressedSize = 0;
+
+    // Plain gzip
+    z_stream mStream;
+    bool mStreamInit = false;
+    bool mStreamEnd = false;
+    sys::Uint64_T mInputOffset = 0;
+    std::vector<sys::ubyte> mInputBuffer;
+};
+}
+
+#endif  // CODA_OSS_zip_BGZFInputStream_h_INCLUDED_
@@ -0,0 +1,129 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_zip_BGZFOutputStream_h_INCLUDED_
+#define CODA_OSS_zip_BGZFOutputStream_h_INCLUDED_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/Exports.h"
+#include "mt/WorkStealingExecutor.h"
+
+#include "zip/BGZF.h"
+
+namespace zip
+{
+/*!
+ *  \class BGZFOutputStream
+ *  \brief Writes BGZF (blocked gzip), compressing blocks in parallel
+ *
+ *  Input is cut into 64 KiB blocks, which are deflated as independent gzip
+ *  members on an mt::WorkStealingExecutor, a batch at a time, while the
+ *  caller fills the next batch.  Blocks are written in order, so the
+ *  result is a normal gzip file that gunzip reads, and BGZFInputStream can
+ *  inflate it in parallel and seek in it.
+ *
+ *  \code
+    zip::BGZFOutputStream output("log.txt.gz");
+    input.streamTo(output);
+    output.close();
+    zip::bgzf::writeIndex(output.getIndex(), indexStream);
+    \endcode
+ */
+class CODA_OSS_API BGZFOutputStream final : public io::OutputStream
+{
+public:
+    /*!
+     *  \param file The file to create
+     *  \param level The zlib compression level
+     *  \param numThreads How many blocks to compress at once; 0 means one
+     *         per executor thread.  With 1, blocks are compressed on the
+     *         calling thread.
+     */
+    explicit BGZFOutputStream(const std::string& file,
+                              int level = Z_DEFAULT_COMPRESSION,
+                              size_t numThreads = 0);
+
+    //! Write to output, which must outlive this stream
+    explicit BGZFOutputStream(io::OutputStream& output,
+                              int level = Z_DEFAULT_COMPRESSION,
+                              size_t numThreads = 0);
+
+    //! Closes the stream if close() wasn't called, ignoring errors
+    ~BGZFOutputStream();
+
+    BGZFOutputStream(const BGZFOutputStream&) = delete;
+    BGZFOutputStream& operator=(const BGZFOutputStream&) = delete;
+
+    virtual void write(const void* buffer, size_t len) override;
+
+    //! Compress and write everything buffered so far, as whole blocks
+    virtual void flush() override;
+
+    /*!
+     *  Write the remaining blocks and the BGZF end-of-file marker, then
+     *  close the file (if this stream opened it).
+     */
+    virtual void close() override;
+
+    /*!
+     *  \return The offset of every block written so far.  After close(),
+     *          this is the complete index.
+     */
+    const bgzf::Index& getIndex() const
+    {
+        return mIndex;
+    }
+
+private:
+    struct Batch final
+    {
+        std::vector<sys::ubyte> data;
+        std::vector<std::vector<sys::ubyte> > blocks;
+        std::unique_ptr<mt::TaskGroup> tasks;
+    };
+
+    void init(int level, size_t numThreads);
+    void dispatch();
+    void finishPending();
+
+    std::unique_ptr<io::OutputStream> mOwned;
+    io::OutputStream* mOutput;
+    int mLevel = Z_DEFAULT_COMPRESSION;
+    size_t mNumThreads = 1;
+    size_t mBatchSize = 0;
+    bool mClosed = false;
+
+    // mCurrent is being filled while mPending is compressed
+    std::unique_ptr<Batch> mCurrent;
+    std::unique_ptr<Batch> mPending;
+
+    bgzf::Index mIndex;
+    sys::Uint64_T mCompressedOffset = 0;
+    sys::Uint64_T mUncompressedOffset = 0;
+};
+}
+
+#endif  // CODA_OSS_zip_BGZFOutputStream_h_INCLUDED_
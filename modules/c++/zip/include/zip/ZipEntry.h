@@ -23,6 +23,9 @@
 #ifndef __ZIP_ZIP_ENTRY_H__
 #define __ZIP_ZIP_ENTRY_H__
 
+#include <memory>
+
+#include "zip/ArchiveSource.h"
 #include "zip/Types.h"
 
 namespace zip
@@ -32,10 +35,15 @@ namespace zip
  *  \brief Each entry in a ZipFile is a ZipEntry
  *
  *  Class stores the information about individual elements
- *  in a PKZIP zip file
+ *  in a PKZIP zip file.  Entries read by a ZipFile don't hold their data;
+ *  it's read from the archive when the entry is decompressed or opened with
+ *  a ZipEntryInputStream.
  */
 class ZipEntry
 {
+    friend class ZipFile;
+    friend class ZipEntryInputStream;
+
     enum CompressionMethod
     {
         COMP_STORED = 0, COMP_DEFLATED = 8
@@ -57,6 +65,10 @@ class ZipEntry
     sys::Uint16_T mInternalAttrs;
     sys::Uint32_T mExternalAttrs;
 
+    //!  Set by ZipFile; the data is read from here on demand
+    std::shared_ptr<const ArchiveSource> mSource;
+    sys::Uint64_T mLocalHeaderOffset = 0;
+
     static void inflate(sys::ubyte* out, sys::Size_T outLen, sys::ubyte* in,
             sys::Size_T inLen);
 
@@ -86,9 +98,29 @@ public:
     {
     }
 
+    /*!
+     *  Decompress the whole entry into a new buffer, which the caller
+     *  must delete[].  Use a ZipEntryInputStream for large entries.
+     */
     sys::ubyte* decompress();
+
+    //!  Decompress the first outLen bytes of the entry into out
     void decompress(sys::ubyte* out, sys::Size_T outLen);
 
+    //!  \return The offset of the entry's local header in the archive
+    sys::Uint64_T getLocalHeaderOffset() const
+    {
+        return mLocalHeaderOffset;
+    }
+
+    /*!
+     *  \return The offset of the entry's (compressed) data in the archive.
+     *  This reads the local header.
+     *
+     *  \throw except::IOException if the local header is bad
+     */
+    sys::Uint64_T getDataOffset() const;
+
     sys::Uint16_T getVersionMadeBy() const
     {
         return mVersionMadeBy;
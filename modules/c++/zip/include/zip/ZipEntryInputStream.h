@@ -0,0 +1,115 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#ifndef CODA_OSS_zip_ZipEntryInputStream_h_INCLUDED_
+#define CODA_OSS_zip_ZipEntryInputStream_h_INCLUDED_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/Exports.h"
+
+#include "zip/ArchiveSource.h"
+#include "zip/Types.h"
+#include "zip/ZipEntry.h"
+
+namespace zip
+{
+/*!
+ *  \class ZipEntryInputStream
+ *  \brief Reads one ZipEntry of a ZipFile, inflating it as it goes
+ *
+ *  Only bufferSize bytes of compressed data are held at a time (none if the
+ *  archive is memory-mapped), so entries of any size can be streamed.  The
+ *  CRC-32 is checked when the last byte has been read.
+ *
+ *  \code
+    zip::ZipFile zipFile("tiles.zip");
+    zip::ZipEntryInputStream input(**zipFile.lookup("tile_0_0.raw"));
+    input.streamTo(output);
+    \endcode
+ *
+ *  Each thread should use its own stream; any number of streams, on the
+ *  same entry or different ones, can read from one ZipFile at once.  The
+ *  ZipFile must outlive the stream.
+ */
+class CODA_OSS_API ZipEntryInputStream final : public io::InputStream
+{
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    /*!
+     *  \param entry An entry of a ZipFile
+     *  \param bufferSize How much compressed data to read at a time
+     *
+     *  \throw except::NotImplementedException if the entry is encrypted or
+     *         uses a compression method other than stored or deflated
+     */
+    explicit ZipEntryInputStream(const ZipEntry& entry,
+                                 size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    ~ZipEntryInputStream();
+
+    ZipEntryInputStream(const ZipEntryInputStream&) = delete;
+    ZipEntryInputStream& operator=(const ZipEntryInputStream&) = delete;
+
+    //! \return The number of uncompressed bytes left to read
+    virtual sys::Off_T available() override
+    {
+        return static_cast<sys::Off_T>(mUncompressedRemaining);
+    }
+
+protected:
+    /*!
+     *  Inflate up to len bytes into buffer.
+     *
+     *  \throw except::IOException if the data is corrupt or its CRC-32
+     *         doesn't match
+     */
+    virtual sys::SSize_T readImpl(void* buffer, size_t len) override;
+
+private:
+    void fillInput();
+
+    std::shared_ptr<const ArchiveSource> mSource;
+    std::string mFileName;
+    bool mDeflated = false;
+    sys::Uint32_T mExpectedCRC = 0;
+    sys::Uint32_T mCRC = 0;
+
+    // Next byte of compressed data to read, and how much is left
+    sys::Uint64_T mOffset = 0;
+    sys::Uint64_T mCompressedRemaining = 0;
+    sys::Uint64_T mUncompressedRemaining = 0;
+
+    // Compressed data comes straight from the mapping if there is one,
+    // otherwise through mBuffer
+    const sys::ubyte* mView = nullptr;
+    std::vector<sys::ubyte> mBuffer;
+
+    z_stream mStream;
+};
+}
+
+#endif  // CODA_OSS_zip_ZipEntryInputStream_h_INCLUDED_
@@ -23,9 +23,17 @@
 #ifndef __ZIP_ZIP_FILE_H__
 #define __ZIP_ZIP_FILE_H__
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "gsl/gsl.h"
+#include "io/SeekableStreams.h"
 
+#include "zip/ArchiveSource.h"
 #include "zip/ZipEntry.h"
+#include "zip/ZipEntryInputStream.h"
 
 /*!
  *  This file is loosely based on libzipfile, from Google's Android OS,
@@ -48,46 +56,56 @@ namespace zip
  *  \class ZipFile
  *  \brief Contains the functionality for reading PKZIP files
  *
+ *  Only the central directory (including ZIP64 records) is read up front;
+ *  entry data is read from the archive when an entry is decompressed or
+ *  opened with a ZipEntryInputStream.  Lookups by name are hashed.
+ *
+ *  Once constructed, a ZipFile is read-only, so several threads can
+ *  extract entries at the same time, each with its own ZipEntryInputStream.
  */
 
 class ZipFile
 {
 
+    //!  Where the archive's bytes come from
+    std::shared_ptr<const ArchiveSource> mSource;
+
     //!  This is the container for ZipEntry objects
     std::vector<ZipEntry*> mEntries;
 
+    //!  Index into mEntries by file name
+    std::unordered_map<std::string, size_t> mIndex;
+
     //!  Zip (apparently) is little-endian
     bool mSwapBytes;
 
-    //!  Compressed data buffer (yes we eat the whole file)
-    sys::ubyte* mCompressed;
-    sys::Size_T mCompressedLength;
-
-    sys::Uint16_T mDiskNum;
-    sys::Uint16_T mDiskWithCentralDir;
-
-    sys::Uint32_T mCentralDirSize;
-    sys::Uint32_T mCentralDirOffset;
+    sys::Uint64_T mNumEntries = 0;
+    sys::Uint64_T mCentralDirSize = 0;
+    sys::Uint64_T mCentralDirOffset = 0;
 
     std::string mComment;
 
+    //!  Read a long (little-endian)
+    sys::Uint64_T readLong(const sys::ubyte* buf) const;
+
     //!  Read an integer (little-endian)
-    sys::Uint32_T readInt(sys::ubyte* buf);
+    sys::Uint32_T readInt(const sys::ubyte* buf) const;
 
     //!  Read a short (little-endian)
-    sys::Uint16_T readShort(sys::ubyte* buf);
+    sys::Uint16_T readShort(const sys::ubyte* buf) const;
 
     //!  Read the top-level zip directory
     void readCentralDir();
 
-    //!  Get the ZipEntry for some element
-    ZipEntry* newCentralDirEntry(sys::ubyte** p, sys::SSize_T len);
+    //!  Get the ZipEntry for some element, advancing p past it
+    std::unique_ptr<ZipEntry> newCentralDirEntry(const sys::ubyte*& p,
+                                                 const sys::ubyte* end);
 
     //!  Get information for the central dir
-    void readCentralDirValues(sys::ubyte* buf, sys::SSize_T len);
+    void readCentralDirValues(const sys::ubyte* buf, sys::SSize_T len);
 
-    //!  Copy to a string
-    //void copyString(const sys::ubyte* buf, sys::SSize_T len);
+    //!  Get information for the central dir from the ZIP64 records
+    void readZip64CentralDirValues(const sys::ubyte* locator);
 
 public:
 
@@ -97,18 +115,38 @@ public:
     /*!
      *  We require an input stream for initialization
      *  This stream should be already initialized, since we
-     *  are planning on reading from it immediately
+     *  are planning on reading from it immediately.
+     *
+     *  The whole stream is read into memory; prefer one of the other
+     *  constructors for large archives.
      */
-    ZipFile(io::InputStream* inputStream) :
-        mCompressed(nullptr)
-    {
-        mSwapBytes = sys::isBigEndianSystem();
-        mCompressedLength = inputStream->available();
-        mCompressed = new sys::ubyte[mCompressedLength];
-        inputStream->read((sys::byte*) mCompressed, mCompressedLength);
+    ZipFile(io::InputStream* inputStream);
 
-        readCentralDir();
-    }
+    /*!
+     *  Read the central directory from a seekable stream.  Entry data is
+     *  read from the stream on demand (one reader at a time), so it must
+     *  outlive the ZipFile and shouldn't be used for anything else.
+     */
+    explicit ZipFile(io::SeekableInputStream& inputStream);
+
+    /*!
+     *  Open an archive on disk.  Entry data is read on demand with
+     *  positioned reads, so concurrent extraction doesn't contend for a
+     *  file pointer.
+     *
+     *  \param pathname The archive
+     *  \param memoryMap Map the archive instead, so stored entries can
+     *         be read, and deflated ones inflated, without a copy
+     */
+    explicit ZipFile(const std::string& pathname, bool memoryMap = false);
+
+    /*!
+     *  Read the central directory from any ArchiveSource.
+     */
+    explicit ZipFile(std::shared_ptr<const ArchiveSource> source);
+
+    ZipFile(const ZipFile&) = delete;
+    ZipFile& operator=(const ZipFile&) = delete;
 
     /*!
      *  When the ZipFile object goes out of scope, that
@@ -119,7 +157,7 @@ public:
     ~ZipFile();
 
     //!  Look for a ZipEntry with the same fileName
-    Iterator lookup(std::string fileName) const;
+    Iterator lookup(const std::string& fileName) const;
 
     //!  Iterator to beginning of collection
     Iterator begin() const
@@ -133,11 +171,11 @@ public:
         return mEntries.end();
     }
 
-    sys::Uint32_T getCentralDirSize() const
+    sys::Uint64_T getCentralDirSize() const
     {
         return mCentralDirSize;
     }
-    sys::Uint32_T getCentralDirOffset() const
+    sys::Uint64_T getCentralDirOffset() const
     {
         return mCentralDirOffset;
     }
@@ -24,8 +24,10 @@
 #define __ZIP_ZIP_OUTPUT_STREAM_H__
 
 #include <string>
+#include <vector>
 #include <zip.h>
 #include <sys/Conf.h>
+#include <io/InputStream.h>
 #include <io/OutputStream.h>
 
 namespace zip
@@ -38,6 +40,26 @@ namespace zip
 class ZipOutputStream: public io::OutputStream
 {
 public:
+    /*
+     *  \struct Entry
+     *  \brief One file for writeEntries(): a file on disk, a buffer, or
+     *         whatever is left in a stream.  Buffers and streams must
+     *         outlive the writeEntries() call.
+     */
+    struct Entry
+    {
+        Entry(const std::string& zipPathname,
+              const std::string& inputPathname);
+        Entry(const std::string& zipPathname, const void* buffer, size_t len);
+        Entry(const std::string& zipPathname, io::InputStream& input);
+
+        std::string zipPathname;
+        std::string inputPathname;
+        const void* buffer = nullptr;
+        size_t len = 0;
+        io::InputStream* input = nullptr;
+    };
+
     /*
      *  \func Constructor
      *  \brief Sets up the internal structure of the class.
@@ -76,12 +98,32 @@ public:
     void write(const std::string& inputPathname,
                const std::string& zipPathname);
 
+    /*
+     *  \func writeEntries
+     *  \brief Adds every entry, deflating them concurrently.
+     *
+     *  Entries are deflated on an mt::WorkStealingExecutor into memory (or,
+     *  past a few tens of MB, a temporary file next to the zip) and written
+     *  in order as each is done, so the archive is the same as writing them
+     *  one at a time.  Entries of 4 GB or more are written as ZIP64.
+     *
+     *  \entries The files to add
+     *  \numThreads How many entries to deflate at once; 0 means one per
+     *              executor thread.  With 1, entries are deflated on the
+     *              calling thread.
+     *  \level The zlib compression level
+     */
+    void writeEntries(const std::vector<Entry>& entries,
+                      size_t numThreads = 0,
+                      int level = Z_DEFAULT_COMPRESSION);
+
     virtual void write(const void* buffer, size_t len) override;
 
     virtual void close() override;
 
 private:
     zipFile mZip;
+    std::string mSpillDirectory;
 };
 }
 
@@ -0,0 +1,249 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "zip/BGZF.h"
+
+#include <string.h>
+
+#include "except/Exception.h"
+#include "str/Format.h"
+
+namespace
+{
+// gzip and BGZF are little-endian
+void put16(sys::ubyte* p, size_t value)
+{
+    p[0] = static_cast<sys::ubyte>(value & 0xFF);
+    p[1] = static_cast<sys::ubyte>((value >> 8) & 0xFF);
+}
+void put32(sys::ubyte* p, sys::Uint64_T value)
+{
+    put16(p, static_cast<size_t>(value & 0xFFFF));
+    put16(p + 2, static_cast<size_t>((value >> 16) & 0xFFFF));
+}
+void put64(sys::ubyte* p, sys::Uint64_T value)
+{
+    put32(p, value & 0xFFFFFFFF);
+    put32(p + 4, value >> 32);
+}
+
+sys::Uint16_T get16(const sys::ubyte* p)
+{
+    return static_cast<sys::Uint16_T>(p[0] | (p[1] << 8));
+}
+sys::Uint32_T get32(const sys::ubyte* p)
+{
+    return get16(p) | (static_cast<sys::Uint32_T>(get16(p + 2)) << 16);
+}
+sys::Uint64_T get64(const sys::ubyte* p)
+{
+    return get32(p) | (static_cast<sys::Uint64_T>(get32(p + 4)) << 32);
+}
+
+// Raw deflate into out; returns the compressed size, or 0 if it didn't fit
+size_t deflateRaw(const sys::ubyte* data, size_t len, int level,
+                  sys::ubyte* out, size_t outLen)
+{
+    z_stream zstream;
+    ::memset(&zstream, 0, sizeof(zstream));
+    int zerr = deflateInit2(&zstream, level, Z_DEFLATED, -MAX_WBITS, 8,
+                            Z_DEFAULT_STRATEGY);
+    if (zerr != Z_OK)
+    {
+        throw except::IOException(Ctxt(str::Format(
+                "deflateInit2 failed [%d]", zerr)));
+    }
+    zstream.next_in = const_cast<Bytef*>(data);
+    zstream.avail_in = static_cast<uInt>(len);
+    zstream.next_out = out;
+    zstream.avail_out = static_cast<uInt>(outLen);
+    zerr = deflate(&zstream, Z_FINISH);
+    const size_t compressedLen = zstream.total_out;
+    deflateEnd(&zstream);
+
+    if (zerr == Z_STREAM_END)
+    {
+        return compressedLen;
+    }
+    if (zerr == Z_OK || zerr == Z_BUF_ERROR)
+    {
+        return 0;
+    }
+    throw except::IOException(Ctxt(str::Format("deflate failed [%d]", zerr)));
+}
+}
+
+namespace zip
+{
+namespace bgzf
+{
+void writeIndex(const Index& index, io::OutputStream& output)
+{
+    const size_t numEntries = index.empty() ? 0 : index.size() - 1;
+    std::vector<sys::ubyte> buffer(8 + numEntries * 16);
+    put64(buffer.data(), numEntries);
+    for (size_t ii = 0; ii < numEntries; ++ii)
+    {
+        sys::ubyte* const p = buffer.data() + 8 + ii * 16;
+        put64(p, index[ii + 1].compressedOffset);
+        put64(p + 8, index[ii + 1].uncompressedOffset);
+    }
+    output.write(buffer.data(), buffer.size());
+}
+
+Index readIndex(io::InputStream& input)
+{
+    sys::ubyte count[8];
+    input.read(count, sizeof(count), true);
+    const sys::Uint64_T numEntries = get64(count);
+
+    Index index(1);
+    sys::ubyte entry[16];
+    for (sys::Uint64_T ii = 0; ii < numEntries; ++ii)
+    {
+        input.read(entry, sizeof(entry), true);
+        Block block;
+        block.compressedOffset = get64(entry);
+        block.uncompressedOffset = get64(entry + 8);
+        index.push_back(block);
+    }
+    return index;
+}
+
+namespace details
+{
+void compressBlock(const sys::ubyte* data, size_t len, int level,
+                   std::vector<sys::ubyte>& block)
+{
+    if (len > BLOCK_DATA_SIZE)
+    {
+        throw except::InvalidArgumentException(Ctxt(str::Format(
+                "BGZF blocks hold at most %d bytes", BLOCK_DATA_SIZE)));
+    }
+
+    block.resize(MAX_BLOCK_SIZE);
+    const size_t maxCompressed = MAX_BLOCK_SIZE - HEADER_SIZE - TRAILER_SIZE;
+    size_t compressedLen = deflateRaw(data, len, level,
+                                      block.data() + HEADER_SIZE,
+                                      maxCompressed);
+    if (compressedLen == 0)
+    {
+        // Incompressible; stored blocks always fit
+        compressedLen = deflateRaw(data, len, Z_NO_COMPRESSION,
+                                   block.data() + HEADER_SIZE, maxCompressed);
+    }
+    const size_t blockLen = HEADER_SIZE + compressedLen + TRAILER_SIZE;
+    block.resize(blockLen);
+
+    static const sys::ubyte header[] = {
+            0x1f, 0x8b, 8, 4,  // magic, deflate, FEXTRA
+            0, 0, 0, 0,        // mtime
+            0, 0xff,           // extra flags, unknown OS
+            6, 0,              // XLEN
+            'B', 'C', 2, 0 };  // BC subfield, 2 bytes
+    ::memcpy(block.data(), header, sizeof(header));
+    put16(block.data() + 16, blockLen - 1);
+
+    const uLong crc = crc32(0, data, static_cast<uInt>(len));
+    sys::ubyte* const trailer = block.data() + blockLen - TRAILER_SIZE;
+    put32(trailer, crc);
+    put32(trailer + 4, len);
+}
+
+size_t getBlockSize(const sys::ubyte* header, size_t headerLen)
+{
+    if (headerLen < 12 || header[0] != 0x1f || header[1] != 0x8b ||
+        header[2] != 8 || !(header[3] & 4))
+    {
+        return 0;
+    }
+
+    const size_t extraLen = get16(header + 10);
+    if (headerLen < 12 + extraLen)
+    {
+        return 0;
+    }
+
+    // Find the BC subfield among whatever else is there
+    const sys::ubyte* p = header + 12;
+    const sys::ubyte* const end = p + extraLen;
+    while (end - p >= 4)
+    {
+        const size_t subfieldLen = get16(p + 2);
+        if (p[0] == 'B' && p[1] == 'C' && subfieldLen == 2 &&
+            end - p >= 6)
+        {
+            const size_t blockLen = get16(p + 4) + 1u;
+            return blockLen >= 12 + extraLen + TRAILER_SIZE ? blockLen : 0;
+        }
+        p += 4 + subfieldLen;
+    }
+    return 0;
+}
+
+void inflateBlock(const sys::ubyte* block, size_t blockLen,
+                  std::vector<sys::ubyte>& data)
+{
+    const size_t headerLen = 12 + get16(block + 10);
+    const sys::ubyte* const trailer = block + blockLen - TRAILER_SIZE;
+    const sys::Uint32_T expectedCRC = get32(trailer);
+    const sys::Uint32_T dataLen = get32(trailer + 4);
+    if (dataLen > MAX_BLOCK_SIZE)
+    {
+        throw except::IOException(Ctxt(str::Format(
+                "BGZF block claims %u bytes", dataLen)));
+    }
+    data.resize(dataLen);
+
+    z_stream zstream;
+    ::memset(&zstream, 0, sizeof(zstream));
+    int zerr = inflateInit2(&zstream, -MAX_WBITS);
+    if (zerr != Z_OK)
+    {
+        throw except::IOException(Ctxt(str::Format(
+                "inflateInit2 failed [%d]", zerr)));
+    }
+    zstream.next_in = const_cast<Bytef*>(block + headerLen);
+    zstream.avail_in = static_cast<uInt>(blockLen - headerLen - TRAILER_SIZE);
+    // inflate() rejects a null next_out, which an empty block would give
+    sys::ubyte empty = 0;
+    zstream.next_out = data.empty() ? &empty : data.data();
+    zstream.avail_out = static_cast<uInt>(data.size());
+    zerr = inflate(&zstream, Z_FINISH);
+    const size_t inflatedLen = zstream.total_out;
+    inflateEnd(&zstream);
+
+    if (zerr != Z_STREAM_END || inflatedLen != dataLen)
+    {
+        throw except::IOException(Ctxt(str::Format(
+                "Corrupt BGZF block [%d]", zerr)));
+    }
+    const auto crc = static_cast<sys::Uint32_T>(
+            crc32(0, data.data(), static_cast<uInt>(data.size())));
+    if (crc != expectedCRC)
+    {
+        throw except::IOException(Ctxt("BGZF block CRC-32 mismatch"));
+    }
+}
+}
+}
+}
@@ -0,0 +1,533 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "zip/BGZFInputStream.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include "io/FileInputStream.h"
+#include "str/Format.h"
+
+namespace
+{
+// Same as BGZFOutputStream
+constexpr size_t BLOCKS_PER_THREAD = 4;
+
+// For plain gzip
+constexpr size_t INPUT_BUFFER_SIZE = 64 * 1024;
+
+// The size of the data in a block, from its trailer
+sys::Uint32_T getDataSize(const std::vector<sys::ubyte>& block)
+{
+    const sys::ubyte* const p = block.data() + block.size() - 4;
+    return p[0] | (p[1] << 8) | (p[2] << 16) |
+            (static_cast<sys::Uint32_T>(p[3]) << 24);
+}
+}
+
+namespace zip
+{
+BGZFInputStream::BGZFInputStream(const std::string& file, size_t numThreads) :
+    mOwned(new io::FileInputStream(file)),
+    mInput(mOwned.get())
+{
+    init(numThreads);
+}
+
+BGZFInputStream::BGZFInputStream(io::SeekableInputStream& input,
+                                 size_t numThreads) :
+    mInput(&input)
+{
+    init(numThreads);
+}
+
+void BGZFInputStream::init(size_t numThreads)
+{
+    mNumThreads = numThreads ? numThreads :
+            mt::WorkStealingExecutor::getInstance().getNumThreads();
+    mNumThreads = std::max<size_t>(mNumThreads, 1);
+    mMaxBatchBlocks = mNumThreads * BLOCKS_PER_THREAD;
+    mBatchBlocks = mMaxBatchBlocks;
+    ::memset(&mStream, 0, sizeof(mStream));
+
+    mInputSize = static_cast<sys::Uint64_T>(
+            mInput->seek(0, io::Seekable::END));
+    if (mInputSize == 0)
+    {
+        // Nothing to read either way
+        mIsBGZF = true;
+        mHaveIndex = mHaveSize = true;
+        return;
+    }
+
+    sys::ubyte magic[2] = { 0, 0 };
+    mInput->seek(0, io::Seekable::START);
+    mInput->read(magic, std::min<size_t>(2, mInputSize));
+    if (magic[0] != 0x1f || magic[1] != 0x8b)
+    {
+        throw except::IOException(Ctxt("Not a gzip file"));
+    }
+
+    std::vector<sys::ubyte> header;
+    try
+    {
+        mIsBGZF = readBlockHeader(0, header) > 0;
+    }
+    catch (const except::IOException&)
+    {
+        // No BC field, so it's plain gzip
+    }
+
+    if (!mIsBGZF)
+    {
+        const int zerr = inflateInit2(&mStream, 16 + MAX_WBITS);
+        if (zerr != Z_OK)
+        {
+            throw except::IOException(Ctxt(str::Format(
+                    "inflateInit2 failed [%d]", zerr)));
+        }
+        mStreamInit = true;
+        mInputBuffer.resize(INPUT_BUFFER_SIZE);
+    }
+}
+
+BGZFInputStream::~BGZFInputStream()
+{
+    discardBatches();
+    if (mStreamInit)
+    {
+        inflateEnd(&mStream);
+    }
+}
+
+void BGZFInputStream::close()
+{
+    discardBatches();
+    if (mOwned)
+    {
+        mOwned->close();
+    }
+}
+
+size_t BGZFInputStream::readBlockHeader(sys::Uint64_T offset,
+                                        std::vector<sys::ubyte>& block)
+{
+    if (offset >= mInputSize)
+    {
+        return 0;
+    }
+
+    // The fixed part of the header, then the extra field
+    const size_t fixedLen = 12;
+    if (mInputSize - offset < fixedLen)
+    {
+        throw except::IOException(Ctxt("Truncated gzip header"));
+    }
+    block.resize(fixedLen);
+    mInput->seek(static_cast<sys::Off_T>(offset), io::Seekable::START);
+    mInput->read(block.data(), fixedLen, true);
+
+    const size_t extraLen = (block[3] & 4) ? block[10] | (block[11] << 8) : 0;
+    if (mInputSize - offset < fixedLen + extraLen)
+    {
+        throw except::IOException(Ctxt("Truncated gzip header"));
+    }
+    block.resize(fixedLen + extraLen);
+    if (extraLen > 0)
+    {
+        mInput->read(block.data() + fixedLen, extraLen, true);
+    }
+
+    const size_t blockLen =
+            bgzf::details::getBlockSize(block.data(), block.size());
+    if (blockLen == 0 || mInputSize - offset < blockLen)
+    {
+        std::ostringstream ostr;
+        ostr << "Bad BGZF block at offset " << offset;
+        throw except::IOException(Ctxt(ostr));
+    }
+    return blockLen;
+}
+
+void BGZFInputStream::startBatch()
+{
+    if (mNextBlockOffset >= mInputSize)
+    {
+        return;
+    }
+
+    std::unique_ptr<Batch> batch(new Batch);
+    batch->start = mNextBlockStart;
+    while (batch->blocks.size() < mBatchBlocks)
+    {
+        std::vector<sys::ubyte> block;
+        const size_t blockLen = readBlockHeader(mNextBlockOffset, block);
+        if (blockLen == 0)
+        {
+            break;
+        }
+
+        const size_t headerLen = block.size();
+        block.resize(blockLen);
+        mInput->read(block.data() + headerLen, blockLen - headerLen, true);
+
+        const sys::Uint32_T dataSize = getDataSize(block);
+        batch->size += dataSize;
+        mNextBlockStart += dataSize;
+        mNextBlockOffset += blockLen;
+        batch->blocks.push_back(std::move(block));
+    }
+
+    // Ramp back up after a seek
+    mBatchBlocks = std::min(mBatchBlocks * 2, mMaxBatchBlocks);
+
+    Batch& b = *batch;
+    const size_t numBlocks = b.blocks.size();
+    b.data.resize(numBlocks);
+    const auto inflate = [&b](size_t ii)
+    {
+        bgzf::details::inflateBlock(b.blocks[ii].data(), b.blocks[ii].size(),
+                                    b.data[ii]);
+        std::vector<sys::ubyte>().swap(b.blocks[ii]);
+    };
+    if (mNumThreads == 1 || numBlocks == 1)
+    {
+        for (size_t ii = 0; ii < numBlocks; ++ii)
+        {
+            inflate(ii);
+        }
+    }
+    else
+    {
+        b.tasks.reset(new mt::TaskGroup);
+        for (size_t ii = 0; ii < numBlocks; ++ii)
+        {
+            b.tasks->run([inflate, ii]() { inflate(ii); });
+        }
+    }
+    mAhead = std::move(batch);
+}
+
+bool BGZFInputStream::nextBatch()
+{
+    if (!mAhead)
+    {
+        startBatch();
+    }
+    if (!mAhead)
+    {
+        return false;
+    }
+
+    std::unique_ptr<Batch> batch(std::move(mAhead));
+    if (batch->tasks)
+    {
+        batch->tasks->wait();
+    }
+    mCurrent = std::move(batch);
+    mBlock = 0;
+    mBlockPos = 0;
+
+    // Read ahead while the caller works through this one
+    startBatch();
+    return true;
+}
+
+void BGZFInputStream::discardBatches()
+{
+    // Destroying a TaskGroup waits for its tasks
+    mAhead.reset();
+    mCurrent.reset();
+    mBlock = 0;
+    mBlockPos = 0;
+}
+
+sys::SSize_T BGZFInputStream::readImpl(void* buffer, size_t len)
+{
+    len = std::min<size_t>(len, std::numeric_limits<sys::SSize_T>::max());
+    sys::ubyte* const out = static_cast<sys::ubyte*>(buffer);
+    const sys::SSize_T numBytes =
+            mIsBGZF ? readBGZF(out, len) : readGZip(out, len);
+    if (numBytes > 0)
+    {
+        mPosition += numBytes;
+    }
+    return numBytes;
+}
+
+sys::SSize_T BGZFInputStream::readBGZF(sys::ubyte* buffer, size_t len)
+{
+    size_t numBytes = 0;
+    while (numBytes < len)
+    {
+        if (!mCurrent || mBlock == mCurrent->data.size())
+        {
+            if (!nextBatch())
+            {
+                break;
+            }
+            continue;
+        }
+
+        const auto& data = mCurrent->data[mBlock];
+        const size_t n = std::min(len - numBytes, data.size() - mBlockPos);
+        ::memcpy(buffer + numBytes, data.data() + mBlockPos, n);
+        numBytes += n;
+        mBlockPos += n;
+        if (mBlockPos == data.size())
+        {
+            ++mBlock;
+            mBlockPos = 0;
+        }
+    }
+    return numBytes > 0 ? static_cast<sys::SSize_T>(numBytes) :
+                          static_cast<sys::SSize_T>(io::InputStream::IS_EOF);
+}
+
+sys::SSize_T BGZFInputStream::readGZip(sys::ubyte* buffer, size_t len)
+{
+    size_t numBytes = 0;
+    while (numBytes < len && !mStreamEnd)
+    {
+        if (mStream.avail_in == 0)
+        {
+            const size_t n = static_cast<size_t>(std::min<sys::Uint64_T>(
+                    mInputBuffer.size(), mInputSize - mInputOffset));
+            if (n == 0)
+            {
+                throw except::IOException(Ctxt("Truncated gzip stream"));
+            }
+            mInput->seek(static_cast<sys::Off_T>(mInputOffset),
+                         io::Seekable::START);
+            mInput->read(mInputBuffer.data(), n, true);
+            mInputOffset += n;
+            mStream.next_in = mInputBuffer.data();
+            mStream.avail_in = static_cast<uInt>(n);
+        }
+
+        const size_t outLen = std::min<size_t>(
+                len - numBytes, std::numeric_limits<uInt>::max());
+        mStream.next_out = buffer + numBytes;
+        mStream.avail_out = static_cast<uInt>(outLen);
+        const int zerr = ::inflate(&mStream, Z_NO_FLUSH);
+        numBytes += outLen - mStream.avail_out;
+
+        if (zerr == Z_STREAM_END)
+        {
+            // Another member may follow; anything else ends the stream
+            if (mStream.avail_in == 0 && mInputOffset < mInputSize)
+            {
+                const size_t n = static_cast<size_t>(std::min<sys::Uint64_T>(
+                        mInputBuffer.size(), mInputSize - mInputOffset));
+                mInput->seek(static_cast<sys::Off_T>(mInputOffset),
+                             io::Seekable::START);
+                mInput->read(mInputBuffer.data(), n, true);
+                mInputOffset += n;
+                mStream.next_in = mInputBuffer.data();
+                mStream.avail_in = static_cast<uInt>(n);
+            }
+            if (mStream.avail_in >= 2 && mStream.next_in[0] == 0x1f &&
+                mStream.next_in[1] == 0x8b)
+            {
+                inflateReset(&mStream);
+            }
+            else
+            {
+                mStreamEnd = true;
+            }
+        }
+        else if (zerr != Z_OK && zerr != Z_BUF_ERROR)
+        {
+            throw except::IOException(Ctxt(str::Format(
+                    "inflate failed [%d]", zerr)));
+        }
+    }
+    return numBytes > 0 ? static_cast<sys::SSize_T>(numBytes) :
+                          static_cast<sys::SSize_T>(io::InputStream::IS_EOF);
+}
+
+void BGZFInputStream::restartGZip()
+{
+    inflateReset(&mStream);
+    mStream.next_in = nullptr;
+    mStream.avail_in = 0;
+    mStreamEnd = false;
+    mInputOffset = 0;
+    mPosition = 0;
+}
+
+void BGZFInputStream::scanIndex()
+{
+    bgzf::Index index;
+    sys::Uint64_T offset = 0;
+    sys::Uint64_T start = 0;
+    std::vector<sys::ubyte> header;
+    sys::ubyte trailer[4];
+    while (const size_t blockLen = readBlockHeader(offset, header))
+    {
+        mInput->seek(static_cast<sys::Off_T>(offset + blockLen - 4),
+                     io::Seekable::START);
+        mInput->read(trailer, sizeof(trailer), true);
+        const sys::Uint32_T dataSize = trailer[0] | (trailer[1] << 8) |
+                (trailer[2] << 16) |
+                (static_cast<sys::Uint32_T>(trailer[3]) << 24);
+
+        // Empty blocks (the EOF marker) can't be seeked into
+        if (dataSize > 0 || index.empty())
+        {
+            bgzf::Block block;
+            block.compressedOffset = offset;
+            block.uncompressedOffset = start;
+            index.push_back(block);
+        }
+        offset += blockLen;
+        start += dataSize;
+    }
+    if (index.empty())
+    {
+        index.resize(1);
+    }
+
+    mIndex = std::move(index);
+    mHaveIndex = true;
+    mUncompressedSize = start;
+    mHaveSize = true;
+}
+
+const bgzf::Index& BGZFInputStream::getIndex()
+{
+    if (mIsBGZF && !mHaveIndex)
+    {
+        scanIndex();
+    }
+    return mIndex;
+}
+
+void BGZFInputStream::setIndex(const bgzf::Index& index)
+{
+    if (index.empty() || index[0].compressedOffset != 0 ||
+        index[0].uncompressedOffset != 0)
+    {
+        throw except::InvalidArgumentException(Ctxt(
+                "A BGZF index starts with block (0, 0)"));
+    }
+    mIndex = index;
+    mHaveIndex = true;
+}
+
+void BGZFInputStream::skip(sys::Uint64_T numBytes)
+{
+    std::vector<sys::ubyte> scratch(static_cast<size_t>(
+            std::min<sys::Uint64_T>(numBytes, INPUT_BUFFER_SIZE)));
+    while (numBytes > 0)
+    {
+        const size_t n = static_cast<size_t>(
+                std::min<sys::Uint64_T>(numBytes, scratch.size()));
+        const sys::SSize_T numRead = read(scratch.data(), n);
+        if (numRead <= 0)
+        {
+            throw except::IOException(Ctxt(
+                    "Tried to seek past the end of the gzip stream"));
+        }
+        numBytes -= numRead;
+    }
+}
+
+sys::Off_T BGZFInputStream::seek(sys::Off_T offset, Whence whence)
+{
+    sys::Off_T target = offset;
+    switch (whence)
+    {
+    case END:
+        if (!mIsBGZF)
+        {
+            throw except::NotImplementedException(Ctxt(
+                    "Can't seek from the end of a plain gzip stream"));
+        }
+        if (!mHaveSize)
+        {
+            scanIndex();
+        }
+        target += static_cast<sys::Off_T>(mUncompressedSize);
+        break;
+
+    case CURRENT:
+        target += static_cast<sys::Off_T>(mPosition);
+        break;
+
+    case START:
+    default:
+        break;
+    }
+    if (target < 0)
+    {
+        throw except::IOException(Ctxt("Tried to seek before the start"));
+    }
+    const auto position = static_cast<sys::Uint64_T>(target);
+
+    if (!mIsBGZF)
+    {
+        if (position < mPosition)
+        {
+            restartGZip();
+        }
+        skip(position - mPosition);
+        return target;
+    }
+
+    // Stay in the current batch if we can
+    if (mCurrent && position >= mCurrent->start &&
+        position < mCurrent->start + mCurrent->size)
+    {
+        sys::Uint64_T remaining = position - mCurrent->start;
+        mBlock = 0;
+        while (remaining >= mCurrent->data[mBlock].size())
+        {
+            remaining -= mCurrent->data[mBlock].size();
+            ++mBlock;
+        }
+        mBlockPos = static_cast<size_t>(remaining);
+        mPosition = position;
+        return target;
+    }
+
+    const bgzf::Index& index = getIndex();
+    auto block = std::upper_bound(index.begin(), index.end(), position,
+            [](sys::Uint64_T value, const bgzf::Block& b)
+            {
+                return value < b.uncompressedOffset;
+            });
+    --block;  // index[0] is (0, 0), so there's always one
+
+    discardBatches();
+    mNextBlockOffset = block->compressedOffset;
+    mNextBlockStart = block->uncompressedOffset;
+    mPosition = block->uncompressedOffset;
+    mBatchBlocks = 1;
+    skip(position - mPosition);
+    return target;
+}
+}
@@ -0,0 +1,212 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "zip/BGZFOutputStream.h"
+
+#include <algorithm>
+
+#include "io/FileOutputStream.h"
+#include "math/Round.h"
+
+namespace
+{
+// Enough blocks per thread that uneven blocks balance out
+constexpr size_t BLOCKS_PER_THREAD = 4;
+}
+
+namespace zip
+{
+BGZFOutputStream::BGZFOutputStream(const std::string& file, int level,
+                                   size_t numThreads) :
+    mOwned(new io::FileOutputStream(file)),
+    mOutput(mOwned.get())
+{
+    init(level, numThreads);
+}
+
+BGZFOutputStream::BGZFOutputStream(io::OutputStream& output, int level,
+                                   size_t numThreads) :
+    mOutput(&output)
+{
+    init(level, numThreads);
+}
+
+void BGZFOutputStream::init(int level, size_t numThreads)
+{
+    mLevel = level;
+    mNumThreads = numThreads ? numThreads :
+            mt::WorkStealingExecutor::getInstance().getNumThreads();
+    mNumThreads = std::max<size_t>(mNumThreads, 1);
+    mBatchSize = mNumThreads * BLOCKS_PER_THREAD * bgzf::BLOCK_DATA_SIZE;
+    mCurrent.reset(new Batch);
+    mCurrent->data.reserve(mBatchSize);
+    mIndex.resize(1);
+}
+
+BGZFOutputStream::~BGZFOutputStream()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void BGZFOutputStream::write(const void* buffer, size_t len)
+{
+    if (mClosed)
+    {
+        throw except::IOException(Ctxt("BGZF stream is closed"));
+    }
+
+    const sys::ubyte* p = static_cast<const sys::ubyte*>(buffer);
+    while (len > 0)
+    {
+        auto& data = mCurrent->data;
+        const size_t numBytes = std::min(len, mBatchSize - data.size());
+        data.insert(data.end(), p, p + numBytes);
+        p += numBytes;
+        len -= numBytes;
+
+        if (data.size() == mBatchSize)
+        {
+            dispatch();
+        }
+    }
+}
+
+void BGZFOutputStream::dispatch()
+{
+    // Only one batch is compressed at a time, so memory stays bounded
+    finishPending();
+
+    Batch& batch = *mCurrent;
+    const size_t numBlocks =
+            math::ceilingDivide(batch.data.size(),
+                                static_cast<size_t>(bgzf::BLOCK_DATA_SIZE));
+    batch.blocks.resize(numBlocks);
+    const auto compress = [&batch, this](size_t ii)
+    {
+        const size_t offset = ii * bgzf::BLOCK_DATA_SIZE;
+        const size_t len = std::min<size_t>(bgzf::BLOCK_DATA_SIZE,
+                                            batch.data.size() - offset);
+        bgzf::details::compressBlock(batch.data.data() + offset, len,
+                                     mLevel, batch.blocks[ii]);
+    };
+
+    if (mNumThreads == 1)
+    {
+        for (size_t ii = 0; ii < numBlocks; ++ii)
+        {
+            compress(ii);
+        }
+    }
+    else
+    {
+        batch.tasks.reset(new mt::TaskGroup);
+        for (size_t ii = 0; ii < numBlocks; ++ii)
+        {
+            batch.tasks->run([compress, ii]() { compress(ii); });
+        }
+    }
+
+    mPending = std::move(mCurrent);
+    mCurrent.reset(new Batch);
+    mCurrent->data.reserve(mBatchSize);
+}
+
+void BGZFOutputStream::finishPending()
+{
+    if (!mPending)
+    {
+        return;
+    }
+
+    // Drop the batch even if it failed; its tasks are done either way
+    std::unique_ptr<Batch> batch(std::move(mPending));
+    if (batch->tasks)
+    {
+        batch->tasks->wait();
+    }
+
+    size_t dataOffset = 0;
+    for (const auto& block : batch->blocks)
+    {
+        if (mCompressedOffset > 0)
+        {
+            bgzf::Block entry;
+            entry.compressedOffset = mCompressedOffset;
+            entry.uncompressedOffset = mUncompressedOffset;
+            mIndex.push_back(entry);
+        }
+        mOutput->write(block.data(), block.size());
+
+        const size_t len = std::min<size_t>(bgzf::BLOCK_DATA_SIZE,
+                                            batch->data.size() - dataOffset);
+        dataOffset += len;
+        mCompressedOffset += block.size();
+        mUncompressedOffset += len;
+    }
+}
+
+void BGZFOutputStream::flush()
+{
+    if (mClosed)
+    {
+        return;
+    }
+    if (!mCurrent->data.empty())
+    {
+        dispatch();
+    }
+    finishPending();
+    mOutput->flush();
+}
+
+void BGZFOutputStream::close()
+{
+    if (mClosed)
+    {
+        return;
+    }
+    mClosed = true;
+
+    if (!mCurrent->data.empty())
+    {
+        dispatch();
+    }
+    finishPending();
+
+    // An empty block marks the end of a BGZF file
+    std::vector<sys::ubyte> eof;
+    bgzf::details::compressBlock(nullptr, 0, mLevel, eof);
+    mOutput->write(eof.data(), eof.size());
+    mCompressedOffset += eof.size();
+
+    if (mOwned)
+    {
+        mOwned->close();
+    }
+}
+}
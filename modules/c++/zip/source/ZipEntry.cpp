@@ -21,6 +21,7 @@
  */
 
 #include "zip/ZipEntry.h"
+#include "zip/ZipEntryInputStream.h"
 #undef Z_NULL
 #define Z_NULL nullptr
 
@@ -83,7 +84,12 @@ sys::ubyte* ZipEntry::decompress()
 
 void ZipEntry::decompress(sys::ubyte* out, sys::Size_T outLen)
 {
-    if (mCompressionMethod == COMP_STORED)
+    if (mSource)
+    {
+        ZipEntryInputStream input(*this);
+        input.read(out, outLen, true);
+    }
+    else if (mCompressionMethod == COMP_STORED)
     {
         memcpy(out, mCompressedData, outLen);
     }
@@ -93,6 +99,35 @@ void ZipEntry::decompress(sys::ubyte* out, sys::Size_T outLen)
     }
 }
 
+sys::Uint64_T ZipEntry::getDataOffset() const
+{
+    if (!mSource)
+    {
+        throw except::Exception(Ctxt(
+                "Entry [" + mFileName + "] was not read from a ZipFile"));
+    }
+
+    sys::ubyte header[LFH_SIZE];
+    mSource->readAt(mLocalHeaderOffset, header, LFH_SIZE);
+
+    // Zip is little-endian
+    const auto readShort = [](const sys::ubyte* p)
+    {
+        return static_cast<sys::Uint16_T>(p[0] | (p[1] << 8));
+    };
+    const sys::Uint32_T signature = readShort(header) |
+            (static_cast<sys::Uint32_T>(readShort(header + 2)) << 16);
+    if (signature != LFH_SIGNATURE)
+    {
+        throw except::IOException(Ctxt(
+                "Did not find local header signature for [" + mFileName + "]"));
+    }
+
+    const sys::Uint16_T fileNameLength = readShort(&header[0x1a]);
+    const sys::Uint16_T extraFieldLength = readShort(&header[0x1c]);
+    return mLocalHeaderOffset + LFH_SIZE + fileNameLength + extraFieldLength;
+}
+
 std::ostream& operator<<(std::ostream& os, const zip::ZipEntry& ze)
 {
     const char* madeBy = ze.getVersionMadeByString();
@@ -0,0 +1,222 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "zip/ZipEntryInputStream.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "except/Exception.h"
+#include "str/Format.h"
+
+namespace
+{
+// zlib counts in uInt
+constexpr size_t MAX_ZLIB_LEN = std::numeric_limits<uInt>::max();
+
+sys::Uint32_T updateCRC(sys::Uint32_T crc, const sys::ubyte* data, size_t len)
+{
+    while (len > 0)
+    {
+        const size_t n = std::min(len, MAX_ZLIB_LEN);
+        crc = static_cast<sys::Uint32_T>(
+                crc32(crc, data, static_cast<uInt>(n)));
+        data += n;
+        len -= n;
+    }
+    return crc;
+}
+}
+
+namespace zip
+{
+ZipEntryInputStream::ZipEntryInputStream(const ZipEntry& entry,
+                                         size_t bufferSize) :
+    mSource(entry.mSource),
+    mFileName(entry.getFileName()),
+    mExpectedCRC(entry.getCRC32()),
+    mCompressedRemaining(entry.getCompressedSize()),
+    mUncompressedRemaining(entry.getUncompressedSize())
+{
+    if (!mSource)
+    {
+        throw except::InvalidArgumentException(Ctxt(
+                "Entry [" + mFileName + "] was not read from a ZipFile"));
+    }
+    if (entry.getGeneralPurposeBitFlag() & 0x1)
+    {
+        throw except::NotImplementedException(Ctxt(
+                "Entry [" + mFileName + "] is encrypted"));
+    }
+
+    switch (entry.getCompressionMethod())
+    {
+    case ZipEntry::COMP_STORED:
+        break;
+    case ZipEntry::COMP_DEFLATED:
+        mDeflated = true;
+        break;
+    default:
+        throw except::NotImplementedException(Ctxt(str::Format(
+                "Entry [%s] uses unsupported compression method %d",
+                mFileName.c_str(), entry.getCompressionMethod())));
+    }
+
+    mOffset = entry.getDataOffset();
+    if (mCompressedRemaining <= std::numeric_limits<size_t>::max())
+    {
+        mView = mSource->view(mOffset,
+                              static_cast<size_t>(mCompressedRemaining));
+    }
+    if (!mView)
+    {
+        mBuffer.resize(static_cast<size_t>(std::min<sys::Uint64_T>(
+                std::max<size_t>(bufferSize, 1), mCompressedRemaining)));
+    }
+
+    ::memset(&mStream, 0, sizeof(mStream));
+    if (mDeflated)
+    {
+        const int zerr = inflateInit2(&mStream, -MAX_WBITS);
+        if (zerr != Z_OK)
+        {
+            throw except::IOException(Ctxt(str::Format(
+                    "inflateInit2 failed [%d]", zerr)));
+        }
+    }
+}
+
+ZipEntryInputStream::~ZipEntryInputStream()
+{
+    if (mDeflated)
+    {
+        inflateEnd(&mStream);
+    }
+}
+
+void ZipEntryInputStream::fillInput()
+{
+    if (mCompressedRemaining == 0)
+    {
+        throw except::IOException(Ctxt(
+                "Compressed data for [" + mFileName + "] ended early"));
+    }
+
+    const size_t len = static_cast<size_t>(std::min<sys::Uint64_T>(
+            mCompressedRemaining, mView ? MAX_ZLIB_LEN : mBuffer.size()));
+    if (mView)
+    {
+        mStream.next_in = const_cast<Bytef*>(mView);
+        mView += len;
+    }
+    else
+    {
+        mSource->readAt(mOffset, mBuffer.data(), len);
+        mStream.next_in = mBuffer.data();
+    }
+    mStream.avail_in = static_cast<uInt>(len);
+    mOffset += len;
+    mCompressedRemaining -= len;
+}
+
+sys::SSize_T ZipEntryInputStream::readImpl(void* buffer, size_t len)
+{
+    if (mUncompressedRemaining == 0)
+    {
+        return io::InputStream::IS_EOF;
+    }
+
+    // Stay under what read() can report
+    len = static_cast<size_t>(std::min<sys::Uint64_T>(
+            {len, mUncompressedRemaining,
+             static_cast<sys::Uint64_T>(
+                     std::numeric_limits<sys::SSize_T>::max())}));
+    sys::ubyte* const out = static_cast<sys::ubyte*>(buffer);
+
+    size_t numBytes = 0;
+    if (!mDeflated)
+    {
+        if (len > mCompressedRemaining)
+        {
+            throw except::IOException(Ctxt(
+                    "Stored data for [" + mFileName + "] ended early"));
+        }
+        if (mView)
+        {
+            ::memcpy(out, mView, len);
+            mView += len;
+        }
+        else
+        {
+            mSource->readAt(mOffset, out, len);
+        }
+        mOffset += len;
+        mCompressedRemaining -= len;
+        numBytes = len;
+    }
+    else
+    {
+        while (numBytes < len)
+        {
+            if (mStream.avail_in == 0)
+            {
+                fillInput();
+            }
+
+            const size_t outLen = std::min(len - numBytes, MAX_ZLIB_LEN);
+            mStream.next_out = out + numBytes;
+            mStream.avail_out = static_cast<uInt>(outLen);
+            const int zerr = ::inflate(&mStream, Z_NO_FLUSH);
+            numBytes += outLen - mStream.avail_out;
+
+            if (zerr == Z_STREAM_END)
+            {
+                if (numBytes < len)
+                {
+                    throw except::IOException(Ctxt(
+                            "Entry [" + mFileName +
+                            "] is smaller than its uncompressed size"));
+                }
+                break;
+            }
+            if (zerr != Z_OK && zerr != Z_BUF_ERROR)
+            {
+                throw except::IOException(Ctxt(str::Format(
+                        "inflate failed for [%s] [%d]",
+                        mFileName.c_str(), zerr)));
+            }
+        }
+    }
+
+    mCRC = updateCRC(mCRC, out, numBytes);
+    mUncompressedRemaining -= numBytes;
+    if (mUncompressedRemaining == 0 && mCRC != mExpectedCRC)
+    {
+        throw except::IOException(Ctxt(str::Format(
+                "CRC-32 mismatch for [%s]: expected %08x, got %08x",
+                mFileName.c_str(), mExpectedCRC, mCRC)));
+    }
+    return static_cast<sys::SSize_T>(numBytes);
+}
+}
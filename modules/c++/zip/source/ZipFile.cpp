@@ -22,11 +22,184 @@
 
 #include "zip/ZipFile.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+#include "io/MMapInputStream.h"
+#include "sys/File.h"
+
 #define Z_READ_SHORT_INC(BUF, OFF) readShort(&BUF[OFF]); OFF += 2
 #define Z_READ_INT_INC(BUF, OFF) readInt(&BUF[OFF]); OFF += 4
+#define Z_READ_LONG_INC(BUF, OFF) readLong(&BUF[OFF]); OFF += 8
+
+namespace
+{
+void checkRange(sys::Uint64_T offset, size_t len, sys::Uint64_T size)
+{
+    if (offset > size || len > size - offset)
+    {
+        std::ostringstream ostr;
+        ostr << "Tried to read " << len << " bytes at offset " << offset
+             << " of a " << size << " byte zip archive";
+        throw except::IOException(Ctxt(ostr));
+    }
+}
+
+// The whole archive is in memory, owned or borrowed
+class MemorySource final : public zip::ArchiveSource
+{
+    std::vector<sys::ubyte> mOwned;
+    const sys::ubyte* mData;
+    sys::Uint64_T mSize;
+
+public:
+    explicit MemorySource(std::vector<sys::ubyte>&& data) :
+        mOwned(std::move(data)), mData(mOwned.data()), mSize(mOwned.size())
+    {
+    }
+
+    sys::Uint64_T getSize() const override
+    {
+        return mSize;
+    }
+
+    void readAt(sys::Uint64_T offset, void* buffer, size_t len) const override
+    {
+        checkRange(offset, len, mSize);
+        ::memcpy(buffer, mData + offset, len);
+    }
+
+    const sys::ubyte* view(sys::Uint64_T offset, size_t len) const override
+    {
+        checkRange(offset, len, mSize);
+        return mData + offset;
+    }
+};
+
+class MMapSource final : public zip::ArchiveSource
+{
+    io::MMapInputStream mMap;
+
+public:
+    explicit MMapSource(const std::string& pathname) : mMap(pathname)
+    {
+    }
+
+    sys::Uint64_T getSize() const override
+    {
+        return static_cast<sys::Uint64_T>(mMap.getLength());
+    }
+
+    void readAt(sys::Uint64_T offset, void* buffer, size_t len) const override
+    {
+        ::memcpy(buffer, view(offset, len), len);
+    }
+
+    const sys::ubyte* view(sys::Uint64_T offset, size_t len) const override
+    {
+        checkRange(offset, len, getSize());
+        return reinterpret_cast<const sys::ubyte*>(
+                mMap.view(static_cast<sys::Off_T>(offset), len).data());
+    }
+};
+
+// Positioned reads (pread() or overlapped ReadFile()) don't share a file
+// pointer, so there's no need to lock
+class FileSource final : public zip::ArchiveSource
+{
+    mutable sys::File mFile;
+    sys::Uint64_T mSize;
+
+public:
+    explicit FileSource(const std::string& pathname) :
+        mFile(pathname, sys::File::READ_ONLY, sys::File::EXISTING),
+        mSize(static_cast<sys::Uint64_T>(mFile.length()))
+    {
+    }
+
+    sys::Uint64_T getSize() const override
+    {
+        return mSize;
+    }
+
+    void readAt(sys::Uint64_T offset, void* buffer, size_t len) const override
+    {
+        checkRange(offset, len, mSize);
+        mFile.readAtInto(static_cast<sys::Off_T>(offset), buffer, len);
+    }
+};
+
+// A stream has one position, so readers take turns
+class StreamSource final : public zip::ArchiveSource
+{
+    io::SeekableInputStream& mStream;
+    sys::Uint64_T mSize;
+    mutable std::mutex mMutex;
+
+public:
+    explicit StreamSource(io::SeekableInputStream& stream) : mStream(stream)
+    {
+        mSize = static_cast<sys::Uint64_T>(
+                mStream.seek(0, io::Seekable::END));
+    }
+
+    sys::Uint64_T getSize() const override
+    {
+        return mSize;
+    }
+
+    void readAt(sys::Uint64_T offset, void* buffer, size_t len) const override
+    {
+        checkRange(offset, len, mSize);
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStream.seek(static_cast<sys::Off_T>(offset), io::Seekable::START);
+        mStream.read(buffer, len, true);
+    }
+};
+
+std::vector<sys::ubyte> readAll(io::InputStream& inputStream)
+{
+    std::vector<sys::ubyte> data(
+            static_cast<size_t>(inputStream.available()));
+    if (!data.empty())
+    {
+        inputStream.read(data.data(), data.size());
+    }
+    return data;
+}
+}
 
 namespace zip
 {
+ZipFile::ZipFile(io::InputStream* inputStream) :
+    ZipFile(std::make_shared<MemorySource>(readAll(*inputStream)))
+{
+}
+
+ZipFile::ZipFile(io::SeekableInputStream& inputStream) :
+    ZipFile(std::make_shared<StreamSource>(inputStream))
+{
+}
+
+ZipFile::ZipFile(const std::string& pathname, bool memoryMap) :
+    ZipFile(memoryMap ?
+            std::shared_ptr<const ArchiveSource>(
+                    std::make_shared<MMapSource>(pathname)) :
+            std::make_shared<FileSource>(pathname))
+{
+}
+
+ZipFile::ZipFile(std::shared_ptr<const ArchiveSource> source) :
+    mSource(std::move(source))
+{
+    mSwapBytes = sys::isBigEndianSystem();
+    readCentralDir();
+}
+
 ZipFile::~ZipFile()
 {
     for (size_t i = 0; i < mEntries.size(); ++i)
@@ -34,17 +207,22 @@ ZipFile::~ZipFile()
         // Delete ZipEntry
         delete mEntries[i];
     }
+}
+
+sys::Uint64_T ZipFile::readLong(const sys::ubyte* buf) const
+{
+    sys::Uint64_T le;
+    memcpy(&le, buf, 8);
 
-    if (mCompressed)
-        delete[] mCompressed;
+    if (mSwapBytes)
+        le = sys::byteSwap(le);
+    return le;
 }
 
-sys::Uint32_T ZipFile::readInt(sys::ubyte* buf)
+sys::Uint32_T ZipFile::readInt(const sys::ubyte* buf) const
 {
-    sys::ubyte* p;
-    sys::Uint32_T le;// = *((sys::Uint32_T *)buf);
-    p = (sys::ubyte*) &le;
-    memcpy(p, buf, 4);
+    sys::Uint32_T le;
+    memcpy(&le, buf, 4);
 
     // Kind of hackish, but we need it like yesterday    
     if (mSwapBytes)
@@ -55,51 +233,44 @@ sys::Uint32_T ZipFile::readInt(sys::ubyte* buf)
     return le;
 }
 
-sys::Uint16_T ZipFile::readShort(sys::ubyte* buf)
+sys::Uint16_T ZipFile::readShort(const sys::ubyte* buf) const
 {
-    sys::ubyte* p;
-    sys::Uint16_T le;// = *((sys::Uint16_T *)buf);
-    p = (sys::ubyte*) &le;
-    memcpy(p, buf, 2);
+    sys::Uint16_T le;
+    memcpy(&le, buf, 2);
 
     if (mSwapBytes)
         le = sys::byteSwap(le);
     return le;
 }
 
-ZipFile::Iterator ZipFile::lookup(std::string fileName) const
+ZipFile::Iterator ZipFile::lookup(const std::string& fileName) const
 {
-    ZipFile::Iterator p;
-    for (p = mEntries.begin(); p != mEntries.end(); ++p)
-    {
-
-        if ((*p)->getFileName() == fileName)
-            break;
-    }
-
-    return p;
-
+    const auto p = mIndex.find(fileName);
+    if (p == mIndex.end())
+        return mEntries.end();
+    return mEntries.begin() + p->second;
 }
 
 void ZipFile::readCentralDir()
 {
-    if (mCompressedLength < EOCD_LEN)
+    const sys::Uint64_T archiveSize = mSource->getSize();
+    if (archiveSize < EOCD_LEN)
         throw except::IOException(Ctxt(
                 "stream source too small to be a zip stream"));
-    sys::ubyte* start;
 
-    if (mCompressedLength > MAX_EOCD_SEARCH)
-    {
-        start = mCompressed + mCompressedLength - MAX_EOCD_SEARCH;
-    }
-    else
-    {
-        start = mCompressed;
-    }
-    sys::ubyte* p = mCompressed + mCompressedLength - 4;
+    // The EOCD is at most MAX_EOCD_SEARCH bytes from the end; the ZIP64
+    // locator, if there is one, is right before it
+    const size_t tailLen = static_cast<size_t>(std::min<sys::Uint64_T>(
+            archiveSize, MAX_EOCD_SEARCH + ZIP64_LOCATOR_LEN));
+    std::vector<sys::ubyte> tail(tailLen);
+    mSource->readAt(archiveSize - tailLen, tail.data(), tailLen);
 
-    sys::ubyte* eocd = nullptr;
-    auto i = mCompressedLength - 4;
+    const sys::ubyte* const start = tail.data() +
+            (tailLen > MAX_EOCD_SEARCH ? tailLen - MAX_EOCD_SEARCH : 0);
+    const sys::ubyte* const tailEnd = tail.data() + tailLen;
+    const sys::ubyte* p = tailEnd - EOCD_LEN;
+
+    const sys::ubyte* eocd = nullptr;
     while (p >= start)
     {
         if (*p == 0x50)
@@ -111,32 +282,65 @@ void ZipFile::readCentralDir()
             }
         }
         p--;
-        i--;
     }
-    if (p < start)
+    if (eocd == nullptr)
     {
         throw except::IOException(Ctxt("EOCD not found"));
     }
     // else still rockin'
-    readCentralDirValues(eocd, (mCompressed + mCompressedLength) - eocd);
+    readCentralDirValues(eocd, tailEnd - eocd);
 
-    p = mCompressed + mCentralDirOffset;
-    const sys::SSize_T len = (mCompressed + mCompressedLength) - p;
-    for (auto& entry : mEntries)
+    if (eocd - tail.data() >= ZIP64_LOCATOR_LEN &&
+        readInt(eocd - ZIP64_LOCATOR_LEN) == ZIP64_LOCATOR_SIGNATURE)
     {
-        entry = newCentralDirEntry(&p, len);
+        readZip64CentralDirValues(eocd - ZIP64_LOCATOR_LEN);
     }
 
+    if (mCentralDirOffset > archiveSize ||
+        mCentralDirSize > archiveSize - mCentralDirOffset ||
+        mCentralDirSize > std::numeric_limits<size_t>::max())
+    {
+        throw except::IOException(Ctxt("Central directory is out of range"));
+    }
+    // Every entry takes at least ENTRY_LEN bytes
+    if (mNumEntries > mCentralDirSize / ENTRY_LEN)
+    {
+        throw except::IOException(Ctxt(
+                "Central directory is too small for its entries"));
+    }
+
+    std::vector<sys::ubyte> centralDir(static_cast<size_t>(mCentralDirSize));
+    mSource->readAt(mCentralDirOffset, centralDir.data(), centralDir.size());
+
+    std::vector<std::unique_ptr<ZipEntry> > entries;
+    entries.reserve(static_cast<size_t>(mNumEntries));
+    p = centralDir.data();
+    const sys::ubyte* const end = p + centralDir.size();
+    for (sys::Uint64_T i = 0; i < mNumEntries; ++i)
+    {
+        entries.push_back(newCentralDirEntry(p, end));
+    }
+
+    // Like the linear search this replaces, a duplicate name finds the
+    // first entry
+    mEntries.reserve(entries.size());
+    mIndex.reserve(entries.size());
+    for (auto& entry : entries)
+    {
+        mIndex.emplace(entry->getFileName(), mEntries.size());
+        mEntries.push_back(entry.release());
+    }
 }
 
-ZipEntry* ZipFile::newCentralDirEntry(sys::ubyte** buf, sys::SSize_T len)
+std::unique_ptr<ZipEntry> ZipFile::newCentralDirEntry(const sys::ubyte*& buf,
+                                                      const sys::ubyte* end)
 {
-    if (len < ENTRY_LEN)
+    if (end - buf < ENTRY_LEN)
         throw except::IOException(Ctxt("CDE entry not large enough"));
 
     sys::SSize_T off = 0;
 
-    sys::ubyte* p = *buf;
+    const sys::ubyte* p = buf;
 
     sys::Uint32_T entrySig = Z_READ_INT_INC(p, off);
 
@@ -150,26 +354,57 @@ ZipEntry* ZipFile::newCentralDirEntry(sys::ubyte** buf, sys::SSize_T len)
     sys::Uint16_T lastModifiedTime = Z_READ_SHORT_INC(p, off);
     sys::Uint16_T lastModifiedDate = Z_READ_SHORT_INC(p, off);
     sys::Uint32_T crc32 = Z_READ_INT_INC(p, off);
-    sys::Uint32_T compressedSize = Z_READ_INT_INC(p, off);
-    sys::Uint32_T uncompressedSize = Z_READ_INT_INC(p, off);
+    sys::Uint64_T compressedSize = Z_READ_INT_INC(p, off);
+    sys::Uint64_T uncompressedSize = Z_READ_INT_INC(p, off);
     sys::Uint16_T fileNameLength = Z_READ_SHORT_INC(p, off);
     sys::Uint16_T extraFieldLength = Z_READ_SHORT_INC(p, off);
     sys::Uint16_T fileCommentLength = Z_READ_SHORT_INC(p, off);
     Z_READ_SHORT_INC(p, off); // skipping diskNumberStart
     sys::Uint16_T internalAttrs = Z_READ_SHORT_INC(p, off);
     auto externalAttrs = Z_READ_INT_INC(p, off);
-    sys::Uint32_T localHeaderRelOffset = readInt(&p[off]);
+    sys::Uint64_T localHeaderRelOffset = readInt(&p[off]);
     p += ENTRY_LEN;
 
+    if (end - p < fileNameLength + extraFieldLength + fileCommentLength)
+        throw except::IOException(Ctxt("CDE entry not large enough"));
+
     std::string fileName;
     if (fileNameLength != 0)
         fileName = std::string((const char*) p, fileNameLength);
 
     p += fileNameLength;
 
-    // I dont know what extra field is, but skip it for now	    
-    if (extraFieldLength)
-        p += extraFieldLength;
+    // The only extra field we care about is ZIP64's; it has the 64-bit
+    // version of each field that's 0xFFFFFFFF above, in this order
+    const sys::ubyte* const extraEnd = p + extraFieldLength;
+    while (extraEnd - p >= 4)
+    {
+        const sys::Uint16_T headerID = readShort(p);
+        const sys::Uint16_T dataSize = readShort(p + 2);
+        p += 4;
+        if (extraEnd - p < dataSize)
+            break;
+
+        if (headerID == ZIP64_EXTRA_ID)
+        {
+            const sys::ubyte* field = p;
+            const sys::ubyte* const fieldEnd = p + dataSize;
+            for (sys::Uint64_T* value : {&uncompressedSize, &compressedSize,
+                                         &localHeaderRelOffset})
+            {
+                if (*value != 0xFFFFFFFF)
+                    continue;
+                if (fieldEnd - field < 8)
+                    throw except::IOException(Ctxt(
+                            "ZIP64 extra field too small for [" +
+                            fileName + "]"));
+                *value = readLong(field);
+                field += 8;
+            }
+        }
+        p += dataSize;
+    }
+    p = extraEnd;
 
     std::string fileComment;
     if (fileCommentLength)
@@ -177,24 +412,28 @@ ZipEntry* ZipFile::newCentralDirEntry(sys::ubyte** buf, sys::SSize_T len)
 
     p += fileCommentLength;
 
-    *buf = p;
-
-    p = mCompressed + localHeaderRelOffset;
-
-    extraFieldLength = readShort(&p[0x1c]);
-
-    sys::Size_T dataOffset = localHeaderRelOffset + LFH_SIZE + fileNameLength
-            + extraFieldLength;
+    buf = p;
 
-    return new ZipEntry(mCompressed + dataOffset, compressedSize,
-            uncompressedSize, fileName, fileComment, versionMadeBy,
-            versionToExtract, generalPurposeBitFlag, compressionMethod,
-            lastModifiedTime, lastModifiedDate, crc32, internalAttrs,
-            externalAttrs);
+    if (compressedSize > std::numeric_limits<sys::Size_T>::max() ||
+        uncompressedSize > std::numeric_limits<sys::Size_T>::max())
+    {
+        throw except::IOException(Ctxt(
+                "Entry [" + fileName + "] is too large for this platform"));
+    }
 
+    // The data is read through mSource when it's needed
+    std::unique_ptr<ZipEntry> entry(new ZipEntry(nullptr,
+            static_cast<sys::Size_T>(compressedSize),
+            static_cast<sys::Size_T>(uncompressedSize), fileName,
+            fileComment, versionMadeBy, versionToExtract,
+            generalPurposeBitFlag, compressionMethod, lastModifiedTime,
+            lastModifiedDate, crc32, internalAttrs, externalAttrs));
+    entry->mSource = mSource;
+    entry->mLocalHeaderOffset = localHeaderRelOffset;
+    return entry;
 }
 
-void ZipFile::readCentralDirValues(sys::ubyte* buf, sys::SSize_T len)
+void ZipFile::readCentralDirValues(const sys::ubyte* buf, sys::SSize_T len)
 {
 
     if (len < EOCD_LEN)
@@ -216,7 +455,7 @@ void ZipFile::readCentralDirValues(sys::ubyte* buf, sys::SSize_T len)
     if (totalEntries != entryCount)
         throw except::IOException(Ctxt("Total entries must match entries"));
 
-    mEntries.resize(entryCount);
+    mNumEntries = entryCount;
 
     mCentralDirSize = Z_READ_INT_INC(buf, off);
     mCentralDirOffset = Z_READ_INT_INC(buf, off);
@@ -229,6 +468,36 @@ void ZipFile::readCentralDirValues(sys::ubyte* buf, sys::SSize_T len)
     mComment = std::string((const char*) (buf + EOCD_LEN), commentLength);
 }
 
+void ZipFile::readZip64CentralDirValues(const sys::ubyte* locator)
+{
+    sys::Uint16_T off = 4;
+    sys::Uint32_T diskWithEOCD = Z_READ_INT_INC(locator, off);
+    sys::Uint64_T eocdOffset = Z_READ_LONG_INC(locator, off);
+    if (diskWithEOCD != 0)
+        throw except::IOException(Ctxt("ZIP64 EOCD disk number must be 0"));
+
+    sys::ubyte eocd[ZIP64_EOCD_LEN];
+    mSource->readAt(eocdOffset, eocd, ZIP64_EOCD_LEN);
+    if (readInt(eocd) != ZIP64_EOCD_SIGNATURE)
+        throw except::IOException(Ctxt("ZIP64 EOCD not found"));
+
+    // Skip the record size and versions
+    off = 16;
+    sys::Uint32_T diskNum = Z_READ_INT_INC(eocd, off);
+    sys::Uint32_T diskWithCentralDir = Z_READ_INT_INC(eocd, off);
+    if (diskNum != 0 || diskWithCentralDir != 0)
+        throw except::IOException(Ctxt("disk number must be 0"));
+
+    sys::Uint64_T entryCount = Z_READ_LONG_INC(eocd, off);
+    sys::Uint64_T totalEntries = Z_READ_LONG_INC(eocd, off);
+    if (totalEntries != entryCount)
+        throw except::IOException(Ctxt("Total entries must match entries"));
+
+    mNumEntries = entryCount;
+    mCentralDirSize = Z_READ_LONG_INC(eocd, off);
+    mCentralDirOffset = Z_READ_LONG_INC(eocd, off);
+}
+
 std::ostream& operator<<(std::ostream& os, const ZipFile& zf)
 {
     os << "central directory length: " << zf.getCentralDirSize() << std::endl;
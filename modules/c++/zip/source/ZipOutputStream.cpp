@@ -21,11 +21,202 @@
  */
 
 #include <zip/ZipOutputStream.h>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+
 #include <io/FileInputStream.h>
+#include <io/FileOutputStream.h>
+#include <io/TempFile.h>
 #include <except/Exception.h>
+#include <mt/WorkStealingExecutor.h>
+#include <str/Format.h>
+#include <sys/Path.h>
+
+namespace
+{
+// Entries deflating at once, per thread, so a big one doesn't stall the rest
+constexpr size_t ENTRIES_PER_THREAD = 2;
+
+// Deflated data past this goes to a temporary file rather than memory
+constexpr size_t SPILL_SIZE = 32 * 1024 * 1024;
+
+constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+constexpr sys::Uint64_T ZIP64_SIZE = 0xffffffff;
+
+// An entry deflated off to the side, waiting its turn to be written
+struct Deflated final
+{
+    sys::Uint64_T uncompressedSize = 0;
+    sys::Uint64_T compressedSize = 0;
+    uLong crc = 0;
+    std::vector<sys::ubyte> data;
+    std::unique_ptr<io::TempFile> spill;
+
+    // Last, so it's destroyed (which waits) before what the task uses
+    std::unique_ptr<mt::TaskGroup> task;
+};
+
+class Deflater final
+{
+public:
+    Deflater(int level, const std::string& spillDirectory, Deflated& result) :
+        mSpillDirectory(spillDirectory),
+        mResult(result),
+        mOutput(CHUNK_SIZE)
+    {
+        ::memset(&mStream, 0, sizeof(mStream));
+        const int zerr = deflateInit2(&mStream, level, Z_DEFLATED,
+                                      -MAX_WBITS, DEF_MEM_LEVEL,
+                                      Z_DEFAULT_STRATEGY);
+        if (zerr != Z_OK)
+        {
+            throw except::IOException(Ctxt(str::Format(
+                    "deflateInit2 failed [%d]", zerr)));
+        }
+    }
+
+    ~Deflater()
+    {
+        deflateEnd(&mStream);
+    }
+
+    Deflater(const Deflater&) = delete;
+    Deflater& operator=(const Deflater&) = delete;
+
+    void deflate(const sys::ubyte* data, size_t len)
+    {
+        mResult.uncompressedSize += len;
+        while (len > 0)
+        {
+            const size_t n = std::min<size_t>(
+                    len, std::numeric_limits<uInt>::max());
+            mResult.crc = crc32(mResult.crc, data, static_cast<uInt>(n));
+            mStream.next_in = const_cast<Bytef*>(data);
+            mStream.avail_in = static_cast<uInt>(n);
+            run(Z_NO_FLUSH);
+            data += n;
+            len -= n;
+        }
+    }
+
+    void finish()
+    {
+        mStream.next_in = nullptr;
+        mStream.avail_in = 0;
+        run(Z_FINISH);
+        if (mSpillStream)
+        {
+            mSpillStream->close();
+        }
+    }
+
+private:
+    void run(int flush)
+    {
+        int zerr;
+        do
+        {
+            mStream.next_out = mOutput.data();
+            mStream.avail_out = static_cast<uInt>(mOutput.size());
+            zerr = ::deflate(&mStream, flush);
+            if (zerr == Z_STREAM_ERROR)
+            {
+                throw except::IOException(Ctxt("deflate failed"));
+            }
+            emit(mOutput.size() - mStream.avail_out);
+        }
+        while (mStream.avail_out == 0 ||
+               (flush == Z_FINISH && zerr != Z_STREAM_END));
+    }
+
+    void emit(size_t len)
+    {
+        mResult.compressedSize += len;
+        auto& data = mResult.data;
+        if (!mSpillStream && data.size() + len > SPILL_SIZE)
+        {
+            mResult.spill.reset(new io::TempFile(mSpillDirectory));
+            mSpillStream.reset(
+                    new io::FileOutputStream(mResult.spill->pathname()));
+            mSpillStream->write(data.data(), data.size());
+            std::vector<sys::ubyte>().swap(data);
+        }
+
+        if (mSpillStream)
+        {
+            mSpillStream->write(mOutput.data(), len);
+        }
+        else
+        {
+            data.insert(data.end(), mOutput.data(), mOutput.data() + len);
+        }
+    }
+
+    const std::string& mSpillDirectory;
+    Deflated& mResult;
+    z_stream mStream;
+    std::vector<sys::ubyte> mOutput;
+    std::unique_ptr<io::FileOutputStream> mSpillStream;
+};
+
+void deflateEntry(const zip::ZipOutputStream::Entry& entry, int level,
+                  const std::string& spillDirectory, Deflated& result)
+{
+    Deflater deflater(level, spillDirectory, result);
+    if (!entry.input && entry.inputPathname.empty())
+    {
+        deflater.deflate(static_cast<const sys::ubyte*>(entry.buffer),
+                         entry.len);
+        deflater.finish();
+        return;
+    }
+
+    std::unique_ptr<io::FileInputStream> file;
+    io::InputStream* input = entry.input;
+    if (!input)
+    {
+        file.reset(new io::FileInputStream(entry.inputPathname));
+        input = file.get();
+    }
+
+    std::vector<sys::ubyte> buffer(CHUNK_SIZE);
+    sys::SSize_T numBytes;
+    while ((numBytes = input->read(buffer.data(), buffer.size())) > 0)
+    {
+        deflater.deflate(buffer.data(), static_cast<size_t>(numBytes));
+    }
+    deflater.finish();
+}
+}
 
 namespace zip
 {
+ZipOutputStream::Entry::Entry(const std::string& zipPathname_,
+                              const std::string& inputPathname_) :
+    zipPathname(zipPathname_),
+    inputPathname(inputPathname_)
+{
+}
+
+ZipOutputStream::Entry::Entry(const std::string& zipPathname_,
+                              const void* buffer_, size_t len_) :
+    zipPathname(zipPathname_),
+    buffer(buffer_),
+    len(len_)
+{
+}
+
+ZipOutputStream::Entry::Entry(const std::string& zipPathname_,
+                              io::InputStream& input_) :
+    zipPathname(zipPathname_),
+    input(&input_)
+{
+}
+
 ZipOutputStream::ZipOutputStream(const std::string& pathname)
 {
     mZip = zipOpen64(pathname.c_str(), APPEND_STATUS_CREATE);
@@ -33,6 +224,10 @@ ZipOutputStream::ZipOutputStream(const std::string& pathname)
         throw except::IOException(Ctxt("Failed to open zip stream " + 
                 pathname));
 
+    // Spill next to the zip, which is where the space is
+    mSpillDirectory = sys::Path::splitPath(pathname).first;
+    if (mSpillDirectory.empty())
+        mSpillDirectory = ".";
 }
 
 void ZipOutputStream::createFileInZip(const std::string& pathname,
@@ -85,6 +280,95 @@ void ZipOutputStream::write(const std::string& inputPathname,
     closeFileInZip();
 }
 
+void ZipOutputStream::writeEntries(const std::vector<Entry>& entries,
+                                   size_t numThreads,
+                                   int level)
+{
+    if (numThreads == 0)
+        numThreads = mt::WorkStealingExecutor::getInstance().getNumThreads();
+    const size_t window = std::max<size_t>(numThreads, 1) * ENTRIES_PER_THREAD;
+
+    const auto start = [&](size_t ii)
+    {
+        std::unique_ptr<Deflated> deflated(new Deflated);
+        if (numThreads == 1)
+        {
+            deflateEntry(entries[ii], level, mSpillDirectory, *deflated);
+        }
+        else
+        {
+            Deflated* const result = deflated.get();
+            const Entry& entry = entries[ii];
+            const std::string& spillDirectory = mSpillDirectory;
+            deflated->task.reset(new mt::TaskGroup);
+            deflated->task->run([&entry, level, &spillDirectory, result]()
+            {
+                deflateEntry(entry, level, spillDirectory, *result);
+            });
+        }
+        return deflated;
+    };
+
+    // Keep a window of entries deflating, and write them in order
+    std::deque<std::unique_ptr<Deflated> > pending;
+    size_t next = 0;
+    for (size_t ii = 0; ii < entries.size(); ++ii)
+    {
+        while (next < entries.size() && next < ii + window &&
+               (numThreads > 1 || next == ii))
+        {
+            pending.push_back(start(next++));
+        }
+
+        std::unique_ptr<Deflated> deflated(std::move(pending.front()));
+        pending.pop_front();
+        if (deflated->task)
+            deflated->task->wait();
+
+        // The deflate is done; add it without minizip deflating it again
+        zip_fileinfo zipFileInfo;
+        memset(&zipFileInfo, 0, sizeof(zipFileInfo));
+        const int zip64 = deflated->uncompressedSize >= ZIP64_SIZE ||
+                deflated->compressedSize >= ZIP64_SIZE;
+        sys::Int32_T results = zipOpenNewFileInZip3_64(
+                mZip,
+                entries[ii].zipPathname.c_str(),
+                &zipFileInfo,
+                nullptr,
+                0,
+                nullptr,
+                0,
+                nullptr,
+                Z_DEFLATED,
+                level,
+                1,
+                -MAX_WBITS,
+                DEF_MEM_LEVEL,
+                Z_DEFAULT_STRATEGY,
+                nullptr,
+                0,
+                zip64);
+        if (results != Z_OK)
+            throw except::IOException(Ctxt("Failed to create file " +
+                    entries[ii].zipPathname));
+
+        if (!deflated->data.empty())
+            write(deflated->data.data(), deflated->data.size());
+        if (deflated->spill)
+        {
+            io::FileInputStream spill(deflated->spill->pathname());
+            spill.streamTo(*this);
+            spill.close();
+        }
+
+        results = zipCloseFileInZipRaw64(mZip, deflated->uncompressedSize,
+                                         deflated->crc);
+        if (results != Z_OK)
+            throw except::IOException(Ctxt("Failed to close file " +
+                    entries[ii].zipPathname));
+    }
+}
+
 void ZipOutputStream::write(const void* buffer, size_t len)
 {
     // Write the contents to the location
@@ -0,0 +1,189 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <import/io.h>
+#include <import/zip.h>
+#include <io/TempFile.h>
+#include <math/Round.h>
+
+#include <TestCase.h>
+
+namespace
+{
+// Compressible, but not trivially
+std::string makeData(size_t len)
+{
+    std::string data(len, '\0');
+    sys::Uint32_T state = 12345;
+    for (size_t ii = 0; ii < len; ++ii)
+    {
+        state = state * 1103515245 + 12345;
+        data[ii] = static_cast<char>('a' + (state >> 16) % 8);
+    }
+    return data;
+}
+
+std::string readAll(io::InputStream& input, size_t chunkSize = 10000)
+{
+    std::string result;
+    std::vector<char> buffer(chunkSize);
+    sys::SSize_T numBytes;
+    while ((numBytes = input.read(buffer.data(), buffer.size())) > 0)
+    {
+        result.append(buffer.data(), static_cast<size_t>(numBytes));
+    }
+    return result;
+}
+
+void writeBGZF(const std::string& pathname, const std::string& data,
+               size_t numThreads, zip::bgzf::Index* index = nullptr)
+{
+    zip::BGZFOutputStream output(pathname, Z_DEFAULT_COMPRESSION, numThreads);
+    // Uneven writes, to cross block and batch boundaries
+    size_t offset = 0;
+    for (size_t len = 1; offset < data.size(); len = len * 3 + 7)
+    {
+        len = std::min(len, data.size() - offset);
+        output.write(data.data() + offset, len);
+        offset += len;
+    }
+    output.close();
+    if (index)
+    {
+        *index = output.getIndex();
+    }
+}
+}
+
+TEST_CASE(testRoundTrip)
+{
+    const std::string data = makeData(3 * 1000 * 1000 + 17);
+    for (const size_t numThreads : {1, 4})
+    {
+        io::TempFile tempFile;
+        writeBGZF(tempFile.pathname(), data, numThreads);
+
+        for (const size_t readThreads : {1, 4})
+        {
+            zip::BGZFInputStream input(tempFile.pathname(), readThreads);
+            TEST_ASSERT_TRUE(input.isBGZF());
+            const auto result = readAll(input);
+            TEST_ASSERT(result == data);
+        }
+
+        // Anything that reads gzip can read it
+        zip::GZipInputStream gzip(tempFile.pathname());
+        const auto result = readAll(gzip);
+        gzip.close();
+        TEST_ASSERT(result == data);
+    }
+}
+
+TEST_CASE(testEmpty)
+{
+    io::TempFile tempFile;
+    writeBGZF(tempFile.pathname(), "", 4);
+
+    zip::BGZFInputStream input(tempFile.pathname());
+    TEST_ASSERT_TRUE(input.isBGZF());
+    const auto result = readAll(input);
+    TEST_ASSERT_TRUE(result.empty());
+}
+
+TEST_CASE(testSeek)
+{
+    const std::string data = makeData(1000 * 1000);
+    io::TempFile tempFile;
+    zip::bgzf::Index index;
+    writeBGZF(tempFile.pathname(), data, 4, &index);
+    TEST_ASSERT_EQ(index.size(),
+                   math::ceilingDivide(data.size(),
+                                       static_cast<size_t>(zip::bgzf::BLOCK_DATA_SIZE)));
+
+    // The index survives a round trip through the .gzi format
+    io::ByteStream indexStream;
+    zip::bgzf::writeIndex(index, indexStream);
+    indexStream.seek(0, io::Seekable::START);
+    const auto readIndex = zip::bgzf::readIndex(indexStream);
+    TEST_ASSERT_EQ(readIndex.size(), index.size());
+    TEST_ASSERT_EQ(readIndex.back().compressedOffset, index.back().compressedOffset);
+    TEST_ASSERT_EQ(readIndex.back().uncompressedOffset, index.back().uncompressedOffset);
+
+    for (const bool setIndex : {false, true})
+    {
+        zip::BGZFInputStream input(tempFile.pathname(), 4);
+        if (setIndex)
+        {
+            input.setIndex(readIndex);
+        }
+
+        const size_t offsets[] = { 700000, 12, 65280, 65279, 999990, 300000, 300001, 0 };
+        for (const size_t offset : offsets)
+        {
+            const auto where = input.seek(static_cast<sys::Off_T>(offset), io::Seekable::START);
+            TEST_ASSERT_EQ(where, static_cast<sys::Off_T>(offset));
+
+            std::string result(100, '\0');
+            const auto numBytes = input.read(&result[0], result.size());
+            result.resize(static_cast<size_t>(std::max<sys::SSize_T>(numBytes, 0)));
+            TEST_ASSERT(result == data.substr(offset, 100));
+        }
+
+        input.seek(-5, io::Seekable::END);
+        const auto tail = readAll(input);
+        TEST_ASSERT(tail == data.substr(data.size() - 5));
+        const auto found = input.getIndex().size();
+        TEST_ASSERT_EQ(found, index.size());
+    }
+}
+
+TEST_CASE(testPlainGZip)
+{
+    const std::string data = makeData(500 * 1000);
+    io::TempFile tempFile;
+    {
+        zip::GZipOutputStream output(tempFile.pathname());
+        output.write(data.data(), data.size());
+        output.close();
+    }
+
+    zip::BGZFInputStream input(tempFile.pathname());
+    TEST_ASSERT_FALSE(input.isBGZF());
+    const auto result = readAll(input);
+    TEST_ASSERT(result == data);
+
+    // Backwards means starting over
+    input.seek(1234, io::Seekable::START);
+    std::string chunk(10, '\0');
+    input.read(&chunk[0], chunk.size());
+    TEST_ASSERT(chunk == data.substr(1234, 10));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testRoundTrip);
+    TEST_CHECK(testEmpty);
+    TEST_CHECK(testSeek);
+    TEST_CHECK(testPlainGZip);
+)
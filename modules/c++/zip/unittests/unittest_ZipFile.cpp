@@ -0,0 +1,336 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <std/filesystem>
+
+#include <import/sys.h>
+#include <import/io.h>
+#include <import/zip.h>
+#include <io/TempFile.h>
+
+#include <TestCase.h>
+
+namespace
+{
+std::filesystem::path findUnittestFile(const std::filesystem::path& name)
+{
+    static const auto unittests = std::filesystem::path("modules") / "c++" / "zip" / "unittests";
+    return sys::test::findGITModuleFile("coda-oss", unittests, name);
+}
+
+struct TestEntry final
+{
+    std::string name;
+    std::string data;
+    bool deflate;
+};
+
+void put16(std::string& out, sys::Uint64_T value)
+{
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>((value >> 8) & 0xFF);
+}
+void put32(std::string& out, sys::Uint64_T value)
+{
+    put16(out, value);
+    put16(out, value >> 16);
+}
+void put64(std::string& out, sys::Uint64_T value)
+{
+    put32(out, value);
+    put32(out, value >> 32);
+}
+
+std::string deflateData(const std::string& data)
+{
+    z_stream zstream{};
+    deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                 Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&zstream, static_cast<uLong>(data.size())), '\0');
+    zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zstream.avail_in = static_cast<uInt>(data.size());
+    zstream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zstream.avail_out = static_cast<uInt>(out.size());
+    deflate(&zstream, Z_FINISH);
+    out.resize(zstream.total_out);
+    deflateEnd(&zstream);
+    return out;
+}
+
+// Builds an archive in memory.  With zip64, every size and offset is in a
+// ZIP64 extra field and there's a ZIP64 EOCD, as if the archive were huge.
+std::string makeArchive(const std::vector<TestEntry>& entries, bool zip64)
+{
+    const sys::Uint64_T escape = zip64 ? 0xFFFFFFFF : 0;
+    std::string archive;
+    std::string centralDir;
+    for (const auto& entry : entries)
+    {
+        const std::string data = entry.deflate ? deflateData(entry.data) : entry.data;
+        const auto crc = crc32(0, reinterpret_cast<const Bytef*>(entry.data.data()),
+                               static_cast<uInt>(entry.data.size()));
+        const sys::Uint64_T localHeaderOffset = archive.size();
+
+        put32(archive, zip::LFH_SIGNATURE);
+        put16(archive, 45);
+        put16(archive, 0);
+        put16(archive, entry.deflate ? 8 : 0);
+        put32(archive, 0);
+        put32(archive, crc);
+        put32(archive, escape ? escape : data.size());
+        put32(archive, escape ? escape : entry.data.size());
+        put16(archive, entry.name.size());
+        put16(archive, zip64 ? 20 : 0);
+        archive += entry.name;
+        if (zip64)
+        {
+            put16(archive, zip::ZIP64_EXTRA_ID);
+            put16(archive, 16);
+            put64(archive, entry.data.size());
+            put64(archive, data.size());
+        }
+        archive += data;
+
+        put32(centralDir, zip::ENTRY_SIGNATURE);
+        put16(centralDir, 45);
+        put16(centralDir, 45);
+        put16(centralDir, 0);
+        put16(centralDir, entry.deflate ? 8 : 0);
+        put32(centralDir, 0);
+        put32(centralDir, crc);
+        put32(centralDir, escape ? escape : data.size());
+        put32(centralDir, escape ? escape : entry.data.size());
+        put16(centralDir, entry.name.size());
+        put16(centralDir, zip64 ? 28 : 0);
+        put16(centralDir, 0);
+        put16(centralDir, 0);
+        put16(centralDir, 0);
+        put32(centralDir, 0);
+        put32(centralDir, escape ? escape : localHeaderOffset);
+        centralDir += entry.name;
+        if (zip64)
+        {
+            put16(centralDir, zip::ZIP64_EXTRA_ID);
+            put16(centralDir, 24);
+            put64(centralDir, entry.data.size());
+            put64(centralDir, data.size());
+            put64(centralDir, localHeaderOffset);
+        }
+    }
+
+    const sys::Uint64_T centralDirOffset = archive.size();
+    archive += centralDir;
+    if (zip64)
+    {
+        const sys::Uint64_T eocdOffset = archive.size();
+        put32(archive, zip::ZIP64_EOCD_SIGNATURE);
+        put64(archive, zip::ZIP64_EOCD_LEN - 12);
+        put16(archive, 45);
+        put16(archive, 45);
+        put32(archive, 0);
+        put32(archive, 0);
+        put64(archive, entries.size());
+        put64(archive, entries.size());
+        put64(archive, centralDir.size());
+        put64(archive, centralDirOffset);
+
+        put32(archive, zip::ZIP64_LOCATOR_SIGNATURE);
+        put32(archive, 0);
+        put64(archive, eocdOffset);
+        put32(archive, 1);
+    }
+    put32(archive, zip::CD_SIGNATURE);
+    put16(archive, 0);
+    put16(archive, 0);
+    put16(archive, zip64 ? 0xFFFF : entries.size());
+    put16(archive, zip64 ? 0xFFFF : entries.size());
+    put32(archive, escape ? escape : centralDir.size());
+    put32(archive, escape ? escape : centralDirOffset);
+    put16(archive, 0);
+    return archive;
+}
+
+std::vector<TestEntry> makeEntries(size_t numEntries)
+{
+    std::vector<TestEntry> entries;
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        TestEntry entry;
+        entry.name = "tile_" + std::to_string(i) + ".txt";
+        for (size_t j = 0; j < 2000 + 500 * i; ++j)
+        {
+            entry.data += std::to_string(j * (i + 1) % 997) + ' ';
+        }
+        entry.deflate = (i % 3) != 0;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+std::string readAll(io::InputStream& input, size_t chunkSize)
+{
+    std::string result;
+    std::vector<char> buffer(chunkSize);
+    sys::SSize_T numBytes;
+    while ((numBytes = input.read(buffer.data(), buffer.size())) > 0)
+    {
+        result.append(buffer.data(), static_cast<size_t>(numBytes));
+    }
+    return result;
+}
+
+std::string extract(const zip::ZipFile& archive, const std::string& name)
+{
+    const auto entry = archive.lookup(name);
+    if (entry == archive.end())
+    {
+        return "";
+    }
+    zip::ZipEntryInputStream input(**entry);
+    return readAll(input, 4096);
+}
+}
+
+TEST_CASE(testStoredEntry)
+{
+    const auto pathname = findUnittestFile("test.zip").string();
+
+    std::vector<std::unique_ptr<zip::ZipFile> > archives;
+    archives.emplace_back(new zip::ZipFile(pathname));
+    archives.emplace_back(new zip::ZipFile(pathname, true));
+    io::FileInputStream stream(pathname);
+    archives.emplace_back(new zip::ZipFile(stream));
+    {
+        io::FileInputStream legacyStream(pathname);
+        archives.emplace_back(new zip::ZipFile(&legacyStream));
+    }
+
+    for (const auto& archive : archives)
+    {
+        TEST_ASSERT_EQ(archive->getNumEntries(), 1);
+        TEST_ASSERT(archive->lookup("missing.txt") == archive->end());
+
+        const auto entry = archive->lookup("text.txt");
+        TEST_ASSERT(entry != archive->end());
+        std::unique_ptr<sys::ubyte[]> data((*entry)->decompress());
+        const std::string text(reinterpret_cast<const char*>(data.get()),
+                               (*entry)->getUncompressedSize());
+        TEST_ASSERT_EQ(text, "Hello World!");
+
+        const auto streamed = extract(*archive, "text.txt");
+        TEST_ASSERT_EQ(streamed, "Hello World!");
+    }
+}
+
+TEST_CASE(testZip64)
+{
+    const auto entries = makeEntries(5);
+    const std::string bytes = makeArchive(entries, true);
+
+    io::ByteStream stream;
+    stream.write(bytes.data(), bytes.size());
+    zip::ZipFile archive(stream);
+
+    TEST_ASSERT_EQ(archive.getNumEntries(), entries.size());
+    for (const auto& expected : entries)
+    {
+        const auto entry = archive.lookup(expected.name);
+        TEST_ASSERT(entry != archive.end());
+        TEST_ASSERT_EQ((*entry)->getUncompressedSize(), expected.data.size());
+
+        // A small buffer makes the inflater refill many times
+        zip::ZipEntryInputStream input(**entry, 100);
+        const auto available = input.available();
+        TEST_ASSERT_EQ(available, static_cast<sys::Off_T>(expected.data.size()));
+        const auto data = readAll(input, 777);
+        TEST_ASSERT(data == expected.data);
+    }
+}
+
+TEST_CASE(testConcurrentExtraction)
+{
+    const auto entries = makeEntries(24);
+    io::TempFile tempFile;
+    {
+        const std::string bytes = makeArchive(entries, false);
+        std::ofstream out(tempFile.pathname(), std::ios::binary);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    for (const bool memoryMap : {false, true})
+    {
+        const zip::ZipFile archive(tempFile.pathname(), memoryMap);
+        std::atomic<size_t> numBad(0);
+        std::vector<std::thread> threads;
+        const size_t numThreads = 4;
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                // Every thread reads every entry, starting at a different one
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    const auto& expected = entries[(i + t * 5) % entries.size()];
+                    if (extract(archive, expected.name) != expected.data)
+                    {
+                        ++numBad;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        const size_t bad = numBad;
+        TEST_ASSERT_EQ(bad, 0);
+    }
+}
+
+TEST_CASE(testCorruptData)
+{
+    std::vector<TestEntry> entries(1);
+    entries[0].name = "stored.txt";
+    entries[0].data = "The quick brown fox jumps over the lazy dog";
+    entries[0].deflate = false;
+    std::string bytes = makeArchive(entries, false);
+    bytes[zip::LFH_SIZE + entries[0].name.size() + 4] ^= 0x20;
+
+    io::ByteStream stream;
+    stream.write(bytes.data(), bytes.size());
+    const zip::ZipFile archive(stream);
+    TEST_EXCEPTION(extract(archive, "stored.txt"));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testStoredEntry);
+    TEST_CHECK(testZip64);
+    TEST_CHECK(testConcurrentExtraction);
+    TEST_CHECK(testCorruptData);
+)
@@ -0,0 +1,125 @@
+/* =========================================================================
+ * This file is part of zip-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2025, Arka Group, L.P.
+ *
+ * zip-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <import/io.h>
+#include <import/zip.h>
+#include <io/TempFile.h>
+
+#include <TestCase.h>
+
+namespace
+{
+std::string makeData(size_t len, sys::Uint32_T seed)
+{
+    std::string data(len, '\0');
+    for (size_t ii = 0; ii < len; ++ii)
+    {
+        seed = seed * 1103515245 + 12345;
+        data[ii] = static_cast<char>('a' + (seed >> 16) % 8);
+    }
+    return data;
+}
+
+std::string readFile(const std::string& pathname)
+{
+    io::FileInputStream input(pathname);
+    io::StringStream output;
+    input.streamTo(output);
+    return output.stream().str();
+}
+
+std::string extract(const zip::ZipFile& archive, const std::string& name)
+{
+    const auto entry = archive.lookup(name);
+    if (entry == archive.end())
+    {
+        return "<missing>";
+    }
+    zip::ZipEntryInputStream input(**entry);
+    io::StringStream output;
+    input.streamTo(output);
+    return output.stream().str();
+}
+}
+
+TEST_CASE(testWriteEntries)
+{
+    io::TempFile inputFile;
+    const std::string fileData = makeData(300 * 1000, 1);
+    {
+        io::FileOutputStream output(inputFile.pathname());
+        output.write(fileData.data(), fileData.size());
+        output.close();
+    }
+
+    std::vector<std::string> buffers;
+    for (size_t ii = 0; ii < 40; ++ii)
+    {
+        buffers.push_back(makeData(ii * 997, static_cast<sys::Uint32_T>(ii)));
+    }
+    const std::string streamData = makeData(100 * 1000, 2);
+
+    // One archive per thread count; the TempFiles outlive every use of them
+    const size_t threadCounts[] = {1, 4};
+    const io::TempFile outputFiles[2];
+    for (size_t run = 0; run < 2; ++run)
+    {
+        const size_t numThreads = threadCounts[run];
+        const std::string& zipPathname = outputFiles[run].pathname();
+
+        io::StringStream stream;
+        stream.write(streamData);
+
+        std::vector<zip::ZipOutputStream::Entry> entries;
+        entries.emplace_back("file.txt", inputFile.pathname());
+        entries.emplace_back("stream.txt", stream);
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            entries.emplace_back("buffers/" + std::to_string(ii) + ".txt",
+                                 buffers[ii].data(), buffers[ii].size());
+        }
+
+        zip::ZipOutputStream output(zipPathname);
+        output.writeEntries(entries, numThreads);
+        output.close();
+
+        const zip::ZipFile archive(zipPathname);
+        TEST_ASSERT_EQ(archive.getNumEntries(), entries.size());
+        TEST_ASSERT(extract(archive, "file.txt") == fileData);
+        TEST_ASSERT(extract(archive, "stream.txt") == streamData);
+        for (size_t ii = 0; ii < buffers.size(); ++ii)
+        {
+            const auto name = "buffers/" + std::to_string(ii) + ".txt";
+            TEST_ASSERT(extract(archive, name) == buffers[ii]);
+        }
+    }
+
+    // Entries go in in order, however many threads deflate them
+    TEST_ASSERT(readFile(outputFiles[0].pathname()) == readFile(outputFiles[1].pathname()));
+}
+
+TEST_MAIN(
+    TEST_CHECK(testWriteEntries);
+)